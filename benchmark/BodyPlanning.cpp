@@ -0,0 +1,73 @@
+#include <dwl/environment/TerrainMap.h>
+#include <dwl/model/GridBasedBodyAdjacency.h>
+#include <dwl/solver/AStar.h>
+#include <dwl/robot/Robot.h>
+#include <ctime>
+
+
+int main(int argc, char **argv)
+{
+	// The number of cells per side of the synthetic terrain
+	unsigned int N = 512;
+	double resolution = 0.04;
+
+	dwl::robot::Robot robot;
+	dwl::environment::TerrainMap terrain;
+
+	// Generating a synthetic and rough terrain
+	dwl::TerrainData terrain_data;
+	terrain_data.plane_size = resolution;
+	terrain_data.height_size = resolution;
+	terrain.setResolution(resolution, true);
+	terrain.setResolution(resolution, false);
+	for (unsigned int i = 0; i < N; i++) {
+		for (unsigned int j = 0; j < N; j++) {
+			double x = i * resolution;
+			double y = j * resolution;
+
+			dwl::Terrain terrain_info;
+			terrain_info.position << x, y, 0.05 * sin(x) * cos(y);
+			terrain_info.surface_normal = Eigen::Vector3d::UnitZ();
+
+			dwl::TerrainCell cell;
+			double cost = 1. + 0.5 * sin(3 * x) * sin(3 * y);
+			terrain.setTerrainCell(cell, cost, terrain_info.position(2), terrain_info);
+			terrain_data.data.push_back(cell);
+		}
+	}
+	terrain.setTerrainMap(terrain_data);
+
+	// Setting up the body planner
+	dwl::solver::AStar solver;
+	solver.setAdjacencyModel(new dwl::model::GridBasedBodyAdjacency());
+	solver.reset(&robot, &terrain);
+	solver.init();
+
+	// Planning between the start and goal states at increasing distances, the search time
+	// should scale with the expanded vertices and not with the size of the terrain. The
+	// plans are computed with the terrain map and dense grid storages
+	double distances[] = {0.5, 1., 2.};
+	for (unsigned int k = 0; k < 6; k++) {
+		if (k == 3)
+			terrain.setDenseGrid(true);
+
+		Eigen::Vector3d start_state(1., 1., 0.);
+		Eigen::Vector3d goal_state(1. + distances[k % 3], 1. + distances[k % 3], 0.);
+
+		dwl::Vertex source, target;
+		terrain.getTerrainSpaceModel().stateToVertex(source, start_state);
+		terrain.getTerrainSpaceModel().stateToVertex(target, goal_state);
+
+		std::clock_t startcputime = std::clock();
+		solver.compute(source, target, std::numeric_limits<double>::max());
+		double cpu_duration =
+				(std::clock() - startcputime) * 1000 / (double) CLOCKS_PER_SEC;
+
+		std::list<dwl::Vertex> path = solver.getShortestPath(source, target);
+		std::cout << "  Body planning (" << (k >= 3 ? "dense grid, " : "")
+				<< distances[k % 3] << " m, " << path.size()
+				<< " vertices): " << cpu_duration << " (millisecs, CPU time)" << std::endl;
+	}
+
+	return 0;
+}
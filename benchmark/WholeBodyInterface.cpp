@@ -64,6 +64,20 @@ int main(int argc, char **argv)
 	std::cout << "  Forward kinematics: " << cpu_duration / N << " (microsecs, CPU time)" << std::endl;
 
 
+	// The single-pass forward kinematics writes in a preallocated buffer
+	startcputime = std::clock();
+	Eigen::MatrixXd contact_pos_buffer(3, fbs.getNumberOfEndEffectors());
+	for (unsigned int i = 0; i < N; ++i)
+		wkin.computeForwardKinematics(contact_pos_buffer,
+									  ws.base_pos, ws.joint_pos,
+									  fbs.getEndEffectorNames(),
+									  dwl::rbd::Linear, dwl::RollPitchYaw);
+
+	cpu_duration =
+				(std::clock() - startcputime) * 1000000 / (double) CLOCKS_PER_SEC;
+	std::cout << "  Forward kinematics (single pass): " << cpu_duration / N << " (microsecs, CPU time)" << std::endl;
+
+
 	dwl::rbd::BodyVector3d ik_pos;
 	ik_pos["lf_foot"] = contact_pos_W.find("lf_foot")->second.tail(3);
 	ik_pos["rf_foot"] = contact_pos_W.find("rf_foot")->second.tail(3);
@@ -79,6 +93,22 @@ int main(int argc, char **argv)
 	std::cout << "  Inverse kinematics: " << cpu_duration / N << " (microsecs, CPU time)" << std::endl;
 
 
+	// The same inverse kinematics with the Newton solver of the branches
+	dwl::model::WholeBodyKinematics wkin_newton = wkin;
+	const dwl::rbd::BodySelector& feet = fbs.getEndEffectorNames(dwl::model::FOOT);
+	for (unsigned int k = 0; k < feet.size(); ++k)
+		wkin_newton.setTypeOfBranchSolver(feet[k], dwl::model::NewtonBranchSolver);
+
+	Eigen::VectorXd joint_pos_newton = joint_pos_init;
+	startcputime = std::clock();
+	for (unsigned int i = 0; i < N; ++i)
+		wkin_newton.computeJointPosition(joint_pos_newton, ik_pos, joint_pos_init);
+
+	cpu_duration =
+				(std::clock() - startcputime) * 1000000 / (double) CLOCKS_PER_SEC;
+	std::cout << "  Inverse kinematics (Newton branches): " << cpu_duration / N << " (microsecs, CPU time)" << std::endl;
+
+
 	startcputime = std::clock();
 	Eigen::MatrixXd jacobian;
 	for (unsigned int i = 0; i < N; ++i)
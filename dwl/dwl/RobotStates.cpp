@@ -1,10 +1,14 @@
 #include <dwl/RobotStates.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 namespace dwl
 {
 
-RobotStates::RobotStates() : num_joints_(0), num_feet_(0), force_threshold_(0.)
+RobotStates::RobotStates() : num_joints_(0), num_feet_(0), force_threshold_(0.),
+		num_threads_(1)
 {
 
 }
@@ -22,6 +26,7 @@ void RobotStates::reset(const model::WholeBodyDynamics& dynamics)
 	wdyn_ = dynamics;
 	fbs_ = wdyn_.getFloatingBaseSystem();
 	wkin_ = wdyn_.getWholeBodyKinematics();
+	thread_wkin_.clear();
 
 	// Getting some system properties
 	num_joints_ = fbs_.getJointDoF();
@@ -40,76 +45,18 @@ void RobotStates::setForceThreshold(double force_threshold)
 }
 
 
-const WholeBodyState& RobotStates::getWholeBodyState(const ReducedBodyState& state)
+void RobotStates::setNumberOfThreads(unsigned int num_threads)
 {
-	// Adding the time
-	ws_.time = state.time;
-
-	// From the reduced-body state we do not know the joint states, so we neglect
-	// the joint-related components of the CoM. Therefore, we transform the
-	// CoM states assuming that CoM is fixed-point in the base
-	Eigen::Vector3d com_pos_W =
-			frame_tf_.fromBaseToWorldFrame(com_pos_B_,
-										   state.getRPY());
-	ws_.setBasePosition(state.getCoMPosition() - com_pos_W);
-	ws_.setBaseVelocity_W(computeBaseVelocity_W(state, com_pos_W));
-	ws_.setBaseAcceleration_W(computeBaseAcceleration_W(state, com_pos_W));
-
-	ws_.setBaseRPY(state.getRPY());
-	ws_.setBaseAngularVelocity_W(state.getAngularVelocity_W());
-	ws_.setBaseAngularAcceleration_W(state.getAngularAcceleration_W());
-
-
-	// Adding the contact positions, velocities, accelerations and condition
-	// w.r.t the base frame
-	dwl::rbd::BodyVector3d feet_pos;
-	for (unsigned int f = 0; f < num_feet_; f++) {
-		std::string name = feet_[f];
-
-		// Setting up the contact position
-		Eigen::Vector3d contact_pos_B =	state.getFootPosition_B(name) + com_pos_B_;
-		ws_.setContactPosition_B(name, contact_pos_B);
-		feet_pos[name] = contact_pos_B; // for IK computation
-
-		// Setting up the contact velocity
-		ws_.setContactVelocity_W(name, state.getFootVelocity_W(name));
-
-		// Setting up the contact acceleration
-		ws_.setContactAcceleration_W(name, state.getFootAcceleration_W(name));
-
-		// Setting up the contact condition
-		rbd::BodyVector3d::const_iterator support_it = state.support_region.find(name);
-		if (support_it != state.support_region.end())
-			ws_.setContactCondition(name, true);
-		else
-			ws_.setContactCondition(name, false);
-	}
-
-	// Adding the joint positions, velocities and accelerations
-	ws_.setJointPosition(Eigen::VectorXd::Zero(num_joints_));
-	ws_.setJointVelocity(Eigen::VectorXd::Zero(num_joints_));
-	ws_.setJointAcceleration(Eigen::VectorXd::Zero(num_joints_));
-
-	// Computing the joint positions
-	wkin_.computeJointPosition(ws_.joint_pos,
-							   feet_pos);
-
-	// Computing the joint velocities
-	wkin_.computeJointVelocity(ws_.joint_vel,
-							   ws_.joint_pos,
-							   ws_.contact_vel,
-							   feet_);
-
-	// Computing the joint accelerations
-	wkin_.computeJointAcceleration(ws_.joint_acc,
-								   ws_.joint_pos,
-								   ws_.joint_vel,
-								   ws_.contact_vel,
-								   feet_);
+	if (num_threads == 0)
+		num_threads_ = 1;
+	else
+		num_threads_ = num_threads;
+}
 
-	// Setting up the desired joint efforts equals to zero
-	ws_.joint_eff = Eigen::VectorXd::Zero(num_joints_);
 
+const WholeBodyState& RobotStates::getWholeBodyState(const ReducedBodyState& state)
+{
+	computeWholeBodyState(ws_, state, wkin_, false);
 
 	return ws_;
 }
@@ -186,9 +133,28 @@ const WholeBodyTrajectory& RobotStates::getWholeBodyTrajectory(const ReducedBody
 	wt_.clear();
 	wt_.resize(num_points);
 
-	// Getting the full trajectory
-	for (unsigned int k = 0; k < num_points; k++)
-		wt_[k] = getWholeBodyState(trajectory[k]);
+	// Splitting the trajectory into chunks, where each chunk has at least
+	// min_chunk points. Every chunk is converted by a thread with its own
+	// copy of the kinematics, except the first one that uses wkin_
+	const unsigned int min_chunk = 50;
+	unsigned int num_chunks = std::max(1u, std::min(num_threads_, num_points / min_chunk));
+	while (thread_wkin_.size() < num_chunks - 1)
+		thread_wkin_.push_back(wkin_);
+
+	// Getting the full trajectory. The IK solver of every point is
+	// warm-started from the previous point of its chunk
+#pragma omp parallel for num_threads(num_chunks) schedule(static)
+	for (unsigned int c = 0; c < num_chunks; c++) {
+		model::WholeBodyKinematics& kinematics = (c == 0) ? wkin_ : thread_wkin_[c - 1];
+		unsigned int begin = c * num_points / num_chunks;
+		unsigned int end = (c + 1) * num_points / num_chunks;
+		for (unsigned int k = begin; k < end; k++) {
+			if (k > begin)
+				wt_[k].joint_pos = wt_[k - 1].joint_pos;
+
+			computeWholeBodyState(wt_[k], trajectory[k], kinematics, k > begin);
+		}
+	}
 
 	return wt_;
 }
@@ -212,6 +178,89 @@ const ReducedBodyTrajectory& RobotStates::getReducedBodyTrajectory(const WholeBo
 }
 
 
+void RobotStates::computeWholeBodyState(WholeBodyState& ws,
+										const ReducedBodyState& state,
+										model::WholeBodyKinematics& kinematics,
+										bool warm_start)
+{
+	// Adding the time
+	ws.time = state.time;
+
+	// From the reduced-body state we do not know the joint states, so we neglect
+	// the joint-related components of the CoM. Therefore, we transform the
+	// CoM states assuming that CoM is fixed-point in the base
+	Eigen::Vector3d com_pos_W =
+			frame_tf_.fromBaseToWorldFrame(com_pos_B_,
+										   state.getRPY());
+	ws.setBasePosition(state.getCoMPosition() - com_pos_W);
+	ws.setBaseVelocity_W(computeBaseVelocity_W(state, com_pos_W));
+	ws.setBaseAcceleration_W(computeBaseAcceleration_W(state, com_pos_W));
+
+	ws.setBaseRPY(state.getRPY());
+	ws.setBaseAngularVelocity_W(state.getAngularVelocity_W());
+	ws.setBaseAngularAcceleration_W(state.getAngularAcceleration_W());
+
+
+	// Adding the contact positions, velocities, accelerations and condition
+	// w.r.t the base frame
+	dwl::rbd::BodyVector3d feet_pos;
+	for (unsigned int f = 0; f < num_feet_; f++) {
+		const std::string& name = feet_[f];
+
+		// Setting up the contact position
+		Eigen::Vector3d contact_pos_B =	state.getFootPosition_B(name) + com_pos_B_;
+		ws.setContactPosition_B(name, contact_pos_B);
+		feet_pos[name] = contact_pos_B; // for IK computation
+
+		// Setting up the contact velocity
+		ws.setContactVelocity_W(name, state.getFootVelocity_W(name));
+
+		// Setting up the contact acceleration
+		ws.setContactAcceleration_W(name, state.getFootAcceleration_W(name));
+
+		// Setting up the contact condition
+		rbd::BodyVector3d::const_iterator support_it = state.support_region.find(name);
+		if (support_it != state.support_region.end())
+			ws.setContactCondition(name, true);
+		else
+			ws.setContactCondition(name, false);
+	}
+
+	// Adding the joint positions, velocities and accelerations
+	ws.setJointVelocity(Eigen::VectorXd::Zero(num_joints_));
+	ws.setJointAcceleration(Eigen::VectorXd::Zero(num_joints_));
+
+	// Computing the joint positions, where the warm-start guess is the
+	// actual joint position
+	if (warm_start && ws.joint_pos.size() == num_joints_) {
+		Eigen::VectorXd joint_pos_init = ws.joint_pos;
+		kinematics.computeJointPosition(ws.joint_pos,
+										feet_pos,
+										joint_pos_init);
+	} else {
+		ws.setJointPosition(Eigen::VectorXd::Zero(num_joints_));
+		kinematics.computeJointPosition(ws.joint_pos,
+										feet_pos);
+	}
+
+	// Computing the joint velocities
+	kinematics.computeJointVelocity(ws.joint_vel,
+									ws.joint_pos,
+									ws.contact_vel,
+									feet_);
+
+	// Computing the joint accelerations
+	kinematics.computeJointAcceleration(ws.joint_acc,
+										ws.joint_pos,
+										ws.joint_vel,
+										ws.contact_acc,
+										feet_);
+
+	// Setting up the desired joint efforts equals to zero
+	ws.joint_eff = Eigen::VectorXd::Zero(num_joints_);
+}
+
+
 Eigen::Vector3d RobotStates::computeBaseVelocity_W(const ReducedBodyState& state,
 												   const Eigen::Vector3d& com_pos_W)
 {
@@ -28,6 +28,15 @@ class RobotStates
 		/** @brief Set the force threshold for getting active contacts */
 		void setForceThreshold(double force_threshold);
 
+		/**
+		 * @brief Sets the number of threads used for converting reduced-body
+		 * trajectories. Long trajectories are split into chunks, which are
+		 * converted concurrently with their own copy of the kinematics. The
+		 * default value is 1
+		 * @param unsigned int Number of threads
+		 */
+		void setNumberOfThreads(unsigned int num_threads);
+
 		/**
 		 * @brief Converts the reduced-body state to whole-body one
 		 * @param const ReducedBodyStated& Reduced-body state
@@ -43,7 +52,9 @@ class RobotStates
 		const ReducedBodyState& getReducedBodyState(const WholeBodyState& state);
 
 		/**
-		 * @brief Converts a reduced-body trajectory to a whole-body one
+		 * @brief Converts a reduced-body trajectory to a whole-body one. The
+		 * joint positions of every sample are computed from the solution of
+		 * the previous one, which is a close guess for the IK solver
 		 * @param const ReducedBodyTrajectory& Reduced-body trajectory
 		 * @return const WholeBodyTrajectory& Whole-body trajectory
 		 */
@@ -52,6 +63,20 @@ class RobotStates
 
 
 	private:
+		/**
+		 * @brief Converts the reduced-body state to whole-body one
+		 * @param WholeBodyState& Whole-body state. If it's warm-started, its
+		 * joint position is used as initial guess of the IK solver
+		 * @param const ReducedBodyStated& Reduced-body state
+		 * @param model::WholeBodyKinematics& Whole-body kinematics used for
+		 * the conversion
+		 * @param bool Indicates if the IK solver is warm-started
+		 */
+		void computeWholeBodyState(WholeBodyState& ws,
+								   const ReducedBodyState& state,
+								   model::WholeBodyKinematics& kinematics,
+								   bool warm_start);
+
 		/**
 		 * @brief Computes the base velocity in the world frame from the
 		 * CoM acceleration
@@ -90,6 +115,9 @@ class RobotStates
 		/** @brief Whole-body kinematics */
 		model::WholeBodyKinematics wkin_;
 
+		/** @brief Whole-body kinematics of every conversion thread */
+		std::vector<model::WholeBodyKinematics> thread_wkin_;
+
 		/** @brief Whole-body dynamics */
 		model::WholeBodyDynamics wdyn_;
 
@@ -104,6 +132,9 @@ class RobotStates
 
 		/** @brief Force threshold */
 		double force_threshold_;
+
+		/** @brief Number of threads used for converting trajectories */
+		unsigned int num_threads_;
 };
 
 } //@namespace
@@ -0,0 +1,287 @@
+#include <dwl/environment/ObstacleDistanceField.h>
+#include <algorithm>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+ObstacleDistanceField::ObstacleDistanceField(double max_distance) : origin_x_(0), origin_y_(0),
+		origin_(Eigen::Vector2d::Zero()), num_x_(0), num_y_(0), resolution_(0.),
+		max_distance_(max_distance), max_sq_distance_(0)
+{
+
+}
+
+
+ObstacleDistanceField::~ObstacleDistanceField()
+{
+
+}
+
+
+void ObstacleDistanceField::reset()
+{
+	closest_obstacle_.clear();
+	sq_distance_.clear();
+	is_obstacle_.clear();
+	to_raise_.clear();
+	obstacles_.clear();
+	open_queue_ = std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int> >,
+			std::greater<std::pair<int,int> > >();
+	num_x_ = 0;
+	num_y_ = 0;
+}
+
+
+void ObstacleDistanceField::setMaximumDistance(double max_distance)
+{
+	max_distance_ = max_distance;
+	reset();
+}
+
+
+void ObstacleDistanceField::update(const ObstacleMap& obstacle_map,
+								   const SpaceDiscretization& space_discretization)
+{
+	// Getting the keys of the obstacles and their bounding box
+	std::vector<Key> keys;
+	Key min_key, max_key;
+	for (ObstacleMap::const_iterator obstacle_it = obstacle_map.begin();
+			obstacle_it != obstacle_map.end(); obstacle_it++) {
+		if (!obstacle_it->second)
+			continue;
+
+		Key key;
+		space_discretization.vertexToKey(key, obstacle_it->first, true);
+		if (keys.empty()) {
+			min_key = key;
+			max_key = key;
+		} else {
+			min_key.x = std::min(min_key.x, key.x);
+			min_key.y = std::min(min_key.y, key.y);
+			max_key.x = std::max(max_key.x, key.x);
+			max_key.y = std::max(max_key.y, key.y);
+		}
+		keys.push_back(key);
+	}
+
+	// Checking if the grid has to be rebuilt, i.e. the resolution changed or the obstacles
+	// (and their maximum distance) leave the grid
+	double resolution = space_discretization.getEnvironmentResolution(true);
+	bool rebuild = (resolution != resolution_) || (num_x_ == 0);
+	if (!rebuild && !keys.empty()) {
+		int margin = ceil(max_distance_ / resolution_) + 1;
+		if ((min_key.x - margin < origin_x_ && origin_x_ > 0) ||
+				(min_key.y - margin < origin_y_ && origin_y_ > 0) ||
+				(max_key.x + margin >= origin_x_ + num_x_ && origin_x_ + num_x_ <= 65535) ||
+				(max_key.y + margin >= origin_y_ + num_y_ && origin_y_ + num_y_ <= 65535))
+			rebuild = true;
+	}
+
+	if (rebuild) {
+		reset();
+		resolution_ = resolution;
+		if (keys.empty())
+			return;
+
+		resizeGrid(min_key, max_key, space_discretization);
+	}
+
+	// Getting the obstacle cells, which are sorted for computing the changes
+	std::vector<int> obstacles(keys.size());
+	for (unsigned int i = 0; i < keys.size(); i++)
+		obstacles[i] = (keys[i].y - origin_y_) * num_x_ + (keys[i].x - origin_x_);
+	std::sort(obstacles.begin(), obstacles.end());
+	obstacles.erase(std::unique(obstacles.begin(), obstacles.end()), obstacles.end());
+
+	// Removing and adding the changed obstacles, and propagating their waves
+	std::vector<int> removed_obstacles, added_obstacles;
+	std::set_difference(obstacles_.begin(), obstacles_.end(),
+						obstacles.begin(), obstacles.end(),
+						std::back_inserter(removed_obstacles));
+	std::set_difference(obstacles.begin(), obstacles.end(),
+						obstacles_.begin(), obstacles_.end(),
+						std::back_inserter(added_obstacles));
+	for (unsigned int i = 0; i < removed_obstacles.size(); i++)
+		removeObstacle(removed_obstacles[i]);
+	for (unsigned int i = 0; i < added_obstacles.size(); i++)
+		setObstacle(added_obstacles[i]);
+	obstacles_.swap(obstacles);
+
+	propagate();
+}
+
+
+double ObstacleDistanceField::getDistance(const Eigen::Vector2d& position) const
+{
+	int obstacle;
+	if (!getClosestObstacle(obstacle, position))
+		return max_distance_;
+
+	Eigen::Vector2d obstacle_position = origin_ +
+			resolution_ * Eigen::Vector2d(obstacle % num_x_, obstacle / num_x_);
+	return std::min((position - obstacle_position).norm(), max_distance_);
+}
+
+
+double ObstacleDistanceField::getDistance(Eigen::Vector2d& gradient,
+										  const Eigen::Vector2d& position) const
+{
+	gradient.setZero();
+
+	int obstacle;
+	if (!getClosestObstacle(obstacle, position))
+		return max_distance_;
+
+	// The gradient points from the closest obstacle to the position
+	Eigen::Vector2d obstacle_position = origin_ +
+			resolution_ * Eigen::Vector2d(obstacle % num_x_, obstacle / num_x_);
+	Eigen::Vector2d direction = position - obstacle_position;
+	double distance = direction.norm();
+	if (distance > 0.)
+		gradient = direction / distance;
+
+	return std::min(distance, max_distance_);
+}
+
+
+double ObstacleDistanceField::getResolution() const
+{
+	return resolution_;
+}
+
+
+bool ObstacleDistanceField::getClosestObstacle(int& obstacle,
+											   const Eigen::Vector2d& position) const
+{
+	if (num_x_ == 0)
+		return false;
+
+	int x = (int) floor((position(0) - origin_(0)) / resolution_ + 0.5);
+	int y = (int) floor((position(1) - origin_(1)) / resolution_ + 0.5);
+	if (x < 0 || y < 0 || x >= num_x_ || y >= num_y_)
+		return false;
+
+	obstacle = closest_obstacle_[y * num_x_ + x];
+	return obstacle >= 0;
+}
+
+
+void ObstacleDistanceField::resizeGrid(const Key& min_key,
+									   const Key& max_key,
+									   const SpaceDiscretization& space_discretization)
+{
+	// Enlarging the area by twice the maximum distance, so the grid isn't rebuilt for small
+	// displacements of the obstacles
+	int margin = ceil(max_distance_ / resolution_) + 1;
+	max_sq_distance_ = (margin - 1) * (margin - 1);
+	origin_x_ = std::max(0, (int) min_key.x - 2 * margin);
+	origin_y_ = std::max(0, (int) min_key.y - 2 * margin);
+	num_x_ = std::min(65535, (int) max_key.x + 2 * margin) - origin_x_ + 1;
+	num_y_ = std::min(65535, (int) max_key.y + 2 * margin) - origin_y_ + 1;
+	space_discretization.keyToCoord(origin_(0), origin_x_, true);
+	space_discretization.keyToCoord(origin_(1), origin_y_, true);
+
+	unsigned int num_cells = num_x_ * num_y_;
+	closest_obstacle_.assign(num_cells, -1);
+	sq_distance_.assign(num_cells, std::numeric_limits<int>::max());
+	is_obstacle_.assign(num_cells, 0);
+	to_raise_.assign(num_cells, 0);
+}
+
+
+void ObstacleDistanceField::setObstacle(int index)
+{
+	is_obstacle_[index] = 1;
+	to_raise_[index] = 0;
+	closest_obstacle_[index] = index;
+	sq_distance_[index] = 0;
+	open_queue_.push(std::make_pair(0, index));
+}
+
+
+void ObstacleDistanceField::removeObstacle(int index)
+{
+	is_obstacle_[index] = 0;
+	to_raise_[index] = 1;
+	closest_obstacle_[index] = -1;
+	sq_distance_[index] = std::numeric_limits<int>::max();
+	open_queue_.push(std::make_pair(0, index));
+}
+
+
+void ObstacleDistanceField::propagate()
+{
+	while (!open_queue_.empty()) {
+		std::pair<int,int> element = open_queue_.top();
+		open_queue_.pop();
+
+		// Note that the outdated elements of the queue are skipped
+		int index = element.second;
+		if (to_raise_[index])
+			raise(index);
+		else if (element.first == sq_distance_[index] && closest_obstacle_[index] >= 0 &&
+				is_obstacle_[closest_obstacle_[index]])
+			lower(index);
+	}
+}
+
+
+void ObstacleDistanceField::lower(int index)
+{
+	int x = index % num_x_;
+	int y = index / num_x_;
+	int obstacle = closest_obstacle_[index];
+	for (int ny = std::max(0, y - 1); ny <= std::min(num_y_ - 1, y + 1); ny++) {
+		for (int nx = std::max(0, x - 1); nx <= std::min(num_x_ - 1, x + 1); nx++) {
+			int neighbor = ny * num_x_ + nx;
+			if (neighbor == index || to_raise_[neighbor])
+				continue;
+
+			int sq_distance = getSquaredDistance(neighbor, obstacle);
+			if (sq_distance <= max_sq_distance_ && sq_distance < sq_distance_[neighbor]) {
+				sq_distance_[neighbor] = sq_distance;
+				closest_obstacle_[neighbor] = obstacle;
+				open_queue_.push(std::make_pair(sq_distance, neighbor));
+			}
+		}
+	}
+}
+
+
+void ObstacleDistanceField::raise(int index)
+{
+	int x = index % num_x_;
+	int y = index / num_x_;
+	for (int ny = std::max(0, y - 1); ny <= std::min(num_y_ - 1, y + 1); ny++) {
+		for (int nx = std::max(0, x - 1); nx <= std::min(num_x_ - 1, x + 1); nx++) {
+			int neighbor = ny * num_x_ + nx;
+			if (neighbor == index || to_raise_[neighbor] || closest_obstacle_[neighbor] < 0)
+				continue;
+
+			// Clearing the neighbors of removed obstacles, and lowering again the rest
+			open_queue_.push(std::make_pair(sq_distance_[neighbor], neighbor));
+			if (!is_obstacle_[closest_obstacle_[neighbor]]) {
+				closest_obstacle_[neighbor] = -1;
+				sq_distance_[neighbor] = std::numeric_limits<int>::max();
+				to_raise_[neighbor] = 1;
+			}
+		}
+	}
+	to_raise_[index] = 0;
+}
+
+
+int ObstacleDistanceField::getSquaredDistance(int index_a,
+											  int index_b) const
+{
+	int dx = index_a % num_x_ - index_b % num_x_;
+	int dy = index_a / num_x_ - index_b / num_x_;
+	return dx * dx + dy * dy;
+}
+
+} //@namespace environment
+} //@namespace dwl
@@ -0,0 +1,148 @@
+#ifndef DWL__ENVIRONMENT__OBSTACLE_DISTANCE_FIELD__H
+#define DWL__ENVIRONMENT__OBSTACLE_DISTANCE_FIELD__H
+
+#include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/utils/utils.h>
+#include <queue>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+/**
+ * @class ObstacleDistanceField
+ * @brief Euclidean distance field of the obstacle map, i.e. every cell of a dense 2D grid knows
+ * its closest obstacle cell. It's maintained incrementally: the added and removed obstacles
+ * start lower and raise waves that only propagate through the cells whose closest obstacle
+ * changes (dynamic brushfire). The distances are truncated at a maximum distance, so the
+ * update cost only depends on the changed area. Thus, a collision query is a single lookup
+ */
+class ObstacleDistanceField
+{
+	public:
+		/**
+		 * @brief Constructor function
+		 * @param double Maximum distance of the field
+		 */
+		ObstacleDistanceField(double max_distance = 2.);
+
+		/** @brief Destructor function */
+		~ObstacleDistanceField();
+
+		/** @brief Removes all the obstacles of the field */
+		void reset();
+
+		/**
+		 * @brief Sets the maximum distance of the field, i.e. the farther cells get this
+		 * distance. Note that it resets the field
+		 * @param double Maximum distance
+		 */
+		void setMaximumDistance(double max_distance);
+
+		/**
+		 * @brief Updates the field with the current obstacle map. Only the added and removed
+		 * obstacles are processed, unless the obstacles leave the grid or the resolution
+		 * changes, in which case the grid is rebuilt
+		 * @param const ObstacleMap& Obstacle map
+		 * @param const SpaceDiscretization& Space discretization of the obstacle map
+		 */
+		void update(const ObstacleMap& obstacle_map,
+					const SpaceDiscretization& space_discretization);
+
+		/**
+		 * @brief Gets the distance from a position to the center of the closest obstacle cell
+		 * @param const Eigen::Vector2d& Position
+		 * @return The distance, which is the maximum distance if there isn't a close obstacle
+		 */
+		double getDistance(const Eigen::Vector2d& position) const;
+
+		/**
+		 * @brief Gets the distance and its gradient, i.e. the direction from the closest
+		 * obstacle cell to the position
+		 * @param Eigen::Vector2d& Gradient of the distance, which is zero if there isn't a close
+		 * obstacle
+		 * @param const Eigen::Vector2d& Position
+		 * @return The distance, which is the maximum distance if there isn't a close obstacle
+		 */
+		double getDistance(Eigen::Vector2d& gradient,
+						   const Eigen::Vector2d& position) const;
+
+		/** @brief Gets the resolution of the field */
+		double getResolution() const;
+
+
+	private:
+		/**
+		 * @brief Gets the closest obstacle cell of a position
+		 * @param int& Index of the closest obstacle cell
+		 * @param const Eigen::Vector2d& Position
+		 * @return False if there isn't a close obstacle
+		 */
+		bool getClosestObstacle(int& obstacle,
+								const Eigen::Vector2d& position) const;
+
+		/**
+		 * @brief Allocates the grid for a certain area of keys, where the grid is enlarged by
+		 * the maximum distance
+		 * @param const Key& Minimum (x,y) key of the obstacles
+		 * @param const Key& Maximum (x,y) key of the obstacles
+		 * @param const SpaceDiscretization& Space discretization of the obstacle map
+		 */
+		void resizeGrid(const Key& min_key,
+						const Key& max_key,
+						const SpaceDiscretization& space_discretization);
+
+		/** @brief Sets and removes an obstacle cell, which starts a lower or raise wave */
+		void setObstacle(int index);
+		void removeObstacle(int index);
+
+		/** @brief Propagates the lower and raise waves until the field is consistent */
+		void propagate();
+
+		/** @brief Propagates the closest obstacle of a cell to its neighbors */
+		void lower(int index);
+
+		/** @brief Clears the neighbors of a cell whose closest obstacle was removed */
+		void raise(int index);
+
+		/** @brief Computes the squared distance (in cells) between two cells */
+		int getSquaredDistance(int index_a,
+							   int index_b) const;
+
+		/** @brief Closest obstacle cell and its squared distance (in cells) of every cell */
+		std::vector<int> closest_obstacle_;
+		std::vector<int> sq_distance_;
+
+		/** @brief Obstacle and raise flags of every cell */
+		std::vector<char> is_obstacle_;
+		std::vector<char> to_raise_;
+
+		/** @brief Obstacle cells of the field */
+		std::vector<int> obstacles_;
+
+		/** @brief Open queue of the waves, i.e. squared distance and cell */
+		std::priority_queue<std::pair<int,int>, std::vector<std::pair<int,int> >,
+				std::greater<std::pair<int,int> > > open_queue_;
+
+		/** @brief Minimum key, coordinate of its center and size of the grid */
+		int origin_x_;
+		int origin_y_;
+		Eigen::Vector2d origin_;
+		int num_x_;
+		int num_y_;
+
+		/** @brief Resolution of the grid */
+		double resolution_;
+
+		/** @brief Maximum distance and its squared value in cells */
+		double max_distance_;
+		int max_sq_distance_;
+};
+
+} //@namespace environment
+} //@namespace dwl
+
+#endif
@@ -7,7 +7,7 @@ namespace dwl
 namespace environment
 {
 
-ObstacleMap::ObstacleMap() : space_discretization_(0,0), depth_(16), is_added_search_area_(false),
+ObstacleMap::ObstacleMap() : space_discretization_(0,0), terrain_surface_(NULL), depth_(16), is_added_search_area_(false),
 		interest_radius_x_(std::numeric_limits<double>::max()),
 		interest_radius_y_(std::numeric_limits<double>::max()),
 		resolution_(std::numeric_limits<double>::max())
@@ -121,6 +121,18 @@ void ObstacleMap::compute(octomap::OcTree* octomap,
 	robot_2dpose(1) = robot_state(1);
 	robot_2dpose(2) = robot_state(3);
 	removeObstacleOutsideInterestRegion(robot_2dpose);
+
+	// Updating the terrain surface with the octomap
+	if (terrain_surface_ != NULL) {
+		terrain_surface_->addOcTree(*octomap);
+		terrain_surface_->compute();
+	}
+}
+
+
+void ObstacleMap::setTerrainSurface(TerrainSurface* surface)
+{
+	terrain_surface_ = surface;
 }
 
 
@@ -2,6 +2,7 @@
 #define DWL__ENVIRONMENT__OBSTACLE_MAP__H
 
 #include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/environment/TerrainSurface.h>
 #include <dwl/utils/utils.h>
 
 #include <octomap/octomap.h>
@@ -30,13 +31,22 @@ class ObstacleMap
 		void reset();
 
 		/**
-		 * @brief Computes the obstacle map according the robot position and model of the terrain
+		 * @brief Computes the obstacle map according the robot position and model of the terrain.
+		 * If it's defined a terrain surface, the octomap is also added to it and its dirty tiles
+		 * are computed, so the updated cells can be added to the terrain map
+		 * (i.e. TerrainMap::updateTerrainMap)
 		 * @param octomap::OcTree* Octomap model of the environment
 		 * @param const Eigen::Vector4d& robot_state The position of the robot and the yaw angle
 		 */
 		void compute(octomap::OcTree* octomap,
 					 const Eigen::Vector4d& robot_state);
 
+		/**
+		 * @brief Sets the terrain surface that is updated with the octomap of every computation
+		 * @param TerrainSurface* Terrain surface, or NULL for not updating it
+		 */
+		void setTerrainSurface(TerrainSurface* surface);
+
 		/**
 		 * @brief Adds a new search area around the current position of the robot
 		 * @param double Minimum Cartesian position along the x-axis
@@ -101,6 +111,9 @@ class ObstacleMap
 		/** @brief Reward values mapped using vertex id */
 		std::map<Vertex,Cell> obstacle_map_;
 
+		/** @brief Terrain surface updated with the octomap */
+		TerrainSurface* terrain_surface_;
+
 		/** @brief Vector of search areas */
 		std::vector<SearchArea> search_areas_;
 
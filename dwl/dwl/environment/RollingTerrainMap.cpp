@@ -0,0 +1,409 @@
+#include <dwl/environment/RollingTerrainMap.h>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+RollingTerrainMap::RollingTerrainMap(double resolution,
+									 double window_size) :
+		space_discretization_(resolution, resolution, M_PI / 200),
+		size_bits_(0), size_(1), mask_(0), origin_x_(0), origin_y_(0),
+		num_cells_(0), cost_sum_(0.), height_sum_(0.), normal_sum_(Eigen::Vector3d::Zero()),
+		max_cost_(0.), min_height_(0.), update_extremes_(false)
+{
+	setWindowSize(window_size);
+}
+
+
+RollingTerrainMap::~RollingTerrainMap()
+{
+
+}
+
+
+void RollingTerrainMap::reset()
+{
+	std::fill(valid_.begin(), valid_.end(), 0);
+
+	num_cells_ = 0;
+	cost_sum_ = 0.;
+	height_sum_ = 0.;
+	normal_sum_.setZero();
+	max_cost_ = 0.;
+	min_height_ = 0.;
+	update_extremes_ = false;
+}
+
+
+void RollingTerrainMap::setResolution(double resolution,
+									  bool plane)
+{
+	space_discretization_.setEnvironmentResolution(resolution, plane);
+	reset();
+}
+
+
+void RollingTerrainMap::setWindowSize(double window_size)
+{
+	// Computing the number of cells per side as power of two, which allows us to address the
+	// circular buffer with a mask
+	double resolution = space_discretization_.getEnvironmentResolution(true);
+	unsigned int num_cells = ceil(window_size / resolution);
+	size_bits_ = 0;
+	while ((1u << size_bits_) < num_cells && size_bits_ < 15)
+		size_bits_++;
+	size_ = 1 << size_bits_;
+	mask_ = size_ - 1;
+
+	// Allocating the circular buffers
+	unsigned int buffer_size = size_ * size_;
+	cost_.resize(buffer_size);
+	height_.resize(buffer_size);
+	normal_.resize(buffer_size);
+	valid_.assign((buffer_size + 63) / 64, 0);
+	reset();
+
+	// Centering the window in the origin of the space
+	moveWindow(Eigen::Vector2d::Zero());
+}
+
+
+void RollingTerrainMap::moveWindow(const Eigen::Vector2d& center)
+{
+	unsigned short int key_x, key_y;
+	space_discretization_.coordToKey(key_x, (double) center(rbd::X), true);
+	space_discretization_.coordToKey(key_y, (double) center(rbd::Y), true);
+	int new_origin_x = (int) key_x - (int) size_ / 2;
+	int new_origin_y = (int) key_y - (int) size_ / 2;
+
+	int shift_x = new_origin_x - origin_x_;
+	int shift_y = new_origin_y - origin_y_;
+	if (shift_x == 0 && shift_y == 0)
+		return;
+
+	if (abs(shift_x) >= (int) size_ || abs(shift_y) >= (int) size_) {
+		// The new window doesn't overlap the current one
+		reset();
+	} else {
+		// Clearing the columns that leave the window. Note that their slots of the circular
+		// buffer are reused by the columns that enter in the window
+		Key key;
+		int min_x = (shift_x > 0) ? origin_x_ : new_origin_x + size_;
+		int max_x = (shift_x > 0) ? origin_x_ + shift_x : origin_x_ + size_;
+		for (int x = min_x; x < max_x; x++) {
+			key.x = x;
+			for (int y = origin_y_; y < origin_y_ + (int) size_; y++) {
+				key.y = y;
+				clearCell(getCellIndex(key));
+			}
+		}
+
+		// Clearing the rows that leave the window
+		int min_y = (shift_y > 0) ? origin_y_ : new_origin_y + size_;
+		int max_y = (shift_y > 0) ? origin_y_ + shift_y : origin_y_ + size_;
+		for (int y = min_y; y < max_y; y++) {
+			key.y = y;
+			for (int x = origin_x_; x < origin_x_ + (int) size_; x++) {
+				key.x = x;
+				clearCell(getCellIndex(key));
+			}
+		}
+	}
+
+	origin_x_ = new_origin_x;
+	origin_y_ = new_origin_y;
+}
+
+
+unsigned int RollingTerrainMap::updateCells(const std::vector<TerrainCell>& cells)
+{
+	unsigned int num_updates = 0;
+	for (unsigned int i = 0; i < cells.size(); i++) {
+		if (updateCell(cells[i]))
+			num_updates++;
+	}
+
+	return num_updates;
+}
+
+
+bool RollingTerrainMap::updateCell(const TerrainCell& cell)
+{
+	if (!isInsideWindow(cell.key))
+		return false;
+
+	// The height is defined by the z key as in the terrain map
+	double height;
+	space_discretization_.keyToCoord(height, cell.key.z, false);
+
+	unsigned int index = getCellIndex(cell.key);
+	if (isValidCell(index)) {
+		// Removing the old values from the aggregates
+		cost_sum_ -= cost_[index];
+		height_sum_ -= height_[index];
+		normal_sum_ -= normal_[index];
+		if ((cost_[index] == max_cost_ && cell.cost < max_cost_) ||
+				(height_[index] == min_height_ && height > min_height_))
+			update_extremes_ = true;
+	} else {
+		valid_[index >> 6] |= (uint64_t) 1 << (index & 63);
+		if (num_cells_ == 0) {
+			max_cost_ = cell.cost;
+			min_height_ = height;
+		}
+		num_cells_++;
+	}
+
+	cost_[index] = cell.cost;
+	height_[index] = height;
+	normal_[index] = cell.normal;
+
+	// Adding the new values to the aggregates
+	cost_sum_ += cell.cost;
+	height_sum_ += height;
+	normal_sum_ += cell.normal;
+	if (!update_extremes_) {
+		max_cost_ = std::max(max_cost_, cell.cost);
+		min_height_ = std::min(min_height_, height);
+	}
+
+	return true;
+}
+
+
+void RollingTerrainMap::removeCell(const Key& key)
+{
+	if (isInsideWindow(key))
+		clearCell(getCellIndex(key));
+}
+
+
+bool RollingTerrainMap::getTerrainData(TerrainCell& cell,
+									   const Vertex& vertex) const
+{
+	unsigned int index;
+	if (!findCell(index, vertex))
+		return false;
+
+	space_discretization_.vertexToKey(cell.key, vertex, true);
+	space_discretization_.coordToKey(cell.key.z, height_[index], false);
+	cell.cost = cost_[index];
+	cell.height = height_[index];
+	cell.normal = normal_[index];
+
+	return true;
+}
+
+
+bool RollingTerrainMap::getTerrainData(TerrainCell& cell,
+									   const Eigen::Vector2d& position) const
+{
+	// Converting the position to a vertex
+	Vertex vertex;
+	space_discretization_.coordToVertex(vertex, position);
+
+	return getTerrainData(cell, vertex);
+}
+
+
+bool RollingTerrainMap::getTerrainCost(Weight& cost,
+									   const Vertex& vertex) const
+{
+	unsigned int index;
+	if (!findCell(index, vertex))
+		return false;
+
+	cost = cost_[index];
+	return true;
+}
+
+
+bool RollingTerrainMap::getTerrainCost(Weight& cost,
+									   const Eigen::Vector2d& position) const
+{
+	// Converting the position to a vertex
+	Vertex vertex;
+	space_discretization_.coordToVertex(vertex, position);
+
+	return getTerrainCost(cost, vertex);
+}
+
+
+bool RollingTerrainMap::getTerrainHeight(double& height,
+										 const Vertex& vertex) const
+{
+	unsigned int index;
+	if (!findCell(index, vertex))
+		return false;
+
+	height = height_[index];
+	return true;
+}
+
+
+bool RollingTerrainMap::getTerrainHeight(double& height,
+										 const Eigen::Vector2d& position) const
+{
+	// Converting the position to a vertex
+	Vertex vertex;
+	space_discretization_.coordToVertex(vertex, position);
+
+	return getTerrainHeight(height, vertex);
+}
+
+
+bool RollingTerrainMap::getTerrainNormal(Eigen::Vector3d& normal,
+										 const Vertex& vertex) const
+{
+	unsigned int index;
+	if (!findCell(index, vertex))
+		return false;
+
+	normal = normal_[index];
+	return true;
+}
+
+
+bool RollingTerrainMap::getTerrainNormal(Eigen::Vector3d& normal,
+										 const Eigen::Vector2d& position) const
+{
+	// Converting the position to a vertex
+	Vertex vertex;
+	space_discretization_.coordToVertex(vertex, position);
+
+	return getTerrainNormal(normal, vertex);
+}
+
+
+double RollingTerrainMap::getAverageCostOfTerrain() const
+{
+	if (num_cells_ == 0)
+		return 0.;
+
+	return cost_sum_ / num_cells_;
+}
+
+
+double RollingTerrainMap::getMaxCostOfTerrain() const
+{
+	if (update_extremes_)
+		updateExtremes();
+
+	return max_cost_;
+}
+
+
+double RollingTerrainMap::getMinHeightOfTerrain() const
+{
+	if (update_extremes_)
+		updateExtremes();
+
+	return min_height_;
+}
+
+
+double RollingTerrainMap::getAverageHeightOfTerrain() const
+{
+	if (num_cells_ == 0)
+		return 0.;
+
+	return height_sum_ / num_cells_;
+}
+
+
+Eigen::Vector3d RollingTerrainMap::getAverageNormalOfTerrain() const
+{
+	if (normal_sum_.norm() == 0.)
+		return Eigen::Vector3d::UnitZ();
+
+	return normal_sum_.normalized();
+}
+
+
+unsigned int RollingTerrainMap::getNumberOfCells() const
+{
+	return num_cells_;
+}
+
+
+const SpaceDiscretization& RollingTerrainMap::getTerrainSpaceModel() const
+{
+	return space_discretization_;
+}
+
+
+bool RollingTerrainMap::isInsideWindow(const Key& key) const
+{
+	return ((unsigned int) ((int) key.x - origin_x_) < size_) &&
+			((unsigned int) ((int) key.y - origin_y_) < size_);
+}
+
+
+unsigned int RollingTerrainMap::getCellIndex(const Key& key) const
+{
+	return ((key.y & mask_) << size_bits_) | (key.x & mask_);
+}
+
+
+bool RollingTerrainMap::isValidCell(unsigned int index) const
+{
+	return valid_[index >> 6] & ((uint64_t) 1 << (index & 63));
+}
+
+
+bool RollingTerrainMap::findCell(unsigned int& index,
+								 const Vertex& vertex) const
+{
+	Key key;
+	space_discretization_.vertexToKey(key, vertex, true);
+	if (!isInsideWindow(key))
+		return false;
+
+	index = getCellIndex(key);
+	return isValidCell(index);
+}
+
+
+void RollingTerrainMap::clearCell(unsigned int index)
+{
+	if (!isValidCell(index))
+		return;
+
+	valid_[index >> 6] &= ~((uint64_t) 1 << (index & 63));
+	num_cells_--;
+
+	cost_sum_ -= cost_[index];
+	height_sum_ -= height_[index];
+	normal_sum_ -= normal_[index];
+	if (cost_[index] == max_cost_ || height_[index] == min_height_)
+		update_extremes_ = true;
+}
+
+
+void RollingTerrainMap::updateExtremes() const
+{
+	max_cost_ = 0.;
+	min_height_ = 0.;
+	bool first_cell = true;
+	for (unsigned int index = 0; index < cost_.size(); index++) {
+		if (!isValidCell(index))
+			continue;
+
+		if (first_cell) {
+			max_cost_ = cost_[index];
+			min_height_ = height_[index];
+			first_cell = false;
+		} else {
+			max_cost_ = std::max(max_cost_, cost_[index]);
+			min_height_ = std::min(min_height_, height_[index]);
+		}
+	}
+
+	update_extremes_ = false;
+}
+
+} //@namespace environment
+} //@namespace dwl
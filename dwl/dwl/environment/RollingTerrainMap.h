@@ -0,0 +1,209 @@
+#ifndef DWL__ENVIRONMENT__ROLLING_TERRAIN_MAP__H
+#define DWL__ENVIRONMENT__ROLLING_TERRAIN_MAP__H
+
+#include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/utils/utils.h>
+#include <stdint.h>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+/**
+ * @class RollingTerrainMap
+ * @brief Robot-centric terrain map of a fixed square window. The cells are stored in a circular
+ * buffer addressed by their (x,y) keys modulo the window size, so moving the window only clears
+ * the cells that leave it (i.e. the data isn't copied). The cost, height and normal statistics
+ * are kept as running aggregates of the cell updates
+ */
+class RollingTerrainMap
+{
+	public:
+		/**
+		 * @brief Constructor function
+		 * @param double Plane and height resolution of the cells
+		 * @param double Side length of the window
+		 */
+		RollingTerrainMap(double resolution = 0.04,
+						  double window_size = 10.24);
+
+		/** @brief Destructor function */
+		~RollingTerrainMap();
+
+		/** @brief Removes all the cells of the map */
+		void reset();
+
+		/**
+		 * @brief Sets the resolution of the cells. Note that it resets the map
+		 * @param double Resolution of the cells
+		 * @param bool Indicates if the resolution is for the plane or the height
+		 */
+		void setResolution(double resolution,
+						   bool plane);
+
+		/**
+		 * @brief Sets the side length of the window, which is rounded to a power of two
+		 * number of cells. Note that it resets the map
+		 * @param double Side length of the window
+		 */
+		void setWindowSize(double window_size);
+
+		/**
+		 * @brief Moves the window for centering it in a certain position (e.g. the robot
+		 * position). The cells that leave the window are removed
+		 * @param const Eigen::Vector2d& Center of the window
+		 */
+		void moveWindow(const Eigen::Vector2d& center);
+
+		/**
+		 * @brief Updates a batch of cells, e.g. the cells of a mapping update. The cells outside
+		 * the window are ignored
+		 * @param const std::vector<TerrainCell>& Cells
+		 * @return The number of updated cells
+		 */
+		unsigned int updateCells(const std::vector<TerrainCell>& cells);
+
+		/**
+		 * @brief Updates a cell
+		 * @param const TerrainCell& Cell
+		 * @return False if the cell is outside the window
+		 */
+		bool updateCell(const TerrainCell& cell);
+
+		/**
+		 * @brief Removes a cell
+		 * @param const Key& Key of the cell
+		 */
+		void removeCell(const Key& key);
+
+		/**
+		 * @brief Gets the terrain data of a vertex or 2d position
+		 * @param TerrainCell& Cell data
+		 * @return True if the cell is known
+		 */
+		bool getTerrainData(TerrainCell& cell,
+							const Vertex& vertex) const;
+		bool getTerrainData(TerrainCell& cell,
+							const Eigen::Vector2d& position) const;
+
+		/**
+		 * @brief Gets the terrain cost of a vertex or 2d position
+		 * @param Weight& Cost value
+		 * @return True if the cell is known
+		 */
+		bool getTerrainCost(Weight& cost,
+							const Vertex& vertex) const;
+		bool getTerrainCost(Weight& cost,
+							const Eigen::Vector2d& position) const;
+
+		/**
+		 * @brief Gets the terrain height of a vertex or 2d position
+		 * @param double& Height value
+		 * @return True if the cell is known
+		 */
+		bool getTerrainHeight(double& height,
+							  const Vertex& vertex) const;
+		bool getTerrainHeight(double& height,
+							  const Eigen::Vector2d& position) const;
+
+		/**
+		 * @brief Gets the terrain normal of a vertex or 2d position
+		 * @param Eigen::Vector3d& Normal value
+		 * @return True if the cell is known
+		 */
+		bool getTerrainNormal(Eigen::Vector3d& normal,
+							  const Vertex& vertex) const;
+		bool getTerrainNormal(Eigen::Vector3d& normal,
+							  const Eigen::Vector2d& position) const;
+
+		/** @brief Gets the average cost of the known cells */
+		double getAverageCostOfTerrain() const;
+
+		/** @brief Gets the maximum cost of the known cells */
+		double getMaxCostOfTerrain() const;
+
+		/** @brief Gets the minimum and average height of the known cells */
+		double getMinHeightOfTerrain() const;
+		double getAverageHeightOfTerrain() const;
+
+		/** @brief Gets the average normal of the known cells */
+		Eigen::Vector3d getAverageNormalOfTerrain() const;
+
+		/** @brief Gets the number of known cells */
+		unsigned int getNumberOfCells() const;
+
+		/** @brief Gets the discrete model of the space */
+		const SpaceDiscretization& getTerrainSpaceModel() const;
+
+		/**
+		 * @brief Indicates if a key is inside the window
+		 * @param const Key& Key of the cell
+		 * @return True if it's inside the window
+		 */
+		bool isInsideWindow(const Key& key) const;
+
+
+	private:
+		/** @brief Gets the index of a key in the circular buffer */
+		unsigned int getCellIndex(const Key& key) const;
+
+		/** @brief Returns true if the cell of a certain index is known */
+		bool isValidCell(unsigned int index) const;
+
+		/**
+		 * @brief Finds a known cell of a vertex
+		 * @param unsigned int& Index of the cell in the circular buffer
+		 * @param const Vertex& Terrain vertex
+		 * @return True if the cell is known
+		 */
+		bool findCell(unsigned int& index,
+					  const Vertex& vertex) const;
+
+		/** @brief Removes the cell of a certain index from the buffer and the aggregates */
+		void clearCell(unsigned int index);
+
+		/** @brief Recomputes the maximum cost and minimum height from the known cells */
+		void updateExtremes() const;
+
+		/** @brief Discrete model of the space */
+		SpaceDiscretization space_discretization_;
+
+		/** @brief Number of cells per side of the window, and its mask */
+		unsigned int size_bits_;
+		unsigned int size_;
+		unsigned int mask_;
+
+		/** @brief Minimum (x,y) key of the window */
+		int origin_x_;
+		int origin_y_;
+
+		/** @brief Circular buffers of the cost, height and normal of the cells */
+		std::vector<Weight> cost_;
+		std::vector<double> height_;
+		std::vector<Eigen::Vector3d> normal_;
+
+		/** @brief Validity bitmask of the cells */
+		std::vector<uint64_t> valid_;
+
+		/** @brief Running aggregates of the known cells */
+		unsigned int num_cells_;
+		double cost_sum_;
+		double height_sum_;
+		Eigen::Vector3d normal_sum_;
+
+		/**
+		 * @brief Maximum cost and minimum height. They are recomputed lazily when the
+		 * extreme cell is removed
+		 */
+		mutable double max_cost_;
+		mutable double min_height_;
+		mutable bool update_extremes_;
+};
+
+} //@namespace environment
+} //@namespace dwl
+
+#endif
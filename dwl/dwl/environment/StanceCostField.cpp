@@ -0,0 +1,247 @@
+#include <dwl/environment/StanceCostField.h>
+#include <set>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+StanceCostField::StanceCostField() : terrain_(NULL), revision_(0),
+		min_position_(Eigen::Vector2d::Zero()), max_position_(Eigen::Vector2d::Zero()),
+		num_yaw_bins_(16), num_lowest_costs_(10)
+{
+
+}
+
+
+StanceCostField::~StanceCostField()
+{
+
+}
+
+
+void StanceCostField::setNumberOfYawBins(unsigned int num_bins)
+{
+	if (num_bins == 0)
+		num_yaw_bins_ = 1;
+	else
+		num_yaw_bins_ = num_bins;
+
+	layers_.clear();
+}
+
+
+void StanceCostField::setNumberOfLowestCosts(unsigned int num_costs)
+{
+	if (num_costs == 0)
+		num_lowest_costs_ = 1;
+	else
+		num_lowest_costs_ = num_costs;
+
+	layers_.clear();
+}
+
+
+void StanceCostField::reset(const TerrainMap& terrain)
+{
+	terrain_ = &terrain;
+	revision_ = terrain.getRevision();
+	layers_.clear();
+
+	// Computing the bounding box of the known cells
+	const SpaceDiscretization& space_discretization = terrain.getTerrainSpaceModel();
+	const TerrainDataMap& terrain_map = terrain.getTerrainDataMap();
+	min_position_.setZero();
+	max_position_.setZero();
+	for (TerrainDataMap::const_iterator cell_it = terrain_map.begin();
+			cell_it != terrain_map.end(); cell_it++) {
+		Eigen::Vector2d position;
+		space_discretization.keyToCoord(position(0), cell_it->second.key.x, true);
+		space_discretization.keyToCoord(position(1), cell_it->second.key.y, true);
+
+		if (cell_it == terrain_map.begin()) {
+			min_position_ = position;
+			max_position_ = position;
+		} else {
+			min_position_ = min_position_.cwiseMin(position);
+			max_position_ = max_position_.cwiseMax(position);
+		}
+	}
+}
+
+
+bool StanceCostField::isUpdated(const TerrainMap& terrain) const
+{
+	return terrain_ == &terrain && revision_ == terrain.getRevision();
+}
+
+
+bool StanceCostField::getStanceCost(double& cost,
+									const Eigen::Vector2d& position,
+									double yaw,
+									const Eigen::Vector2d& window_size)
+{
+	if (terrain_ == NULL)
+		return false;
+
+	// Computing the half size of the window in cells
+	double resolution = terrain_->getTerrainSpaceModel().getEnvironmentResolution(true);
+	unsigned int half_x = (unsigned int) round(fabs(window_size(0)) / (2 * resolution));
+	unsigned int half_y = (unsigned int) round(fabs(window_size(1)) / (2 * resolution));
+
+	// Rounding the yaw to the closest bin
+	double bin_size = 2 * M_PI / num_yaw_bins_;
+	int yaw_bin = (int) round(yaw / bin_size) % (int) num_yaw_bins_;
+	if (yaw_bin < 0)
+		yaw_bin += num_yaw_bins_;
+	const Layer& layer = getLayer(yaw_bin, half_x, half_y);
+
+	// Describing the position in the frame of the yaw bin
+	double bin_yaw = yaw_bin * bin_size;
+	double x = cos(bin_yaw) * position(0) + sin(bin_yaw) * position(1);
+	double y = -sin(bin_yaw) * position(0) + cos(bin_yaw) * position(1);
+	int i = (int) floor((x - layer.origin(0)) / resolution + 0.5);
+	int j = (int) floor((y - layer.origin(1)) / resolution + 0.5);
+	if (i < 0 || j < 0 || i >= (int) layer.num_x || j >= (int) layer.num_y)
+		return false;
+
+	// Note that the windows without known cells are NaN
+	float stance_cost = layer.cost[j * layer.num_x + i];
+	if (stance_cost != stance_cost)
+		return false;
+
+	cost = stance_cost;
+	return true;
+}
+
+
+const StanceCostField::Layer& StanceCostField::getLayer(unsigned int yaw_bin,
+														unsigned int half_x,
+														unsigned int half_y)
+{
+	// The layers are built in the first query, so the concurrent queries are serialized here
+	const Layer* layer = NULL;
+#pragma omp critical(stance_cost_field)
+	{
+		for (unsigned int l = 0; l < layers_.size(); l++) {
+			if (layers_[l].yaw_bin == yaw_bin && layers_[l].half_x == half_x &&
+					layers_[l].half_y == half_y) {
+				layer = &layers_[l];
+				break;
+			}
+		}
+
+		if (layer == NULL) {
+			Layer new_layer;
+			new_layer.yaw_bin = yaw_bin;
+			new_layer.half_x = half_x;
+			new_layer.half_y = half_y;
+			layers_.push_back(new_layer);
+			buildLayer(layers_.back());
+			layer = &layers_.back();
+		}
+	}
+
+	return *layer;
+}
+
+
+void StanceCostField::buildLayer(Layer& layer)
+{
+	double resolution = terrain_->getTerrainSpaceModel().getEnvironmentResolution(true);
+	double yaw = layer.yaw_bin * 2 * M_PI / num_yaw_bins_;
+	double cos_yaw = cos(yaw);
+	double sin_yaw = sin(yaw);
+
+	// Computing the bounding box of the known cells in the frame of the yaw bin. It's enlarged
+	// by the window size since the windows centered outside of it could contain known cells
+	Eigen::Vector2d min_position, max_position;
+	for (unsigned int c = 0; c < 4; c++) {
+		double x = (c & 1) ? max_position_(0) : min_position_(0);
+		double y = (c & 2) ? max_position_(1) : min_position_(1);
+		Eigen::Vector2d position(cos_yaw * x + sin_yaw * y, -sin_yaw * x + cos_yaw * y);
+		if (c == 0) {
+			min_position = position;
+			max_position = position;
+		} else {
+			min_position = min_position.cwiseMin(position);
+			max_position = max_position.cwiseMax(position);
+		}
+	}
+	Eigen::Vector2d margin(layer.half_x * resolution, layer.half_y * resolution);
+	layer.origin = min_position - margin;
+	layer.num_x = (unsigned int) floor((max_position(0) - min_position(0)) / resolution) +
+			2 * layer.half_x + 2;
+	layer.num_y = (unsigned int) floor((max_position(1) - min_position(1)) / resolution) +
+			2 * layer.half_y + 2;
+
+	// Resampling the terrain costs in the frame of the yaw bin
+	const float unknown = std::numeric_limits<float>::quiet_NaN();
+	int num_x = layer.num_x;
+	int num_y = layer.num_y;
+	std::vector<float> samples(num_x * num_y);
+	for (int j = 0; j < num_y; j++) {
+		for (int i = 0; i < num_x; i++) {
+			double x = layer.origin(0) + i * resolution;
+			double y = layer.origin(1) + j * resolution;
+			Eigen::Vector2d position(cos_yaw * x - sin_yaw * y, sin_yaw * x + cos_yaw * y);
+
+			Weight cost;
+			if (terrain_->getTerrainCost(cost, position))
+				samples[j * num_x + i] = cost;
+			else
+				samples[j * num_x + i] = unknown;
+		}
+	}
+
+	// Sliding the window along the rows, where the known costs of the window are kept sorted
+	layer.cost.assign(num_x * num_y, unknown);
+	int half_x = layer.half_x;
+	int half_y = layer.half_y;
+	std::multiset<float> window_costs;
+	for (int j = 0; j < num_y; j++) {
+		int min_row = std::max(0, j - half_y);
+		int max_row = std::min(num_y - 1, j + half_y);
+
+		window_costs.clear();
+		for (int i = -half_x; i < num_x; i++) {
+			// Adding the column that enters in the window
+			int in_col = i + half_x;
+			if (in_col >= 0 && in_col < num_x) {
+				for (int row = min_row; row <= max_row; row++) {
+					float cost = samples[row * num_x + in_col];
+					if (cost == cost)
+						window_costs.insert(cost);
+				}
+			}
+
+			// Removing the column that leaves the window
+			int out_col = i - half_x - 1;
+			if (out_col >= 0) {
+				for (int row = min_row; row <= max_row; row++) {
+					float cost = samples[row * num_x + out_col];
+					if (cost == cost)
+						window_costs.erase(window_costs.find(cost));
+				}
+			}
+
+			if (i < 0 || window_costs.empty())
+				continue;
+
+			// Averaging the k-lowest costs
+			unsigned int num_costs = 0;
+			double cost_sum = 0.;
+			for (std::multiset<float>::const_iterator cost_it = window_costs.begin();
+					cost_it != window_costs.end() && num_costs < num_lowest_costs_; cost_it++) {
+				cost_sum += *cost_it;
+				num_costs++;
+			}
+			layer.cost[j * num_x + i] = cost_sum / num_costs;
+		}
+	}
+}
+
+} //@namespace environment
+} //@namespace dwl
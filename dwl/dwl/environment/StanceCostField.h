@@ -0,0 +1,126 @@
+#ifndef DWL__ENVIRONMENT__STANCE_COST_FIELD__H
+#define DWL__ENVIRONMENT__STANCE_COST_FIELD__H
+
+#include <dwl/environment/TerrainMap.h>
+#include <deque>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+/**
+ * @class StanceCostField
+ * @brief Precomputed stance cost of the terrain, i.e. the mean of the k-lowest known costs inside
+ * a rectangular window (e.g. a footstep search area). There is a layer per yaw bin and window
+ * size, which is computed by resampling the terrain costs in the frame rotated by the yaw bin and
+ * sliding the window along its rows. Thus, the stance cost of a window is a single lookup. The
+ * layers are built once per terrain revision, when they are queried for first time. The stance
+ * costs can be queried concurrently, but the field has to be reset serially
+ */
+class StanceCostField
+{
+	public:
+		/** @brief Constructor function */
+		StanceCostField();
+
+		/** @brief Destructor function */
+		~StanceCostField();
+
+		/**
+		 * @brief Sets the number of yaw bins of the field. Note that it resets the field
+		 * @param unsigned int Number of yaw bins
+		 */
+		void setNumberOfYawBins(unsigned int num_bins);
+
+		/**
+		 * @brief Sets the number of lowest costs that are averaged. Note that it resets the field
+		 * @param unsigned int Number of lowest costs
+		 */
+		void setNumberOfLowestCosts(unsigned int num_costs);
+
+		/**
+		 * @brief Resets the field for a terrain map. The layers are rebuilt when the terrain
+		 * revision changes
+		 * @param const TerrainMap& Terrain map
+		 */
+		void reset(const TerrainMap& terrain);
+
+		/**
+		 * @brief Indicates if the field is up to date with a terrain map
+		 * @param const TerrainMap& Terrain map
+		 * @return True if it's up to date
+		 */
+		bool isUpdated(const TerrainMap& terrain) const;
+
+		/**
+		 * @brief Gets the stance cost of a window, i.e. the mean of the k-lowest known costs
+		 * inside it
+		 * @param double& Stance cost
+		 * @param const Eigen::Vector2d& Center of the window
+		 * @param double Yaw of the window, which is rounded to the closest yaw bin
+		 * @param const Eigen::Vector2d& Size of the window in x and y
+		 * @return False if there isn't a known cell inside the window
+		 */
+		bool getStanceCost(double& cost,
+						   const Eigen::Vector2d& position,
+						   double yaw,
+						   const Eigen::Vector2d& window_size);
+
+
+	private:
+		/** @brief Stance costs of a yaw bin and window size, in the frame of the yaw bin */
+		struct Layer
+		{
+			unsigned int yaw_bin;
+			unsigned int half_x;
+			unsigned int half_y;
+			Eigen::Vector2d origin;
+			unsigned int num_x;
+			unsigned int num_y;
+			std::vector<float> cost;
+		};
+
+		/**
+		 * @brief Gets the layer of a yaw bin and window size, and builds it if it doesn't exist
+		 * @param unsigned int Yaw bin
+		 * @param unsigned int Half size of the window in x (in cells)
+		 * @param unsigned int Half size of the window in y (in cells)
+		 * @return The layer
+		 */
+		const Layer& getLayer(unsigned int yaw_bin,
+							  unsigned int half_x,
+							  unsigned int half_y);
+
+		/**
+		 * @brief Builds the stance costs of a layer
+		 * @param Layer& Layer with the yaw bin and window size
+		 */
+		void buildLayer(Layer& layer);
+
+		/** @brief Terrain map of the field */
+		const TerrainMap* terrain_;
+
+		/** @brief Terrain revision of the layers */
+		unsigned int revision_;
+
+		/** @brief Bounding box of the known cells */
+		Eigen::Vector2d min_position_;
+		Eigen::Vector2d max_position_;
+
+		/** @brief Layers of the field. Note that adding a layer doesn't move the rest */
+		std::deque<Layer> layers_;
+
+		/** @brief Number of yaw bins */
+		unsigned int num_yaw_bins_;
+
+		/** @brief Number of lowest costs that are averaged */
+		unsigned int num_lowest_costs_;
+};
+
+} //@namespace environment
+} //@namespace dwl
+
+#endif
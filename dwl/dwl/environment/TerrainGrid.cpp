@@ -0,0 +1,232 @@
+#include <dwl/environment/TerrainGrid.h>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+TerrainGrid::Tile::Tile()
+{
+	for (unsigned int i = 0; i < TILE_CELLS / 64; i++)
+		valid[i] = 0;
+}
+
+
+TerrainGrid::TerrainGrid() : origin_x_(0), origin_y_(0),
+		num_tiles_x_(0), num_tiles_y_(0), num_cells_(0)
+{
+
+}
+
+
+TerrainGrid::~TerrainGrid()
+{
+
+}
+
+
+void TerrainGrid::reset()
+{
+	directory_.clear();
+	tiles_.clear();
+	origin_x_ = 0;
+	origin_y_ = 0;
+	num_tiles_x_ = 0;
+	num_tiles_y_ = 0;
+	num_cells_ = 0;
+}
+
+
+void TerrainGrid::reserve(const Key& min_key,
+						  const Key& max_key)
+{
+	resizeDirectory(min_key.x >> TILE_BITS, min_key.y >> TILE_BITS,
+					max_key.x >> TILE_BITS, max_key.y >> TILE_BITS);
+}
+
+
+void TerrainGrid::load(const TerrainData& terrain_data,
+					   const SpaceDiscretization& space_discretization)
+{
+	unsigned int num_cells = terrain_data.data.size();
+	if (num_cells == 0)
+		return;
+
+	// Allocating the tile directory for the whole area of the terrain data
+	Key min_key = terrain_data.data[0].key;
+	Key max_key = terrain_data.data[0].key;
+	for (unsigned int i = 1; i < num_cells; i++) {
+		const Key& key = terrain_data.data[i].key;
+		min_key.x = std::min(min_key.x, key.x);
+		min_key.y = std::min(min_key.y, key.y);
+		max_key.x = std::max(max_key.x, key.x);
+		max_key.y = std::max(max_key.y, key.y);
+	}
+	reserve(min_key, max_key);
+
+	// Setting the cells, the height is defined by the z key as in the terrain map
+	for (unsigned int i = 0; i < num_cells; i++) {
+		const TerrainCell& cell = terrain_data.data[i];
+
+		double height;
+		space_discretization.keyToCoord(height, cell.key.z, false);
+		setCell(cell.key, cell.cost, height, cell.normal);
+	}
+}
+
+
+void TerrainGrid::setCell(const Key& key,
+						  Weight cost,
+						  double height,
+						  const Eigen::Vector3d& normal)
+{
+	unsigned int tile_index;
+	if (!getTileIndex(tile_index, key)) {
+		// Growing the directory for including the tile of this key
+		unsigned int tile_x = key.x >> TILE_BITS;
+		unsigned int tile_y = key.y >> TILE_BITS;
+		resizeDirectory(tile_x, tile_y, tile_x, tile_y);
+		getTileIndex(tile_index, key);
+	}
+
+	// Allocating the tile
+	if (directory_[tile_index] < 0) {
+		directory_[tile_index] = tiles_.size();
+		tiles_.push_back(Tile());
+	}
+
+	Tile* tile = &tiles_[directory_[tile_index]];
+	unsigned int cell = getCellIndex(key);
+	tile->cost[cell] = cost;
+	tile->height[cell] = height;
+	tile->normal[cell] = normal;
+
+	uint64_t mask = (uint64_t) 1 << (cell & 63);
+	if (!(tile->valid[cell >> 6] & mask)) {
+		tile->valid[cell >> 6] |= mask;
+		num_cells_++;
+	}
+}
+
+
+void TerrainGrid::removeCell(const Key& key)
+{
+	unsigned int tile_index;
+	if (!getTileIndex(tile_index, key) || directory_[tile_index] < 0)
+		return;
+
+	Tile* tile = &tiles_[directory_[tile_index]];
+	unsigned int cell = getCellIndex(key);
+	uint64_t mask = (uint64_t) 1 << (cell & 63);
+	if (tile->valid[cell >> 6] & mask) {
+		tile->valid[cell >> 6] &= ~mask;
+		num_cells_--;
+	}
+}
+
+
+bool TerrainGrid::find(CellIndex& index,
+					   const Key& key) const
+{
+	unsigned int tile_index;
+	if (!getTileIndex(tile_index, key))
+		return false;
+
+	int tile = directory_[tile_index];
+	if (tile < 0)
+		return false;
+
+	unsigned int cell = getCellIndex(key);
+	if (!(tiles_[tile].valid[cell >> 6] & ((uint64_t) 1 << (cell & 63))))
+		return false;
+
+	index.tile = tile;
+	index.cell = cell;
+	return true;
+}
+
+
+const Weight& TerrainGrid::getCost(const CellIndex& index) const
+{
+	return tiles_[index.tile].cost[index.cell];
+}
+
+
+const double& TerrainGrid::getHeight(const CellIndex& index) const
+{
+	return tiles_[index.tile].height[index.cell];
+}
+
+
+const Eigen::Vector3d& TerrainGrid::getNormal(const CellIndex& index) const
+{
+	return tiles_[index.tile].normal[index.cell];
+}
+
+
+unsigned int TerrainGrid::getNumberOfCells() const
+{
+	return num_cells_;
+}
+
+
+bool TerrainGrid::getTileIndex(unsigned int& tile_index,
+							   const Key& key) const
+{
+	// Note that the unsigned arithmetic wraps the keys before the origin
+	unsigned int tile_x = (key.x >> TILE_BITS) - origin_x_;
+	unsigned int tile_y = (key.y >> TILE_BITS) - origin_y_;
+	if (tile_x >= num_tiles_x_ || tile_y >= num_tiles_y_)
+		return false;
+
+	tile_index = tile_y * num_tiles_x_ + tile_x;
+	return true;
+}
+
+
+unsigned int TerrainGrid::getCellIndex(const Key& key) const
+{
+	return ((key.y & (TILE_SIZE - 1)) << TILE_BITS) | (key.x & (TILE_SIZE - 1));
+}
+
+
+void TerrainGrid::resizeDirectory(unsigned int min_tile_x,
+								  unsigned int min_tile_y,
+								  unsigned int max_tile_x,
+								  unsigned int max_tile_y)
+{
+	// Including the current area of the directory
+	if (num_tiles_x_ != 0) {
+		min_tile_x = std::min(min_tile_x, origin_x_);
+		min_tile_y = std::min(min_tile_y, origin_y_);
+		max_tile_x = std::max(max_tile_x, origin_x_ + num_tiles_x_ - 1);
+		max_tile_y = std::max(max_tile_y, origin_y_ + num_tiles_y_ - 1);
+	}
+
+	unsigned int num_tiles_x = max_tile_x - min_tile_x + 1;
+	unsigned int num_tiles_y = max_tile_y - min_tile_y + 1;
+	if (min_tile_x == origin_x_ && min_tile_y == origin_y_ &&
+			num_tiles_x == num_tiles_x_ && num_tiles_y == num_tiles_y_)
+		return;
+
+	// Moving the allocated tiles to the new directory, the tiles themselves are not copied
+	std::vector<int> directory(num_tiles_x * num_tiles_y, -1);
+	for (unsigned int y = 0; y < num_tiles_y_; y++) {
+		for (unsigned int x = 0; x < num_tiles_x_; x++) {
+			unsigned int new_x = origin_x_ + x - min_tile_x;
+			unsigned int new_y = origin_y_ + y - min_tile_y;
+			directory[new_y * num_tiles_x + new_x] = directory_[y * num_tiles_x_ + x];
+		}
+	}
+
+	directory_.swap(directory);
+	origin_x_ = min_tile_x;
+	origin_y_ = min_tile_y;
+	num_tiles_x_ = num_tiles_x;
+	num_tiles_y_ = num_tiles_y;
+}
+
+} //@namespace environment
+} //@namespace dwl
@@ -0,0 +1,157 @@
+#ifndef DWL__ENVIRONMENT__TERRAIN_GRID__H
+#define DWL__ENVIRONMENT__TERRAIN_GRID__H
+
+#include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/utils/utils.h>
+#include <stdint.h>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+/**
+ * @class TerrainGrid
+ * @brief Dense 2.5D grid of terrain cells, which are addressed directly from their (x,y) keys.
+ * The grid is divided in square tiles that are allocated only where there are cells. Each
+ * tile stores the cost, height and normal of its cells in row-major arrays (structure of
+ * arrays), and a validity bitmask that marks the cells that were set (i.e. the unknown cells
+ * don't have valid data)
+ */
+class TerrainGrid
+{
+	public:
+		/** @brief Number of bits of the tile side, i.e. tiles of 32x32 cells */
+		static const unsigned int TILE_BITS = 5;
+		static const unsigned int TILE_SIZE = 1 << TILE_BITS;
+		static const unsigned int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+		/** @brief Position of a cell in the grid, i.e. allocated tile and cell indexes */
+		struct CellIndex
+		{
+			CellIndex() : tile(0), cell(0) {}
+			unsigned int tile;
+			unsigned int cell;
+		};
+
+		/** @brief Constructor function */
+		TerrainGrid();
+
+		/** @brief Destructor function */
+		~TerrainGrid();
+
+		/** @brief Removes all the cells and tiles of the grid */
+		void reset();
+
+		/**
+		 * @brief Allocates the tile directory for a certain area of keys. Note that the grid
+		 * grows automatically, but reserving the area avoids rebuilding the directory
+		 * @param const Key& Minimum (x,y) key of the area
+		 * @param const Key& Maximum (x,y) key of the area
+		 */
+		void reserve(const Key& min_key,
+					 const Key& max_key);
+
+		/**
+		 * @brief Loads the cells of a terrain data in bulk. The height of each cell is
+		 * computed from its z key
+		 * @param const TerrainData& Terrain data
+		 * @param const SpaceDiscretization& Space discretization of the terrain
+		 */
+		void load(const TerrainData& terrain_data,
+				  const SpaceDiscretization& space_discretization);
+
+		/**
+		 * @brief Sets the values of a cell
+		 * @param const Key& Key of the cell
+		 * @param Weight Cost of the cell
+		 * @param double Height of the cell
+		 * @param const Eigen::Vector3d& Normal of the cell
+		 */
+		void setCell(const Key& key,
+					 Weight cost,
+					 double height,
+					 const Eigen::Vector3d& normal);
+
+		/**
+		 * @brief Marks a cell as unknown
+		 * @param const Key& Key of the cell
+		 */
+		void removeCell(const Key& key);
+
+		/**
+		 * @brief Finds a valid cell in the grid
+		 * @param CellIndex& Index of the cell
+		 * @param const Key& Key of the cell
+		 * @return True if the cell is known
+		 */
+		bool find(CellIndex& index,
+				  const Key& key) const;
+
+		/** @brief Gets the cost, height and normal of a valid cell */
+		const Weight& getCost(const CellIndex& index) const;
+		const double& getHeight(const CellIndex& index) const;
+		const Eigen::Vector3d& getNormal(const CellIndex& index) const;
+
+		/** @brief Gets the number of valid cells */
+		unsigned int getNumberOfCells() const;
+
+
+	private:
+		/** @brief Tile of cells, where the values are stored in row-major order */
+		struct Tile
+		{
+			Tile();
+
+			Weight cost[TILE_CELLS];
+			double height[TILE_CELLS];
+			Eigen::Vector3d normal[TILE_CELLS];
+			uint64_t valid[TILE_CELLS / 64];
+		};
+
+		/**
+		 * @brief Gets the tile index of a key
+		 * @param unsigned int& Tile index
+		 * @param const Key& Key of the cell
+		 * @return False if the key is outside of the tile directory
+		 */
+		bool getTileIndex(unsigned int& tile_index,
+						  const Key& key) const;
+
+		/** @brief Gets the cell index inside its tile */
+		unsigned int getCellIndex(const Key& key) const;
+
+		/**
+		 * @brief Grows the tile directory for including a certain area of tiles
+		 * @param unsigned int Minimum x tile
+		 * @param unsigned int Minimum y tile
+		 * @param unsigned int Maximum x tile
+		 * @param unsigned int Maximum y tile
+		 */
+		void resizeDirectory(unsigned int min_tile_x,
+							 unsigned int min_tile_y,
+							 unsigned int max_tile_x,
+							 unsigned int max_tile_y);
+
+		/** @brief Row-major directory of tiles, i.e. index of the allocated tile or -1 */
+		std::vector<int> directory_;
+
+		/** @brief Allocated tiles */
+		std::vector<Tile> tiles_;
+
+		/** @brief Origin and size of the tile directory (in tiles) */
+		unsigned int origin_x_;
+		unsigned int origin_y_;
+		unsigned int num_tiles_x_;
+		unsigned int num_tiles_y_;
+
+		/** @brief Number of valid cells */
+		unsigned int num_cells_;
+};
+
+} //@namespace environment
+} //@namespace dwl
+
+#endif
@@ -1,4 +1,5 @@
 #include <dwl/environment/TerrainMap.h>
+#include <dwl/environment/TerrainSurface.h>
 
 
 namespace dwl
@@ -10,10 +11,10 @@ namespace environment
 TerrainMap::TerrainMap() :
 		space_discretization_(0.04, 0.04, M_PI / 200),
 		obstacle_discretization_(0.04, 0.04, M_PI / 200),
-		average_cost_(0.), max_cost_(0.),
+		dense_grid_(false), rolling_window_(false), average_cost_(0.), max_cost_(0.),
 		min_height_(std::numeric_limits<double>::max()),
 		terrain_information_(false), obstacle_information_(false),
-		obstacle_resolution_(0.04)
+		obstacle_resolution_(0.04), revision_(0)
 {
 	// Setting up the default values of the cell
 	 // TODO compute the default height from robot state
@@ -32,7 +33,66 @@ TerrainMap::~TerrainMap()
 void TerrainMap::reset()
 {
 	terrain_map_.clear();
+	terrain_grid_.reset();
+	rolling_map_.reset();
 	terrain_heightmap_.clear();
+	revision_++;
+}
+
+
+void TerrainMap::setDenseGrid(bool dense_grid)
+{
+	dense_grid_ = dense_grid;
+	if (dense_grid_)
+		buildDenseGrid();
+	else
+		terrain_grid_.reset();
+}
+
+
+void TerrainMap::setRollingWindow(bool rolling_window,
+								  double window_size)
+{
+	rolling_window_ = rolling_window;
+	if (rolling_window_) {
+		rolling_map_.setResolution(space_discretization_.getEnvironmentResolution(true), true);
+		rolling_map_.setResolution(space_discretization_.getEnvironmentResolution(false), false);
+		rolling_map_.setWindowSize(window_size);
+	}
+
+	// The terrain data could be outside the window
+	reset();
+}
+
+
+void TerrainMap::moveWindow(const Eigen::Vector2d& center)
+{
+	if (!rolling_window_) {
+		printf(YELLOW_ "Warning: it isn't used the rolling window\n" COLOR_RESET);
+		return;
+	}
+
+	rolling_map_.moveWindow(center);
+
+	// Removing the cells that left the window
+	bool removed_cells = false;
+	for (TerrainDataMap::iterator cell_it = terrain_map_.begin();
+			cell_it != terrain_map_.end(); ) {
+		if (rolling_map_.isInsideWindow(cell_it->second.key)) {
+			cell_it++;
+			continue;
+		}
+
+		if (dense_grid_)
+			terrain_grid_.removeCell(cell_it->second.key);
+		terrain_map_.erase(cell_it++);
+		removed_cells = true;
+	}
+
+	if (removed_cells) {
+		average_cost_ = rolling_map_.getAverageCostOfTerrain();
+		revision_++;
+	}
 }
 
 
@@ -41,7 +101,10 @@ void TerrainMap::setTerrainMap(const TerrainData& terrain_map)
 	// Cleaning the old information
 	TerrainDataMap empty_terrain_cost_map;
 	terrain_map_.swap(empty_terrain_cost_map);
+	terrain_grid_.reset();
+	rolling_map_.reset();
 	average_cost_ = 0.;
+	revision_++;
 
 	// Storing the terrain data according the vertex id
 	Vertex vertex_2d;
@@ -52,6 +115,10 @@ void TerrainMap::setTerrainMap(const TerrainData& terrain_map)
 		setResolution(terrain_map.height_size, false);
 
 		for (unsigned int i = 0; i < num_cells; i++) {
+			// The cells outside the rolling window are ignored
+			if (rolling_window_ && !rolling_map_.updateCell(terrain_map.data[i]))
+				continue;
+
 			// Building a cost-map for a every 3d vertex
 			space_discretization_.keyToVertex(vertex_2d, terrain_map.data[i].key, true);
 			double cost_value = terrain_map.data[i].cost;
@@ -65,7 +132,18 @@ void TerrainMap::setTerrainMap(const TerrainData& terrain_map)
 		}
 
 		// Computing the average cost of the terrain
-		average_cost_ /= num_cells;
+		if (rolling_window_)
+			average_cost_ = rolling_map_.getAverageCostOfTerrain();
+		else
+			average_cost_ /= num_cells;
+
+		// Loading the cells in the dense grid
+		if (dense_grid_) {
+			if (rolling_window_)
+				buildDenseGrid();
+			else
+				terrain_grid_.load(terrain_map, space_discretization_);
+		}
 
 		// Setting up the values of the default cell. Note that these values
 		// are used for unperceived cells
@@ -81,6 +159,94 @@ void TerrainMap::setTerrainMap(const TerrainData& terrain_map)
 void TerrainMap::setTerrainMap(const TerrainDataMap& map)
 {
 	terrain_map_ = map;
+	revision_++;
+
+	// Keeping the cells inside the rolling window
+	if (rolling_window_) {
+		rolling_map_.reset();
+		for (TerrainDataMap::iterator cell_it = terrain_map_.begin();
+				cell_it != terrain_map_.end(); ) {
+			if (rolling_map_.updateCell(cell_it->second))
+				cell_it++;
+			else
+				terrain_map_.erase(cell_it++);
+		}
+		average_cost_ = rolling_map_.getAverageCostOfTerrain();
+	}
+
+	if (dense_grid_)
+		buildDenseGrid();
+}
+
+
+void TerrainMap::updateTerrainMap(const std::vector<TerrainCell>& cells)
+{
+	// Getting the total cost of the current cells for updating the average cost
+	double cost_sum = average_cost_ * terrain_map_.size();
+
+	Vertex vertex_2d;
+	unsigned int num_cells = cells.size();
+	for (unsigned int i = 0; i < num_cells; i++) {
+		const TerrainCell& cell = cells[i];
+
+		// The cells outside the rolling window are ignored
+		if (rolling_window_ && !rolling_map_.updateCell(cell))
+			continue;
+
+		space_discretization_.keyToVertex(vertex_2d, cell.key, true);
+		TerrainDataMap::iterator cell_it = terrain_map_.find(vertex_2d);
+		if (cell_it != terrain_map_.end()) {
+			cost_sum -= cell_it->second.cost;
+			cell_it->second = cell;
+		} else
+			terrain_map_[vertex_2d] = cell;
+		cost_sum += cell.cost;
+
+		if (cell.cost > max_cost_)
+			max_cost_ = cell.cost;
+
+		if (dense_grid_) {
+			double height;
+			space_discretization_.keyToCoord(height, cell.key.z, false);
+			terrain_grid_.setCell(cell.key, cell.cost, height, cell.normal);
+		}
+	}
+	revision_++;
+
+	if (!terrain_map_.empty()) {
+		// Updating the average cost of the terrain
+		if (rolling_window_)
+			average_cost_ = rolling_map_.getAverageCostOfTerrain();
+		else
+			average_cost_ = cost_sum / terrain_map_.size();
+
+		// Setting up the cost of the unperceived cells
+		default_cell_.cost = max_cost_;
+
+		terrain_information_ = true;
+	}
+}
+
+
+void TerrainMap::updateTerrainMap(const TerrainSurface& surface)
+{
+	// Checking the resolution of the surface
+	const SpaceDiscretization& surface_space = surface.getTerrainSpaceModel();
+	double plane_resolution = surface_space.getEnvironmentResolution(true);
+	double height_resolution = surface_space.getEnvironmentResolution(false);
+	if (terrain_map_.empty()) {
+		setResolution(plane_resolution, true);
+		setResolution(height_resolution, false);
+	} else if (plane_resolution != getResolution(true) ||
+			height_resolution != getResolution(false)) {
+		printf(YELLOW_ "Warning: the resolution of the terrain surface is different to the "
+				"terrain map\n" COLOR_RESET);
+		return;
+	}
+
+	std::vector<TerrainCell> cells;
+	surface.getUpdatedCells(cells);
+	updateTerrainMap(cells);
 }
 
 
@@ -106,6 +272,9 @@ void TerrainMap::setObstacleMap(const std::vector<Cell>& obstacle_map)
 
 		obstacle_information_ = true;
 	}
+
+	// Updating the distance field with the changed obstacles
+	obstacle_field_.update(obstaclemap_, obstacle_discretization_);
 }
 
 
@@ -123,15 +292,35 @@ void TerrainMap::setTerrainCell(TerrainCell& cell,
 
 void TerrainMap::addCellToTerrainMap(const TerrainCell& cell)
 {
+	// The cells outside the rolling window are ignored
+	if (rolling_window_ && !rolling_map_.updateCell(cell))
+		return;
+
 	Vertex vertex_id;
 	space_discretization_.keyToVertex(vertex_id, cell.key, true);
 	terrain_map_[vertex_id] = cell;
+	revision_++;
+
+	if (dense_grid_) {
+		double height;
+		space_discretization_.keyToCoord(height, cell.key.z, false);
+		terrain_grid_.setCell(cell.key, cell.cost, height, cell.normal);
+	}
 }
 
 
 void TerrainMap::removeCellToTerrainMap(const Vertex& cell_vertex)
 {
 	terrain_map_.erase(cell_vertex);
+	revision_++;
+
+	Key key;
+	space_discretization_.vertexToKey(key, cell_vertex, true);
+	if (dense_grid_)
+		terrain_grid_.removeCell(key);
+
+	if (rolling_window_)
+		rolling_map_.removeCell(key);
 }
 
 
@@ -167,6 +356,12 @@ void TerrainMap::setResolution(double resolution,
 							   bool plane)
 {
 	space_discretization_.setEnvironmentResolution(resolution, plane);
+	revision_++;
+
+	// Note that the rolling window is reset with a new resolution
+	if (rolling_window_ &&
+			rolling_map_.getTerrainSpaceModel().getEnvironmentResolution(plane) != resolution)
+		rolling_map_.setResolution(resolution, plane);
 }
 
 
@@ -205,6 +400,18 @@ const ObstacleMap& TerrainMap::getObstacleMap() const
 }
 
 
+const ObstacleDistanceField& TerrainMap::getObstacleDistanceField() const
+{
+	return obstacle_field_;
+}
+
+
+const TerrainGrid& TerrainMap::getTerrainGrid() const
+{
+	return terrain_grid_;
+}
+
+
 const TerrainCell& TerrainMap::getTerrainData(const Vertex& vertex) const
 {
 	TerrainDataMap::const_iterator cell_it = terrain_map_.find(vertex);
@@ -228,6 +435,29 @@ const TerrainCell& TerrainMap::getTerrainData(const Eigen::Vector2d& position) c
 bool TerrainMap::getTerrainData(TerrainCell& cell,
 								const Vertex& vertex) const
 {
+	if (rolling_window_) {
+		if (rolling_map_.getTerrainData(cell, vertex))
+			return true;
+
+		cell = default_cell_;
+		return false;
+	}
+
+	if (dense_grid_) {
+		TerrainGrid::CellIndex index;
+		if (findGridCell(index, vertex)) {
+			space_discretization_.vertexToKey(cell.key, vertex, true);
+			cell.cost = terrain_grid_.getCost(index);
+			cell.height = terrain_grid_.getHeight(index);
+			cell.normal = terrain_grid_.getNormal(index);
+			space_discretization_.coordToKey(cell.key.z, cell.height, false);
+			return true;
+		} else {
+			cell = default_cell_;
+			return false;
+		}
+	}
+
 	TerrainDataMap::const_iterator cell_it = terrain_map_.find(vertex);
 	if (cell_it != terrain_map_.end()) {
 		cell = cell_it->second;
@@ -254,6 +484,10 @@ bool TerrainMap::getTerrainData(TerrainCell& cell,
 
 double TerrainMap::getTerrainHeight(const Vertex& vertex) const
 {
+	TerrainGrid::CellIndex index;
+	if (dense_grid_ && findGridCell(index, vertex))
+		return terrain_grid_.getHeight(index);
+
 	double height;
 	Key key = getTerrainData(vertex).key;
 	space_discretization_.keyToCoord(height, key.z, false);
@@ -297,6 +531,14 @@ bool TerrainMap::getTerrainHeight(double& height,
 
 const Weight& TerrainMap::getTerrainCost(const Vertex& vertex) const
 {
+	if (dense_grid_) {
+		TerrainGrid::CellIndex index;
+		if (findGridCell(index, vertex))
+			return terrain_grid_.getCost(index);
+		else
+			return default_cell_.cost;
+	}
+
 	return getTerrainData(vertex).cost;
 }
 
@@ -314,6 +556,25 @@ const Weight& TerrainMap::getTerrainCost(const Eigen::Vector2d& position) const
 bool TerrainMap::getTerrainCost(Weight& cost,
 								const Vertex& vertex) const
 {
+	if (rolling_window_) {
+		if (rolling_map_.getTerrainCost(cost, vertex))
+			return true;
+
+		cost = default_cell_.cost;
+		return false;
+	}
+
+	if (dense_grid_) {
+		TerrainGrid::CellIndex index;
+		if (findGridCell(index, vertex)) {
+			cost = terrain_grid_.getCost(index);
+			return true;
+		} else {
+			cost = default_cell_.cost;
+			return false;
+		}
+	}
+
 	TerrainCell cell;
 	bool data = getTerrainData(cell, vertex);
 	cost = cell.cost;
@@ -335,6 +596,14 @@ bool TerrainMap::getTerrainCost(Weight& cost,
 
 const Eigen::Vector3d& TerrainMap::getTerrainNormal(const Vertex& vertex) const
 {
+	if (dense_grid_) {
+		TerrainGrid::CellIndex index;
+		if (findGridCell(index, vertex))
+			return terrain_grid_.getNormal(index);
+		else
+			return default_cell_.normal;
+	}
+
 	return getTerrainData(vertex).normal;
 }
 
@@ -352,6 +621,25 @@ const Eigen::Vector3d& TerrainMap::getTerrainNormal(const Eigen::Vector2d& posit
 bool TerrainMap::getTerrainNormal(Eigen::Vector3d& normal,
 								  const Vertex& vertex) const
 {
+	if (rolling_window_) {
+		if (rolling_map_.getTerrainNormal(normal, vertex))
+			return true;
+
+		normal = default_cell_.normal;
+		return false;
+	}
+
+	if (dense_grid_) {
+		TerrainGrid::CellIndex index;
+		if (findGridCell(index, vertex)) {
+			normal = terrain_grid_.getNormal(index);
+			return true;
+		} else {
+			normal = default_cell_.normal;
+			return false;
+		}
+	}
+
 	TerrainCell cell;
 	bool data = getTerrainData(cell, vertex);
 	normal = cell.normal;
@@ -400,5 +688,35 @@ bool TerrainMap::isObstacleInformation()
 	return obstacle_information_;
 }
 
+
+unsigned int TerrainMap::getRevision() const
+{
+	return revision_;
+}
+
+
+void TerrainMap::buildDenseGrid()
+{
+	terrain_grid_.reset();
+	for (TerrainDataMap::const_iterator cell_it = terrain_map_.begin();
+			cell_it != terrain_map_.end(); cell_it++) {
+		const TerrainCell& cell = cell_it->second;
+
+		double height;
+		space_discretization_.keyToCoord(height, cell.key.z, false);
+		terrain_grid_.setCell(cell.key, cell.cost, height, cell.normal);
+	}
+}
+
+
+bool TerrainMap::findGridCell(TerrainGrid::CellIndex& index,
+							  const Vertex& vertex) const
+{
+	Key key;
+	space_discretization_.vertexToKey(key, vertex, true);
+
+	return terrain_grid_.find(index, key);
+}
+
 } //@namespace environment
 } //@namespace dwl
@@ -2,6 +2,9 @@
 #define DWL__ENVIRONMENT__TERRAIN_MAP__H
 
 #include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/environment/TerrainGrid.h>
+#include <dwl/environment/RollingTerrainMap.h>
+#include <dwl/environment/ObstacleDistanceField.h>
 #include <dwl/utils/utils.h>
 
 
@@ -11,6 +14,8 @@ namespace dwl
 namespace environment
 {
 
+class TerrainSurface;
+
 /**
  * @class TerrainMap
  * @brief Class for defining the terrain information
@@ -27,10 +32,52 @@ class TerrainMap
 		/** @brief Reset the terrain map */
 		void reset();
 
+		/**
+		 * @brief Uses a dense grid for the terrain queries. The cost, height and normal
+		 * of the cells are looked up in constant time from a tiled grid instead of the
+		 * terrain data map, which is still kept for iterating over the cells. The grid is
+		 * built from the current terrain data
+		 * @param bool Indicates if the dense grid is used
+		 */
+		void setDenseGrid(bool dense_grid);
+
+		/**
+		 * @brief Uses a robot-centric rolling window for the terrain data. Only the cells inside
+		 * the window are kept, and the cost, height and normal queries are answered by the
+		 * circular buffer of the window. Note that it resets the terrain data
+		 * @param bool Indicates if the rolling window is used
+		 * @param double Side length of the window
+		 */
+		void setRollingWindow(bool rolling_window,
+							  double window_size = 10.24);
+
+		/**
+		 * @brief Moves the rolling window for centering it in a certain position (e.g. the
+		 * robot position). The cells that leave the window are removed from the terrain data
+		 * @param const Eigen::Vector2d& Center of the window
+		 */
+		void moveWindow(const Eigen::Vector2d& center);
+
 		/** @brief Sets the terrain data map */
 		void setTerrainMap(const TerrainData& terrain_map);
 		void setTerrainMap(const TerrainDataMap& map);
 
+		/**
+		 * @brief Updates a batch of cells of the terrain map (e.g. the cells of a mapping
+		 * update), where the rest of the cells are kept. With a rolling window, the cells
+		 * outside the window are ignored
+		 * @param const std::vector<TerrainCell>& Updated cells
+		 */
+		void updateTerrainMap(const std::vector<TerrainCell>& cells);
+
+		/**
+		 * @brief Updates the terrain map with the cells of the tiles computed in the last
+		 * computation of a terrain surface. Note that the surface has to have the resolution
+		 * of the terrain map, which is adopted from it when the map is empty
+		 * @param const TerrainSurface& Terrain surface
+		 */
+		void updateTerrainMap(const TerrainSurface& surface);
+
 		/**
 		 * @brief Sets the obstacle map
 		 * @param const std::vector<Cell>& Obstacle map
@@ -118,6 +165,12 @@ class TerrainMap
 		/** @brief Gets the obstacle-map (using vertex id) */
 		const ObstacleMap& getObstacleMap() const;
 
+		/** @brief Gets the distance field of the obstacle-map, which is updated with it */
+		const ObstacleDistanceField& getObstacleDistanceField() const;
+
+		/** @brief Gets the dense grid of the terrain */
+		const TerrainGrid& getTerrainGrid() const;
+
 		/**
 		 * @brief Gets the terrain data value give a vertex or 2d position
 		 * @return The cell data
@@ -194,8 +247,27 @@ class TerrainMap
 		 */
 		bool isObstacleInformation();
 
+		/**
+		 * @brief Gets the revision of the terrain data, which increases in every update of it.
+		 * It allows us to know if a terrain layer (e.g. a cost field) is up to date
+		 * @return The revision of the terrain data
+		 */
+		unsigned int getRevision() const;
+
 
 	protected:
+		/** @brief Builds the dense grid from the terrain data map */
+		void buildDenseGrid();
+
+		/**
+		 * @brief Finds the cell of a vertex in the dense grid
+		 * @param TerrainGrid::CellIndex& Index of the cell in the grid
+		 * @param const Vertex& Terrain vertex
+		 * @return True if the cell is known
+		 */
+		bool findGridCell(TerrainGrid::CellIndex& index,
+						  const Vertex& vertex) const;
+
 		/** @brief Object of the SpaceDiscretization class for defining the
 		 *  grid routines */
 		SpaceDiscretization space_discretization_;
@@ -208,12 +280,27 @@ class TerrainMap
 		/** @brief Terrain values mapped using vertex id */
 		TerrainDataMap terrain_map_;
 
+		/** @brief Dense grid of the terrain values, which is used for the queries */
+		TerrainGrid terrain_grid_;
+
+		/** @brief Indicates if it's used the dense grid */
+		bool dense_grid_;
+
+		/** @brief Robot-centric rolling window of the terrain values */
+		RollingTerrainMap rolling_map_;
+
+		/** @brief Indicates if it's used the rolling window */
+		bool rolling_window_;
+
 		/** @brief Terrain height map */
 		HeightMap terrain_heightmap_;
 
 		/** @brief Gathers the obstacles that are mapped using the vertex id */
 		ObstacleMap obstaclemap_;
 
+		/** @brief Distance field of the obstacles */
+		ObstacleDistanceField obstacle_field_;
+
 		/** @brief Default values of the cell, e.g. for unperceived cells */
 		TerrainCell default_cell_;
 
@@ -234,6 +321,9 @@ class TerrainMap
 
 		/** @brief Obstacle resolution of the environment */
 		double obstacle_resolution_;
+
+		/** @brief Revision of the terrain data */
+		unsigned int revision_;
 };
 
 } //@namespace environment
@@ -0,0 +1,379 @@
+#include <dwl/environment/TerrainSurface.h>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+TerrainSurface::Tile::Tile(unsigned short int _tile_x,
+						   unsigned short int _tile_y) : tile_x(_tile_x), tile_y(_tile_y),
+								   dirty(false)
+{
+	for (unsigned int i = 0; i < TILE_CELLS / 64; i++)
+		occupied[i] = 0;
+}
+
+
+TerrainSurface::TerrainSurface(double resolution) : space_discretization_(resolution),
+		radius_(2), num_threads_(1), stamp_(0), num_cells_(0)
+{
+
+}
+
+
+TerrainSurface::~TerrainSurface()
+{
+
+}
+
+
+void TerrainSurface::reset()
+{
+	directory_.clear();
+	tiles_.clear();
+	updated_tiles_.clear();
+	num_cells_ = 0;
+}
+
+
+void TerrainSurface::setResolution(double resolution,
+								   bool plane)
+{
+	space_discretization_.setEnvironmentResolution(resolution, plane);
+	reset();
+}
+
+
+void TerrainSurface::setNeighboringRadius(unsigned int radius)
+{
+	if (radius > TILE_SIZE)
+		radius_ = TILE_SIZE;
+	else
+		radius_ = radius;
+
+	// Recomputing all the tiles with the new neighboring area
+	for (unsigned int t = 0; t < tiles_.size(); t++)
+		tiles_[t].dirty = true;
+}
+
+
+void TerrainSurface::setNumberOfThreads(unsigned int num_threads)
+{
+	if (num_threads == 0)
+		num_threads_ = 1;
+	else
+		num_threads_ = num_threads;
+}
+
+
+void TerrainSurface::addFeature(Feature* feature)
+{
+	double weight;
+	feature->getWeight(weight);
+	printf(GREEN_ "Adding the %s feature with a weight of %f\n" COLOR_RESET,
+			feature->getName().c_str(), weight);
+	features_.push_back(feature);
+
+	// Recomputing the costs of all the tiles
+	for (unsigned int t = 0; t < tiles_.size(); t++)
+		tiles_[t].dirty = true;
+}
+
+
+void TerrainSurface::addPointCloud(const std::vector<Eigen::Vector3f>& points)
+{
+	// Starting a new update
+	stamp_++;
+
+	unsigned int num_points = points.size();
+	for (unsigned int i = 0; i < num_points; i++)
+		addPoint(points[i].cast<double>());
+}
+
+
+unsigned int TerrainSurface::compute()
+{
+	// Getting the dirty tiles
+	updated_tiles_.clear();
+	for (unsigned int t = 0; t < tiles_.size(); t++) {
+		if (tiles_[t].dirty) {
+			updated_tiles_.push_back(t);
+			tiles_[t].dirty = false;
+		}
+	}
+
+	// Computing the dirty tiles concurrently. Note that the heights aren't modified here, so
+	// the neighboring tiles can be read by every thread
+	int num_tiles = updated_tiles_.size();
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+	for (int t = 0; t < num_tiles; t++)
+		computeTile(updated_tiles_[t]);
+
+	return num_tiles;
+}
+
+
+void TerrainSurface::getUpdatedCells(std::vector<TerrainCell>& cells) const
+{
+	cells.clear();
+	for (unsigned int t = 0; t < updated_tiles_.size(); t++) {
+		const Tile& tile = tiles_[updated_tiles_[t]];
+		for (unsigned int i = 0; i < TILE_CELLS; i++) {
+			if (!isOccupied(tile, i))
+				continue;
+
+			TerrainCell cell;
+			getTerrainCell(cell, tile, i);
+			cells.push_back(cell);
+		}
+	}
+}
+
+
+void TerrainSurface::getTerrainData(TerrainData& terrain_data) const
+{
+	terrain_data.plane_size = space_discretization_.getEnvironmentResolution(true);
+	terrain_data.height_size = space_discretization_.getEnvironmentResolution(false);
+	terrain_data.data.clear();
+	terrain_data.data.reserve(num_cells_);
+	for (unsigned int t = 0; t < tiles_.size(); t++) {
+		const Tile& tile = tiles_[t];
+		for (unsigned int i = 0; i < TILE_CELLS; i++) {
+			if (!isOccupied(tile, i))
+				continue;
+
+			TerrainCell cell;
+			getTerrainCell(cell, tile, i);
+			terrain_data.data.push_back(cell);
+		}
+	}
+}
+
+
+unsigned int TerrainSurface::getNumberOfCells() const
+{
+	return num_cells_;
+}
+
+
+const SpaceDiscretization& TerrainSurface::getTerrainSpaceModel() const
+{
+	return space_discretization_;
+}
+
+
+void TerrainSurface::addPoint(const Eigen::Vector3d& point)
+{
+	// Getting the key of the cell
+	Key key;
+	if (!space_discretization_.coordToKeyChecked(key.x, point(0), true) ||
+			!space_discretization_.coordToKeyChecked(key.y, point(1), true))
+		return;
+
+	// Getting the tile of the cell, and allocating it if it doesn't exist
+	int tile_x = key.x >> TILE_BITS;
+	int tile_y = key.y >> TILE_BITS;
+	int tile_index;
+	if (!findTile(tile_index, tile_x, tile_y)) {
+		tile_index = tiles_.size();
+		directory_[(tile_y << 16) | tile_x] = tile_index;
+		tiles_.push_back(Tile(tile_x, tile_y));
+	}
+
+	// The first point of the update replaces the height of the cell, and the rest keep the
+	// highest one
+	Tile& tile = tiles_[tile_index];
+	int cell_x = key.x & (TILE_SIZE - 1);
+	int cell_y = key.y & (TILE_SIZE - 1);
+	unsigned int index = (cell_y << TILE_BITS) | cell_x;
+	if (!isOccupied(tile, index)) {
+		tile.occupied[index >> 6] |= (uint64_t) 1 << (index & 63);
+		num_cells_++;
+	} else if (tile.stamp[index] == stamp_ && tile.height[index] >= point(2))
+		return;
+
+	tile.height[index] = point(2);
+	tile.stamp[index] = stamp_;
+	tile.dirty = true;
+
+	// Marking the neighboring tiles whose planes use this cell
+	int radius = radius_;
+	int min_tile_x = (cell_x - radius < 0) ? tile_x - 1 : tile_x;
+	int max_tile_x = (cell_x + radius >= (int) TILE_SIZE) ? tile_x + 1 : tile_x;
+	int min_tile_y = (cell_y - radius < 0) ? tile_y - 1 : tile_y;
+	int max_tile_y = (cell_y + radius >= (int) TILE_SIZE) ? tile_y + 1 : tile_y;
+	for (int y = min_tile_y; y <= max_tile_y; y++) {
+		for (int x = min_tile_x; x <= max_tile_x; x++) {
+			int neighbor_index;
+			if (findTile(neighbor_index, x, y))
+				tiles_[neighbor_index].dirty = true;
+		}
+	}
+}
+
+
+bool TerrainSurface::findTile(int& tile_index,
+							  int tile_x,
+							  int tile_y) const
+{
+	if (tile_x < 0 || tile_y < 0)
+		return false;
+
+	std::map<unsigned int, unsigned int>::const_iterator tile_it =
+			directory_.find((tile_y << 16) | tile_x);
+	if (tile_it == directory_.end())
+		return false;
+
+	tile_index = tile_it->second;
+	return true;
+}
+
+
+void TerrainSurface::computeTile(unsigned int tile_index)
+{
+	Tile& tile = tiles_[tile_index];
+	double resolution = space_discretization_.getEnvironmentResolution(true);
+
+	// Getting the neighboring tiles, where the center one is the current tile
+	int neighbor_tiles[9];
+	for (int y = -1; y <= 1; y++) {
+		for (int x = -1; x <= 1; x++) {
+			int& neighbor_index = neighbor_tiles[(y + 1) * 3 + (x + 1)];
+			if (!findTile(neighbor_index, tile.tile_x + x, tile.tile_y + y))
+				neighbor_index = -1;
+		}
+	}
+
+	// Copying the heights of the tile and its neighboring margin in a flat buffer, where the
+	// unknown cells are NaN. It avoids the tile lookups per neighboring cell
+	int radius = radius_;
+	int patch_size = TILE_SIZE + 2 * radius;
+	std::vector<double> patch(patch_size * patch_size,
+							  std::numeric_limits<double>::quiet_NaN());
+	for (int py = 0; py < patch_size; py++) {
+		int y = py - radius;
+		int tile_y = (y < 0) ? 0 : (y >= (int) TILE_SIZE) ? 2 : 1;
+		for (int px = 0; px < patch_size; px++) {
+			int x = px - radius;
+			int tile_x = (x < 0) ? 0 : (x >= (int) TILE_SIZE) ? 2 : 1;
+			int neighbor_index = neighbor_tiles[tile_y * 3 + tile_x];
+			if (neighbor_index < 0)
+				continue;
+
+			const Tile& neighbor_tile = tiles_[neighbor_index];
+			unsigned int neighbor_cell = ((y & (TILE_SIZE - 1)) << TILE_BITS) |
+					(x & (TILE_SIZE - 1));
+			if (isOccupied(neighbor_tile, neighbor_cell))
+				patch[py * patch_size + px] = neighbor_tile.height[neighbor_cell];
+		}
+	}
+
+	// Building the height map of the features once per tile, which is shared by its cells
+	std::shared_ptr<std::map<Vertex, double> > height_map;
+	if (!features_.empty()) {
+		height_map.reset(new std::map<Vertex, double>());
+		for (int py = 0; py < patch_size; py++) {
+			for (int px = 0; px < patch_size; px++) {
+				double patch_height = patch[py * patch_size + px];
+				if (std::isnan(patch_height))
+					continue;
+
+				Key key;
+				key.x = (tile.tile_x << TILE_BITS) + px - radius;
+				key.y = (tile.tile_y << TILE_BITS) + py - radius;
+				Vertex vertex;
+				space_discretization_.keyToVertex(vertex, key, true);
+				(*height_map)[vertex] = patch_height;
+			}
+		}
+	}
+
+	std::vector<Eigen::Vector3f> points;
+	points.reserve((2 * radius + 1) * (2 * radius + 1));
+	for (unsigned int index = 0; index < TILE_CELLS; index++) {
+		if (!isOccupied(tile, index))
+			continue;
+
+		int cell_x = index & (TILE_SIZE - 1);
+		int cell_y = index >> TILE_BITS;
+		double height = tile.height[index];
+
+		// Getting the neighboring cells, which are described relative to the current cell
+		// for a better conditioning of the covariance matrix
+		double min_height = height;
+		points.clear();
+		for (int dy = -radius; dy <= radius; dy++) {
+			const double* patch_row = &patch[(cell_y + dy + radius) * patch_size + radius];
+			for (int dx = -radius; dx <= radius; dx++) {
+				double neighbor_height = patch_row[cell_x + dx];
+				if (std::isnan(neighbor_height))
+					continue;
+
+				points.push_back(Eigen::Vector3f(dx * resolution, dy * resolution,
+												 neighbor_height - height));
+				min_height = std::min(min_height, neighbor_height);
+			}
+		}
+
+		// Fitting a plane to the neighboring cells, where the normal is the eigenvector of the
+		// smallest eigenvalue of the covariance matrix
+		Eigen::Vector3d normal = Eigen::Vector3d::UnitZ();
+		double curvature = 0.;
+		if (points.size() >= 3) {
+			Eigen::Vector3d mean;
+			Eigen::Matrix3d covariance;
+			math::computeMeanAndCovarianceMatrix(mean, covariance, points);
+			math::solvePlaneParameters(normal, curvature, covariance);
+		}
+		tile.normal[index] = normal;
+
+		// Computing the cost of the terrain features
+		Weight cost = 0.;
+		if (!features_.empty()) {
+			Terrain terrain_info;
+			unsigned short int key_x = (tile.tile_x << TILE_BITS) | cell_x;
+			unsigned short int key_y = (tile.tile_y << TILE_BITS) | cell_y;
+			space_discretization_.keyToCoord(terrain_info.position(0), key_x, true);
+			space_discretization_.keyToCoord(terrain_info.position(1), key_y, true);
+			terrain_info.position(2) = height;
+			terrain_info.surface_normal = normal;
+			terrain_info.curvature = curvature;
+			terrain_info.height_map = height_map;
+			terrain_info.min_height = min_height;
+			terrain_info.resolution = resolution;
+
+			for (unsigned int i = 0; i < features_.size(); i++) {
+				double feature_cost, weight;
+				features_[i]->computeCost(feature_cost, terrain_info);
+				features_[i]->getWeight(weight);
+				cost += weight * feature_cost;
+			}
+		}
+		tile.cost[index] = cost;
+	}
+}
+
+
+void TerrainSurface::getTerrainCell(TerrainCell& cell,
+									const Tile& tile,
+									unsigned int index) const
+{
+	cell.key.x = (tile.tile_x << TILE_BITS) | (index & (TILE_SIZE - 1));
+	cell.key.y = (tile.tile_y << TILE_BITS) | (index >> TILE_BITS);
+	space_discretization_.coordToKey(cell.key.z, tile.height[index], false);
+	cell.cost = tile.cost[index];
+	cell.height = tile.height[index];
+	cell.normal = tile.normal[index];
+}
+
+
+bool TerrainSurface::isOccupied(const Tile& tile,
+								unsigned int index) const
+{
+	return tile.occupied[index >> 6] & ((uint64_t) 1 << (index & 63));
+}
+
+} //@namespace environment
+} //@namespace dwl
@@ -0,0 +1,205 @@
+#ifndef DWL__ENVIRONMENT__TERRAIN_SURFACE__H
+#define DWL__ENVIRONMENT__TERRAIN_SURFACE__H
+
+#include <dwl/environment/SpaceDiscretization.h>
+#include <dwl/environment/Feature.h>
+#include <dwl/utils/utils.h>
+#include <stdint.h>
+#include <limits>
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+/**
+ * @class TerrainSurface
+ * @brief Bulk builder of the terrain cells from point clouds or octrees. The points are
+ * voxelized in a dense grid of square tiles, where every cell keeps the height of the top
+ * surface. Then the normal and curvature of each cell are computed by fitting a plane to its
+ * neighboring cells, and its cost from the terrain features. The updates mark their tiles as
+ * dirty, so only those tiles are recomputed, and they are processed concurrently
+ */
+class TerrainSurface
+{
+	public:
+		/** @brief Number of bits of the tile side, i.e. tiles of 16x16 cells */
+		static const unsigned int TILE_BITS = 4;
+		static const unsigned int TILE_SIZE = 1 << TILE_BITS;
+		static const unsigned int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+		/**
+		 * @brief Constructor function
+		 * @param double Resolution of the cells
+		 */
+		TerrainSurface(double resolution = 0.04);
+
+		/** @brief Destructor function */
+		~TerrainSurface();
+
+		/** @brief Removes all the cells of the surface */
+		void reset();
+
+		/**
+		 * @brief Sets the resolution of the environment discretization. Note that it resets
+		 * the surface
+		 * @param double Resolution of the environment
+		 * @param bool Indicates if the key represents a plane or a height
+		 */
+		void setResolution(double resolution,
+						   bool plane);
+
+		/**
+		 * @brief Sets the radius of the neighboring area used for fitting the planes. Note
+		 * that it's limited by the tile size
+		 * @param unsigned int Radius in cells
+		 */
+		void setNeighboringRadius(unsigned int radius);
+
+		/**
+		 * @brief Sets the number of threads used for computing the dirty tiles
+		 * @param unsigned int Number of threads
+		 */
+		void setNumberOfThreads(unsigned int num_threads);
+
+		/**
+		 * @brief Adds a feature for computing the terrain cost. Note that the features are
+		 * shared by the threads, so their cost computation has to be read-only
+		 * @param Feature* Terrain feature
+		 */
+		void addFeature(Feature* feature);
+
+		/**
+		 * @brief Adds a point cloud to the surface. The heights of the observed cells are
+		 * replaced by the highest point of the cloud inside them
+		 * @param const std::vector<Eigen::Vector3f>& Point cloud
+		 */
+		void addPointCloud(const std::vector<Eigen::Vector3f>& points);
+
+		/**
+		 * @brief Adds the occupied leafs of an octree (e.g. octomap::OcTree) to the surface.
+		 * The top face of every leaf is sampled with the resolution of the surface
+		 * @param const OcTree& Octree
+		 */
+		template<typename OcTree>
+		void addOcTree(const OcTree& octree);
+
+		/**
+		 * @brief Computes the normal, curvature and cost of the cells of the dirty tiles
+		 * @return The number of computed tiles
+		 */
+		unsigned int compute();
+
+		/**
+		 * @brief Gets the cells of the tiles computed in the last computation, which could be
+		 * added to a terrain map (e.g. RollingTerrainMap::updateCells)
+		 * @param std::vector<TerrainCell>& Updated cells
+		 */
+		void getUpdatedCells(std::vector<TerrainCell>& cells) const;
+
+		/**
+		 * @brief Gets all the cells of the surface
+		 * @param TerrainData& Terrain data
+		 */
+		void getTerrainData(TerrainData& terrain_data) const;
+
+		/** @brief Gets the number of cells of the surface */
+		unsigned int getNumberOfCells() const;
+
+		/** @brief Gets the discrete model of the space */
+		const SpaceDiscretization& getTerrainSpaceModel() const;
+
+
+	private:
+		/** @brief Tile of cells, where the values are stored in row-major order */
+		struct Tile
+		{
+			Tile(unsigned short int _tile_x,
+				 unsigned short int _tile_y);
+
+			unsigned short int tile_x;
+			unsigned short int tile_y;
+			double height[TILE_CELLS];
+			unsigned int stamp[TILE_CELLS];
+			Weight cost[TILE_CELLS];
+			Eigen::Vector3d normal[TILE_CELLS];
+			uint64_t occupied[TILE_CELLS / 64];
+			bool dirty;
+		};
+
+		/**
+		 * @brief Sets the height of a cell from a point of the current update
+		 * @param const Eigen::Vector3d& Point
+		 */
+		void addPoint(const Eigen::Vector3d& point);
+
+		/**
+		 * @brief Gets the index of a tile
+		 * @param int& Index of the tile
+		 * @param int Tile along the x-axis
+		 * @param int Tile along the y-axis
+		 * @return False if the tile wasn't allocated
+		 */
+		bool findTile(int& tile_index,
+					  int tile_x,
+					  int tile_y) const;
+
+		/**
+		 * @brief Computes the normal, curvature and cost of the cells of a tile. The heights
+		 * of the tile and its neighboring margin are copied once in a flat buffer, which is
+		 * used by the plane fitting of every cell. The height map of the features is also
+		 * built once per tile and shared by its cells
+		 * @param unsigned int Index of the tile
+		 */
+		void computeTile(unsigned int tile_index);
+
+		/**
+		 * @brief Gets the terrain cell of a tile
+		 * @param TerrainCell& Terrain cell
+		 * @param const Tile& Tile
+		 * @param unsigned int Cell index inside the tile
+		 */
+		void getTerrainCell(TerrainCell& cell,
+							const Tile& tile,
+							unsigned int index) const;
+
+		/** @brief Indicates if a cell of a tile is occupied */
+		bool isOccupied(const Tile& tile,
+						unsigned int index) const;
+
+		/** @brief Object of the SpaceDiscretization class for defining the grid routines */
+		SpaceDiscretization space_discretization_;
+
+		/** @brief Directory of the allocated tiles, i.e. tile id and index */
+		std::map<unsigned int, unsigned int> directory_;
+
+		/** @brief Allocated tiles */
+		std::vector<Tile> tiles_;
+
+		/** @brief Tiles computed in the last computation */
+		std::vector<unsigned int> updated_tiles_;
+
+		/** @brief Features of the terrain cost */
+		std::vector<Feature*> features_;
+
+		/** @brief Radius of the neighboring area (in cells) */
+		unsigned int radius_;
+
+		/** @brief Number of threads for computing the tiles */
+		unsigned int num_threads_;
+
+		/** @brief Stamp of the current update */
+		unsigned int stamp_;
+
+		/** @brief Number of occupied cells */
+		unsigned int num_cells_;
+};
+
+} //@namespace environment
+} //@namespace dwl
+
+#include <dwl/environment/impl/TerrainSurface.hpp>
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef DWL__ENVIRONMENT__TERRAIN_SURFACE__IMPL_H
+#define DWL__ENVIRONMENT__TERRAIN_SURFACE__IMPL_H
+
+
+namespace dwl
+{
+
+namespace environment
+{
+
+template<typename OcTree>
+void TerrainSurface::addOcTree(const OcTree& octree)
+{
+	// Starting a new update
+	stamp_++;
+
+	// Sampling the top face of the occupied leafs
+	double resolution = space_discretization_.getEnvironmentResolution(true);
+	for (typename OcTree::leaf_iterator leaf_it = octree.begin_leafs(),
+			end = octree.end_leafs(); leaf_it != end; ++leaf_it) {
+		if (!octree.isNodeOccupied(*leaf_it))
+			continue;
+
+		double half_size = 0.5 * leaf_it.getSize();
+		Eigen::Vector3d point;
+		point(2) = leaf_it.getZ() + half_size;
+		if (half_size <= 0.5 * resolution) {
+			point(0) = leaf_it.getX();
+			point(1) = leaf_it.getY();
+			addPoint(point);
+		} else {
+			for (double y = leaf_it.getY() - half_size + 0.5 * resolution;
+					y < leaf_it.getY() + half_size; y += resolution) {
+				for (double x = leaf_it.getX() - half_size + 0.5 * resolution;
+						x < leaf_it.getX() + half_size; x += resolution) {
+					point(0) = x;
+					point(1) = y;
+					addPoint(point);
+				}
+			}
+		}
+	}
+}
+
+} //@namespace environment
+} //@namespace dwl
+
+#endif
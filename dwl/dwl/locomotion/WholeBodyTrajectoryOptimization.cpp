@@ -102,6 +102,22 @@ bool WholeBodyTrajectoryOptimization::compute(const WholeBodyState& current_stat
 }
 
 
+bool WholeBodyTrajectoryOptimization::computeRecedingHorizon(const WholeBodyState& current_state,
+															 const WholeBodyState& desired_state,
+															 double elapsed_time,
+															 double computation_time)
+{
+	// Shifting the last solution for warm-starting the primal and dual variables. Note that the
+	// first computation starts from the nominal trajectory
+	const Eigen::VectorXd& last_solution = solver_->getSolution();
+	if (last_solution.size() != 0)
+		oc_model_.shiftStartingPoint(last_solution, elapsed_time);
+	solver_->setWarmStart(last_solution.size() != 0);
+
+	return compute(current_state, desired_state, computation_time);
+}
+
+
 ocp::DynamicalSystem* WholeBodyTrajectoryOptimization::getDynamicalSystem()
 {
 	return oc_model_.getDynamicalSystem();
@@ -122,19 +138,25 @@ const WholeBodyTrajectory& WholeBodyTrajectoryOptimization::getInterpolatedWhole
 	// Getting the whole-body trajectory
 	WholeBodyTrajectory trajectory = getWholeBodyTrajectory();
 
-	// Getting the number of joints and end-effectors
+	// Getting the number of joints
 	unsigned int num_joints = getDynamicalSystem()->getFloatingBaseSystem().getJointDoF();
-	unsigned int num_contacts = getDynamicalSystem()->getFloatingBaseSystem().getNumberOfEndEffectors();
 
-	// Defining splines //TODO for the time being only cubic interpolation is OK
-	std::vector<math::CubicSpline> base_spline, joint_spline, control_spline;
-	std::vector<std::vector<math::CubicSpline> > contact_force_spline;
-	base_spline.resize(6);
-	joint_spline.resize(num_joints);
-	control_spline.resize(num_joints);
-	contact_force_spline.resize(num_contacts);
+	// Defining the motion (base and joints) and control splines, where every spline evaluates
+	// all its channels at once //TODO for the time being only cubic interpolation is OK
+	math::MultiDimensionalSpline motion_spline(math::ThirdOrder);
+	math::MultiDimensionalSpline control_spline(math::ThirdOrder);
+	Eigen::VectorXd motion_start_pos(6 + num_joints), motion_start_vel(6 + num_joints);
+	Eigen::VectorXd motion_start_acc(6 + num_joints), motion_end_pos(6 + num_joints);
+	Eigen::VectorXd motion_end_vel(6 + num_joints), motion_end_acc(6 + num_joints);
+
+	// Sample buffers, which are reused by the knots with the same number of samples
+	std::vector<double> times;
+	Eigen::MatrixXd motion_pos, motion_vel, motion_acc;
+	Eigen::MatrixXd control_pos, control_vel, control_acc;
 
 	// Computing the interpolation of the whole-body trajectory
+	rbd::BodySelector end_effector_names =
+			getDynamicalSystem()->getFloatingBaseSystem().getEndEffectorNames();
 	unsigned int horizon = oc_model_.getHorizon();
 	for (unsigned int k = 0; k < horizon; k++) {
 		// Adding the starting state
@@ -144,67 +166,41 @@ const WholeBodyTrajectory& WholeBodyTrajectoryOptimization::getInterpolatedWhole
 		double starting_time = trajectory[k].time;
 		double duration = trajectory[k+1].duration;
 
+		// Initialization of the motion and control splines
+		motion_start_pos << trajectory[k].base_pos, trajectory[k].joint_pos;
+		motion_start_vel << trajectory[k].base_vel, trajectory[k].joint_vel;
+		motion_start_acc << trajectory[k].base_acc, trajectory[k].joint_acc;
+		motion_end_pos << trajectory[k+1].base_pos, trajectory[k+1].joint_pos;
+		motion_end_vel << trajectory[k+1].base_vel, trajectory[k+1].joint_vel;
+		motion_end_acc << trajectory[k+1].base_acc, trajectory[k+1].joint_acc;
+		motion_spline.setBoundary(starting_time, duration,
+								  motion_start_pos, motion_start_vel, motion_start_acc,
+								  motion_end_pos, motion_end_vel, motion_end_acc);
+		control_spline.setBoundary(starting_time, duration,
+								   trajectory[k].joint_eff, trajectory[k+1].joint_eff);
+
+		// Sampling the splines at the interpolation times, except the starting one
+		unsigned int index = floor(duration / interpolation_time);
+		times.clear();
+		for (unsigned int t = 1; t < index; t++)
+			times.push_back(starting_time + t * interpolation_time);
+		motion_spline.sample(times, motion_pos, motion_vel, motion_acc);
+		control_spline.sample(times, control_pos, control_vel, control_acc);
+
 		// Interpolating the current state
 		WholeBodyState current_state(num_joints);
-		math::Spline::Point current_point;
-		unsigned int index = floor(duration / interpolation_time);
-		for (unsigned int t = 0; t < index; t++) {
-			double time = starting_time + t * interpolation_time;
-
-			// Base interpolation
-			for (unsigned int base_idx = 0; base_idx < 6; base_idx++) {
-				if (t == 0) {
-					// Initialization of the base motion splines
-					math::Spline::Point starting(trajectory[k].base_pos(base_idx),
-											 	 trajectory[k].base_vel(base_idx),
-												 trajectory[k].base_acc(base_idx));
-					math::Spline::Point ending(trajectory[k+1].base_pos(base_idx),
-											   trajectory[k+1].base_vel(base_idx),
-											   trajectory[k+1].base_acc(base_idx));
-					base_spline[base_idx].setBoundary(starting_time, duration, starting, ending);
-				} else {
-					// Getting and setting the interpolated point
-					base_spline[base_idx].getPoint(time, current_point);
-					current_state.base_pos(base_idx) = current_point.x;
-					current_state.base_vel(base_idx) = current_point.xd;
-					current_state.base_acc(base_idx) = current_point.xdd;
-				}
-			}
-
-			// Joint interpolations
-			for (unsigned int joint_idx = 0; joint_idx < num_joints; joint_idx++) {
-				if (t == 0) {
-					// Initialization of the joint motion splines
-					math::Spline::Point motion_starting(trajectory[k].joint_pos(joint_idx),
-														trajectory[k].joint_vel(joint_idx),
-														trajectory[k].joint_acc(joint_idx));
-					math::Spline::Point motion_ending(trajectory[k+1].joint_pos(joint_idx),
-													  trajectory[k+1].joint_vel(joint_idx),
-													  trajectory[k+1].joint_acc(joint_idx));
-					joint_spline[joint_idx].setBoundary(starting_time, duration,
-														motion_starting, motion_ending);
-
-					// Initialization of the joint control splines
-					math::Spline::Point control_starting(trajectory[k].joint_eff(joint_idx));
-					math::Spline::Point control_ending(trajectory[k+1].joint_eff(joint_idx));
-					control_spline[joint_idx].setBoundary(starting_time, duration,
-														  control_starting, control_ending);
-				} else {
-					// Getting and setting the joint motion interpolated point
-					joint_spline[joint_idx].getPoint(time, current_point);
-					current_state.joint_pos(joint_idx) = current_point.x;
-					current_state.joint_vel(joint_idx) = current_point.xd;
-					current_state.joint_acc(joint_idx) = current_point.xdd;
-
-					// Getting and setting the joint motion interpolated point
-					control_spline[joint_idx].getPoint(time, current_point);
-					current_state.joint_eff(joint_idx) = current_point.x;
-				}
-			}
+		for (unsigned int t = 0; t < times.size(); t++) {
+			// Setting the base, joint and control interpolated points
+			current_state.base_pos = motion_pos.col(t).head<6>();
+			current_state.base_vel = motion_vel.col(t).head<6>();
+			current_state.base_acc = motion_acc.col(t).head<6>();
+			current_state.joint_pos = motion_pos.col(t).tail(num_joints);
+			current_state.joint_vel = motion_vel.col(t).tail(num_joints);
+			current_state.joint_acc = motion_acc.col(t).tail(num_joints);
+			current_state.joint_eff = control_pos.col(t);
 
 			// Compute the contact information
 			// Computing the contact positions
-			rbd::BodySelector end_effector_names = getDynamicalSystem()->getFloatingBaseSystem().getEndEffectorNames();
 			getDynamicalSystem()->getKinematics().computeForwardKinematics(current_state.contact_pos,
 																		   current_state.base_pos,
 																		   current_state.joint_pos,
@@ -240,12 +236,8 @@ const WholeBodyTrajectory& WholeBodyTrajectoryOptimization::getInterpolatedWhole
 																	 end_effector_names);
 
 			// Adding the current state
-			if (t != 0) {
-				// Setting the current time
-				current_state.time = time;
-
-				interpolated_trajectory_.push_back(current_state);
-			}
+			current_state.time = times[t];
+			interpolated_trajectory_.push_back(current_state);
 		}
 	}
 
@@ -95,6 +95,22 @@ class WholeBodyTrajectoryOptimization
 					 const WholeBodyState& desired_state,
 					 double computation_time);
 
+		/**
+		 * @brief Computes a whole-body trajectory in receding horizon. The last solution is
+		 * shifted by the elapsed time and used for warm-starting the primal and dual variables
+		 * of the solver. The optimal control problem isn't re-initialized if only the current
+		 * state changed, which allows us to re-plan at control rates. The first computation
+		 * starts from the nominal trajectory
+		 * @param const WholeBodyState& Current whole-body state
+		 * @param const WholeBodyState& Desired whole-body state
+		 * @param double Elapsed time since the last computation
+		 * @param double Allowed computation time
+		 */
+		bool computeRecedingHorizon(const WholeBodyState& current_state,
+									const WholeBodyState& desired_state,
+									double elapsed_time,
+									double computation_time);
+
 		/** @brief Gets the dynamical system constraint */
 		ocp::DynamicalSystem* getDynamicalSystem();
 
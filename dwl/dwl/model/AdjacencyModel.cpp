@@ -8,7 +8,7 @@ namespace model
 {
 
 AdjacencyModel::AdjacencyModel() :	robot_(NULL), terrain_(NULL), is_lattice_(false),
-		is_added_feature_(false), uncertainty_factor_(1.15)
+		is_added_feature_(false), uncertainty_factor_(1.15), num_threads_(1)
 {
 
 }
@@ -54,8 +54,8 @@ void AdjacencyModel::getTheClosestStartAndGoalVertex(Vertex& closest_source,
 	bool is_there_start_vertex, is_there_goal_vertex = false;
 	std::vector<Vertex> vertex_map;
 	if (terrain_->isTerrainInformation()) {
-		TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
-		for (TerrainDataMap::iterator vertex_iter = terrain_map.begin();
+		const TerrainDataMap& terrain_map = terrain_->getTerrainDataMap();
+		for (TerrainDataMap::const_iterator vertex_iter = terrain_map.begin();
 				vertex_iter != terrain_map.end(); vertex_iter++) {
 			Vertex current_vertex = vertex_iter->first;
 			if (source == current_vertex) {
@@ -158,8 +158,8 @@ void AdjacencyModel::getTheClosestVertex(Vertex& closest_vertex,
 	// Checking if the  vertex is part of the terrain information
 	std::vector<Vertex> vertex_map;
 	if (terrain_->isTerrainInformation()) {
-		TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
-		for (TerrainDataMap::iterator vertex_iter = terrain_map.begin();
+		const TerrainDataMap& terrain_map = terrain_->getTerrainDataMap();
+		for (TerrainDataMap::const_iterator vertex_iter = terrain_map.begin();
 				vertex_iter != terrain_map.end(); vertex_iter++) {
 			Vertex current_vertex = vertex_iter->first;
 			if (vertex == current_vertex) {
@@ -282,12 +282,27 @@ void AdjacencyModel::addFeature(environment::Feature* feature)
 }
 
 
+void AdjacencyModel::setNumberOfThreads(unsigned int num_threads)
+{
+	if (num_threads == 0)
+		num_threads_ = 1;
+	else
+		num_threads_ = num_threads;
+}
+
+
 bool AdjacencyModel::isLatticeRepresentation()
 {
 	return is_lattice_;
 }
 
 
+environment::TerrainMap* AdjacencyModel::getTerrainMap()
+{
+	return terrain_;
+}
+
+
 std::string AdjacencyModel::getName()
 {
 	return name_;
@@ -110,12 +110,26 @@ class AdjacencyModel
 		 */
 		void addFeature(environment::Feature* feature);
 
+		/**
+		 * @brief Sets the number of threads used for evaluating the successors of a vertex
+		 * concurrently, e.g. the actions of a lattice. Note that the features are shared by the
+		 * threads, so their cost computation has to be read-only
+		 * @param unsigned int Number of threads
+		 */
+		void setNumberOfThreads(unsigned int num_threads);
+
 		/**
 		 * @brief Indicates if it is a lattice representation of the environment
 		 * @return True if it is a lattice representation and false otherwise
 		 */
 		bool isLatticeRepresentation();
 
+		/**
+		 * @brief Gets the terrain map of the adjacency model
+		 * @return The terrain map, or NULL if it wasn't defined
+		 */
+		environment::TerrainMap* getTerrainMap();
+
 		/**
 		 * @brief Gets the name of the adjacency model
 		 * @return The name of the adjacency model
@@ -144,6 +158,9 @@ class AdjacencyModel
 
 		/** @brief Uncertainty factor which is applied in unperceived environment */
 		double uncertainty_factor_; // For unknown (non-perceive) areas
+
+		/** @brief Number of threads for evaluating the successors */
+		unsigned int num_threads_;
 };
 
 } //@namespace model
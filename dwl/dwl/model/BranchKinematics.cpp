@@ -0,0 +1,349 @@
+#include <dwl/model/BranchKinematics.h>
+
+
+namespace dwl
+{
+
+namespace model
+{
+
+/**
+ * @brief Solves the trigonometric equation a cos(x) + b sin(x) = c
+ * @param double[2] The two solutions
+ * @param double a coefficient
+ * @param double b coefficient
+ * @param double c coefficient
+ * @return False if there isn't solution, in that case the solutions are the
+ * closest ones
+ */
+static bool solveTrigonometricEquation(double solution[2],
+									   double a, double b, double c)
+{
+	double rho = sqrt(a * a + b * b);
+	if (rho < 1e-12) {
+		solution[0] = solution[1] = 0.;
+		return false;
+	}
+
+	double cos_value = c / rho;
+	bool reachable = fabs(cos_value) <= 1.;
+	cos_value = std::max(-1., std::min(1., cos_value));
+
+	double alpha = atan2(b, a);
+	double beta = acos(cos_value);
+	solution[0] = alpha + beta;
+	solution[1] = alpha - beta;
+
+	return reachable;
+}
+
+
+BranchKinematics::BranchKinematics() : step_tol_(1.0e-12), lambda_(0.01),
+		max_iter_(50), pos_tol_(1.0e-8)
+{
+
+}
+
+
+BranchKinematics::~BranchKinematics()
+{
+
+}
+
+
+void BranchKinematics::reset()
+{
+	branches_.clear();
+}
+
+
+enum TypeOfBranchSolver BranchKinematics::addBranch(const std::string& body_name,
+													unsigned int joint_idx,
+													const Eigen::MatrixXd& jacobian,
+													const Eigen::Vector3d& body_pos,
+													const Eigen::VectorXd& joint_pos_ref,
+													const Eigen::VectorXd& lower_limit,
+													const Eigen::VectorXd& upper_limit)
+{
+	unsigned int num_dof = jacobian.cols();
+	if (num_dof == 0 || num_dof > MAX_DOF || jacobian.rows() != 6)
+		return NoBranchSolver;
+
+	// Computing the screws of the revolute joints, where the linear jacobian
+	// is v = w x (p - o). So a point of the axis is o = p - v x w
+	Branch branch;
+	branch.joint_idx = joint_idx;
+	branch.num_dof = num_dof;
+	branch.axis.resize(3, num_dof);
+	branch.point.resize(3, num_dof);
+	branch.body_pos = body_pos;
+	for (unsigned int i = 0; i < num_dof; i++) {
+		Eigen::Vector3d axis = jacobian.block<3,1>(0,i);
+		Eigen::Vector3d vel = jacobian.block<3,1>(3,i);
+		if (fabs(axis.norm() - 1.) > 1e-6)
+			return NoBranchSolver;
+
+		branch.axis.col(i) = axis.normalized();
+		branch.point.col(i) = body_pos - vel.cross(branch.axis.col(i));
+	}
+	branch.joint_pos_ref = joint_pos_ref;
+	branch.lower_limit = lower_limit;
+	branch.upper_limit = upper_limit;
+
+	// Selecting the analytic solver if the branch supports it
+	branch.solver = NewtonBranchSolver;
+	if (isAnalyticBranch(branch))
+		branch.solver = AnalyticBranchSolver;
+
+	branches_[body_name] = branch;
+	return branch.solver;
+}
+
+
+void BranchKinematics::removeBranch(const std::string& body_name)
+{
+	branches_.erase(body_name);
+}
+
+
+void BranchKinematics::setNewtonSolver(double step_tol,
+									   double lambda,
+									   unsigned int max_iter)
+{
+	step_tol_ = step_tol;
+	lambda_ = lambda;
+	max_iter_ = max_iter;
+}
+
+
+bool BranchKinematics::setTypeOfSolver(const std::string& body_name,
+									   enum TypeOfBranchSolver solver)
+{
+	std::map<std::string,Branch>::iterator branch_it = branches_.find(body_name);
+	if (branch_it == branches_.end() || solver == NoBranchSolver)
+		return false;
+
+	Branch& branch = branch_it->second;
+	if (solver == AnalyticBranchSolver && !isAnalyticBranch(branch))
+		return false;
+
+	branch.solver = solver;
+	return true;
+}
+
+
+enum TypeOfBranchSolver BranchKinematics::getTypeOfSolver(const std::string& body_name) const
+{
+	std::map<std::string,Branch>::const_iterator branch_it = branches_.find(body_name);
+	if (branch_it == branches_.end())
+		return NoBranchSolver;
+
+	return branch_it->second.solver;
+}
+
+
+bool BranchKinematics::computePosition(Eigen::Vector3d& body_pos,
+									   const std::string& body_name,
+									   const Eigen::VectorXd& joint_pos) const
+{
+	std::map<std::string,Branch>::const_iterator branch_it = branches_.find(body_name);
+	if (branch_it == branches_.end())
+		return false;
+
+	const Branch& branch = branch_it->second;
+	BranchJacobian jacobian;
+	computeBranchKinematics(body_pos, jacobian, branch,
+							joint_pos.segment(branch.joint_idx, branch.num_dof));
+	return true;
+}
+
+
+bool BranchKinematics::computeJointPosition(Eigen::VectorXd& joint_pos,
+											const std::string& body_name,
+											const Eigen::Vector3d& body_pos,
+											const Eigen::VectorXd& joint_pos_init) const
+{
+	std::map<std::string,Branch>::const_iterator branch_it = branches_.find(body_name);
+	if (branch_it == branches_.end())
+		return false;
+
+	const Branch& branch = branch_it->second;
+	BranchVector branch_pos;
+	BranchVector branch_pos_init = joint_pos_init.segment(branch.joint_idx, branch.num_dof);
+
+	bool success = false;
+	if (branch.solver == AnalyticBranchSolver)
+		success = computeAnalyticSolution(branch_pos, branch, body_pos, branch_pos_init);
+	else
+		success = computeNewtonSolution(branch_pos, branch, body_pos, branch_pos_init);
+
+	joint_pos.segment(branch.joint_idx, branch.num_dof) = branch_pos;
+	return success;
+}
+
+
+bool BranchKinematics::isAnalyticBranch(const Branch& branch) const
+{
+	return branch.num_dof == 3 &&
+			branch.axis.col(1).cross(branch.axis.col(2)).norm() < 1e-6 &&
+			branch.axis.col(0).cross(branch.axis.col(1)).norm() > 1e-6;
+}
+
+
+void BranchKinematics::computeBranchKinematics(Eigen::Vector3d& body_pos,
+											   BranchJacobian& jacobian,
+											   const Branch& branch,
+											   const BranchVector& joint_pos) const
+{
+	// Composing the exponentials of the joint screws, i.e. rotations about
+	// the axes that pass through their points. The axes and points of the
+	// actual posture are moved by the previous joints
+	jacobian.resize(3, branch.num_dof);
+	Eigen::Matrix3Xd axis(3, branch.num_dof), point(3, branch.num_dof);
+	Eigen::Matrix3d rotation = Eigen::Matrix3d::Identity();
+	Eigen::Vector3d translation = Eigen::Vector3d::Zero();
+	for (unsigned int i = 0; i < branch.num_dof; i++) {
+		axis.col(i) = rotation * branch.axis.col(i);
+		point.col(i) = rotation * branch.point.col(i) + translation;
+
+		Eigen::Matrix3d joint_rot =
+				Eigen::AngleAxisd(joint_pos(i) - branch.joint_pos_ref(i),
+								  branch.axis.col(i)).toRotationMatrix();
+		translation += rotation * (branch.point.col(i) - joint_rot * branch.point.col(i));
+		rotation = rotation * joint_rot;
+	}
+	body_pos = rotation * branch.body_pos + translation;
+
+	// Computing the linear jacobian
+	for (unsigned int i = 0; i < branch.num_dof; i++)
+		jacobian.col(i) = axis.col(i).cross(body_pos - (Eigen::Vector3d) point.col(i));
+}
+
+
+bool BranchKinematics::computeAnalyticSolution(BranchVector& joint_pos,
+											   const Branch& branch,
+											   const Eigen::Vector3d& body_pos,
+											   const BranchVector& joint_pos_init) const
+{
+	const Eigen::Vector3d& w1 = branch.axis.col(0);
+	const Eigen::Vector3d& w2 = branch.axis.col(1);
+	double sign = (w2.dot(branch.axis.col(2)) > 0.) ? 1. : -1.;
+	Eigen::Vector3d o1 = branch.point.col(0);
+	Eigen::Vector3d o2 = branch.point.col(1);
+	Eigen::Vector3d o3 = branch.point.col(2);
+
+	// The first joint defines the plane of the last two ones. So the
+	// component of the body position along the second axis is constant,
+	// i.e. w2 . R1^T (x - o1) = w2 . (p0 - o1), which is
+	// a cos(q1) + b sin(q1) = c
+	Eigen::Vector3d r = body_pos - o1;
+	double w1_r = w1.dot(r);
+	double w1_w2 = w1.dot(w2);
+	double q1[2];
+	bool reachable = solveTrigonometricEquation(q1,
+												w2.dot(r) - w1_r * w1_w2,
+												-w2.dot(w1.cross(r)),
+												w2.dot(branch.body_pos - o1) - w1_r * w1_w2);
+
+	// The last two joints define a planar 2-link chain in the plane
+	// orthogonal to the second axis
+	Eigen::Vector3d u = o3 - o2;
+	Eigen::Vector3d v = branch.body_pos - o3;
+	Eigen::Vector3d pu = u - w2.dot(u) * w2;
+	Eigen::Vector3d pv = v - w2.dot(v) * w2;
+	Eigen::Vector3d w2_pv = w2.cross(pv);
+
+	// Choosing the solution within the joint limits that is the closest to
+	// the initial joint position
+	double min_cost = std::numeric_limits<double>::infinity();
+	bool success = false;
+	joint_pos = joint_pos_init;
+	for (unsigned int i = 0; i < 2; i++) {
+		Eigen::Vector3d y =
+				Eigen::AngleAxisd(-q1[i], w1) * r - (o2 - o1);
+		Eigen::Vector3d py = y - w2.dot(y) * w2;
+
+		// Solving the knee joint from the distance between the second joint
+		// and the body
+		double q3[2];
+		bool knee_reachable =
+				solveTrigonometricEquation(q3,
+										   pu.dot(pv), pu.dot(w2_pv),
+										   (py.squaredNorm() - pu.squaredNorm() -
+												   pv.squaredNorm()) / 2);
+		for (unsigned int j = 0; j < 2; j++) {
+			// Solving the second joint as the rotation of the planar chain
+			Eigen::Vector3d z = pu + cos(q3[j]) * pv + sin(q3[j]) * w2_pv;
+			double q2 = atan2(w2.dot(z.cross(py)), z.dot(py));
+
+			// Getting the joint position closest to the initial one
+			Eigen::Vector3d candidate(q1[i], q2, sign * q3[j]);
+			double cost = 0.;
+			for (unsigned int k = 0; k < 3; k++) {
+				double q = candidate(k) + branch.joint_pos_ref(k);
+				candidate(k) = joint_pos_init(k) + remainder(q - joint_pos_init(k), 2 * M_PI);
+
+				double violation = std::max(0., branch.lower_limit(k) - candidate(k)) +
+						std::max(0., candidate(k) - branch.upper_limit(k));
+				cost += 1e6 * violation +
+						(candidate(k) - joint_pos_init(k)) * (candidate(k) - joint_pos_init(k));
+			}
+
+			if (cost < min_cost) {
+				min_cost = cost;
+				joint_pos = candidate;
+				success = reachable && knee_reachable;
+			}
+		}
+	}
+
+	// Checking if the solution is in the joint limits and reaches the body
+	// position
+	joint_pos = joint_pos.cwiseMax(branch.lower_limit).cwiseMin(branch.upper_limit);
+	if (success) {
+		Eigen::Vector3d solution_pos;
+		BranchJacobian jacobian;
+		computeBranchKinematics(solution_pos, jacobian, branch, joint_pos);
+		success = (body_pos - solution_pos).norm() < pos_tol_;
+	}
+
+	return success;
+}
+
+
+bool BranchKinematics::computeNewtonSolution(BranchVector& joint_pos,
+											 const Branch& branch,
+											 const Eigen::Vector3d& body_pos,
+											 const BranchVector& joint_pos_init) const
+{
+	joint_pos = joint_pos_init.cwiseMax(branch.lower_limit).cwiseMin(branch.upper_limit);
+
+	// Iterating damped Newton steps, where the linear system is always 3x3
+	Eigen::Vector3d solution_pos, error;
+	BranchJacobian jacobian;
+	Eigen::Matrix3d JJT_lambda2_I;
+	BranchVector delta_theta;
+	for (unsigned int k = 0; k < max_iter_; ++k) {
+		computeBranchKinematics(solution_pos, jacobian, branch, joint_pos);
+		error = body_pos - solution_pos;
+		if (error.norm() < pos_tol_)
+			return true;
+
+		JJT_lambda2_I = jacobian * jacobian.transpose();
+		JJT_lambda2_I.diagonal().array() += lambda_ * lambda_;
+		delta_theta = jacobian.transpose() * JJT_lambda2_I.ldlt().solve(error);
+
+		// Checking if the solution is in the joint limits
+		joint_pos += delta_theta;
+		joint_pos = joint_pos.cwiseMax(branch.lower_limit).cwiseMin(branch.upper_limit);
+
+		if (delta_theta.norm() < step_tol_)
+			break;
+	}
+
+	computeBranchKinematics(solution_pos, jacobian, branch, joint_pos);
+	return (body_pos - solution_pos).norm() < pos_tol_;
+}
+
+} //@namespace model
+} //@namespace dwl
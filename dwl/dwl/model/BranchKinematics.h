@@ -0,0 +1,214 @@
+#ifndef DWL__MODEL__BRANCH_KINEMATICS__H
+#define DWL__MODEL__BRANCH_KINEMATICS__H
+
+#include <dwl/utils/utils.h>
+
+
+namespace dwl
+{
+
+namespace model
+{
+
+/**
+ * @brief Type of inverse kinematics solver of a branch. The analytic solver
+ * is used for 3-DoF revolute branches where the last two joint axes are
+ * parallel (e.g. the HAA-HFE-KFE legs of HyQ), otherwise a damped Newton
+ * solver of fixed size is used
+ */
+enum TypeOfBranchSolver {NoBranchSolver, AnalyticBranchSolver, NewtonBranchSolver};
+
+/**
+ * @class BranchKinematics
+ * @brief BranchKinematics class implements the position kinematics of the
+ * branches (e.g. legs) of a floating-base robot. Every branch is described
+ * by the screws of its joints in a reference posture (i.e. a product of
+ * exponentials), which are computed once from the body jacobian. So the
+ * forward and inverse kinematics of a branch don't require to update the
+ * kinematic tree of the whole robot
+ */
+class BranchKinematics
+{
+	public:
+		/** @brief Constructor function */
+		BranchKinematics();
+
+		/** @brief Destructor function */
+		~BranchKinematics();
+
+		/** @brief Removes all the branches */
+		void reset();
+
+		/**
+		 * @brief Adds the branch of a body. The type of solver is selected
+		 * from the joint screws. Branches with prismatic joints, more than 6
+		 * DoF or undefined screws are not added
+		 * @param const std::string& Body name
+		 * @param unsigned int Index of the first joint of the branch
+		 * @param const Eigen::MatrixXd& Full jacobian of the body w.r.t. the
+		 * branch joints, i.e. (angular, linear)^T, in the reference posture
+		 * @param const Eigen::Vector3d& Body position in the reference posture
+		 * @param const Eigen::VectorXd& Joint position of the reference posture
+		 * @param const Eigen::VectorXd& Lower limits of the branch joints
+		 * @param const Eigen::VectorXd& Upper limits of the branch joints
+		 * @return The type of solver of the branch
+		 */
+		enum TypeOfBranchSolver addBranch(const std::string& body_name,
+										  unsigned int joint_idx,
+										  const Eigen::MatrixXd& jacobian,
+										  const Eigen::Vector3d& body_pos,
+										  const Eigen::VectorXd& joint_pos_ref,
+										  const Eigen::VectorXd& lower_limit,
+										  const Eigen::VectorXd& upper_limit);
+
+		/**
+		 * @brief Removes the branch of a body
+		 * @param const std::string& Body name
+		 */
+		void removeBranch(const std::string& body_name);
+
+		/**
+		 * @brief Sets the Newton solver properties
+		 * @param double Step tolerance
+		 * @param double Lambda value for singularities
+		 * @param unsigned int Maximum number of iterations
+		 */
+		void setNewtonSolver(double step_tol,
+							 double lambda,
+							 unsigned int max_iter);
+
+		/**
+		 * @brief Sets the type of solver of the branch of a body, e.g. the
+		 * Newton solver for tracking the initial joint position. The analytic
+		 * solver is only set if the branch supports it
+		 * @param const std::string& Body name
+		 * @param enum TypeOfBranchSolver Type of solver
+		 * @return False if the branch is not defined or doesn't support the solver
+		 */
+		bool setTypeOfSolver(const std::string& body_name,
+							 enum TypeOfBranchSolver solver);
+
+		/**
+		 * @brief Gets the type of solver of the branch of a body
+		 * @param const std::string& Body name
+		 * @return The type of solver, NoBranchSolver if the branch is not defined
+		 */
+		enum TypeOfBranchSolver getTypeOfSolver(const std::string& body_name) const;
+
+		/**
+		 * @brief Computes the position of a body w.r.t. the base frame
+		 * @param Eigen::Vector3d& Body position
+		 * @param const std::string& Body name
+		 * @param const Eigen::VectorXd& Joint position
+		 * @return False if the branch is not defined
+		 */
+		bool computePosition(Eigen::Vector3d& body_pos,
+							 const std::string& body_name,
+							 const Eigen::VectorXd& joint_pos) const;
+
+		/**
+		 * @brief Computes the branch joint position of a body position
+		 * w.r.t. the base frame. Only the branch joints are modified. The
+		 * solutions are bounded by the joint limits
+		 * @param Eigen::VectorXd& Joint position
+		 * @param const std::string& Body name
+		 * @param const Eigen::Vector3d& Body position
+		 * @param const Eigen::VectorXd& Initial joint position. The analytic
+		 * solver uses it for choosing the closest solution, e.g. the knee
+		 * configuration
+		 * @return True on success, false otherwise
+		 */
+		bool computeJointPosition(Eigen::VectorXd& joint_pos,
+								  const std::string& body_name,
+								  const Eigen::Vector3d& body_pos,
+								  const Eigen::VectorXd& joint_pos_init) const;
+
+
+	private:
+		/** @brief Maximum number of DoF of a branch */
+		static const int MAX_DOF = 6;
+		typedef Eigen::Matrix<double,Eigen::Dynamic,1,0,MAX_DOF,1> BranchVector;
+		typedef Eigen::Matrix<double,3,Eigen::Dynamic,0,3,MAX_DOF> BranchJacobian;
+
+		/**
+		 * @brief Defines a branch as the screws of its revolute joints in
+		 * the reference posture, i.e. axis directions and points, and the
+		 * body position
+		 */
+		struct Branch {
+			enum TypeOfBranchSolver solver;
+			unsigned int joint_idx;
+			unsigned int num_dof;
+			Eigen::Matrix3Xd axis;
+			Eigen::Matrix3Xd point;
+			Eigen::Vector3d body_pos;
+			BranchVector joint_pos_ref;
+			BranchVector lower_limit;
+			BranchVector upper_limit;
+		};
+
+		/**
+		 * @brief Computes the body position and its jacobian w.r.t. the
+		 * branch joints
+		 * @param Eigen::Vector3d& Body position
+		 * @param BranchJacobian& Linear jacobian
+		 * @param const Branch& Branch
+		 * @param const BranchVector& Branch joint position
+		 */
+		void computeBranchKinematics(Eigen::Vector3d& body_pos,
+									 BranchJacobian& jacobian,
+									 const Branch& branch,
+									 const BranchVector& joint_pos) const;
+
+		/**
+		 * @brief Indicates if a branch supports the analytic solver, i.e. it's
+		 * a 3-DoF branch where the last two axes are parallel, and the first
+		 * one is not parallel to them
+		 * @param const Branch& Branch
+		 * @return True if it supports the analytic solver
+		 */
+		bool isAnalyticBranch(const Branch& branch) const;
+
+		/**
+		 * @brief Computes the analytic solution of a 3-DoF branch where the
+		 * last two axes are parallel
+		 * @param BranchVector& Branch joint position
+		 * @param const Branch& Branch
+		 * @param const Eigen::Vector3d& Body position
+		 * @param const BranchVector& Initial branch joint position
+		 * @return True if the body position is reachable
+		 */
+		bool computeAnalyticSolution(BranchVector& joint_pos,
+									 const Branch& branch,
+									 const Eigen::Vector3d& body_pos,
+									 const BranchVector& joint_pos_init) const;
+
+		/**
+		 * @brief Computes the damped Newton solution of a branch
+		 * @param BranchVector& Branch joint position
+		 * @param const Branch& Branch
+		 * @param const Eigen::Vector3d& Body position
+		 * @param const BranchVector& Initial branch joint position
+		 * @return True if the solver converges
+		 */
+		bool computeNewtonSolution(BranchVector& joint_pos,
+								   const Branch& branch,
+								   const Eigen::Vector3d& body_pos,
+								   const BranchVector& joint_pos_init) const;
+
+		/** @brief Branch of every body */
+		std::map<std::string,Branch> branches_;
+
+		/** @brief Newton solver */
+		double step_tol_;
+		double lambda_;
+		unsigned int max_iter_;
+
+		/** @brief Tolerance of the body position */
+		double pos_tol_;
+};
+
+} //@namespace model
+} //@namespace dwl
+
+#endif
@@ -585,7 +585,7 @@ const rbd::BodySelector& FloatingBaseSystem::getEndEffectorNames(enum TypeOfEndE
 }
 
 
-bool FloatingBaseSystem::isFullyFloatingBase()
+bool FloatingBaseSystem::isFullyFloatingBase() const
 {
 	if (floating_ax_.active && floating_ay_.active &&
 			floating_az_.active	&& floating_lx_.active &&
@@ -596,7 +596,7 @@ bool FloatingBaseSystem::isFullyFloatingBase()
 }
 
 
-bool FloatingBaseSystem::isVirtualFloatingBaseRobot()
+bool FloatingBaseSystem::isVirtualFloatingBaseRobot() const
 {
 	if (type_of_system_ == VirtualFloatingBase)
 		return true;
@@ -605,7 +605,7 @@ bool FloatingBaseSystem::isVirtualFloatingBaseRobot()
 }
 
 
-bool FloatingBaseSystem::isConstrainedFloatingBaseRobot()
+bool FloatingBaseSystem::isConstrainedFloatingBaseRobot() const
 {
 	if (type_of_system_ == ConstrainedFloatingBase)
 		return true;
@@ -614,7 +614,7 @@ bool FloatingBaseSystem::isConstrainedFloatingBaseRobot()
 }
 
 
-bool FloatingBaseSystem::hasFloatingBaseConstraints()
+bool FloatingBaseSystem::hasFloatingBaseConstraints() const
 {
 	if (floating_ax_.constrained || floating_ay_.constrained ||
 			floating_az_.constrained ||	floating_lx_.constrained ||
@@ -640,23 +640,23 @@ const Eigen::VectorXd& FloatingBaseSystem::toGeneralizedJointState(const rbd::Ve
 					   rbd::angularPart(_base_state),
 					   joint_state;
 	} else if (getTypeOfDynamicSystem() == VirtualFloatingBase) {
+		// Writing the virtual floating-base joints directly in the generalized
+		// state avoids a temporary vector
 		unsigned int base_dof = getFloatingBaseDoF();
-
-		Eigen::VectorXd virtual_base(base_dof);
 		if (floating_ax_.active)
-			virtual_base(floating_ax_.id) = base_state(rbd::AX);
+			full_state_(floating_ax_.id) = base_state(rbd::AX);
 		if (floating_ay_.active)
-			virtual_base(floating_ay_.id) = base_state(rbd::AY);
+			full_state_(floating_ay_.id) = base_state(rbd::AY);
 		if (floating_az_.active)
-			virtual_base(floating_az_.id) = base_state(rbd::AZ);
+			full_state_(floating_az_.id) = base_state(rbd::AZ);
 		if (floating_lx_.active)
-			virtual_base(floating_lx_.id) = base_state(rbd::LX);
+			full_state_(floating_lx_.id) = base_state(rbd::LX);
 		if (floating_ly_.active)
-			virtual_base(floating_ly_.id) = base_state(rbd::LY);
+			full_state_(floating_ly_.id) = base_state(rbd::LY);
 		if (floating_lz_.active)
-			virtual_base(floating_lz_.id) = base_state(rbd::LZ);
+			full_state_(floating_lz_.id) = base_state(rbd::LZ);
 
-		full_state_ << virtual_base, joint_state;
+		full_state_.segment(base_dof, getJointDoF()) = joint_state;
 	} else {
 		full_state_ = joint_state;
 	}
@@ -742,7 +742,7 @@ Eigen::VectorXd FloatingBaseSystem::getBranchState(Eigen::VectorXd& joint_state,
 
 void FloatingBaseSystem::getBranch(unsigned int& pos_idx,
 		   	   	   	   	   	   	   unsigned int& num_dof,
-								   const std::string& body_name)
+								   const std::string& body_name) const
 {
 	// Getting the body id
 	unsigned int body_id = rbd_model_.GetBodyId(body_name.c_str());
@@ -766,6 +766,7 @@ void FloatingBaseSystem::getBranch(unsigned int& pos_idx,
 	// Adding the branch state to the joint state. Two safety checking are done;
 	// checking that this branch has at least one joint, and checking the size
 	// of the new branch state
+	pos_idx = 0;
 	num_dof = 0;
 	if (parent_id != base_id) {
 		do {
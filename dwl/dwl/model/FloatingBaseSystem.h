@@ -329,16 +329,16 @@ class FloatingBaseSystem
 		const rbd::BodySelector& getEndEffectorNames(enum TypeOfEndEffector type = ALL) const;
 
 		/** @brief Returns true if the system has fully floating-base */
-		bool isFullyFloatingBase();
+		bool isFullyFloatingBase() const;
 
 		/** @brief Returns true if the system has a virtual floating-base */
-		bool isVirtualFloatingBaseRobot();
+		bool isVirtualFloatingBaseRobot() const;
 
 		/** @brief Returns true if the system has a physical constraint with a fully floating-base */
-		bool isConstrainedFloatingBaseRobot();
+		bool isConstrainedFloatingBaseRobot() const;
 
 		/** @brief Returns true if there are a physical constraint in the floating-base */
-		bool hasFloatingBaseConstraints();
+		bool hasFloatingBaseConstraints() const;
 
 		/**
 		 * @brief Converts the base and joint states to a generalized joint state
@@ -386,7 +386,7 @@ class FloatingBaseSystem
 		 */
 		void getBranch(unsigned int& pos_idx,
 					   unsigned int& num_dof,
-					   const std::string& body_name);
+					   const std::string& body_name) const;
 
 		/**
 		 * @brief Gets the default posture defined in the system file
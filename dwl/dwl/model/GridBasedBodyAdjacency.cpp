@@ -49,8 +49,8 @@ void GridBasedBodyAdjacency::computeAdjacencyMap(AdjacencyMap& adjacency_map,
 		}
 
 		// Computing the adjacency map given the terrain information
-		TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
-		for (TerrainDataMap::iterator vertex_iter = terrain_map.begin();
+		const TerrainDataMap& terrain_map = terrain_->getTerrainDataMap();
+		for (TerrainDataMap::const_iterator vertex_iter = terrain_map.begin();
 				vertex_iter != terrain_map.end();
 				vertex_iter++)
 		{
@@ -98,9 +98,6 @@ void GridBasedBodyAdjacency::getSuccessors(std::list<Edge>& successors,
 	std::vector<Vertex> neighbor_actions;
 	searchNeighbors(neighbor_actions, state_vertex);
 	if (terrain_->isTerrainInformation()) {
-		// Getting the terrain map
-		TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
-
 		unsigned int action_size = neighbor_actions.size();
 		for (unsigned int i = 0; i < action_size; i++) {
 			// Converting the state vertex (x,y,yaw) to a terrain vertex (x,y)
@@ -145,8 +142,9 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 	bool is_found_neighbor_positive_xy = false, is_found_neighbor_negative_xy = false;
 	bool is_found_neighbor_positive_yx = false, is_found_neighbor_negative_yx = false;
 	if (terrain_->isTerrainInformation()) {
-		// Getting the terrain map
-		TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
+		// Getting a view of the terrain map
+		const TerrainDataMap& terrain_map = terrain_->getTerrainDataMap();
+		TerrainDataMap::const_iterator terrain_end = terrain_map.end();
 
 		double x, y, yaw;
 
@@ -159,7 +157,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x + r;
 			searching_key.y = terrain_key.y;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_positive_x)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_positive_x)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -175,7 +173,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x - r;
 			searching_key.y = terrain_key.y;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_negative_x)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_negative_x)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -191,7 +189,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x;
 			searching_key.y = terrain_key.y + r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_positive_y)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_positive_y)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -207,7 +205,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x;
 			searching_key.y = terrain_key.y - r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_negative_y)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_negative_y)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -223,7 +221,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x + r;
 			searching_key.y = terrain_key.y + r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_positive_xy)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_positive_xy)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -239,7 +237,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x - r;
 			searching_key.y = terrain_key.y - r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_negative_xy)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_negative_xy)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -255,7 +253,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x - r;
 			searching_key.y = terrain_key.y + r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_positive_yx)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_positive_yx)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -271,7 +269,7 @@ void GridBasedBodyAdjacency::searchNeighbors(std::vector<Vertex>& neighbor_state
 			searching_key.x = terrain_key.x + r;
 			searching_key.y = terrain_key.y - r;
 			terrain_->getTerrainSpaceModel().keyToVertex(neighbor_vertex, searching_key, true);
-			if ((terrain_map.count(neighbor_vertex) > 0) && (!is_found_neighbor_negative_yx)) {
+			if ((terrain_map.find(neighbor_vertex) != terrain_end) && (!is_found_neighbor_negative_yx)) {
 				// Getting the state vertex of the neighbor
 				terrain_->getTerrainSpaceModel().keyToState(x, searching_key.x, true);
 				terrain_->getTerrainSpaceModel().keyToState(y, searching_key.y, true);
@@ -296,9 +294,6 @@ void GridBasedBodyAdjacency::computeBodyCost(double& cost,
 	Eigen::Vector3d state;
 	terrain_->getTerrainSpaceModel().vertexToState(state, state_vertex);
 
-	// Getting the terrain map
-	TerrainDataMap terrain_map = terrain_->getTerrainDataMap();
-
 	// Computing the terrain cost
 	double terrain_cost = 0;
 	unsigned int area_size = stance_areas_.size();
@@ -327,10 +322,10 @@ void GridBasedBodyAdjacency::computeBodyCost(double& cost,
 				terrain_->getTerrainSpaceModel().coordToVertex(current_2d_vertex, point_position);
 
 				// Inserts the element in an organized vertex queue, according to the maximum value
-				if (terrain_map.count(current_2d_vertex) > 0)
-					stance_cost_queue.insert(std::pair<Weight, Vertex>(
-							terrain_->getTerrainCost(current_2d_vertex),
-							current_2d_vertex));
+				Weight cell_cost;
+				if (terrain_->getTerrainCost(cell_cost, current_2d_vertex))
+					stance_cost_queue.insert(std::pair<Weight, Vertex>(cell_cost,
+																	   current_2d_vertex));
 			}
 		}
 
@@ -352,7 +347,8 @@ void GridBasedBodyAdjacency::computeBodyCost(double& cost,
 
 		terrain_cost += stance_cost;
 	}
-	terrain_cost /= stance_areas_.size();
+	if (area_size > 0)
+		terrain_cost /= area_size;
 
 	// Getting robot and terrain information
 	RobotAndTerrain info;
@@ -361,7 +357,7 @@ void GridBasedBodyAdjacency::computeBodyCost(double& cost,
 	info.body_action = default_action;
 	info.pose.position = (Eigen::Vector2d) state.head(2);
 	info.pose.orientation = (double) state(2);
-	info.height_map = terrain_->getTerrainHeightMap();
+	info.height_map = &terrain_->getTerrainHeightMap();
 	info.resolution = terrain_->getResolution(true);
 
 	// Computing the cost of the body features
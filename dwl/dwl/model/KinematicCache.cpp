@@ -0,0 +1,180 @@
+#include <dwl/model/KinematicCache.h>
+
+
+namespace dwl
+{
+
+namespace model
+{
+
+KinematicCache::KinematicCache(unsigned int capacity) : next_entry_(0), num_hits_(0)
+{
+	if (capacity == 0)
+		capacity = 1;
+	entries_.resize(capacity);
+}
+
+
+KinematicCache::~KinematicCache()
+{
+
+}
+
+
+void KinematicCache::reset()
+{
+	for (unsigned int i = 0; i < entries_.size(); i++)
+		entries_[i].valid = false;
+	next_entry_ = 0;
+	num_hits_ = 0;
+}
+
+
+const rbd::BodyVectorXd& KinematicCache::computePosition(WholeBodyKinematics& kinematics,
+														 const rbd::Vector6d& base_pos,
+														 const Eigen::VectorXd& joint_pos,
+														 const rbd::BodySelector& body_set,
+														 enum rbd::Component component,
+														 enum TypeOfOrientation type)
+{
+	rbd::Vector6d base_vel = rbd::Vector6d::Zero();
+	Eigen::VectorXd joint_vel;
+	int index = findEntry(Position, base_pos, joint_pos, base_vel, joint_vel,
+						  body_set, component, type);
+	if (index >= 0)
+		return entries_[index].values;
+
+	Entry& entry = replaceEntry(Position, base_pos, joint_pos, base_vel, joint_vel,
+								body_set, component, type);
+	kinematics.computeForwardKinematics(entry.values,
+										base_pos, joint_pos,
+										body_set, component, type);
+	entry.valid = true;
+
+	return entry.values;
+}
+
+
+const Eigen::MatrixXd& KinematicCache::computeJacobian(WholeBodyKinematics& kinematics,
+													   const rbd::Vector6d& base_pos,
+													   const Eigen::VectorXd& joint_pos,
+													   const rbd::BodySelector& body_set,
+													   enum rbd::Component component)
+{
+	rbd::Vector6d base_vel = rbd::Vector6d::Zero();
+	Eigen::VectorXd joint_vel;
+	int index = findEntry(Jacobian, base_pos, joint_pos, base_vel, joint_vel,
+						  body_set, component, RollPitchYaw);
+	if (index >= 0)
+		return entries_[index].jacobian;
+
+	Entry& entry = replaceEntry(Jacobian, base_pos, joint_pos, base_vel, joint_vel,
+								body_set, component, RollPitchYaw);
+	kinematics.computeJacobian(entry.jacobian,
+							   base_pos, joint_pos,
+							   body_set, component);
+	entry.valid = true;
+
+	return entry.jacobian;
+}
+
+
+const rbd::BodyVectorXd& KinematicCache::computeVelocity(WholeBodyKinematics& kinematics,
+														 const rbd::Vector6d& base_pos,
+														 const Eigen::VectorXd& joint_pos,
+														 const rbd::Vector6d& base_vel,
+														 const Eigen::VectorXd& joint_vel,
+														 const rbd::BodySelector& body_set,
+														 enum rbd::Component component)
+{
+	int index = findEntry(Velocity, base_pos, joint_pos, base_vel, joint_vel,
+						  body_set, component, RollPitchYaw);
+	if (index >= 0)
+		return entries_[index].values;
+
+	Entry& entry = replaceEntry(Velocity, base_pos, joint_pos, base_vel, joint_vel,
+								body_set, component, RollPitchYaw);
+	kinematics.computeVelocity(entry.values,
+							   base_pos, joint_pos,
+							   base_vel, joint_vel,
+							   body_set, component);
+	entry.valid = true;
+
+	return entry.values;
+}
+
+
+unsigned int KinematicCache::getNumberOfHits() const
+{
+	return num_hits_;
+}
+
+
+int KinematicCache::findEntry(enum Quantity quantity,
+							  const rbd::Vector6d& base_pos,
+							  const Eigen::VectorXd& joint_pos,
+							  const rbd::Vector6d& base_vel,
+							  const Eigen::VectorXd& joint_vel,
+							  const rbd::BodySelector& body_set,
+							  enum rbd::Component component,
+							  enum TypeOfOrientation type)
+{
+	for (unsigned int i = 0; i < entries_.size(); i++) {
+		const Entry& entry = entries_[i];
+		if (!entry.valid || entry.quantity != quantity || entry.component != component)
+			continue;
+
+		// The orientation type only changes the positions, and the velocities only change
+		// the operational velocities
+		if (quantity == Position && entry.type != type)
+			continue;
+		if (entry.base_pos != base_pos || !isEqual(entry.joint_pos, joint_pos))
+			continue;
+		if (quantity == Velocity &&
+				(entry.base_vel != base_vel || !isEqual(entry.joint_vel, joint_vel)))
+			continue;
+		if (entry.body_set != body_set)
+			continue;
+
+		num_hits_++;
+		return i;
+	}
+
+	return -1;
+}
+
+
+KinematicCache::Entry& KinematicCache::replaceEntry(enum Quantity quantity,
+													const rbd::Vector6d& base_pos,
+													const Eigen::VectorXd& joint_pos,
+													const rbd::Vector6d& base_vel,
+													const Eigen::VectorXd& joint_vel,
+													const rbd::BodySelector& body_set,
+													enum rbd::Component component,
+													enum TypeOfOrientation type)
+{
+	Entry& entry = entries_[next_entry_];
+	next_entry_ = (next_entry_ + 1) % entries_.size();
+
+	entry.valid = false;
+	entry.quantity = quantity;
+	entry.component = component;
+	entry.type = type;
+	entry.body_set = body_set;
+	entry.base_pos = base_pos;
+	entry.joint_pos = joint_pos;
+	entry.base_vel = base_vel;
+	entry.joint_vel = joint_vel;
+
+	return entry;
+}
+
+
+bool KinematicCache::isEqual(const Eigen::VectorXd& vector_a,
+							 const Eigen::VectorXd& vector_b) const
+{
+	return vector_a.size() == vector_b.size() && vector_a == vector_b;
+}
+
+} //@namespace model
+} //@namespace dwl
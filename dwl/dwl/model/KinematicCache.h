@@ -0,0 +1,169 @@
+#ifndef DWL__MODEL__KINEMATIC_CACHE__H
+#define DWL__MODEL__KINEMATIC_CACHE__H
+
+#include <dwl/model/WholeBodyKinematics.h>
+#include <dwl/utils/utils.h>
+
+
+namespace dwl
+{
+
+namespace model
+{
+
+/**
+ * @class KinematicCache
+ * @brief Cache of the kinematic quantities (i.e. positions, velocities and jacobians of a set
+ * of bodies) computed for a certain whole-body state. The costs and constraints evaluated at
+ * the same knot usually need the same quantities, so they are computed once and shared with
+ * the rest. The entries are keyed on the state, and they are replaced in round-robin order.
+ * Note that the cache isn't thread-safe, so every thread needs its own cache, and it assumes
+ * that all the kinematic models describe the same robot
+ */
+class KinematicCache
+{
+	public:
+		/**
+		 * @brief Constructor function
+		 * @param unsigned int Number of cached entries
+		 */
+		KinematicCache(unsigned int capacity = 8);
+
+		/** @brief Destructor function */
+		~KinematicCache();
+
+		/** @brief Removes all the cached entries */
+		void reset();
+
+		/**
+		 * @brief Computes the forward kinematics of a set of bodies, or gets it from the
+		 * cache. The returned reference is valid until its entry is replaced
+		 * @param WholeBodyKinematics& Kinematic model used if it isn't cached
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::BodySelector& A predefined set of bodies
+		 * @param enum rbd::Component Component of the operational position
+		 * @param enum TypeOfOrientation Desired type of orientation
+		 * @return The operational position of the bodies
+		 */
+		const rbd::BodyVectorXd& computePosition(WholeBodyKinematics& kinematics,
+												 const rbd::Vector6d& base_pos,
+												 const Eigen::VectorXd& joint_pos,
+												 const rbd::BodySelector& body_set,
+												 enum rbd::Component component = rbd::Full,
+												 enum TypeOfOrientation type = RollPitchYaw);
+
+		/**
+		 * @brief Computes the jacobian of a set of bodies, or gets it from the cache. The
+		 * returned reference is valid until its entry is replaced
+		 * @param WholeBodyKinematics& Kinematic model used if it isn't cached
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::BodySelector& A predefined set of bodies
+		 * @param enum rbd::Component Component of the jacobian
+		 * @return The jacobian of the bodies
+		 */
+		const Eigen::MatrixXd& computeJacobian(WholeBodyKinematics& kinematics,
+											   const rbd::Vector6d& base_pos,
+											   const Eigen::VectorXd& joint_pos,
+											   const rbd::BodySelector& body_set,
+											   enum rbd::Component component = rbd::Full);
+
+		/**
+		 * @brief Computes the operational velocity of a set of bodies, or gets it from the
+		 * cache. The returned reference is valid until its entry is replaced
+		 * @param WholeBodyKinematics& Kinematic model used if it isn't cached
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::Vector6d& Base velocity
+		 * @param const Eigen::VectorXd& Joint velocity
+		 * @param const rbd::BodySelector& A predefined set of bodies
+		 * @param enum rbd::Component Component of the operational velocity
+		 * @return The operational velocity of the bodies
+		 */
+		const rbd::BodyVectorXd& computeVelocity(WholeBodyKinematics& kinematics,
+												 const rbd::Vector6d& base_pos,
+												 const Eigen::VectorXd& joint_pos,
+												 const rbd::Vector6d& base_vel,
+												 const Eigen::VectorXd& joint_vel,
+												 const rbd::BodySelector& body_set,
+												 enum rbd::Component component = rbd::Full);
+
+		/** @brief Gets the number of queries answered from the cache */
+		unsigned int getNumberOfHits() const;
+
+
+	private:
+		/** @brief Kind of the cached quantity */
+		enum Quantity {Position, Velocity, Jacobian};
+
+		/** @brief Cached entry, i.e. the query and its result */
+		struct Entry
+		{
+			Entry() : valid(false) {}
+
+			bool valid;
+			enum Quantity quantity;
+			enum rbd::Component component;
+			enum TypeOfOrientation type;
+			rbd::BodySelector body_set;
+			rbd::Vector6d base_pos;
+			Eigen::VectorXd joint_pos;
+			rbd::Vector6d base_vel;
+			Eigen::VectorXd joint_vel;
+			rbd::BodyVectorXd values;
+			Eigen::MatrixXd jacobian;
+		};
+
+		/**
+		 * @brief Finds the entry of a query
+		 * @param enum Quantity Kind of the cached quantity
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::Vector6d& Base velocity (only used for velocities)
+		 * @param const Eigen::VectorXd& Joint velocity (only used for velocities)
+		 * @param const rbd::BodySelector& A predefined set of bodies
+		 * @param enum rbd::Component Component of the quantity
+		 * @param enum TypeOfOrientation Type of orientation (only used for positions)
+		 * @return The index of the entry, or -1 if it isn't cached
+		 */
+		int findEntry(enum Quantity quantity,
+					  const rbd::Vector6d& base_pos,
+					  const Eigen::VectorXd& joint_pos,
+					  const rbd::Vector6d& base_vel,
+					  const Eigen::VectorXd& joint_vel,
+					  const rbd::BodySelector& body_set,
+					  enum rbd::Component component,
+					  enum TypeOfOrientation type);
+
+		/**
+		 * @brief Gets the entry that is replaced by a new query, and sets its key
+		 * @return The replaced entry
+		 */
+		Entry& replaceEntry(enum Quantity quantity,
+							const rbd::Vector6d& base_pos,
+							const Eigen::VectorXd& joint_pos,
+							const rbd::Vector6d& base_vel,
+							const Eigen::VectorXd& joint_vel,
+							const rbd::BodySelector& body_set,
+							enum rbd::Component component,
+							enum TypeOfOrientation type);
+
+		/** @brief Indicates if two vectors are equal, including their sizes */
+		bool isEqual(const Eigen::VectorXd& vector_a,
+					 const Eigen::VectorXd& vector_b) const;
+
+		/** @brief Cached entries */
+		std::vector<Entry> entries_;
+
+		/** @brief Next entry to replace */
+		unsigned int next_entry_;
+
+		/** @brief Number of queries answered from the cache */
+		unsigned int num_hits_;
+};
+
+} //@namespace model
+} //@namespace dwl
+
+#endif
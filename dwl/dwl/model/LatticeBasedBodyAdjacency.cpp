@@ -12,6 +12,7 @@ LatticeBasedBodyAdjacency::LatticeBasedBodyAdjacency() : is_stance_adjacency_(tr
 {
 	name_ = "Lattice-based Body";
 	is_lattice_ = true;
+	stance_field_.setNumberOfLowestCosts(number_top_cost_);
 }
 
 
@@ -39,40 +40,68 @@ void LatticeBasedBodyAdjacency::getSuccessors(std::list<Edge>& successors,
 
 	// Evaluating every action (body motor primitives)
 	if (terrain_->isTerrainInformation()) {
-		unsigned int action_size = actions.size();
-		for (unsigned int i = 0; i < action_size; i++) {
-			// Converting the action to current vertex
-			Eigen::Vector3d action_state;
-			action_state << actions[i].pose.position, actions[i].pose.orientation;
-			Vertex current_action_vertex, terrain_vertex;
-			terrain_->getTerrainSpaceModel().stateToVertex(current_action_vertex, action_state);
-
-			// Converting state vertex to environment vertex
-			terrain_->getTerrainSpaceModel().stateVertexToEnvironmentVertex(terrain_vertex,
-					current_action_vertex, XY_Y);
-
-			// Computing the current action
-			current_action_ = action_state - current_state;
-
-			// Checks if there is an obstacle
-			if (isFreeOfObstacle(current_action_vertex, XY_Y, true)) {
-				if (!isStanceAdjacency()) {
-					double terrain_cost;
-					if (terrain_->getTerrainDataMap().count(terrain_vertex) == 0)
-						terrain_cost = uncertainty_factor_ * terrain_->getAverageCostOfTerrain();
-					else
-						terrain_cost = terrain_->getTerrainCost(terrain_vertex);
-
-					successors.push_back(Edge(current_action_vertex, terrain_cost));
-				} else {
-					// Computing the body cost
-					double body_cost;
-					computeBodyCost(body_cost, action_state);
-					body_cost += actions[i].cost;
-					successors.push_back(Edge(current_action_vertex, body_cost));
-				}
+		// Updating the stance-cost field after a terrain update
+		if (isStanceAdjacency() && !stance_field_.isUpdated(*terrain_))
+			stance_field_.reset(*terrain_);
+
+		// Converting the actions to state vertices
+		int action_size = actions.size();
+		std::vector<Eigen::Vector3d> action_states(action_size);
+		std::vector<Vertex> action_vertices(action_size);
+		for (int i = 0; i < action_size; i++) {
+			action_states[i] << actions[i].pose.position, actions[i].pose.orientation;
+			terrain_->getTerrainSpaceModel().stateToVertex(action_vertices[i], action_states[i]);
+		}
+
+		// Checking if there is an obstacle. The actions are independent, so they are evaluated
+		// concurrently, where every action writes its own slot
+		std::vector<char> is_free(action_size);
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+		for (int i = 0; i < action_size; i++)
+			is_free[i] = isFreeOfObstacle(action_vertices[i], XY_Y, true);
+
+		// Getting the stance areas of the free actions. Note that the stance of the robot
+		// depends on the previous action, so they are computed in the action order
+		std::vector<SearchAreaMap> stance_areas(action_size);
+		if (isStanceAdjacency()) {
+			for (int i = 0; i < action_size; i++) {
+				if (is_free[i])
+					stance_areas[i] = robot_->getFootstepSearchAreas(action_states[i] -
+																	 current_state);
+			}
+		}
+
+		// Computing the costs of the free actions concurrently
+		std::vector<double> action_costs(action_size);
+#pragma omp parallel for num_threads(num_threads_) schedule(dynamic)
+		for (int i = 0; i < action_size; i++) {
+			if (!is_free[i])
+				continue;
+
+			if (!isStanceAdjacency()) {
+				// Converting state vertex to environment vertex
+				Vertex terrain_vertex;
+				terrain_->getTerrainSpaceModel().stateVertexToEnvironmentVertex(terrain_vertex,
+						action_vertices[i], XY_Y);
+
+				if (terrain_->getTerrainDataMap().count(terrain_vertex) == 0)
+					action_costs[i] = uncertainty_factor_ * terrain_->getAverageCostOfTerrain();
+				else
+					action_costs[i] = terrain_->getTerrainCost(terrain_vertex);
+			} else {
+				// Computing the body cost
+				computeBodyCost(action_costs[i], action_states[i],
+								action_states[i] - current_state, stance_areas[i]);
+				action_costs[i] += actions[i].cost;
 			}
 		}
+
+		// Adding the successors in the action order, so they don't depend on the number
+		// of threads
+		for (int i = 0; i < action_size; i++) {
+			if (is_free[i])
+				successors.push_back(Edge(action_vertices[i], action_costs[i]));
+		}
 	} else
 		printf(RED_ "Could not computed the successors because there is not terrain information \n"
 				COLOR_RESET);
@@ -80,77 +109,43 @@ void LatticeBasedBodyAdjacency::getSuccessors(std::list<Edge>& successors,
 
 
 void LatticeBasedBodyAdjacency::computeBodyCost(double& cost,
-												Eigen::Vector3d state)
+												const Eigen::Vector3d& state,
+												const Eigen::Vector3d& action,
+												const SearchAreaMap& stance_areas)
 {
-	// Getting the stance areas according to the action
-	stance_areas_ = robot_->getFootstepSearchAreas(current_action_);
-
-	// Computing the terrain cost
+	// Computing the terrain cost from the stance-cost field, i.e. a lookup per stance area
 	double terrain_cost = 0;
-	unsigned int area_size = stance_areas_.size();
-	for (unsigned int n = 0; n < area_size; n++) {
-		// Computing the boundary of stance area
-		Eigen::Vector2d boundary_min, boundary_max;
-		boundary_min(0) = stance_areas_[n].min_x + state(0);
-		boundary_min(1) = stance_areas_[n].min_y + state(1);
-		boundary_max(0) = stance_areas_[n].max_x + state(0);
-		boundary_max(1) = stance_areas_[n].max_y + state(1);
-
-		// Computing the stance cost
-		std::set< std::pair<Weight, Vertex>, pair_first_less<Weight, Vertex> > stance_cost_queue;
-		double stance_cost = 0;
-		double resolution = stance_areas_[n].resolution;
-		for (double y = boundary_min(1); y <= boundary_max(1); y += resolution) {
-			for (double x = boundary_min(0); x <= boundary_max(0); x += resolution) {
-				// Computing the rotated coordinate according to the orientation of the body
-				Eigen::Vector2d point_position;
-				double current_x = state(0);
-				double current_y = state(1);
-				double current_yaw = state(2);
-				point_position(0) = (x - current_x) * cos(current_yaw) -
-						(y - current_y) * sin(current_yaw) + current_x;
-				point_position(1) = (x - current_x) * sin(current_yaw) +
-						(y - current_y) * cos(current_yaw) + current_y;
-
-				Vertex current_2d_vertex;
-				terrain_->getTerrainSpaceModel().coordToVertex(current_2d_vertex, point_position);
-
-				// Inserts the element in an organized vertex queue, according to the maximum value
-				if (terrain_->getTerrainDataMap().count(current_2d_vertex) > 0) {
-					stance_cost_queue.insert(std::pair<Weight, Vertex>(
-							terrain_->getTerrainCost(current_2d_vertex),
-							current_2d_vertex));
-				}
-			}
-		}
-
-		// Averaging the 5-best (lowest) cost
-		unsigned int number_top_cost = number_top_cost_;
-		if (stance_cost_queue.size() < number_top_cost)
-			number_top_cost = stance_cost_queue.size();
-
-		if (number_top_cost == 0) {
-			stance_cost += uncertainty_factor_ * terrain_->getAverageCostOfTerrain();
-		} else {
-			for (unsigned int i = 0; i < number_top_cost; i++) {
-				stance_cost += stance_cost_queue.begin()->first;
-				stance_cost_queue.erase(stance_cost_queue.begin());
-			}
-
-			stance_cost /= number_top_cost;
-		}
+	double yaw = state(2);
+	for (SearchAreaMap::const_iterator area_it = stance_areas.begin();
+			area_it != stance_areas.end(); area_it++) {
+		const SearchArea& area = area_it->second;
+
+		// Computing the center and size of the stance area, where the center is rotated
+		// according to the orientation of the body
+		double center_x = 0.5 * (area.min_x + area.max_x);
+		double center_y = 0.5 * (area.min_y + area.max_y);
+		Eigen::Vector2d area_position, area_size;
+		area_position(0) = center_x * cos(yaw) - center_y * sin(yaw) + state(0);
+		area_position(1) = center_x * sin(yaw) + center_y * cos(yaw) + state(1);
+		area_size << area.max_x - area.min_x, area.max_y - area.min_y;
+
+		// Averaging the lowest costs of the stance area
+		double stance_cost;
+		if (!stance_field_.getStanceCost(stance_cost, area_position, yaw, area_size))
+			stance_cost = uncertainty_factor_ * terrain_->getAverageCostOfTerrain();
 
 		terrain_cost += stance_cost;
 	}
-	terrain_cost /= stance_areas_.size();
+	if (stance_areas.size() > 0)
+		terrain_cost /= stance_areas.size();
 
 
 	// Getting robot and terrain information
 	RobotAndTerrain info;
-	info.body_action = current_action_;
+	info.body_action = action;
 	info.pose.position = (Eigen::Vector2d) state.head(2);
 	info.pose.orientation = (double) state(2);
-	info.height_map = terrain_->getTerrainHeightMap();
+	info.height_map = &terrain_->getTerrainHeightMap();
 	info.resolution = terrain_->getResolution(true);
 
 	// Computing the cost of the body features
@@ -172,9 +167,6 @@ bool LatticeBasedBodyAdjacency::isFreeOfObstacle(Vertex state_vertex,
 												 TypeOfState state_representation,
 												 bool body)
 {
-	// Getting the terrain obstacle map
-	ObstacleMap obstacle_map = terrain_->getObstacleMap();
-
 	// Converting the vertex to state (x,y,yaw)
 	Eigen::Vector3d state_3d;
 	Eigen::Vector2d state_2d;
@@ -197,37 +189,42 @@ bool LatticeBasedBodyAdjacency::isFreeOfObstacle(Vertex state_vertex,
 			// Getting the body area of the robot
 			SearchArea body_workspace = robot_->getPredefinedBodyWorkspace();
 
-			// Computing the boundary of stance area
-			Eigen::Vector2d boundary_min, boundary_max;
-			boundary_min(0) = body_workspace.min_x + current_x;
-			boundary_min(1) = body_workspace.min_y + current_y;
-			boundary_max(0) = body_workspace.max_x + current_x;
-			boundary_max(1) = body_workspace.max_y + current_y;
-
-			// Getting the resolution of the obstacle map
-			double obstacle_resolution = terrain_->getObstacleResolution();
-			if (body_workspace.resolution > obstacle_resolution)
-				obstacle_resolution = body_workspace.resolution;
-
-			for (double y = boundary_min(1); y <= boundary_max(1); y += obstacle_resolution) {
-				for (double x = boundary_min(0); x <= boundary_max(0); x += obstacle_resolution) {
-					// Computing the rotated coordinate according to the orientation of the body
-					Eigen::Vector2d point_position;
-					point_position(0) = (x - current_x) * cos(current_yaw) -
-							(y - current_y) * sin(current_yaw) + current_x;
-					point_position(1) = (x - current_x) * sin(current_yaw) +
-							(y - current_y) * cos(current_yaw) + current_y;
-
-					Vertex current_2d_vertex;
-					terrain_->getObstacleSpaceModel().coordToVertex(current_2d_vertex, point_position);
-
-					// Checking if there is an obstacle
-					if (obstacle_map.count(current_2d_vertex) > 0) {
-						if (obstacle_map.find(current_2d_vertex)->second) {
-							is_free = false;
-							goto found_obstacle;
-						}
-					}
+			// Covering the body area with circles along its longest side, which are checked in
+			// the obstacle distance field. Note that the obstacles are cells, so the clearance
+			// of every circle includes half of the cell diagonal
+			const environment::ObstacleDistanceField& obstacle_field =
+					terrain_->getObstacleDistanceField();
+			double length_x = body_workspace.max_x - body_workspace.min_x;
+			double length_y = body_workspace.max_y - body_workspace.min_y;
+			double length = std::max(length_x, length_y);
+			double width = std::min(length_x, length_y);
+			unsigned int num_circles = 1;
+			if (width > 0.)
+				num_circles = ceil(length / width);
+			double step = length / num_circles;
+			double clearance = 0.5 * sqrt(step * step + width * width) +
+					M_SQRT1_2 * obstacle_field.getResolution();
+
+			for (unsigned int c = 0; c < num_circles; c++) {
+				// Computing the center of the circle in the body frame
+				double x, y;
+				if (length_x >= length_y) {
+					x = body_workspace.min_x + (c + 0.5) * step;
+					y = 0.5 * (body_workspace.min_y + body_workspace.max_y);
+				} else {
+					x = 0.5 * (body_workspace.min_x + body_workspace.max_x);
+					y = body_workspace.min_y + (c + 0.5) * step;
+				}
+
+				// Computing the rotated coordinate according to the orientation of the body
+				Eigen::Vector2d circle_position;
+				circle_position(0) = x * cos(current_yaw) - y * sin(current_yaw) + current_x;
+				circle_position(1) = x * sin(current_yaw) + y * cos(current_yaw) + current_y;
+
+				// Checking if there is an obstacle
+				if (obstacle_field.getDistance(circle_position) <= clearance) {
+					is_free = false;
+					break;
 				}
 			}
 		} else {
@@ -236,6 +233,8 @@ bool LatticeBasedBodyAdjacency::isFreeOfObstacle(Vertex state_vertex,
 			terrain_->getObstacleSpaceModel().stateVertexToEnvironmentVertex(terrain_vertex,
 					state_vertex, state_representation);
 
+			// Checking if there is an obstacle
+			const ObstacleMap& obstacle_map = terrain_->getObstacleMap();
 			if (obstacle_map.count(terrain_vertex) > 0) {
 				if (obstacle_map.find(terrain_vertex)->second)
 					is_free = false;
@@ -243,7 +242,6 @@ bool LatticeBasedBodyAdjacency::isFreeOfObstacle(Vertex state_vertex,
 		}
 	}
 
-	found_obstacle:
 	return is_free;
 }
 
@@ -2,6 +2,7 @@
 #define DWL__MODEL__LATTICE_BASED_BODY_ADJACENCY__H
 
 #include <dwl/model/AdjacencyModel.h>
+#include <dwl/environment/StanceCostField.h>
 
 
 namespace dwl
@@ -43,11 +44,18 @@ class LatticeBasedBodyAdjacency : public AdjacencyModel
 							 Vertex vertex_id);
 
 		/**
-		 * @brief Computes the body cost of a current vertex
-		 * @param Eigen::Vector3d Current robot state (x,y,yaw)
+		 * @brief Computes the body cost of a current vertex. The terrain cost of each stance area
+		 * is looked up in the stance-cost field. Note that it's called concurrently for the
+		 * actions of a vertex
+		 * @param double& Body cost
+		 * @param const Eigen::Vector3d& Current robot state (x,y,yaw)
+		 * @param const Eigen::Vector3d& Body action that reaches the current state
+		 * @param const SearchAreaMap& Stance areas of the action
 		 */
 		void computeBodyCost(double& cost,
-							 Eigen::Vector3d state);
+							 const Eigen::Vector3d& state,
+							 const Eigen::Vector3d& action,
+							 const SearchAreaMap& stance_areas);
 
 		/**
 		 * @brief Indicates if the free of obstacle
@@ -66,17 +74,14 @@ class LatticeBasedBodyAdjacency : public AdjacencyModel
 		 */
 		bool isStanceAdjacency();
 
-		/** @brief Current action of the body */
-		Eigen::Vector3d current_action_;
-
 		/** @brief Indicates it was requested a stance or terrain adjacency */
 		bool is_stance_adjacency_;
 
-		/** @brief Map of search areas */
-		SearchAreaMap stance_areas_;
-
 		/** @brief Number of top cost for computing the stance cost */
 		int number_top_cost_;
+
+		/** @brief Precomputed stance cost of the terrain */
+		environment::StanceCostField stance_field_;
 };
 
 } //@namespace model
@@ -8,9 +8,9 @@ namespace model
 {
 
 OptimizationModel::OptimizationModel() : solution_(NULL), state_dimension_(0),
-		constraint_dimension_(0), nonzero_jacobian_(0), nonzero_hessian_(0), gradient_(true),
-		jacobian_(true), hessian_(true), bounds_(false), soft_constraints_(false),
-		first_time_(true), cost_function_(this), num_diff_mode_(Eigen::Central), epsilon_(1E-06),
+		constraint_dimension_(0), nonzero_jacobian_(0), nonzero_hessian_(0), epsilon_(1E-06),
+		gradient_(true), jacobian_(true), hessian_(true), bounds_(false), soft_constraints_(false),
+		first_time_(true), num_diff_mode_(Eigen::Central),
 		soft_properties_(SoftConstraintProperties(10000., 0., 0.))
 {
 
@@ -28,6 +28,12 @@ void OptimizationModel::init(bool only_soft_constraints)
 }
 
 
+OptimizationModel* OptimizationModel::clone() const
+{
+	return NULL;
+}
+
+
 void OptimizationModel::setDimensionOfState(unsigned int dimension)
 {
 	state_dimension_ = dimension;
@@ -74,6 +80,49 @@ void OptimizationModel::getStartingPoint(double* decision, int decision_dim)
 }
 
 
+bool OptimizationModel::getStartingDualPoint(double* bound_lmult, double* bound_umult,
+											 int decision_dim,
+											 double* constraint_mult, int constraint_dim)
+{
+	if (bound_lmult_.size() != decision_dim || constraint_mult_.size() != constraint_dim)
+		return false;
+
+	// Eigen interfacing to raw buffers
+	Eigen::Map<Eigen::VectorXd> lmult(bound_lmult, decision_dim);
+	Eigen::Map<Eigen::VectorXd> umult(bound_umult, decision_dim);
+	Eigen::Map<Eigen::VectorXd> mult(constraint_mult, constraint_dim);
+	lmult = bound_lmult_;
+	umult = bound_umult_;
+	mult = constraint_mult_;
+
+	return true;
+}
+
+
+void OptimizationModel::setDualSolution(const double* bound_lmult, const double* bound_umult,
+										int decision_dim,
+										const double* constraint_mult, int constraint_dim)
+{
+	bound_lmult_ = Eigen::Map<const Eigen::VectorXd>(bound_lmult, decision_dim);
+	bound_umult_ = Eigen::Map<const Eigen::VectorXd>(bound_umult, decision_dim);
+	constraint_mult_ = Eigen::Map<const Eigen::VectorXd>(constraint_mult, constraint_dim);
+}
+
+
+bool OptimizationModel::requiresInitialization()
+{
+	return true;
+}
+
+
+bool OptimizationModel::getStageStructure(unsigned int& num_stages,
+										  unsigned int& stage_dim,
+										  unsigned int& stage_constraint_dim)
+{
+	return false;
+}
+
+
 void OptimizationModel::evaluateBounds(double* decision_lbound, int decision_dim1,
 									   double* decision_ubound, int decision_dim2,
 									   double* constraint_lbound, int constraint_dim1,
@@ -106,35 +155,80 @@ void OptimizationModel::evaluateCosts(double& cost,
 }
 
 
+void OptimizationModel::evaluateCostsBatch(Eigen::VectorXd& costs,
+										   Eigen::VectorXd& penalties,
+										   const Eigen::MatrixXd& candidates,
+										   bool with_penalties)
+{
+	unsigned int num_candidates = candidates.cols();
+	unsigned int decision_dim = candidates.rows();
+	costs.resize(num_candidates);
+	penalties.setZero(num_candidates);
+	for (unsigned int i = 0; i < num_candidates; i++) {
+		evaluateCosts(costs(i), candidates.col(i).data(), decision_dim);
+		if (with_penalties && constraint_dimension_ > 0)
+			penalties(i) = evaluateAsSoftConstraints(candidates.col(i).data(), decision_dim);
+	}
+}
+
+
 void OptimizationModel::evaluateCostGradient(double* gradient, int grad_dim,
 											 const double* decision, int decision_dim)
 {
-	// Indicates that the gradient is computed using numerical differenciation
+	// Indicates that the gradient is computed using numerical differenciation. Note that the
+	// solvers probe it without a decision vector
 	gradient_ = false;
+	if (decision == NULL)
+		return;
 
 	// Eigen interfacing to raw buffers
 	Eigen::Map<Eigen::VectorXd> full_gradient(gradient, grad_dim);
 	const Eigen::Map<const Eigen::VectorXd> decision_var(decision, decision_dim);
 
-	Eigen::MatrixXd grad(1, decision_dim);
-
-	switch (num_diff_mode_) {
-		case Eigen::Forward: {
-			Eigen::NumericalDiff<CostFunction,Eigen::Forward> num_diff(cost_function_, epsilon_);
-			num_diff.df(decision_var, grad);
-			break;
-		} case Eigen::Central: {
-			Eigen::NumericalDiff<CostFunction,Eigen::Central> num_diff(cost_function_, epsilon_);
-			num_diff.df(decision_var, grad);
-			break;
-		} default: {
-			Eigen::NumericalDiff<CostFunction,Eigen::Central> num_diff(cost_function_, epsilon_);
-			num_diff.df(decision_var, grad);
-			break;
-		}
+	// Getting the steps of Eigen::NumericalDiff. The forward differences also need the cost of
+	// the decision vector
+	bool central = num_diff_mode_ != Eigen::Forward;
+	unsigned int num_steps = central ? 2 : 1;
+	Eigen::VectorXd costs, penalties;
+	double cost = 0.;
+	if (!central) {
+		Eigen::MatrixXd candidate = decision_var;
+		evaluateCostsBatch(costs, penalties, candidate, false);
+		cost = costs(0);
 	}
+	double eps = sqrt(std::max(epsilon_, Eigen::NumTraits<double>::epsilon()));
+
+	// Evaluating the batches of perturbed decision vectors in chunks of variables, so the
+	// memory of a batch is bounded for large problems
+	const int max_chunk_dim = 32;
+	int chunk_dim = std::min(decision_dim, max_chunk_dim);
+	Eigen::MatrixXd candidates;
+	Eigen::VectorXd steps(chunk_dim);
+	for (int first = 0; first < decision_dim; first += chunk_dim) {
+		int num_vars = std::min(chunk_dim, decision_dim - first);
+		candidates = decision_var.replicate(1, num_steps * num_vars);
+		for (int i = 0; i < num_vars; i++) {
+			int j = first + i;
+			steps(i) = eps * fabs(decision_var(j));
+			if (steps(i) == 0.)
+				steps(i) = eps;
+
+			if (central) {
+				candidates(j, 2 * i) += steps(i);
+				candidates(j, 2 * i + 1) -= steps(i);
+			} else
+				candidates(j, i) += steps(i);
+		}
 
-	full_gradient = grad;
+		// Evaluating the costs of the batch and computing the gradient
+		evaluateCostsBatch(costs, penalties, candidates, false);
+		for (int i = 0; i < num_vars; i++) {
+			if (central)
+				full_gradient(first + i) = (costs(2 * i) - costs(2 * i + 1)) / (2 * steps(i));
+			else
+				full_gradient(first + i) = (costs(i) - cost) / steps(i);
+		}
+	}
 }
 
 
@@ -295,5 +389,14 @@ bool OptimizationModel::isSoftConstraint()
 	return soft_constraints_;
 }
 
+
+void OptimizationModel::copyProperties(OptimizationModel* model) const
+{
+	model->epsilon_ = epsilon_;
+	model->soft_constraints_ = soft_constraints_;
+	model->num_diff_mode_ = num_diff_mode_;
+	model->soft_properties_ = soft_properties_;
+}
+
 } //@namespace model
 } //@namespace dwl
\ No newline at end of file
@@ -69,26 +69,6 @@ class OptimizationModel
 			int values() const { return m_values; }
 		};
 
-		/**
-		 * @brief Describes the cost function requires for computing numerical
-		 * differentiation (gradient computation) with Eigen
-		 */
-		struct CostFunction : Functor<double>
-		{
-			CostFunction(OptimizationModel* model) : Functor<double>(0, 0), model_(model) {}
-			int operator() (const Eigen::VectorXd& x, Eigen::VectorXd& f) const
-			{
-				f.resize(1);
-				double cost;
-				model_->evaluateCosts(cost, x.data(), x.size());
-				f(0) = cost;
-
-				return 0;
-			}
-
-			OptimizationModel* const model_;
-		};
-
 		/** @brief Constructor function */
 		OptimizationModel();
 
@@ -99,6 +79,15 @@ class OptimizationModel
 		 * vectors */
 		virtual void init(bool only_soft_constraints = false);
 
+		/**
+		 * @brief Clones the optimization model, i.e. its components and properties. The clones
+		 * are used for evaluating different decision vectors concurrently (e.g. the population
+		 * of an evolutionary solver), so they don't share any evaluation state. By default the
+		 * model cannot be cloned
+		 * @return The cloned model, or NULL if cloning isn't supported
+		 */
+		virtual OptimizationModel* clone() const;
+
 		/** @brief Sets the dimension of the decision variables, here called state */
 		void setDimensionOfState(unsigned int dim);
 
@@ -129,6 +118,51 @@ class OptimizationModel
 		 */
 		virtual void getStartingPoint(double* decision, int decision_dim);
 
+		/**
+		 * @brief Gets the starting point of the dual variables, which is the last dual solution
+		 * (see setDualSolution()) by default
+		 * @param double* Initial values for the lower bound multipliers, $z^L$
+		 * @param double* Initial values for the upper bound multipliers, $z^U$
+		 * @param int Number of decision variables (dimension of $x$)
+		 * @param double* Initial values for the constraint multipliers, $\lambda$
+		 * @param int Number of constraints (dimension of $g(x)$)
+		 * @return False if there isn't a dual solution of these dimensions
+		 */
+		virtual bool getStartingDualPoint(double* bound_lmult, double* bound_umult, int decision_dim,
+										  double* constraint_mult, int constraint_dim);
+
+		/**
+		 * @brief Sets the dual solution of the last computation, which is used for warm-starting
+		 * the next one
+		 * @param const double* Lower bound multipliers, $z^L$
+		 * @param const double* Upper bound multipliers, $z^U$
+		 * @param int Number of decision variables (dimension of $x$)
+		 * @param const double* Constraint multipliers, $\lambda$
+		 * @param int Number of constraints (dimension of $g(x)$)
+		 */
+		void setDualSolution(const double* bound_lmult, const double* bound_umult, int decision_dim,
+							 const double* constraint_mult, int constraint_dim);
+
+		/**
+		 * @brief Indicates if the model has to be initialized before a new computation, i.e. if
+		 * its structure could have changed. By default, it's initialized in every computation
+		 */
+		virtual bool requiresInitialization();
+
+		/**
+		 * @brief Gets the stage-wise structure of the problem, i.e. the decision variables are
+		 * split in stages of the same dimension, and the first constraints are split in stages
+		 * that only depend on the current and previous stages. The rest of constraints (terminal
+		 * constraints) only depend on the last stage. By default, the problem doesn't have it
+		 * @param unsigned int& Number of stages
+		 * @param unsigned int& Number of decision variables of every stage
+		 * @param unsigned int& Number of constraints of every stage
+		 * @return True if the problem has a stage-wise structure
+		 */
+		virtual bool getStageStructure(unsigned int& num_stages,
+									   unsigned int& stage_dim,
+									   unsigned int& stage_constraint_dim);
+
 		/**
 		 * @brief Abstract method for evaluating the bounds of the problem
 		 * @param double* Lower bounds $x^L$ for $x$
@@ -154,6 +188,23 @@ class OptimizationModel
 		virtual void evaluateCosts(double& cost,
 								   const double* decision, int decision_dim);
 
+		/**
+		 * @brief Evaluates the cost and soft-constraint penalty of a batch of decision vectors,
+		 * which share the structure of the problem (e.g. the population of an evolutionary
+		 * solver or the perturbations of a finite-difference gradient). By default, every
+		 * candidate is evaluated with evaluateCosts() and evaluateAsSoftConstraints(), so a model
+		 * could override it for vectorizing across the candidates and reusing their setup
+		 * @param Eigen::VectorXd& Cost values of the candidates
+		 * @param Eigen::VectorXd& Soft-constraint penalties of the candidates, which are zero
+		 * for problems without constraints or if they aren't required
+		 * @param const Eigen::MatrixXd& Decision vectors of the candidates (column-wise)
+		 * @param bool True for evaluating the soft-constraint penalties
+		 */
+		virtual void evaluateCostsBatch(Eigen::VectorXd& costs,
+										Eigen::VectorXd& penalties,
+										const Eigen::MatrixXd& candidates,
+										bool with_penalties = true);
+
 		/**
 		 * @brief Abstract method for evaluating the gradient of the cost function given a
 		 * current decision state
@@ -257,6 +308,13 @@ class OptimizationModel
 
 
 	protected:
+		/**
+		 * @brief Copies the soft-constraint and numerical differentiation properties to a
+		 * cloned model
+		 * @param OptimizationModel* Cloned model
+		 */
+		void copyProperties(OptimizationModel* model) const;
+
 		/**@brief The solution vector */
 		double* solution_;
 
@@ -272,6 +330,15 @@ class OptimizationModel
 		/** @brief Number of nonzero values of the Hessian */
 		unsigned int nonzero_hessian_;
 
+		/** @brief Machine epsilon constant which gives an upper bound on the relative error
+		    due to rounding in floating point arithmetic */
+		double epsilon_;
+
+		/** @brief Dual solution, i.e. the bound and constraint multipliers */
+		Eigen::VectorXd bound_lmult_;
+		Eigen::VectorXd bound_umult_;
+		Eigen::VectorXd constraint_mult_;
+
 
 	private:
 		/** @brief True if the gradient of the cost function is implemented */
@@ -291,16 +358,9 @@ class OptimizationModel
 
 		bool first_time_;
 
-		/** @brief Cost functor for numerical differentiation */
-		CostFunction cost_function_;
-
 		/** @brief Numerical differentiation mode */
 		Eigen::NumericalDiffMode num_diff_mode_;
 
-		/** @brief Machine epsilon constant which gives an upper bound on the relative error
-		    due to rounding in floating point arithmetic */
-		double epsilon_;
-
 		/** @brief Lower and upper bound of the constraints */
 		Eigen::VectorXd g_lbound_, g_ubound_;
 
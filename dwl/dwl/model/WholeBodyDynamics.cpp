@@ -7,6 +7,17 @@ namespace dwl
 namespace model
 {
 
+void InverseDynamicsWorkspace::resize(FloatingBaseSystem& system)
+{
+	unsigned int num_dof = system.getSystemDoF();
+	q.setZero(num_dof);
+	q_dot.setZero(num_dof);
+	q_ddot.setZero(num_dof);
+	tau.setZero(num_dof);
+	fext.assign(system.getRBDModel().mBodies.size(), SpatialVector_t::Zero());
+}
+
+
 WholeBodyDynamics::WholeBodyDynamics()
 {
 
@@ -47,6 +58,9 @@ void WholeBodyDynamics::modelFromURDFModel(const std::string& urdf_model,
 	// Setting up the size of the joint space inertia matrix
 	joint_inertia_mat_.resize(system_.getSystemDoF(), system_.getSystemDoF());
 	joint_inertia_mat_.setZero();
+
+	// Setting up the size of the inverse dynamics workspace
+	id_ws_.resize(system_);
 }
 
 
@@ -63,22 +77,24 @@ void WholeBodyDynamics::computeInverseDynamics(rbd::Vector6d& base_wrench,
 	// Setting the size of the joint forces vector
 	joint_forces.resize(system_.getJointDoF());
 
-	// Converting base and joint states to generalized joint states
-	Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-	Eigen::VectorXd q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
-	Eigen::VectorXd q_ddot = system_.toGeneralizedJointState(base_acc, joint_acc);
-	Eigen::VectorXd tau = Eigen::VectorXd::Zero(system_.getSystemDoF());
+	// Converting base and joint states to generalized joint states. Note
+	// that the workspace is already sized, so these copies don't allocate
+	id_ws_.q = system_.toGeneralizedJointState(base_pos, joint_pos);
+	id_ws_.q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
+	id_ws_.q_ddot = system_.toGeneralizedJointState(base_acc, joint_acc);
+	id_ws_.tau.setZero();
 
 	// Computing the applied external spatial forces for every body
-	std::vector<SpatialVector_t> fext;
-	convertAppliedExternalForces(fext, ext_force, q);
+	convertAppliedExternalForces(id_ws_.fext, ext_force, id_ws_.q);
 
 	// Computing the inverse dynamics with Recursive Newton-Euler Algorithm (RNEA)
-	RigidBodyDynamics::InverseDynamics(system_.getRBDModel(), q, q_dot, q_ddot, tau, &fext);
+	RigidBodyDynamics::InverseDynamics(system_.getRBDModel(),
+									   id_ws_.q, id_ws_.q_dot, id_ws_.q_ddot,
+									   id_ws_.tau, &id_ws_.fext);
 
 	// Converting the generalized joint forces to base wrench and joint forces
 	base_wrench.setZero();
-	system_.fromGeneralizedJointState(base_wrench, joint_forces, tau);
+	system_.fromGeneralizedJointState(base_wrench, joint_forces, id_ws_.tau);
 }
 
 
@@ -94,22 +110,23 @@ void WholeBodyDynamics::computeFloatingBaseInverseDynamics(rbd::Vector6d& base_a
 	// Setting the size of the joint forces vector
 	joint_forces.resize(system_.getJointDoF());
 
-	// Converting base and joint states to generalized joint states
-	Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-	Eigen::VectorXd q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
-	Eigen::VectorXd q_ddot = system_.toGeneralizedJointState(base_acc, joint_acc);
-	Eigen::VectorXd tau = Eigen::VectorXd::Zero(system_.getSystemDoF());
+	// Converting base and joint states to generalized joint states. Note
+	// that the workspace is already sized, so these copies don't allocate
+	id_ws_.q = system_.toGeneralizedJointState(base_pos, joint_pos);
+	id_ws_.q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
+	id_ws_.q_ddot = system_.toGeneralizedJointState(base_acc, joint_acc);
+	id_ws_.tau.setZero();
 
 	// Computing the applied external spatial forces for every body
-	std::vector<SpatialVector_t> fext;
-	convertAppliedExternalForces(fext, ext_force, q);
+	convertAppliedExternalForces(id_ws_.fext, ext_force, id_ws_.q);
 
 	// Computing the inverse dynamics with Recursive Newton-Euler Algorithm (RNEA)
 	if (system_.isFullyFloatingBase()) {
 		RigidBodyDynamics::Math::SpatialVector base_ddot =
 				RigidBodyDynamics::Math::SpatialVector(base_acc);
 		rbd::FloatingBaseInverseDynamics(system_.getRBDModel(),
-										 q, q_dot, q_ddot, base_ddot, tau, &fext);
+										 id_ws_.q, id_ws_.q_dot, id_ws_.q_ddot,
+										 base_ddot, id_ws_.tau, &id_ws_.fext);
 
 		// Converting the base acceleration
 		base_acc = base_ddot;
@@ -118,8 +135,8 @@ void WholeBodyDynamics::computeFloatingBaseInverseDynamics(rbd::Vector6d& base_a
 			RigidBodyDynamics::Math::SpatialVector base_ddot =
 					RigidBodyDynamics::Math::SpatialVector(base_acc);
 			rbd::FloatingBaseInverseDynamics(system_.getRBDModel(), 1,
-											q, q_dot, q_ddot, base_ddot,
-											tau, &fext);
+											id_ws_.q, id_ws_.q_dot, id_ws_.q_ddot,
+											base_ddot, id_ws_.tau, &id_ws_.fext);
 			base_acc = base_ddot;
 //			RigidBodyDynamics::InverseDynamics(system_.getRBDModel(), q, q_dot, q_ddot, tau, &fext);
 //			tau(0) = 0;
@@ -131,7 +148,7 @@ void WholeBodyDynamics::computeFloatingBaseInverseDynamics(rbd::Vector6d& base_a
 
 	// Converting the generalized joint forces to base wrench and joint forces
 	rbd::Vector6d base_wrench;
-	system_.fromGeneralizedJointState(base_wrench, joint_forces, tau);
+	system_.fromGeneralizedJointState(base_wrench, joint_forces, id_ws_.tau);
 }
 
 
@@ -243,15 +260,43 @@ void WholeBodyDynamics::computeContactForces(rbd::BodyVector6d& contact_forces,
 											 rbd::Vector6d& base_acc,
 											 Eigen::VectorXd& joint_acc,
 											 const rbd::BodySelector& contacts)
+{
+	// Computing the contact forces for the compiled set of contacts
+	kinematics_.compileBodySet(contact_set_, contacts);
+	computeContactForces(contact_for_, joint_forces,
+						 base_pos, joint_pos,
+						 base_vel, joint_vel,
+						 base_acc, joint_acc,
+						 contact_set_);
+
+	// Adding the contact forces in the set of external forces
+	unsigned int num_contacts = contact_set_.size();
+	for (unsigned int k = 0; k < num_contacts; ++k)
+		contact_forces[contact_set_.names[k]] = contact_for_.col(k);
+
+	// Adding the base reaction forces in the set of external forces
+	if (contact_for_.cols() > num_contacts)
+		contact_forces[system_.getRBDModel().GetBodyName(6)] =
+				contact_for_.col(num_contacts);
+}
+
+
+void WholeBodyDynamics::computeContactForces(Eigen::MatrixXd& contact_forces,
+											 Eigen::VectorXd& joint_forces,
+											 const rbd::Vector6d& base_pos,
+											 const Eigen::VectorXd& joint_pos,
+											 const rbd::Vector6d& base_vel,
+											 const Eigen::VectorXd& joint_vel,
+											 rbd::Vector6d& base_acc,
+											 Eigen::VectorXd& joint_acc,
+											 const rbd::BodySet& contacts)
 {
 	// Setting the size of the joint forces vector
 	joint_forces.resize(system_.getJointDoF());
 
-	// Computing the fixed-base jacobian and base contact jacobian. These
-	// jacobians are used for computing a consistent joint acceleration, and
-	// for mapping desired base wrench to joint forces
-	Eigen::MatrixXd full_jac;
-	kinematics_.computeJacobian(full_jac,
+	// Computing the contact jacobian. This jacobian is used for mapping
+	// desired base wrench to joint forces
+	kinematics_.computeJacobian(contact_jac_,
 								base_pos, joint_pos,
 								contacts, rbd::Linear);
 
@@ -259,8 +304,7 @@ void WholeBodyDynamics::computeContactForces(rbd::BodyVector6d& contact_forces,
 	// acceleration and contact definition. We assume that contacts are static,
 	// which it allows us to computed a consistent joint accelerations.
 	rbd::Vector6d base_feas_acc = rbd::Vector6d::Zero();
-	Eigen::VectorXd joint_feas_acc(system_.getJointDoF());
-	computeConstrainedConsistentAcceleration(base_feas_acc, joint_feas_acc,
+	computeConstrainedConsistentAcceleration(base_feas_acc, joint_feas_acc_,
 											 base_pos, joint_pos,
 											 base_vel, joint_vel,
 											 base_acc, joint_acc,
@@ -272,15 +316,24 @@ void WholeBodyDynamics::computeContactForces(rbd::BodyVector6d& contact_forces,
 	computeInverseDynamics(base_wrench, joint_forces,
 						   base_pos, joint_pos,
 						   base_vel, joint_vel,
-						   base_feas_acc, joint_feas_acc);
+						   base_feas_acc, joint_feas_acc_);
 
 	// Rewriting the base and joint acceleration
 	base_acc = base_feas_acc;
-	joint_acc = joint_feas_acc;
+	joint_acc = joint_feas_acc_;
 
 	// Computing the base contribution of contact jacobian
-	Eigen::MatrixXd base_contact_jac;
-	kinematics_.getFloatingBaseJacobian(base_contact_jac, full_jac);
+	kinematics_.getFloatingBaseJacobian(base_contact_jac_, contact_jac_);
+
+	// Setting the size of the contact forces matrix. Constrained
+	// floating-base robots have an extra column for the base constraint forces
+	unsigned int num_contacts = contacts.size();
+	bool base_constraint =
+			system_.isFullyFloatingBase() && system_.isConstrainedFloatingBaseRobot();
+	unsigned int num_cols = base_constraint ? num_contacts + 1 : num_contacts;
+	if (contact_forces.rows() != 6 || contact_forces.cols() != num_cols)
+		contact_forces.resize(6, num_cols);
+	contact_forces.setZero();
 
 	// Computing the contact forces that generates the desired base wrench. A
 	// floating-base system can be described as floating-base with or without
@@ -291,75 +344,88 @@ void WholeBodyDynamics::computeContactForces(rbd::BodyVector6d& contact_forces,
 		// This approach builds an augmented jacobian matrix as [base contact
 		// jacobian; base constraint jacobian]. Therefore, we compute
 		// constrained reaction forces in the base.
+		unsigned int num_rows = base_contact_jac_.rows();
 		if (system_.isConstrainedFloatingBaseRobot()) {
-			// Computing the base constraint contribution to the jacobian
-			Eigen::MatrixXd base_constraint_jac = Eigen::MatrixXd::Zero(6,6);
+			// Computing the transpose of the augmented jacobian
+			// [base contact jacobian; base constraint jacobian], where the
+			// base constraint contribution is diagonal
+			if (contact_map_.rows() != 6 || contact_map_.cols() != num_rows + 6)
+				contact_map_.resize(6, num_rows + 6);
+			contact_map_.leftCols(num_rows) = base_contact_jac_.transpose();
+			contact_map_.rightCols<6>().setZero();
 			for (unsigned int base_idx = 0; base_idx < 6; base_idx++) {
 				rbd::Coords6d base_coord = rbd::Coords6d(base_idx);
 				FloatingBaseJoint base_joint =
 						system_.getFloatingBaseJoint(base_coord);
 
-				base_constraint_jac(base_coord, base_coord) = !base_joint.constrained;
+				contact_map_(base_coord, num_rows + base_coord) = !base_joint.constrained;
 			}
 
-			// Computing the augmented jacobian
-			// [base contact jacobian; base constraint jacobian]
-			Eigen::MatrixXd augmented_jac =
-					Eigen::MatrixXd::Zero(base_contact_jac.rows() + 6,
-										  base_contact_jac.cols());
-			augmented_jac.block(0, 0, base_contact_jac.rows(), base_contact_jac.cols()) = base_contact_jac;
-			augmented_jac.block<6,6>(base_contact_jac.rows(), 0) = base_constraint_jac;
-
 			// Computing the external forces from the augmented forces
 			// [contact forces; base constraint forces]
-			Eigen::VectorXd augmented_forces =
-					math::pseudoInverse((Eigen::MatrixXd) augmented_jac.transpose()) * base_wrench;
-
-			// Adding the base reaction forces in the set of external forces
-			contact_forces[system_.getRBDModel().GetBodyName(6)] =
-					augmented_forces.tail<6>();
+			computeMinimumNormSolution(contact_sol_, contact_svd_, contact_map_, base_wrench);
 
-			// Adding the contact forces in the set of external forces
-			unsigned int num_active_contacts = contacts.size();
-			for (unsigned int i = 0; i < num_active_contacts; i++)
-				contact_forces[contacts[i]] << 0., 0., 0., augmented_forces.segment<3>(3 * i);
+			// Adding the base reaction forces in the last column
+			contact_forces.col(num_contacts) = contact_sol_.tail<6>();
 		} else {
 			// This is a floating-base without physical constraints. So, we
 			// don't need to augment the jacobian
 			// Computing the external forces from contact forces
-			Eigen::VectorXd endeffector_forces =
-					math::pseudoInverse((Eigen::MatrixXd) base_contact_jac.transpose()) * base_wrench;
-
-			// Adding the contact forces in the set of external forces
-			unsigned int num_active_contacts = contacts.size();
-			for (unsigned int i = 0; i < num_active_contacts; i++)
-				contact_forces[contacts[i]] << 0., 0., 0., endeffector_forces.segment<3>(3 * i);
+			contact_map_ = base_contact_jac_.transpose();
+			computeMinimumNormSolution(contact_sol_, contact_svd_, contact_map_, base_wrench);
 		}
+
+		// Adding the contact forces
+		for (unsigned int k = 0; k < num_contacts; k++)
+			contact_forces.block<3,1>(rbd::LX,k) = contact_sol_.segment<3>(3 * k);
 	} else if (system_.isVirtualFloatingBaseRobot()) {
 		// This is n-dimensional floating-base system. So, we need to compute
 		// a virtual base wrench
-		Eigen::VectorXd virtual_base_wrench =
-				Eigen::VectorXd::Zero(system_.getFloatingBaseDoF());
+		contact_wrench_.setZero(system_.getFloatingBaseDoF());
 		for (unsigned int base_idx = 0; base_idx < 6; base_idx++) {
 			rbd::Coords6d base_coord = rbd::Coords6d(base_idx);
 			FloatingBaseJoint base_joint = system_.getFloatingBaseJoint(base_coord);
 
 			if (base_joint.active)
-				virtual_base_wrench(base_joint.id) = base_wrench(base_coord);
+				contact_wrench_(base_joint.id) = base_wrench(base_coord);
 		}
 
 		// Computing the contact forces that generates the desired base wrench
 		// in the case of n dof floating-base, where n is less than 6. Note
 		// that we describe this floating-base as an under-actuated virtual
 		// floating-base joints
-		Eigen::VectorXd endeffector_forces =
-				math::pseudoInverse((Eigen::MatrixXd) base_contact_jac.transpose()) * virtual_base_wrench;
+		contact_map_ = base_contact_jac_.transpose();
+		computeMinimumNormSolution(contact_sol_, contact_svd_,
+								   contact_map_, contact_wrench_);
+
+		// Adding the contact forces
+		for (unsigned int k = 0; k < num_contacts; k++)
+			contact_forces.block<3,1>(rbd::LX,k) = contact_sol_.segment<3>(3 * k);
+	}
+}
+
 
-		// Adding the contact forces in the set of external forces
-		unsigned int num_active_contacts = contacts.size();
-		for (unsigned int i = 0; i < num_active_contacts; i++)
-			contact_forces[contacts[i]] << 0., 0., 0., endeffector_forces.segment<3>(3 * i);
+void WholeBodyDynamics::computeMinimumNormSolution(Eigen::VectorXd& solution,
+												   Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
+												   const Eigen::MatrixXd& matrix,
+												   const Eigen::Ref<const Eigen::VectorXd>& vector)
+{
+	// Computing the minimum-norm solution as in math::pseudoInverse, i.e.
+	// x = V * S^-1 * U^T * b. The decomposition reuses its workspace, and
+	// the buffer of the singular values is on the stack
+	svd.compute(matrix, Eigen::ComputeThinU | Eigen::ComputeThinV);
+
+	const Eigen::VectorXd& singular_values = svd.singularValues();
+	Eigen::Matrix<double,Eigen::Dynamic,1,0,6,1> buffer(singular_values.size());
+	buffer.noalias() = svd.matrixU().transpose() * vector;
+	for (unsigned int i = 0; i < singular_values.size(); i++) {
+		if (singular_values(i) > 1E-9)
+			buffer(i) /= singular_values(i);
+		else
+			buffer(i) = 0.;
 	}
+
+	solution.noalias() = svd.matrixV() * buffer;
 }
 
 
@@ -706,48 +772,46 @@ void WholeBodyDynamics::convertAppliedExternalForces(std::vector<RigidBodyDynami
 													 const rbd::BodyVector6d& ext_force,
 													 const Eigen::VectorXd& q)
 {
-	// Computing the applied external spatial forces for every body
+	// Resetting the applied external spatial forces for every body. Note that
+	// the vector is only resized if it doesn't match the number of bodies
 	fext.resize(system_.getRBDModel().mBodies.size());
-	// Searching over the movable bodies
-	for (unsigned int body_id = 0;
-			body_id < system_.getRBDModel().mBodies.size(); body_id++) {
-		std::string body_name = system_.getRBDModel().GetBodyName(body_id);
-
-		if (ext_force.count(body_name) > 0) {
-			// Converting the applied force to spatial force vector in
-			// base coordinates
-			rbd::Vector6d force = ext_force.at(body_name);
-			Eigen::Vector3d force_point =
-					CalcBodyToBaseCoordinates(system_.getRBDModel(),
-											  q, body_id,
-											  Eigen::Vector3d::Zero(), true);
-			rbd::Vector6d spatial_force =
-					rbd::convertPointForceToSpatialForce(force, force_point);
-
-			fext.at(body_id) = spatial_force;
-		} else
-			fext.at(body_id) = rbd::Vector6d::Zero();
-	}
+	for (unsigned int body_id = 0; body_id < fext.size(); body_id++)
+		fext[body_id].setZero();
 
-	// Searching over the fixed bodies
-	for (unsigned int it = 0; it < system_.getRBDModel().mFixedBodies.size(); it++) {
-		unsigned int body_id = it + system_.getRBDModel().fixed_body_discriminator;
-		std::string body_name = system_.getRBDModel().GetBodyName(body_id);
-
-		if (ext_force.count(body_name) > 0) {
-			// Converting the applied force to spatial force vector in
-			// base coordinates
-			rbd::Vector6d force = ext_force.at(body_name);
-			Eigen::Vector3d force_point =
-					CalcBodyToBaseCoordinates(system_.getRBDModel(),
-											  q, body_id,
-											  Eigen::Vector3d::Zero(), true);
-			rbd::Vector6d spatial_force =
-					rbd::convertPointForceToSpatialForce(force, force_point);
-
-			unsigned parent_id = system_.getRBDModel().mFixedBodies[it].mMovableParent;
-			fext.at(parent_id) += spatial_force;
-		}
+	if (ext_force.empty())
+		return;
+
+	// Updating the body positions once for all the applied forces
+	RigidBodyDynamics::UpdateKinematicsCustom(system_.getRBDModel(), &q, NULL, NULL);
+
+	// Searching over the applied forces
+	for (rbd::BodyVector6d::const_iterator force_it = ext_force.begin();
+			force_it != ext_force.end(); force_it++) {
+		rbd::BodyID::const_iterator body_it = body_id_.find(force_it->first);
+		if (body_it == body_id_.end())
+			continue;
+
+		// Converting the applied force to spatial force vector in
+		// base coordinates
+		unsigned int body_id = body_it->second;
+		rbd::Vector6d force = force_it->second;
+		Eigen::Vector3d force_point =
+				CalcBodyToBaseCoordinates(system_.getRBDModel(),
+										  q, body_id,
+										  Eigen::Vector3d::Zero(), false);
+		rbd::Vector6d spatial_force =
+				rbd::convertPointForceToSpatialForce(force, force_point);
+
+		// The forces applied to fixed bodies are applied to their movable
+		// parents
+		if (system_.getRBDModel().IsFixedBodyId(body_id)) {
+			unsigned int fixed_idx =
+					body_id - system_.getRBDModel().fixed_body_discriminator;
+			unsigned int parent_id =
+					system_.getRBDModel().mFixedBodies[fixed_idx].mMovableParent;
+			fext[parent_id] += spatial_force;
+		} else
+			fext[body_id] += spatial_force;
 	}
 }
 
@@ -760,7 +824,7 @@ void WholeBodyDynamics::computeConstrainedConsistentAcceleration(rbd::Vector6d&
 																 const Eigen::VectorXd& joint_vel,
 																 const rbd::Vector6d& base_acc,
 																 const Eigen::VectorXd& joint_acc,
-																 const rbd::BodySelector& contacts)
+																 const rbd::BodySet& contacts)
 {
 	// Computing the consistent joint accelerations given a desired base
 	// acceleration and contact definition. We assume that contacts are static,
@@ -778,47 +842,43 @@ void WholeBodyDynamics::computeConstrainedConsistentAcceleration(rbd::Vector6d&
 	Eigen::Vector3d base_ang_acc = rbd::angularPart(base_des_acc);
 	Eigen::Vector3d base_lin_acc = rbd::linearPart(base_des_acc);
 
-	// Computing contact linear positions and the J_d*q_d component, which
-	// are used for computing the joint accelerations
-	rbd::BodyVectorXd op_pos, jacd_qd;
-	kinematics_.computeForwardKinematics(op_pos,
+	// Computing contact linear positions, the J_d*q_d component and the
+	// fixed-base jacobians of all the contacts, which are used for computing
+	// the joint accelerations
+	kinematics_.computeForwardKinematics(contact_pos_,
 										 base_pos, joint_pos,
 										 contacts, rbd::Linear);
-	kinematics_.computeJdotQdot(jacd_qd,
+	kinematics_.computeJdotQdot(contact_jacd_qd_,
 								base_pos, joint_pos,
 								base_vel, joint_vel,
 								contacts, rbd::Linear);
+	kinematics_.computeJacobian(fixed_contact_jac_,
+								rbd::Vector6d::Zero(), joint_pos,
+								contacts, rbd::Linear);
 
 	// Computing the consistent joint acceleration given a base state
-	for (rbd::BodySelector::const_iterator contact_iter = contacts.begin();
-			contact_iter != contacts.end();
-			contact_iter++)
-	{
-		std::string contact_name = *contact_iter;
-		if (body_id_.count(contact_name) > 0) {
-			Eigen::Vector3d contact_pos = op_pos[contact_name];
-
-			// Computing the desired contact velocity
-			Eigen::Vector3d contact_vel =
-					-base_lin_vel - base_ang_vel.cross(contact_pos);
-			Eigen::Vector3d contact_acc =
-					-base_lin_acc - base_ang_acc.cross(contact_pos) -
-					base_ang_vel.cross(contact_pos) - 2 * base_ang_vel.cross(contact_vel);
-
-			// Computing the fixed-base jacobian
-			Eigen::MatrixXd fixed_jac;
-			kinematics_.computeFixedJacobian(fixed_jac,
-											 joint_pos,
-											 contact_name, rbd::Linear);
-
-			// Computing the join acceleration from x_dd = J*q_dd + J_d*q_d
-			// since we are doing computation in the base frame
-			Eigen::VectorXd q_dd =
-					math::pseudoInverse(fixed_jac) * (contact_acc - jacd_qd[contact_name]);
-
-			// Setting up the branch joint acceleration
-			system_.setBranchState(joint_feas_acc, q_dd, contact_name);
-		}
+	unsigned int base_dof = system_.getSystemDoF() - system_.getJointDoF();
+	for (unsigned int k = 0; k < contacts.size(); ++k) {
+		Eigen::Vector3d contact_pos = contact_pos_.col(k);
+
+		// Computing the desired contact velocity
+		Eigen::Vector3d contact_vel =
+				-base_lin_vel - base_ang_vel.cross(contact_pos);
+		Eigen::Vector3d contact_acc =
+				-base_lin_acc - base_ang_acc.cross(contact_pos) -
+				base_ang_vel.cross(contact_pos) - 2 * base_ang_vel.cross(contact_vel);
+
+		// Getting the fixed-base jacobian of the contact branch
+		unsigned int branch_idx = contacts.branch_idx[k];
+		unsigned int num_dof = contacts.branch_dof[k];
+		branch_jac_ = fixed_contact_jac_.block(3 * k, base_dof + branch_idx, 3, num_dof);
+
+		// Computing the join acceleration from x_dd = J*q_dd + J_d*q_d
+		// since we are doing computation in the base frame, and setting up
+		// the branch joint acceleration
+		contact_acc -= contact_jacd_qd_.col(k);
+		computeMinimumNormSolution(branch_acc_, branch_svd_, branch_jac_, contact_acc);
+		joint_feas_acc.segment(branch_idx, num_dof) = branch_acc_;
 	}
 }
 
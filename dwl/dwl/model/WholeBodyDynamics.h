@@ -12,6 +12,26 @@ namespace dwl
 namespace model
 {
 
+/**
+ * @brief Defines the workspace of the inverse dynamics routines. It holds
+ * every temporary of the computation and it's sized once from the
+ * floating-base system, so the inverse dynamics doesn't allocate memory after
+ * the model is loaded
+ */
+struct InverseDynamicsWorkspace {
+	/** @brief Sizes the workspace given a floating-base system */
+	void resize(FloatingBaseSystem& system);
+
+	/** @brief Generalized joint states and forces */
+	Eigen::VectorXd q;
+	Eigen::VectorXd q_dot;
+	Eigen::VectorXd q_ddot;
+	Eigen::VectorXd tau;
+
+	/** @brief Applied external spatial forces of every body */
+	std::vector<SpatialVector_t> fext;
+};
+
 /**
  * @class WholeBodyDynamics
  * @brief WholeBodyDynamics class implements the dynamics methods for a
@@ -194,6 +214,35 @@ class WholeBodyDynamics
 								  Eigen::VectorXd& joint_acc,
 								  const rbd::BodySelector& contacts);
 
+		/**
+		 * @brief Computes the contact forces that generates the desired base
+		 * wrench for a compiled set of contacts. The contact forces are
+		 * written in a caller-owned buffer in which the k-th column is the
+		 * wrench of the k-th contact of the set. For constrained
+		 * floating-base robots, an extra last column describes the base
+		 * constraint forces
+		 * @param Eigen::MatrixXd& Contact forces (one column per contact)
+		 * @param Eigen::VectorXd& Joint forces
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::Vector6d& Base velocity
+		 * @param const Eigen::VectorXd& Joint velocity
+		 * @param const rbd::Vector6d& Base acceleration with respect to a
+		 * gravity field
+		 * @param const Eigen::VectorXd& Joint acceleration
+		 * @param const rbd::BodySet& Compiled set of bodies that are
+		 * constrained to be in contact
+		 */
+		void computeContactForces(Eigen::MatrixXd& contact_forces,
+								  Eigen::VectorXd& joint_forces,
+								  const rbd::Vector6d& base_pos,
+								  const Eigen::VectorXd& joint_pos,
+								  const rbd::Vector6d& base_vel,
+								  const Eigen::VectorXd& joint_vel,
+								  rbd::Vector6d& base_acc,
+								  Eigen::VectorXd& joint_acc,
+								  const rbd::BodySet& contacts);
+
 		/**
 		 * @brief Computes the contact forces by comparing the estimated joint
 		 * forces with the measured of the joint forces in a selected set of
@@ -367,7 +416,9 @@ class WholeBodyDynamics
 
 	private:
 		/**
-		 * @brief Converts the applied external forces to RBDL format
+		 * @brief Converts the applied external forces to RBDL format. The
+		 * kinematic tree is updated once for all the applied forces, and the
+		 * external forces vector is only resized if the model changes
 		 * @param std::vector<RigidBodyDynamcis::Math::SpatialVector>& RBDL
 		 * external forces format
 		 * @param const rbd::BodyWrench& External forces
@@ -389,8 +440,8 @@ class WholeBodyDynamics
 		 * @param const rbd::Vector6d& Base acceleration with respect to a
 		 * gravity field
 		 * @param const Eigen::VectorXd& Joint acceleration
-		 * @param const rbd::BodySelector& Bodies that are constrained to be
-		 * in contact
+		 * @param const rbd::BodySet& Compiled set of bodies that are
+		 * constrained to be in contact
 		 */
 		void computeConstrainedConsistentAcceleration(rbd::Vector6d& base_feas_acc,
 													  Eigen::VectorXd& joint_feas_acc,
@@ -400,7 +451,21 @@ class WholeBodyDynamics
 													  const Eigen::VectorXd& joint_vel,
 													  const rbd::Vector6d& base_acc,
 													  const Eigen::VectorXd& joint_acc,
-													  const rbd::BodySelector& contacts);
+													  const rbd::BodySet& contacts);
+
+		/**
+		 * @brief Computes the minimum-norm solution of A x = b, i.e. the
+		 * pseudo-inverse solution, without allocating memory once the sizes
+		 * are set. The smallest dimension of A cannot be bigger than 6
+		 * @param Eigen::VectorXd& Solution x
+		 * @param Eigen::JacobiSVD<Eigen::MatrixXd>& SVD workspace
+		 * @param const Eigen::MatrixXd& Matrix A
+		 * @param const Eigen::Ref<const Eigen::VectorXd>& Vector b
+		 */
+		void computeMinimumNormSolution(Eigen::VectorXd& solution,
+										Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
+										const Eigen::MatrixXd& matrix,
+										const Eigen::Ref<const Eigen::VectorXd>& vector);
 
 		/* @brief Body ids */
 		rbd::BodyID body_id_;
@@ -419,6 +484,29 @@ class WholeBodyDynamics
 
 		/** @brief The centroidal inertia matrix */
 		rbd::Matrix6d com_inertia_mat_;
+
+		/** @brief Workspace of the inverse dynamics routines */
+		InverseDynamicsWorkspace id_ws_;
+
+		/** @brief Buffers used by the contact forces computation */
+		rbd::BodySet contact_set_;
+		Eigen::MatrixXd contact_for_;
+		Eigen::MatrixXd contact_jac_;
+		Eigen::MatrixXd base_contact_jac_;
+		Eigen::MatrixXd fixed_contact_jac_;
+		Eigen::MatrixXd contact_pos_;
+		Eigen::MatrixXd contact_jacd_qd_;
+		Eigen::VectorXd joint_feas_acc_;
+
+		/** @brief Workspaces of the minimum-norm solutions of the contact
+		 * forces and branch accelerations */
+		Eigen::JacobiSVD<Eigen::MatrixXd> contact_svd_;
+		Eigen::MatrixXd contact_map_;
+		Eigen::VectorXd contact_wrench_;
+		Eigen::VectorXd contact_sol_;
+		Eigen::JacobiSVD<Eigen::MatrixXd> branch_svd_;
+		Eigen::MatrixXd branch_jac_;
+		Eigen::VectorXd branch_acc_;
 };
 
 } //@namespace model
@@ -42,17 +42,34 @@ void WholeBodyKinematics::modelFromURDFModel(const std::string& urdf_model,
 	if (info)
 		rbd::printModelInfo(system_.getRBDModel());
 
-	// Computing the middle value for IK routines
-	joint_pos_middle_ = Eigen::VectorXd::Zero(system_.getJointDoF());
-	urdf_model::JointLimits joint_limits = system_.getJointLimits();
-	for (urdf_model::JointLimits::iterator it = joint_limits.begin();
+	// Computing the middle value and the joint limits for IK routines. Note
+	// that the joints without limits are boundless
+	unsigned int joint_dof = system_.getJointDoF();
+	joint_pos_middle_ = Eigen::VectorXd::Zero(joint_dof);
+	joint_lower_limit_ = -std::numeric_limits<double>::infinity() *
+			Eigen::VectorXd::Ones(joint_dof);
+	joint_upper_limit_ = std::numeric_limits<double>::infinity() *
+			Eigen::VectorXd::Ones(joint_dof);
+	const urdf_model::JointLimits& joint_limits = system_.getJointLimits();
+	for (urdf_model::JointLimits::const_iterator it = joint_limits.begin();
 			it != joint_limits.end(); ++it) {
-		std::string name = it->first;
+		unsigned int id = system_.getJointId(it->first);
 		double lower_limit = it->second.lower;
 		double upper_limit = it->second.upper;
 
-		joint_pos_middle_(system_.getJointId(name)) = (upper_limit + lower_limit) / 2;
+		joint_pos_middle_(id) = (upper_limit + lower_limit) / 2;
+		joint_lower_limit_(id) = lower_limit;
+		joint_upper_limit_(id) = upper_limit;
 	}
+
+	// Setting up the size of the generalized states and point jacobian
+	q_.setZero(system_.getSystemDoF());
+	q_dot_.setZero(system_.getSystemDoF());
+	q_ddot_.setZero(system_.getSystemDoF());
+	point_jac_.setZero(6, system_.getSystemDoF());
+
+	// Building the IK solvers of the end-effector branches
+	resetBranchSolvers();
 }
 
 
@@ -63,6 +80,33 @@ void WholeBodyKinematics::setIKSolver(double step_tol,
 	step_tol_ = step_tol;
 	lambda_ = lambda;
 	max_iter_ = max_iter;
+	branch_kin_.setNewtonSolver(step_tol, lambda, max_iter);
+}
+
+
+void WholeBodyKinematics::compileBodySet(rbd::BodySet& body_set,
+										 const rbd::BodySelector& body_names) const
+{
+	body_set.names.clear();
+	body_set.ids.clear();
+	body_set.branch_idx.clear();
+	body_set.branch_dof.clear();
+
+	// Getting the base DoF for removing the base index of the branches
+	unsigned int base_dof = system_.getSystemDoF() - system_.getJointDoF();
+	for (unsigned int k = 0; k < body_names.size(); ++k) {
+		const std::string& body_name = body_names[k];
+		rbd::BodyID::const_iterator body_it = body_id_.find(body_name);
+		if (body_it != body_id_.end()) {
+			unsigned int q_index, num_dof;
+			system_.getBranch(q_index, num_dof, body_name);
+
+			body_set.names.push_back(body_name);
+			body_set.ids.push_back(body_it->second);
+			body_set.branch_idx.push_back(num_dof > 0 ? q_index - base_dof : 0);
+			body_set.branch_dof.push_back(num_dof);
+		}
+	}
 }
 
 
@@ -73,28 +117,88 @@ void WholeBodyKinematics::computeForwardKinematics(rbd::BodyVectorXd& op_pos,
 												   enum rbd::Component component,
 												   enum TypeOfOrientation type)
 {
-	// Resizing the position vector
-	int lin_vars = 0, ang_vars = 0;
-	switch(component) {
-	case rbd::Linear:
-		ang_vars = 0;
-		lin_vars = 3;
-		break;
-	case rbd::Angular:
-		switch (type) {
-		case RollPitchYaw:
-			ang_vars = 3;
-			break;
-		case Quaternion:
-			ang_vars = 4;
-			break;
-		case RotationMatrix:
-			ang_vars = 0;
-			break;
+	// Computing the forward kinematics of all the bodies in a single pass
+	compileBodySet(body_set_, body_set);
+	computeForwardKinematics(body_buffer_,
+							 base_pos, joint_pos,
+							 body_set_, component, type);
+
+	// Mapping the operational positions of the bodies
+	for (unsigned int k = 0; k < body_set_.size(); ++k)
+		op_pos[body_set_.names[k]] = body_buffer_.col(k);
+}
+
+
+void WholeBodyKinematics::computeForwardKinematics(Eigen::MatrixXd& op_pos,
+												   const rbd::Vector6d& base_pos,
+												   const Eigen::VectorXd& joint_pos,
+												   const rbd::BodySelector& body_set,
+												   enum rbd::Component component,
+												   enum TypeOfOrientation type)
+{
+	compileBodySet(body_set_, body_set);
+	computeForwardKinematics(op_pos,
+							 base_pos, joint_pos,
+							 body_set_, component, type);
+}
+
+
+void WholeBodyKinematics::computeForwardKinematics(Eigen::MatrixXd& op_pos,
+												   const rbd::Vector6d& base_pos,
+												   const Eigen::VectorXd& joint_pos,
+												   const rbd::BodySet& body_set,
+												   enum rbd::Component component,
+												   enum TypeOfOrientation type)
+{
+	// Resizing the position buffer only if it's needed
+	unsigned int num_vars = getPositionDimension(component, type);
+	unsigned int lin_idx = (component == rbd::Full) ? getPositionDimension(rbd::Angular, type) : 0;
+	if (op_pos.rows() != num_vars || op_pos.cols() != body_set.size())
+		op_pos.resize(num_vars, body_set.size());
+
+	// Updating the kinematic tree once for all the bodies
+	q_ = system_.toGeneralizedJointState(base_pos, joint_pos);
+	RigidBodyDynamics::UpdateKinematicsCustom(system_.getRBDModel(), &q_, NULL, NULL);
+
+	Eigen::Matrix3d rotation_mtx;
+	for (unsigned int k = 0; k < body_set.size(); ++k) {
+		unsigned int body_id = body_set.ids[k];
+
+		// Computing the angular component
+		if (component == rbd::Angular || component == rbd::Full) {
+			rotation_mtx =
+					RigidBodyDynamics::CalcBodyWorldOrientation(system_.getRBDModel(),
+																q_, body_id, false);
+			switch (type) {
+				case RollPitchYaw:
+					op_pos.block<3,1>(0,k) = math::getRPY(rotation_mtx);
+					break;
+				case Quaternion:
+					op_pos.block<4,1>(0,k) = math::getQuaternion(rotation_mtx).coeffs();
+					break;
+				case RotationMatrix:
+					break;
+			}
 		}
-		lin_vars = 0;
-		break;
-	case rbd::Full:
+
+		// Computing the linear component
+		if (component == rbd::Linear || component == rbd::Full) {
+			op_pos.block<3,1>(lin_idx,k) =
+					CalcBodyToBaseCoordinates(system_.getRBDModel(),
+											  q_, body_id,
+											  Eigen::Vector3d::Zero(), false);
+		}
+	}
+}
+
+
+unsigned int WholeBodyKinematics::getPositionDimension(enum rbd::Component component,
+													   enum TypeOfOrientation type) const
+{
+	unsigned int lin_vars = 0, ang_vars = 0;
+	if (component == rbd::Linear || component == rbd::Full)
+		lin_vars = 3;
+	if (component == rbd::Angular || component == rbd::Full) {
 		switch (type) {
 		case RollPitchYaw:
 			ang_vars = 3;
@@ -106,71 +210,9 @@ void WholeBodyKinematics::computeForwardKinematics(rbd::BodyVectorXd& op_pos,
 			ang_vars = 0;
 			break;
 		}
-		lin_vars = 3;
-		break;
 	}
 
-	Eigen::VectorXd body_pos(ang_vars + lin_vars);
-
-
-	for (rbd::BodySelector::const_iterator body_iter = body_set.begin();
-			body_iter != body_set.end();
-			body_iter++)
-	{
-		std::string body_name = *body_iter;
-		if (body_id_.count(body_name) > 0) {
-			unsigned int body_id = body_id_.find(body_name)->second;
-
-			Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-
-			Eigen::Matrix3d rotation_mtx;
-			switch (component) {
-			case rbd::Linear:
-				body_pos.segment<3>(0) =
-						CalcBodyToBaseCoordinates(system_.getRBDModel(),
-												  q, body_id,
-												  Eigen::Vector3d::Zero(), true);
-				break;
-			case rbd::Angular:
-				rotation_mtx =
-						RigidBodyDynamics::CalcBodyWorldOrientation(system_.getRBDModel(),
-																	q, body_id, false);
-				switch (type) {
-					case RollPitchYaw:
-						body_pos.segment<3>(0) = math::getRPY(rotation_mtx);
-						break;
-					case Quaternion:
-						body_pos.segment<4>(0) = math::getQuaternion(rotation_mtx).coeffs();
-						break;
-					case RotationMatrix:
-						break;
-				}
-				break;
-			case rbd::Full:
-				rotation_mtx = RigidBodyDynamics::CalcBodyWorldOrientation(system_.getRBDModel(),
-																		   q, body_id, false);
-				switch (type) {
-					case RollPitchYaw:
-						body_pos.segment<3>(0) = math::getRPY(rotation_mtx);
-						break;
-					case Quaternion:
-						body_pos.segment<4>(0) = math::getQuaternion(rotation_mtx).coeffs();
-						break;
-					case RotationMatrix:
-						break;
-				}
-
-				// Computing the linear component
-				body_pos.segment<3>(ang_vars) =
-						CalcBodyToBaseCoordinates(system_.getRBDModel(),
-												  q, body_id,
-												  Eigen::Vector3d::Zero(), true);
-				break;
-			}
-
-			op_pos[body_name] = body_pos;
-		}
-	}
+	return ang_vars + lin_vars;
 }
 
 
@@ -251,75 +293,188 @@ bool WholeBodyKinematics::computeJointPosition(Eigen::VectorXd& joint_pos,
 											   const rbd::BodyVector3d& op_pos,
 											   const Eigen::VectorXd& joint_pos_init)
 {
-	// Indicates if we manage to solve the IK problem
-	bool success = false;
-
 	// Setting up the guess point
 	joint_pos = joint_pos_init;
 
-	// Getting the end-effector names
+	// Getting the end-effector names and target positions
 	rbd::BodySelector body_names;
-	std::vector<Eigen::Vector3d> target_pos;
+	Eigen::Matrix3Xd target_pos(3, op_pos.size());
 	for (rbd::BodyVector3d::const_iterator contact_it = op_pos.begin();
 			contact_it != op_pos.end(); contact_it++) {
+		target_pos.col(body_names.size()) = contact_it->second;
 		body_names.push_back(contact_it->first);
-		target_pos.push_back(contact_it->second);
+	}
+
+	// Resolving the bodies once, and checking if they belong to different
+	// branches. In that case the fixed-base jacobian is block diagonal, and
+	// the damped least-squares step is solved per branch
+	compileBodySet(ik_set_, body_names);
+	if (ik_set_.size() != body_names.size()) {
+		printf(YELLOW_ "Warning: some bodies of the IK problem are not defined in the model\n"
+				COLOR_RESET);
+		return false;
+	}
+
+	bool decoupled = true;
+	unsigned int base_dof = system_.getSystemDoF() - system_.getJointDoF();
+	for (unsigned int k = 0; k < ik_set_.size() && decoupled; ++k) {
+		unsigned int k_idx = ik_set_.branch_idx[k];
+		unsigned int k_end = k_idx + ik_set_.branch_dof[k];
+		if (ik_set_.branch_dof[k] == 0)
+			decoupled = false;
+
+		for (unsigned int l = 0; l < k && decoupled; ++l) {
+			unsigned int l_idx = ik_set_.branch_idx[l];
+			unsigned int l_end = l_idx + ik_set_.branch_dof[l];
+			if (k_idx < l_end && l_idx < k_end)
+				decoupled = false;
+		}
+	}
+
+	// Solving every branch independently if all of them have a solver
+	unsigned int num_bodies = ik_set_.size();
+	bool branch_solvers = decoupled;
+	for (unsigned int f = 0; f < num_bodies && branch_solvers; ++f) {
+		if (branch_kin_.getTypeOfSolver(ik_set_.names[f]) == NoBranchSolver)
+			branch_solvers = false;
+	}
+
+	if (branch_solvers) {
+		bool success = true;
+		for (unsigned int f = 0; f < num_bodies; ++f) {
+			success = branch_kin_.computeJointPosition(joint_pos,
+													   ik_set_.names[f],
+													   target_pos.col(f),
+													   joint_pos_init) && success;
+		}
+
+		return success;
 	}
 
 	// Defining the residual error
-	Eigen::VectorXd e = Eigen::VectorXd::Zero(3 * body_names.size());
+	Eigen::VectorXd e = Eigen::VectorXd::Zero(3 * num_bodies);
 
 	// Iterating until a satisfied the desired tolerance or reach the maximum
 	// number of iterations
-	Eigen::MatrixXd full_jac, fixed_jac, JJTe_lambda2_I;
+	Eigen::MatrixXd fixed_jac, JJTe_lambda2_I;
+	Eigen::VectorXd z, delta_theta(joint_pos.size());
+	Eigen::Matrix3d branch_JJT;
+	double lambda2 = lambda_ * lambda_;
 	rbd::Vector6d base_pos = rbd::Vector6d::Zero();
 	for (unsigned int k = 0; k < max_iter_; ++k) {
-		// Computing the Jacobian
-		computeJacobian(full_jac, base_pos, joint_pos, body_names, rbd::Linear);
-		getFixedBaseJacobian(fixed_jac, full_jac);
-
-		// Computing the forward kinematics
-		rbd::BodyVectorXd fk_pos;
-		computeForwardKinematics(fk_pos, base_pos, joint_pos, body_names, rbd::Linear);
+		// Computing the Jacobian and forward kinematics
+		computeJacobian(ik_jac_, base_pos, joint_pos, ik_set_, rbd::Linear);
+		computeForwardKinematics(ik_pos_, base_pos, joint_pos, ik_set_, rbd::Linear);
 
 		// Computing the error
-		for (unsigned int f = 0; f < body_names.size(); ++f) {
-			e.segment<3>(3 * f) = target_pos[f] -
-					(Eigen::Vector3d) fk_pos.find(body_names[f])->second;
+		for (unsigned int f = 0; f < num_bodies; ++f)
+			e.segment<3>(3 * f) = target_pos.col(f) - ik_pos_.col(f);
+
+		if (decoupled) {
+			// Solving the damped least-squares step of every branch
+			delta_theta.setZero();
+			for (unsigned int f = 0; f < num_bodies; ++f) {
+				unsigned int idx = ik_set_.branch_idx[f];
+				unsigned int dof = ik_set_.branch_dof[f];
+				const Eigen::Block<Eigen::MatrixXd> branch_jac =
+						ik_jac_.block(3 * f, base_dof + idx, 3, dof);
+
+				branch_JJT = branch_jac * branch_jac.transpose();
+				branch_JJT.diagonal().array() += lambda2;
+				delta_theta.segment(idx, dof) =
+						branch_jac.transpose() * branch_JJT.ldlt().solve(e.segment<3>(3 * f));
+			}
+		} else {
+			// Computing the weighted fixed jacobian
+			getFixedBaseJacobian(fixed_jac, ik_jac_);
+			JJTe_lambda2_I = fixed_jac * fixed_jac.transpose() +
+					lambda2 * Eigen::MatrixXd::Identity(e.size(), e.size());
+
+			// Solving the linear system
+			math::GaussianEliminationPivot(z, JJTe_lambda2_I, e);
+			delta_theta = fixed_jac.transpose() * z;
 		}
+		joint_pos += delta_theta;
+
+		// Checking if the IK solution is in the joint limits
+		joint_pos = joint_pos.cwiseMax(joint_lower_limit_).cwiseMin(joint_upper_limit_);
 
-		// Computing the weighted fixed jacobian
-		JJTe_lambda2_I = fixed_jac * fixed_jac.transpose() +
-				lambda_ * lambda_ * Eigen::MatrixXd::Identity(e.size(), e.size());
+		if (delta_theta.norm() < step_tol_)
+			return true;
+	}
 
-		// Solving the linear system
-		Eigen::VectorXd z;
-		math::GaussianEliminationPivot(z, JJTe_lambda2_I, e);
+	return false;
+}
 
-		Eigen::VectorXd delta_theta = fixed_jac.transpose() * z; //math::pseudoInverse(fixed_jac) * e;
-		joint_pos = joint_pos + delta_theta;
 
-		// Checking if the IK solution is in the joint limits
-		dwl::urdf_model::JointLimits joint_limits = system_.getJointLimits();
-		for (dwl::urdf_model::JointLimits::iterator jnt_it = joint_limits.begin();
-				jnt_it != joint_limits.end(); ++jnt_it) {
-			std::string name = jnt_it->first;
-			urdf::JointLimits limits = jnt_it->second;
-			unsigned int id = system_.getJointId(name);
-
-			if (joint_pos(id) > limits.upper)
-				joint_pos(id) = limits.upper;
-			else if (joint_pos(id) < limits.lower)
-				joint_pos(id) = limits.lower;
-		}
+bool WholeBodyKinematics::setTypeOfBranchSolver(const std::string& body_name,
+												enum TypeOfBranchSolver solver)
+{
+	return branch_kin_.setTypeOfSolver(body_name, solver);
+}
+
 
-		if (delta_theta.norm() < step_tol_) {
-			success = true;
-			return success;
+enum TypeOfBranchSolver WholeBodyKinematics::getTypeOfBranchSolver(const std::string& body_name) const
+{
+	return branch_kin_.getTypeOfSolver(body_name);
+}
+
+
+void WholeBodyKinematics::resetBranchSolvers()
+{
+	branch_kin_.reset();
+	branch_kin_.setNewtonSolver(step_tol_, lambda_, max_iter_);
+
+	// Computing the jacobians and positions of the end-effectors in the zero
+	// posture, which describe the screws of the branch joints
+	rbd::BodySet end_effectors;
+	compileBodySet(end_effectors, system_.getEndEffectorNames());
+
+	unsigned int joint_dof = system_.getJointDoF();
+	unsigned int base_dof = system_.getSystemDoF() - joint_dof;
+	rbd::Vector6d base_pos = rbd::Vector6d::Zero();
+	Eigen::VectorXd joint_pos_ref = Eigen::VectorXd::Zero(joint_dof);
+	Eigen::MatrixXd full_jac, ref_pos;
+	computeJacobian(full_jac, base_pos, joint_pos_ref, end_effectors, rbd::Full);
+	computeForwardKinematics(ref_pos, base_pos, joint_pos_ref, end_effectors, rbd::Linear);
+
+	// Getting the end-effector positions of the postures used for checking
+	// the branch solvers
+	std::vector<Eigen::VectorXd> test_joint_pos(1, joint_pos_middle_);
+	if (system_.getDefaultPosture().size() == joint_dof)
+		test_joint_pos.push_back(system_.getDefaultPosture());
+
+	std::vector<Eigen::MatrixXd> test_pos(test_joint_pos.size());
+	for (unsigned int i = 0; i < test_joint_pos.size(); i++)
+		computeForwardKinematics(test_pos[i],
+								 base_pos, test_joint_pos[i],
+								 end_effectors, rbd::Linear);
+
+	for (unsigned int k = 0; k < end_effectors.size(); k++) {
+		const std::string& name = end_effectors.names[k];
+		unsigned int idx = end_effectors.branch_idx[k];
+		unsigned int dof = end_effectors.branch_dof[k];
+		enum TypeOfBranchSolver solver =
+				branch_kin_.addBranch(name, idx,
+									  full_jac.block(6 * k, base_dof + idx, 6, dof),
+									  ref_pos.col(k),
+									  joint_pos_ref.segment(idx, dof),
+									  joint_lower_limit_.segment(idx, dof),
+									  joint_upper_limit_.segment(idx, dof));
+		if (solver == NoBranchSolver)
+			continue;
+
+		Eigen::Vector3d branch_pos;
+		for (unsigned int i = 0; i < test_joint_pos.size(); i++) {
+			branch_kin_.computePosition(branch_pos, name, test_joint_pos[i]);
+			if ((branch_pos - test_pos[i].col(k)).norm() > 1e-6) {
+				printf(YELLOW_ "Warning: the branch solver of %s body doesn't match the "
+						"model\n" COLOR_RESET, name.c_str());
+				branch_kin_.removeBranch(name);
+				break;
+			}
 		}
 	}
-
-	return success;
 }
 
 
@@ -328,25 +483,27 @@ void WholeBodyKinematics::computeJointVelocity(Eigen::VectorXd& joint_vel,
 											   const rbd::BodyVectorXd& op_vel,
 											   const rbd::BodySelector& body_set)
 {
+	// Computing the jacobians of all the bodies in a single pass. The branch
+	// jacobians are blocks of it
+	compileBodySet(ik_set_, body_set);
+	computeJacobian(ik_jac_,
+					rbd::Vector6d::Zero(), joint_pos,
+					ik_set_, rbd::Linear);
+
 	// Computing the joint velocities per every body
-	for (unsigned int f = 0; f < body_set.size(); f++) {
-		std::string body_name = body_set[f];
+	unsigned int base_dof = system_.getSystemDoF() - system_.getJointDoF();
+	for (unsigned int f = 0; f < ik_set_.size(); f++) {
+		const std::string& body_name = ik_set_.names[f];
 
 		// Computing the joint velocity associated to the actual body
 		rbd::BodyVectorXd::const_iterator vel_it = op_vel.find(body_name);
 		if (vel_it != op_vel.end()) {
-			Eigen::VectorXd body_vel = vel_it->second;
-
-			// Computing the body jacobians
-			Eigen::MatrixXd branch_jac;
-			computeFixedJacobian(branch_jac, joint_pos, body_name, rbd::Linear);
+			unsigned int idx = ik_set_.branch_idx[f];
+			unsigned int dof = ik_set_.branch_dof[f];
+			Eigen::MatrixXd branch_jac = ik_jac_.block(3 * f, base_dof + idx, 3, dof);
 
-			// Computing the branch joint velocity
-			Eigen::VectorXd branch_joint_vel =
-					math::pseudoInverse(branch_jac) * body_vel;
-
-			// Setting up the branch joint velocity
-			system_.setBranchState(joint_vel, branch_joint_vel, body_name);
+			// Computing and setting up the branch joint velocity
+			joint_vel.segment(idx, dof) = math::pseudoInverse(branch_jac) * vel_it->second;
 		} else
 			printf(YELLOW_ "Warning: the operational velocity of %s body was "
 					"not defined\n" COLOR_RESET, body_name.c_str());
@@ -367,26 +524,28 @@ void WholeBodyKinematics::computeJointAcceleration(Eigen::VectorXd& joint_acc,
 					rbd::Vector6d::Zero(), joint_vel,
 					body_set, dwl::rbd::Linear);
 
+	// Computing the jacobians of all the bodies in a single pass. The branch
+	// jacobians are blocks of it
+	compileBodySet(ik_set_, body_set);
+	computeJacobian(ik_jac_,
+					rbd::Vector6d::Zero(), joint_pos,
+					ik_set_, rbd::Linear);
+
 	// Computing the joint accelerations per every body
-	for (unsigned int f = 0; f < body_set.size(); f++) {
-		std::string body_name = body_set[f];
+	unsigned int base_dof = system_.getSystemDoF() - system_.getJointDoF();
+	for (unsigned int f = 0; f < ik_set_.size(); f++) {
+		const std::string& body_name = ik_set_.names[f];
 
 		// Computing the joint acceleration associated to the actual body
 		rbd::BodyVectorXd::const_iterator acc_it = op_acc.find(body_name);
 		if (acc_it != op_acc.end()) {
-			Eigen::VectorXd body_acc = acc_it->second;
-
-			// Computing the body jacobians
-			Eigen::MatrixXd branch_jac;
-			computeFixedJacobian(branch_jac, joint_pos, body_name, rbd::Linear);
+			unsigned int idx = ik_set_.branch_idx[f];
+			unsigned int dof = ik_set_.branch_dof[f];
+			Eigen::MatrixXd branch_jac = ik_jac_.block(3 * f, base_dof + idx, 3, dof);
 
-			// Computing the branch joint acceleration
-			Eigen::VectorXd branch_joint_acc =
-					math::pseudoInverse(branch_jac) * (body_acc -
-							jacd_qd.find(body_name)->second);
-
-			// Setting up the branch joint velocity
-			system_.setBranchState(joint_acc, branch_joint_acc, body_name);
+			// Computing and setting up the branch joint acceleration
+			joint_acc.segment(idx, dof) = math::pseudoInverse(branch_jac) *
+					(acc_it->second - jacd_qd.find(body_name)->second);
 		} else
 			printf(YELLOW_ "Warning: the operational acceleration of %s body was "
 					"not defined\n" COLOR_RESET, body_name.c_str());
@@ -400,74 +559,57 @@ void WholeBodyKinematics::computeJacobian(Eigen::MatrixXd& jacobian,
 										  const rbd::BodySelector& body_set,
 										  enum rbd::Component component)
 {
-	// Resizing the jacobian matrix
-	int num_vars = 0;
-	switch (component) {
-	case rbd::Linear:
-		num_vars = 3;
-		break;
-	case rbd::Angular:
-		num_vars = 3;
-		break;
-	case rbd::Full:
-		num_vars = 6;
-		break;
-	}
-
-	// Computing the number of active end-effectors
-	int num_body_set = getNumberOfActiveEndEffectors(body_set);
-
-	jacobian.resize(num_vars * num_body_set, system_.getSystemDoF());
-	jacobian.setZero();
-
 	// Adding the jacobian only for the active end-effectors
-	int body_counter = 0;
-	for (rbd::BodySelector::const_iterator body_iter = body_set.begin();
-			body_iter != body_set.end();
-			body_iter++)
-	{
-		int init_row = body_counter * num_vars;
+	compileBodySet(body_set_, body_set);
+	computeJacobian(jacobian,
+					base_pos, joint_pos,
+					body_set_, component);
+}
 
-		std::string body_name = *body_iter;
-		if (body_id_.count(body_name) > 0) {
-			int body_id = body_id_.find(body_name)->second;
-
-			Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-
-			Eigen::MatrixXd jac(Eigen::MatrixXd::Zero(6, system_.getSystemDoF()));
-			if (body_counter == 0) {
-				rbd::computePointJacobian(system_.getRBDModel(),
-										  q, body_id,
-										  Eigen::Vector3d::Zero(),
-										  jac, true);
-			} else {
-				rbd::computePointJacobian(system_.getRBDModel(),
-										  q, body_id,
-										  Eigen::Vector3d::Zero(),
-										  jac, false);
-			}
-			if (system_.isFullyFloatingBase()) {
-				// RBDL defines floating joints as (linear, angular)^T which is
-				// not consistent with our DWL standard, i.e. (angular, linear)^T
-				Eigen::MatrixXd copy_jac = jac.block<6,6>(0,0);
-				jac.block<6,3>(0,0) = copy_jac.rightCols(3);
-				jac.block<6,3>(0,3) = copy_jac.leftCols(3);
-			}
 
-			switch(component) {
-			case rbd::Linear:
-				jacobian.block(init_row, 0, num_vars, system_.getSystemDoF()) =
-						jac.block(3, 0, 3, system_.getSystemDoF());
-				break;
-			case rbd::Angular:
-				jacobian.block(init_row, 0, num_vars, system_.getSystemDoF()) =
-						jac.block(0, 0, 3, system_.getSystemDoF());
-				break;
-			case rbd::Full:
-				jacobian.block(init_row, 0, num_vars, system_.getSystemDoF()) = jac;
-				break;
-			}
-			++body_counter;
+void WholeBodyKinematics::computeJacobian(Eigen::MatrixXd& jacobian,
+										  const rbd::Vector6d& base_pos,
+										  const Eigen::VectorXd& joint_pos,
+										  const rbd::BodySet& body_set,
+										  enum rbd::Component component)
+{
+	// Resizing the jacobian matrix only if it's needed
+	unsigned int num_vars = (component == rbd::Full) ? 6 : 3;
+	unsigned int num_dof = system_.getSystemDoF();
+	if (jacobian.rows() != num_vars * body_set.size() || jacobian.cols() != num_dof)
+		jacobian.resize(num_vars * body_set.size(), num_dof);
+
+	// Updating the kinematic tree once for all the bodies
+	q_ = system_.toGeneralizedJointState(base_pos, joint_pos);
+	RigidBodyDynamics::UpdateKinematicsCustom(system_.getRBDModel(), &q_, NULL, NULL);
+
+	rbd::Matrix6d base_jac;
+	for (unsigned int k = 0; k < body_set.size(); ++k) {
+		unsigned int init_row = k * num_vars;
+
+		point_jac_.setZero();
+		rbd::computePointJacobian(system_.getRBDModel(),
+								  q_, body_set.ids[k],
+								  Eigen::Vector3d::Zero(),
+								  point_jac_, false);
+		if (system_.isFullyFloatingBase()) {
+			// RBDL defines floating joints as (linear, angular)^T which is
+			// not consistent with our DWL standard, i.e. (angular, linear)^T
+			base_jac = point_jac_.leftCols<6>();
+			point_jac_.block<6,3>(0,0) = base_jac.rightCols<3>();
+			point_jac_.block<6,3>(0,3) = base_jac.leftCols<3>();
+		}
+
+		switch(component) {
+		case rbd::Linear:
+			jacobian.middleRows(init_row, num_vars) = point_jac_.bottomRows<3>();
+			break;
+		case rbd::Angular:
+			jacobian.middleRows(init_row, num_vars) = point_jac_.topRows<3>();
+			break;
+		case rbd::Full:
+			jacobian.middleRows(init_row, num_vars) = point_jac_;
+			break;
 		}
 	}
 }
@@ -551,52 +693,53 @@ void WholeBodyKinematics::computeVelocity(rbd::BodyVectorXd& op_vel,
 										  const rbd::BodySelector& body_set,
 										  enum rbd::Component component)
 {
-	// Resizing the velocity vector
-	int num_vars = 0;
-	switch (component) {
-	case rbd::Linear:
-		num_vars = 3;
-		break;
-	case rbd::Angular:
-		num_vars = 3;
-		break;
-	case rbd::Full:
-		num_vars = 6;
-		break;
-	}
-	Eigen::VectorXd body_vel(num_vars);
-
-
 	// Adding the velocity only for the active end-effectors
-	for (rbd::BodySelector::const_iterator body_iter = body_set.begin();
-			body_iter != body_set.end();
-			body_iter++)
-	{
-		std::string body_name = *body_iter;
-		if (body_id_.count(body_name) > 0) {
-			int body_id = body_id_.find(body_name)->second;
+	compileBodySet(body_set_, body_set);
+	computeVelocity(body_buffer_,
+					base_pos, joint_pos,
+					base_vel, joint_vel,
+					body_set_, component);
 
-			Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-			Eigen::VectorXd q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
+	for (unsigned int k = 0; k < body_set_.size(); ++k)
+		op_vel[body_set_.names[k]] = body_buffer_.col(k);
+}
 
-			// Computing the point velocity
-			rbd::Vector6d point_vel =
-					rbd::computePointVelocity(system_.getRBDModel(),
-											  q, q_dot, body_id,
-											  Eigen::Vector3d::Zero(), true);
-			switch (component) {
-			case rbd::Linear:
-				body_vel.segment<3>(0) = rbd::linearPart(point_vel);
-				break;
-			case rbd::Angular:
-				body_vel.segment<3>(0) = rbd::angularPart(point_vel);
-				break;
-			case rbd::Full:
-				body_vel.segment<6>(0) = point_vel;
-				break;
-			}
 
-			op_vel[body_name] = body_vel;
+void WholeBodyKinematics::computeVelocity(Eigen::MatrixXd& op_vel,
+										  const rbd::Vector6d& base_pos,
+										  const Eigen::VectorXd& joint_pos,
+										  const rbd::Vector6d& base_vel,
+										  const Eigen::VectorXd& joint_vel,
+										  const rbd::BodySet& body_set,
+										  enum rbd::Component component)
+{
+	// Resizing the velocity buffer only if it's needed
+	unsigned int num_vars = (component == rbd::Full) ? 6 : 3;
+	if (op_vel.rows() != num_vars || op_vel.cols() != body_set.size())
+		op_vel.resize(num_vars, body_set.size());
+
+	// Updating the kinematic tree once for all the bodies
+	q_ = system_.toGeneralizedJointState(base_pos, joint_pos);
+	q_dot_ = system_.toGeneralizedJointState(base_vel, joint_vel);
+	system_.getRBDModel().v[0].setZero();
+	RigidBodyDynamics::UpdateKinematicsCustom(system_.getRBDModel(), &q_, &q_dot_, NULL);
+
+	for (unsigned int k = 0; k < body_set.size(); ++k) {
+		// Computing the point velocity
+		rbd::Vector6d point_vel =
+				rbd::computePointVelocity(system_.getRBDModel(),
+										  q_, q_dot_, body_set.ids[k],
+										  Eigen::Vector3d::Zero(), false);
+		switch (component) {
+		case rbd::Linear:
+			op_vel.block<3,1>(0,k) = rbd::linearPart(point_vel);
+			break;
+		case rbd::Angular:
+			op_vel.block<3,1>(0,k) = rbd::angularPart(point_vel);
+			break;
+		case rbd::Full:
+			op_vel.col(k) = point_vel;
+			break;
 		}
 	}
 }
@@ -627,54 +770,59 @@ void WholeBodyKinematics::computeAcceleration(rbd::BodyVectorXd& op_acc,
 											  const rbd::BodySelector& body_set,
 											  enum rbd::Component component)
 {
-	// Resizing the velocity vector
-	int num_vars = 0;
-	switch (component) {
-	case rbd::Linear:
-		num_vars = 3;
-		break;
-	case rbd::Angular:
-		num_vars = 3;
-		break;
-	case rbd::Full:
-		num_vars = 6;
-		break;
-	}
+	// Adding the acceleration only for the active end-effectors
+	compileBodySet(body_set_, body_set);
+	computeAcceleration(body_buffer_,
+						base_pos, joint_pos,
+						base_vel, joint_vel,
+						base_acc, joint_acc,
+						body_set_, component);
 
-	Eigen::VectorXd body_acc(num_vars);
+	for (unsigned int k = 0; k < body_set_.size(); ++k)
+		op_acc[body_set_.names[k]] = body_buffer_.col(k);
+}
 
-	// Adding the velocity only for the active end-effectors
-	for (rbd::BodySelector::const_iterator body_iter = body_set.begin();
-			body_iter != body_set.end();
-			body_iter++)
-	{
-		std::string body_name = *body_iter;
-		if (body_id_.count(body_name) > 0) {
-			unsigned int body_id = body_id_.find(body_name)->second;
-
-			Eigen::VectorXd q = system_.toGeneralizedJointState(base_pos, joint_pos);
-			Eigen::VectorXd q_dot = system_.toGeneralizedJointState(base_vel, joint_vel);
-			Eigen::VectorXd q_ddot = system_.toGeneralizedJointState(base_acc, joint_acc);
-
-			// Computing the point acceleration
-			rbd::Vector6d point_acc =
-					rbd::computePointAcceleration(system_.getRBDModel(),
-												  q, q_dot, q_ddot,
-												  body_id,
-												  Eigen::Vector3d::Zero(), true);
-			switch (component) {
-			case rbd::Linear:
-				body_acc.segment<3>(0) = rbd::linearPart(point_acc);
-				break;
-			case rbd::Angular:
-				body_acc.segment<3>(0) = rbd::angularPart(point_acc);
-				break;
-			case rbd::Full:
-				body_acc.segment<6>(0) = point_acc;
-				break;
-			}
 
-			op_acc[body_name] = body_acc;
+void WholeBodyKinematics::computeAcceleration(Eigen::MatrixXd& op_acc,
+											  const rbd::Vector6d& base_pos,
+											  const Eigen::VectorXd& joint_pos,
+											  const rbd::Vector6d& base_vel,
+											  const Eigen::VectorXd& joint_vel,
+											  const rbd::Vector6d& base_acc,
+											  const Eigen::VectorXd& joint_acc,
+											  const rbd::BodySet& body_set,
+											  enum rbd::Component component)
+{
+	// Resizing the acceleration buffer only if it's needed
+	unsigned int num_vars = (component == rbd::Full) ? 6 : 3;
+	if (op_acc.rows() != num_vars || op_acc.cols() != body_set.size())
+		op_acc.resize(num_vars, body_set.size());
+
+	// Updating the kinematic tree once for all the bodies
+	q_ = system_.toGeneralizedJointState(base_pos, joint_pos);
+	q_dot_ = system_.toGeneralizedJointState(base_vel, joint_vel);
+	q_ddot_ = system_.toGeneralizedJointState(base_acc, joint_acc);
+	system_.getRBDModel().v[0].setZero();
+	system_.getRBDModel().a[0].setZero();
+	RigidBodyDynamics::UpdateKinematics(system_.getRBDModel(), q_, q_dot_, q_ddot_);
+
+	for (unsigned int k = 0; k < body_set.size(); ++k) {
+		// Computing the point acceleration
+		rbd::Vector6d point_acc =
+				rbd::computePointAcceleration(system_.getRBDModel(),
+											  q_, q_dot_, q_ddot_,
+											  body_set.ids[k],
+											  Eigen::Vector3d::Zero(), false);
+		switch (component) {
+		case rbd::Linear:
+			op_acc.block<3,1>(0,k) = rbd::linearPart(point_acc);
+			break;
+		case rbd::Angular:
+			op_acc.block<3,1>(0,k) = rbd::angularPart(point_acc);
+			break;
+		case rbd::Full:
+			op_acc.col(k) = point_acc;
+			break;
 		}
 	}
 }
@@ -707,77 +855,83 @@ void WholeBodyKinematics::computeJdotQdot(rbd::BodyVectorXd& jacd_qd,
 										  const rbd::BodySelector& body_set,
 										  enum rbd::Component component)
 {
-	rbd::BodyVectorXd op_vel, op_acc;
-	computeAcceleration(op_acc,
-						base_pos, joint_pos,
-						base_vel, joint_vel,
-						rbd::Vector6d::Zero(), Eigen::VectorXd::Zero(system_.getJointDoF()),
-						body_set, component);
-
-	// Resizing the acceleration contribution vector
-	int num_vars = 0;
-	switch (component) {
-	case rbd::Linear:
-		computeVelocity(op_vel,
-						base_pos, joint_pos,
-						base_vel, joint_vel,
-						body_set);
-		num_vars = 3;
-		break;
-	case rbd::Angular:
-		num_vars = 3;
-		break;
-	case rbd::Full:
-		computeVelocity(op_vel,
-						base_pos, joint_pos,
-						base_vel, joint_vel,
-						body_set);
-		num_vars = 6;
-		break;
-	}
+	compileBodySet(body_set_, body_set);
+	computeJdotQdot(body_buffer_,
+					base_pos, joint_pos,
+					base_vel, joint_vel,
+					body_set_, component);
 
-	Eigen::VectorXd body_jacd_qd(num_vars);
+	for (unsigned int k = 0; k < body_set_.size(); ++k)
+		jacd_qd[body_set_.names[k]] = body_buffer_.col(k);
+}
 
-	for (rbd::BodySelector::const_iterator body_iter = body_set.begin();
-			body_iter != body_set.end();
-			body_iter++)
-	{
-		std::string body_name = *body_iter;
-		if (body_id_.count(body_name) > 0) {
-			switch (component) {
-			case rbd::Linear: {
-				// Computing the point velocity and its angular and linear
-				// components
-				rbd::Vector6d point_vel = op_vel[body_name];
-				Eigen::Vector3d ang_vel, lin_vel;
-				ang_vel = rbd::angularPart(point_vel);
-				lin_vel = rbd::linearPart(point_vel);
-
-				// Computing the JdQd for current point
-				body_jacd_qd.segment<3>(0) =
-						op_acc[body_name] + ang_vel.cross(lin_vel);
-				break;
-			} case rbd::Angular: {
-				// Computing the JdQd for current point
-				body_jacd_qd.segment<3>(0) = op_acc[body_name];
-				break;
-			} case rbd::Full: {
-				// Computing the point velocity and its angular and linear
-				// components
-				rbd::Vector6d point_vel = op_vel[body_name];
-				Eigen::Vector3d ang_vel, lin_vel;
-				ang_vel = rbd::angularPart(point_vel);
-				lin_vel = rbd::linearPart(point_vel);
-
-				// Computing the JdQd for current point
-				rbd::Vector6d point_acc = op_acc[body_name];
-				body_jacd_qd.segment<3>(rbd::AX) = rbd::angularPart(point_acc);
-				body_jacd_qd.segment<3>(rbd::LX) =
-						rbd::linearPart(point_acc) + ang_vel.cross(lin_vel);
-				break;}
-			}
 
-			jacd_qd[body_name] = body_jacd_qd;
+void WholeBodyKinematics::computeJdotQdot(Eigen::MatrixXd& jacd_qd,
+										  const rbd::Vector6d& base_pos,
+										  const Eigen::VectorXd& joint_pos,
+										  const rbd::Vector6d& base_vel,
+										  const Eigen::VectorXd& joint_vel,
+										  const rbd::BodySet& body_set,
+										  enum rbd::Component component)
+{
+	// Resizing the acceleration contribution buffer only if it's needed
+	unsigned int num_vars = (component == rbd::Full) ? 6 : 3;
+	if (jacd_qd.rows() != num_vars || jacd_qd.cols() != body_set.size())
+		jacd_qd.resize(num_vars, body_set.size());
+
+	// Updating the kinematic tree once with zero generalized acceleration
+	q_ = system_.toGeneralizedJointState(base_pos, joint_pos);
+	q_dot_ = system_.toGeneralizedJointState(base_vel, joint_vel);
+	q_ddot_.setZero(system_.getSystemDoF());
+	system_.getRBDModel().v[0].setZero();
+	system_.getRBDModel().a[0].setZero();
+	RigidBodyDynamics::UpdateKinematics(system_.getRBDModel(), q_, q_dot_, q_ddot_);
+
+	Eigen::Vector3d ang_vel, lin_vel;
+	for (unsigned int k = 0; k < body_set.size(); ++k) {
+		unsigned int body_id = body_set.ids[k];
+
+		// Computing the point acceleration with zero joint acceleration
+		rbd::Vector6d point_acc =
+				rbd::computePointAcceleration(system_.getRBDModel(),
+											  q_, q_dot_, q_ddot_,
+											  body_id,
+											  Eigen::Vector3d::Zero(), false);
+
+		switch (component) {
+		case rbd::Linear: {
+			// Computing the point velocity and its angular and linear
+			// components
+			rbd::Vector6d point_vel =
+					rbd::computePointVelocity(system_.getRBDModel(),
+											  q_, q_dot_, body_id,
+											  Eigen::Vector3d::Zero(), false);
+			ang_vel = rbd::angularPart(point_vel);
+			lin_vel = rbd::linearPart(point_vel);
+
+			// Computing the JdQd for current point
+			jacd_qd.block<3,1>(0,k) =
+					rbd::linearPart(point_acc) + ang_vel.cross(lin_vel);
+			break;
+		} case rbd::Angular: {
+			// Computing the JdQd for current point
+			jacd_qd.block<3,1>(0,k) = rbd::angularPart(point_acc);
+			break;
+		} case rbd::Full: {
+			// Computing the point velocity and its angular and linear
+			// components
+			rbd::Vector6d point_vel =
+					rbd::computePointVelocity(system_.getRBDModel(),
+											  q_, q_dot_, body_id,
+											  Eigen::Vector3d::Zero(), false);
+			ang_vel = rbd::angularPart(point_vel);
+			lin_vel = rbd::linearPart(point_vel);
+
+			// Computing the JdQd for current point
+			jacd_qd.block<3,1>(rbd::AX,k) = rbd::angularPart(point_acc);
+			jacd_qd.block<3,1>(rbd::LX,k) =
+					rbd::linearPart(point_acc) + ang_vel.cross(lin_vel);
+			break;}
 		}
 	}
 }
@@ -2,6 +2,7 @@
 #define DWL__MODEL__WHOLE_BODY_KINEMATICS__H
 
 #include <dwl/model/FloatingBaseSystem.h>
+#include <dwl/model/BranchKinematics.h>
 #include <dwl/utils/utils.h>
 
 
@@ -55,6 +56,17 @@ class WholeBodyKinematics
 						 double lambda,
 						 unsigned int max_iter);
 
+		/**
+		 * @brief Compiles a set of bodies, i.e. resolves the body names to
+		 * their RBDL ids and branch information. Bodies that don't belong to
+		 * the model are skipped. A compiled set is used by the hot-path
+		 * routines, which avoids string lookups and map allocations
+		 * @param rbd::BodySet& Compiled set of bodies
+		 * @param const rbd::BodySelector& Body names
+		 */
+		void compileBodySet(rbd::BodySet& body_set,
+							const rbd::BodySelector& body_names) const;
+
 		/**
 		 * @brief Computes the forward kinematics for a predefined set of bodies
 		 * @param rbd::BodyVector& Operational position of bodies
@@ -77,6 +89,47 @@ class WholeBodyKinematics
 												 enum rbd::Component component = rbd::Full,
 												 enum TypeOfOrientation type = RollPitchYaw);
 
+		/**
+		 * @brief Computes the forward kinematics for a predefined set of bodies
+		 * in a single pass, i.e. the kinematic tree is updated once and then
+		 * every body frame is read from the cached kinematic state.
+		 * The operational positions are written in a caller-owned buffer in
+		 * which the k-th column is the k-th body of the set. The buffer is
+		 * resized only if its dimension doesn't match, so a preallocated
+		 * buffer isn't reallocated. Bodies that don't belong to the model are
+		 * skipped
+		 * @param Eigen::MatrixXd& Operational position of bodies (one column per body)
+		 * @param const rbd::Vector6d& Base position
+		 * @param const Eigen::VectorXd& Joint position
+		 * @param const rbd::BodySelector& A predefined set of bodies
+		 * @param enum rbd::Component There are three different important
+		 * kind of jacobian such as: linear, angular and full
+		 * @param enum TypeOfOrientation Desired type of orientation
+		 */
+		void computeForwardKinematics(Eigen::MatrixXd& op_pos,
+									  const rbd::Vector6d& base_pos,
+									  const Eigen::VectorXd& joint_pos,
+									  const rbd::BodySelector& body_set,
+									  enum rbd::Component component = rbd::Full,
+									  enum TypeOfOrientation type = RollPitchYaw);
+		void computeForwardKinematics(Eigen::MatrixXd& op_pos,
+									  const rbd::Vector6d& base_pos,
+									  const Eigen::VectorXd& joint_pos,
+									  const rbd::BodySet& body_set,
+									  enum rbd::Component component = rbd::Full,
+									  enum TypeOfOrientation type = RollPitchYaw);
+
+		/**
+		 * @brief Gets the number of variables that describe the operational
+		 * position of a body
+		 * @param enum rbd::Component There are three different important
+		 * kind of jacobian such as: linear, angular and full
+		 * @param enum TypeOfOrientation Desired type of orientation
+		 * @return unsigned int Number of position variables per body
+		 */
+		unsigned int getPositionDimension(enum rbd::Component component = rbd::Full,
+										  enum TypeOfOrientation type = RollPitchYaw) const;
+
 
 		/**
 		 * @brief Computes the inverse kinematics for a predefined set of
@@ -103,7 +156,14 @@ class WholeBodyKinematics
 		 * @brief Computes the joint position from a predefined set of
 		 * body positions w.r.t the base.
 		 * This inverse kinematics algorithm uses an operational position which
-		 * consists of the desired 3d position for each body
+		 * consists of the desired 3d position for each body. When the bodies
+		 * belong to different branches with a branch solver (see
+		 * BranchKinematics), every branch is solved independently, in closed
+		 * form if possible. Otherwise, it uses damped least squares, where the
+		 * step is solved per branch if the bodies belong to different branches.
+		 * A close initial joint position (e.g. the solution of a neighbouring
+		 * sample of a trajectory) is used to choose the closest solution, and
+		 * reduces the number of iterations
 		 * @param const Eigen::VectorXd& Joint position
 		 * @param const rbd::BodyPosition& Operational position of bodies
 		 * @param const Eigen::VectorXd& Initial joint position for the iteration
@@ -162,6 +222,11 @@ class WholeBodyKinematics
 							 const Eigen::VectorXd& joint_pos,
 							 const rbd::BodySelector& body_set,
 							 enum rbd::Component component = rbd::Full);
+		void computeJacobian(Eigen::MatrixXd& jacobian,
+							 const rbd::Vector6d& base_pos,
+							 const Eigen::VectorXd& joint_pos,
+							 const rbd::BodySet& body_set,
+							 enum rbd::Component component = rbd::Full);
 
 		/**
 		 * @brief Computes the fixed jacobian, without the floating-base
@@ -224,6 +289,13 @@ class WholeBodyKinematics
 												 const Eigen::VectorXd& joint_vel,
 												 const rbd::BodySelector& body_set,
 												 enum rbd::Component component = rbd::Full);
+		void computeVelocity(Eigen::MatrixXd& op_vel,
+							 const rbd::Vector6d& base_pos,
+							 const Eigen::VectorXd& joint_pos,
+							 const rbd::Vector6d& base_vel,
+							 const Eigen::VectorXd& joint_vel,
+							 const rbd::BodySet& body_set,
+							 enum rbd::Component component = rbd::Full);
 
 		/**
 		 * @brief Computes the operational acceleration from the joint space
@@ -256,6 +328,15 @@ class WholeBodyKinematics
 													 const Eigen::VectorXd& joint_acc,
 													 const rbd::BodySelector& body_set,
 													 enum rbd::Component component = rbd::Full);
+		void computeAcceleration(Eigen::MatrixXd& op_acc,
+								 const rbd::Vector6d& base_pos,
+								 const Eigen::VectorXd& joint_pos,
+								 const rbd::Vector6d& base_vel,
+								 const Eigen::VectorXd& joint_vel,
+								 const rbd::Vector6d& base_acc,
+								 const Eigen::VectorXd& joint_acc,
+								 const rbd::BodySet& body_set,
+								 enum rbd::Component component = rbd::Full);
 
 		/**
 		 * @brief Computes the operational acceleration contribution from the
@@ -284,6 +365,13 @@ class WholeBodyKinematics
 												 const Eigen::VectorXd& joint_vel,
 												 const rbd::BodySelector& body_set,
 												 enum rbd::Component component = rbd::Full);
+		void computeJdotQdot(Eigen::MatrixXd& jacd_qd,
+							 const rbd::Vector6d& base_pos,
+							 const Eigen::VectorXd& joint_pos,
+							 const rbd::Vector6d& base_vel,
+							 const Eigen::VectorXd& joint_vel,
+							 const rbd::BodySet& body_set,
+							 enum rbd::Component component = rbd::Full);
 
 		/** @brief Gets the floating-base system information */
 		const FloatingBaseSystem& getFloatingBaseSystem() const;
@@ -294,8 +382,32 @@ class WholeBodyKinematics
 		 */
 		int getNumberOfActiveEndEffectors(const rbd::BodySelector& effector_set);
 
+		/**
+		 * @brief Sets the type of IK solver of the branch of a body (see
+		 * BranchKinematics::setTypeOfSolver)
+		 * @param const std::string& Body name
+		 * @param enum TypeOfBranchSolver Type of branch solver
+		 * @return False if the branch doesn't support the solver
+		 */
+		bool setTypeOfBranchSolver(const std::string& body_name,
+								   enum TypeOfBranchSolver solver);
+
+		/**
+		 * @brief Gets the type of IK solver of the branch of a body
+		 * @param const std::string& Body name
+		 * @return The type of branch solver
+		 */
+		enum TypeOfBranchSolver getTypeOfBranchSolver(const std::string& body_name) const;
+
 
 	private:
+		/**
+		 * @brief Resets the IK solvers of the end-effector branches from their
+		 * jacobians in the zero posture. The solvers that don't match the
+		 * forward kinematics of the model are removed
+		 */
+		void resetBranchSolvers();
+
 		/** @brief Fixed body ids */
 		rbd::BodyID body_id_;
 
@@ -305,11 +417,33 @@ class WholeBodyKinematics
 		/** @brief Middle joint position */
 		Eigen::VectorXd joint_pos_middle_;
 
+		/** @brief Lower and upper joint limits used by the IK routines */
+		Eigen::VectorXd joint_lower_limit_;
+		Eigen::VectorXd joint_upper_limit_;
+
 		rbd::BodyVectorXd body_pos_;
 		rbd::BodyVectorXd body_vel_;
 		rbd::BodyVectorXd body_acc_;
 		rbd::BodyVectorXd jdot_qdot_;
 
+		/** @brief Buffers used by the body name interface */
+		rbd::BodySet body_set_;
+		Eigen::MatrixXd body_buffer_;
+
+		/** @brief Generalized joint states and point jacobian */
+		Eigen::VectorXd q_;
+		Eigen::VectorXd q_dot_;
+		Eigen::VectorXd q_ddot_;
+		Eigen::MatrixXd point_jac_;
+
+		/** @brief IK solvers of the end-effector branches */
+		BranchKinematics branch_kin_;
+
+		/** @brief Buffers of the IK solver */
+		rbd::BodySet ik_set_;
+		Eigen::MatrixXd ik_jac_;
+		Eigen::MatrixXd ik_pos_;
+
 		/** @brief IK solver */
 		double step_tol_;
 		double lambda_;
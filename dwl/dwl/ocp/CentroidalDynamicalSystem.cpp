@@ -26,6 +26,12 @@ CentroidalDynamicalSystem::~CentroidalDynamicalSystem()
 }
 
 
+CentroidalDynamicalSystem* CentroidalDynamicalSystem::clone() const
+{
+	return new CentroidalDynamicalSystem(*this);
+}
+
+
 void CentroidalDynamicalSystem::initDynamicalSystem()
 {
 	// Getting the end-effector names
@@ -42,11 +48,10 @@ void CentroidalDynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& cons
 	// Resizing the constraint vector
 	constraint.resize(4 * system_.getNumberOfEndEffectors());//(1+3)
 
-	// Computing the step time
-	double step_time = state.time - state_buffer_[0].time;
-
-	// Computing the joint acceleration from velocities
-	Eigen::VectorXd base_acc = (state.base_vel - state_buffer_[0].base_vel) / step_time;
+	// Getting the accelerations given the transcription method
+	rbd::Vector6d base_acc;
+	Eigen::VectorXd joint_acc;
+	computeAcceleration(base_acc, joint_acc, state);
 
 
 	// Computing the centroidal dynamics
@@ -63,11 +68,11 @@ void CentroidalDynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& cons
 
 
 
-	// Computing the contact position
-	rbd::BodyVectorXd contact_pos;
-	kinematics_.computeForwardKinematics(contact_pos,
-										 state.base_pos, state.joint_pos,
-										 end_effector_names_, rbd::Linear);
+	// Computing the contact position, which could be cached by other component of the knot
+	const rbd::BodyVectorXd& contact_pos =
+			getKinematicCache().computePosition(kinematics_,
+												state.base_pos, state.joint_pos,
+												end_effector_names_, rbd::Linear);
 	for (unsigned int k = 0; k < system_.getNumberOfEndEffectors(); k++)
 		constraint.segment<3>(3 * k + 1) = contact_pos.at(end_effector_names_[k]) -
 			state.contact_pos.at(end_effector_names_[k]);
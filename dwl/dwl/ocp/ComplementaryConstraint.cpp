@@ -1,4 +1,5 @@
 #include <dwl/ocp/ComplementaryConstraint.h>
+#include <dwl/utils/AutoDiff.h>
 
 
 namespace dwl
@@ -34,15 +35,62 @@ void ComplementaryConstraint::compute(Eigen::VectorXd& constraint,
 	computeFirstComplement(first_constraint, state);
 	computeSecondComplement(second_constraint, state);
 
-	// Resizing the constraint vector
-	constraint.resize(2 * complementary_dimension_ + 1);
+	// Adding the complement constraints and their inner product
+	computeComplementarity(constraint, first_constraint, second_constraint);
+}
 
-	// Adding the complement constraints
-	constraint.segment(0, complementary_dimension_) = first_constraint;
-	constraint.segment(complementary_dimension_, complementary_dimension_) = second_constraint;
 
-	// Computing the inner product of the complementary constraints
-	constraint(2 * complementary_dimension_) = first_constraint.transpose() * second_constraint;
+bool ComplementaryConstraint::computeJacobian(Eigen::MatrixXd& jacobian,
+											  Eigen::MatrixXd& last_jacobian,
+											  const WholeBodyState& state)
+{
+	// Computing the jacobians of the first and second constraints
+	Eigen::MatrixXd first_jac, last_first_jac, second_jac, last_second_jac;
+	if (!computeFirstComplementJacobian(first_jac, last_first_jac, state) ||
+			!computeSecondComplementJacobian(second_jac, last_second_jac, state))
+		return false;
+
+	// Setting the complements as dependent variables of the last and current decision states,
+	// i.e. [last | current]
+	unsigned int state_dim = first_jac.cols();
+	Eigen::MatrixXd first_full_jac(first_jac.rows(), 2 * state_dim);
+	Eigen::MatrixXd second_full_jac(second_jac.rows(), 2 * state_dim);
+	first_full_jac << last_first_jac, first_jac;
+	second_full_jac << last_second_jac, second_jac;
+
+	Eigen::VectorXd first_constraint, second_constraint;
+	computeFirstComplement(first_constraint, state);
+	computeSecondComplement(second_constraint, state);
+	math::ADVector first, second, constraint;
+	math::setVariables(first, first_constraint, first_full_jac);
+	math::setVariables(second, second_constraint, second_full_jac);
+
+	// Propagating the jacobians through the complementarity
+	computeComplementarity(constraint, first, second);
+
+	Eigen::VectorXd constraint_value;
+	Eigen::MatrixXd full_jac;
+	math::getJacobian(constraint_value, full_jac, constraint, 2 * state_dim);
+	last_jacobian = full_jac.leftCols(state_dim);
+	jacobian = full_jac.rightCols(state_dim);
+
+	return true;
+}
+
+
+bool ComplementaryConstraint::computeFirstComplementJacobian(Eigen::MatrixXd& jacobian,
+															 Eigen::MatrixXd& last_jacobian,
+															 const WholeBodyState& state)
+{
+	return false;
+}
+
+
+bool ComplementaryConstraint::computeSecondComplementJacobian(Eigen::MatrixXd& jacobian,
+															  Eigen::MatrixXd& last_jacobian,
+															  const WholeBodyState& state)
+{
+	return false;
 }
 
 
@@ -64,5 +112,23 @@ void ComplementaryConstraint::getBounds(Eigen::VectorXd& lower_bound,
 	upper_bound(2 * complementary_dimension_) = 0.0;
 }
 
+
+template<typename Scalar>
+void ComplementaryConstraint::computeComplementarity(
+		Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+		const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& first,
+		const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& second)
+{
+	// Resizing the constraint vector
+	constraint.resize(2 * complementary_dimension_ + 1);
+
+	// Adding the complement constraints
+	constraint.segment(0, complementary_dimension_) = first;
+	constraint.segment(complementary_dimension_, complementary_dimension_) = second;
+
+	// Computing the inner product of the complementary constraints
+	constraint(2 * complementary_dimension_) = first.dot(second);
+}
+
 } //@namespace ocp
 } //@namespace dwl
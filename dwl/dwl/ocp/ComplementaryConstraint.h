@@ -35,6 +35,20 @@ class ComplementaryConstraint : public Constraint<WholeBodyState>
 		void compute(Eigen::VectorXd& constraint,
 					 const WholeBodyState& state);
 
+		/**
+		 * @brief Computes the exact jacobian of the complementary constraint given a certain
+		 * state. The jacobians of the complements are propagated through the complementarity
+		 * (i.e. their inner product) by automatic differentiation, so it's only available if
+		 * both complements implement their jacobians
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the jacobians of the complements are implemented
+		 */
+		bool computeJacobian(Eigen::MatrixXd& jacobian,
+							 Eigen::MatrixXd& last_jacobian,
+							 const WholeBodyState& state);
+
 		/**
 		 * @brief Gets the bounds of the complementary constraints
 		 * @param Eigen::VectorXd& Lower bounds
@@ -59,10 +73,51 @@ class ComplementaryConstraint : public Constraint<WholeBodyState>
 		virtual void computeSecondComplement(Eigen::VectorXd& constraint,
 											 const WholeBodyState& state) = 0;
 
+		/**
+		 * @brief Computes the jacobian of the first complement given a certain state. The
+		 * jacobians are described with respect to the decision state of the current and last
+		 * knot. By default there isn't an analytic jacobian
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the jacobian is implemented
+		 */
+		virtual bool computeFirstComplementJacobian(Eigen::MatrixXd& jacobian,
+													Eigen::MatrixXd& last_jacobian,
+													const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the jacobian of the second complement given a certain state. The
+		 * jacobians are described with respect to the decision state of the current and last
+		 * knot. By default there isn't an analytic jacobian
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the jacobian is implemented
+		 */
+		virtual bool computeSecondComplementJacobian(Eigen::MatrixXd& jacobian,
+													 Eigen::MatrixXd& last_jacobian,
+													 const WholeBodyState& state);
+
 
 	protected:
 		/** @brief Dimension of the complementary constraints */
 		unsigned int complementary_dimension_;
+
+
+	private:
+		/**
+		 * @brief Computes the complementary constraint from both complements, i.e. the
+		 * complements and their inner product. It's templated on the scalar type for computing
+		 * the constraint value (double) and its jacobian (math::ADScalar)
+		 * @param Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Evaluated constraint function
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& First complement
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Second complement
+		 */
+		template<typename Scalar>
+		void computeComplementarity(Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+									const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& first,
+									const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& second);
 };
 
 } //@namespace ocp
@@ -25,6 +25,12 @@ ConstrainedDynamicalSystem::~ConstrainedDynamicalSystem()
 }
 
 
+ConstrainedDynamicalSystem* ConstrainedDynamicalSystem::clone() const
+{
+	return new ConstrainedDynamicalSystem(*this);
+}
+
+
 void ConstrainedDynamicalSystem::setActiveEndEffectors(const rbd::BodySelector& active_set)
 {
 	active_endeffectors_ = active_set;
@@ -38,13 +44,13 @@ void ConstrainedDynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& con
 	// Resizing the constraint vector
 	constraint.resize(system_.getJointDoF() + 3 * num_actived_endeffectors_);
 
-	// Computing the step time
-	double step_time = state.time - state_buffer_[0].time;
+	// Getting the accelerations given the transcription method
+	rbd::Vector6d base_acc;
+	Eigen::VectorXd joint_acc;
+	computeAcceleration(base_acc, joint_acc, state);
 
 	// Computing the constrained inverse dynamics to the defined active contacts
 	Eigen::VectorXd estimated_joint_forces;
-	Eigen::VectorXd base_acc = (state.base_vel - state_buffer_[0].base_vel) / step_time;
-	Eigen::VectorXd joint_acc = (state.joint_vel - state_buffer_[0].joint_vel) / step_time;
 	dynamics_.computeConstrainedFloatingBaseInverseDynamics(estimated_joint_forces,
 															state.base_pos, state.joint_pos,
 															state.base_vel, state.joint_vel,
@@ -56,13 +62,13 @@ void ConstrainedDynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& con
 	// This constrained inverse dynamic algorithm could generate joint forces in cases where the
 	// ground (or environment) is pulling or pushing the end-effector, which an unreal situation.
 	// So, it's required to impose a velocity kinematic constraint in the active end-effectors
-	rbd::BodyVectorXd endeffectors_vel;
-	kinematics_.computeVelocity(endeffectors_vel,
-								state.base_pos, state.joint_pos,
-								state.base_vel, state.joint_vel,
-								active_endeffectors_, rbd::Linear);
+	const rbd::BodyVectorXd& endeffectors_vel =
+			getKinematicCache().computeVelocity(kinematics_,
+												state.base_pos, state.joint_pos,
+												state.base_vel, state.joint_vel,
+												active_endeffectors_, rbd::Linear);
 
-	for (rbd::BodyVectorXd::iterator endeffector_it = endeffectors_vel.begin();
+	for (rbd::BodyVectorXd::const_iterator endeffector_it = endeffectors_vel.begin();
 			endeffector_it != endeffectors_vel.end(); endeffector_it++) {
 		// Getting the end-effector index
 		std::string name = endeffector_it->first;
@@ -3,6 +3,7 @@
 
 #include <dwl/model/WholeBodyKinematics.h>
 #include <dwl/model/WholeBodyDynamics.h>
+#include <dwl/model/KinematicCache.h>
 #include <dwl/utils/URDF.h>
 #include <dwl/utils/utils.h>
 #include <boost/shared_ptr.hpp>
@@ -53,6 +54,14 @@ class Constraint
 		/** @brief Destructor function */
 		virtual ~Constraint();
 
+		/**
+		 * @brief Clones the constraint, i.e. its model and current configuration.
+		 * The clones are used for evaluating the constraint concurrently. By default
+		 * the constraint cannot be cloned
+		 * @return The cloned constraint, or NULL if cloning isn't supported
+		 */
+		virtual Constraint<TState>* clone() const;
+
 		/**
 		 * @brief Build the model rigid-body system from an URDF file
 		 * @param std::string URDF file
@@ -103,6 +112,23 @@ class Constraint
 		virtual void compute(Eigen::VectorXd& constraint,
 							 const TState& state) = 0;
 
+		/**
+		 * @brief Computes the analytic jacobian of the constraint given a
+		 * certain state. The jacobians are described with respect to the
+		 * decision state of the current and last knot, i.e. the state vector
+		 * defined by the dynamical system (see
+		 * DynamicalSystem::fromWholeBodyState). By default there isn't an
+		 * analytic jacobian, and the optimal control problem approximates it
+		 * with finite differences
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const TState& Whole-body state
+		 * @return True if the analytic jacobian is implemented
+		 */
+		virtual bool computeJacobian(Eigen::MatrixXd& jacobian,
+									 Eigen::MatrixXd& last_jacobian,
+									 const TState& state);
+
 		/**
 		 * @brief Gets the lower and upper bounds of the constraint
 		 * @param Eigen::VectorXd& Lower constraint bound
@@ -130,6 +156,13 @@ class Constraint
 		/** @brief Resets the state buffer */
 		void resetStateBuffer();
 
+		/**
+		 * @brief Sets the kinematic cache shared with the rest of components evaluated at
+		 * the same knot. By default every constraint uses its own cache
+		 * @param model::KinematicCache* Kinematic cache, or NULL for the own cache
+		 */
+		void setKinematicCache(model::KinematicCache* cache);
+
 		/** @brief Gets the dimension of the constraint */
 		unsigned int getConstraintDimension();
 
@@ -141,6 +174,9 @@ class Constraint
 
 
 	protected:
+		/** @brief Gets the kinematic cache used for computing the kinematic quantities */
+		model::KinematicCache& getKinematicCache();
+
 		/** @brief Name of the constraint */
 		std::string name_;
 
@@ -164,6 +200,10 @@ class Constraint
 
 		/** @brief Whole-body dynamical model */
 		model::WholeBodyDynamics dynamics_;
+
+		/** @brief Shared and own kinematic caches */
+		model::KinematicCache* kinematic_cache_;
+		model::KinematicCache own_kinematic_cache_;
 };
 
 } //@namespace ocp
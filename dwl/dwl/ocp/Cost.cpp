@@ -19,6 +19,26 @@ Cost::~Cost()
 }
 
 
+Cost* Cost::clone() const
+{
+	return NULL;
+}
+
+
+bool Cost::computeGradient(WholeBodyState& gradient,
+						   const WholeBodyState& state)
+{
+	return false;
+}
+
+
+bool Cost::computeHessian(WholeBodyState& hessian,
+						  const WholeBodyState& state)
+{
+	return false;
+}
+
+
 void Cost::setWeights(const WholeBodyState& weights)
 {
 	// Checking the cost variables
@@ -44,6 +44,13 @@ class Cost
 		/** @brief Destructor function */
 		virtual ~Cost();
 
+		/**
+		 * @brief Clones the cost, i.e. its weights and desired state. The clones are used for
+		 * evaluating the cost concurrently. By default the cost cannot be cloned
+		 * @return The cloned cost, or NULL if cloning isn't supported
+		 */
+		virtual Cost* clone() const;
+
 		/**
 		 * @brief Computes the cost value given a certain state
 		 * @param double& Cost value
@@ -52,6 +59,32 @@ class Cost
 		virtual void compute(double& cost,
 							 const WholeBodyState& state) = 0;
 
+		/**
+		 * @brief Computes the analytic gradient of the cost given a certain
+		 * state. The gradient is described as a whole-body state, in which
+		 * every variable is the partial derivative of the cost with respect
+		 * to it. By default there isn't an analytic gradient, and the optimal
+		 * control problem approximates it with finite differences
+		 * @param WholeBodyState& Cost gradient (zero-initialized)
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the analytic gradient is implemented
+		 */
+		virtual bool computeGradient(WholeBodyState& gradient,
+									 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the diagonal of the cost Hessian (or of its Gauss-Newton
+		 * approximation) given a certain state. The Hessian is described as a whole-body
+		 * state, in which every variable is the second partial derivative of the cost with
+		 * respect to it. By default there isn't an analytic Hessian, and the optimal control
+		 * problem approximates it with finite differences of the analytic gradient
+		 * @param WholeBodyState& Diagonal of the cost Hessian (zero-initialized)
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the analytic Hessian is implemented
+		 */
+		virtual bool computeHessian(WholeBodyState& hessian,
+									const WholeBodyState& state);
+
 		/**
 		 * @brief Sets the whole-body state weights which are used by specific cost function
 		 * @param WholeBodyState& Whole-body weights
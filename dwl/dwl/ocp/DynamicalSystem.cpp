@@ -1,4 +1,5 @@
 #include <dwl/ocp/DynamicalSystem.h>
+#include <dwl/utils/AutoDiff.h>
 
 
 namespace dwl
@@ -8,8 +9,8 @@ namespace ocp
 {
 
 DynamicalSystem::DynamicalSystem() : state_dimension_(0), terminal_constraint_dimension_(0),
-		system_variables_(false), integration_method_(Fixed), step_time_(0.1),
-		is_full_trajectory_optimization_(false)
+		system_variables_(false), integration_method_(Fixed), transcription_method_(EulerBackward),
+		acceleration_variables_(false), step_time_(0.1), is_full_trajectory_optimization_(false)
 {
 
 }
@@ -21,6 +22,12 @@ DynamicalSystem::~DynamicalSystem()
 }
 
 
+DynamicalSystem* DynamicalSystem::clone() const
+{
+	return NULL;
+}
+
+
 void DynamicalSystem::init(bool info)
 {
 	// Computing the state dimension of the dynamical system constraint
@@ -88,10 +95,11 @@ void DynamicalSystem::compute(Eigen::VectorXd& constraint,
 	computeDynamicalConstraint(dynamical_constraint, state);
 
 	// Adding both constraints
+	unsigned int integration_dim = time_constraint.size();
 	unsigned int dynamical_dim = dynamical_constraint.size();
-	constraint.resize(system_.getSystemDoF() + dynamical_dim);
-	constraint.segment(0, system_.getSystemDoF()) = time_constraint;
-	constraint.segment(system_.getSystemDoF(), dynamical_dim) = dynamical_constraint;
+	constraint.resize(integration_dim + dynamical_dim);
+	constraint.segment(0, integration_dim) = time_constraint;
+	constraint.segment(integration_dim, dynamical_dim) = dynamical_constraint;
 }
 
 
@@ -103,6 +111,172 @@ void DynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& constraint,
 }
 
 
+bool DynamicalSystem::computeJacobian(Eigen::MatrixXd& jacobian,
+									  Eigen::MatrixXd& last_jacobian,
+									  const WholeBodyState& state)
+{
+	// Computing the jacobian of the dynamical constraint. If the dynamical system doesn't
+	// implement it, it's approximated with central differences. Note that the time integration
+	// part is always exact
+	Eigen::MatrixXd dynamical_jac, last_dynamical_jac;
+	if (!computeDynamicalJacobian(dynamical_jac, last_dynamical_jac, state))
+		computeNumericalDynamicalJacobian(dynamical_jac, last_dynamical_jac, state);
+
+	// Checking the jacobian dimension
+	unsigned int dynamical_dim = dynamical_jac.rows();
+	if ((unsigned) dynamical_jac.cols() != state_dimension_ ||
+			(unsigned) last_dynamical_jac.rows() != dynamical_dim ||
+			(unsigned) last_dynamical_jac.cols() != state_dimension_) {
+		printf(RED_ "FATAL: the jacobian dimension of %s constraint is not consistent\n"
+				COLOR_RESET, name_.c_str());
+		exit(EXIT_FAILURE);
+	}
+
+	// Computing the jacobian of the time integration with automatic differentiation, where the
+	// seeds are the decision variables of the last and current knots, i.e. [last | current]
+	unsigned int sys_dof = system_.getSystemDoF();
+	unsigned int integration_dim = getIntegrationDimension();
+	unsigned int num_seeds = 2 * state_dimension_;
+	const WholeBodyState& last_state = state_buffer_[0];
+	Eigen::VectorXd last_position_value =
+			system_.toGeneralizedJointState(last_state.base_pos, last_state.joint_pos);
+	Eigen::VectorXd position_value =
+			system_.toGeneralizedJointState(state.base_pos, state.joint_pos);
+	Eigen::VectorXd last_velocity_value =
+			system_.toGeneralizedJointState(last_state.base_vel, last_state.joint_vel);
+	Eigen::VectorXd velocity_value =
+			system_.toGeneralizedJointState(state.base_vel, state.joint_vel);
+	Eigen::VectorXd last_acceleration_value =
+			system_.toGeneralizedJointState(last_state.base_acc, last_state.joint_acc);
+	Eigen::VectorXd acceleration_value =
+			system_.toGeneralizedJointState(state.base_acc, state.joint_acc);
+	math::ADVector last_position, position, last_velocity, velocity;
+	math::ADVector last_acceleration, acceleration, integration;
+	math::ADScalar duration(state.duration, Eigen::VectorXd::Zero(num_seeds));
+	unsigned int idx = 0;
+	if (system_variables_.time) {
+		duration = math::ADScalar(state.duration, num_seeds, state_dimension_ + idx);
+		++idx;
+	}
+	if (system_variables_.position) {
+		math::seedVariables(last_position, last_position_value, idx, num_seeds);
+		math::seedVariables(position, position_value, state_dimension_ + idx, num_seeds);
+		idx += sys_dof;
+	} else {
+		math::setConstants(last_position, last_position_value, num_seeds);
+		math::setConstants(position, position_value, num_seeds);
+	}
+	if (system_variables_.velocity) {
+		math::seedVariables(last_velocity, last_velocity_value, idx, num_seeds);
+		math::seedVariables(velocity, velocity_value, state_dimension_ + idx, num_seeds);
+		idx += sys_dof;
+	} else {
+		math::setConstants(last_velocity, last_velocity_value, num_seeds);
+		math::setConstants(velocity, velocity_value, num_seeds);
+	}
+	if (system_variables_.acceleration) {
+		math::seedVariables(last_acceleration, last_acceleration_value, idx, num_seeds);
+		math::seedVariables(acceleration, acceleration_value, state_dimension_ + idx, num_seeds);
+		idx += sys_dof;
+	} else {
+		math::setConstants(last_acceleration, last_acceleration_value, num_seeds);
+		math::setConstants(acceleration, acceleration_value, num_seeds);
+	}
+	computeIntegration(integration, last_position, position, last_velocity, velocity,
+					   last_acceleration, acceleration, duration);
+
+	Eigen::VectorXd integration_value;
+	Eigen::MatrixXd integration_jac;
+	math::getJacobian(integration_value, integration_jac, integration, num_seeds);
+	jacobian.resize(integration_dim + dynamical_dim, state_dimension_);
+	last_jacobian.resize(integration_dim + dynamical_dim, state_dimension_);
+	jacobian.topRows(integration_dim) = integration_jac.rightCols(state_dimension_);
+	last_jacobian.topRows(integration_dim) = integration_jac.leftCols(state_dimension_);
+
+	// Adding the jacobian of the dynamical constraint
+	jacobian.bottomRows(dynamical_dim) = dynamical_jac;
+	last_jacobian.bottomRows(dynamical_dim) = last_dynamical_jac;
+
+	return true;
+}
+
+
+bool DynamicalSystem::computeDynamicalJacobian(Eigen::MatrixXd& jacobian,
+											   Eigen::MatrixXd& last_jacobian,
+											   const WholeBodyState& state)
+{
+	return false;
+}
+
+
+void DynamicalSystem::computeNumericalDynamicalJacobian(Eigen::MatrixXd& jacobian,
+														Eigen::MatrixXd& last_jacobian,
+														const WholeBodyState& state)
+{
+	// Getting the decision states of the current and last knots. The step is the default
+	// epsilon of the optimization model
+	const double epsilon = 1E-06;
+	WholeBodyState last_state = state_buffer_[0];
+	Eigen::VectorXd decision_state, last_decision_state;
+	fromWholeBodyState(decision_state, state);
+	fromWholeBodyState(last_decision_state, last_state);
+
+	Eigen::VectorXd constraint_value;
+	computeDynamicalConstraint(constraint_value, state);
+	jacobian.resize(constraint_value.size(), state_dimension_);
+	last_jacobian.resize(constraint_value.size(), state_dimension_);
+
+	// Perturbing the current decision state. The duration of the knot is the first decision
+	// variable if time is optimized, and it also shifts the time of the knot
+	Eigen::VectorXd constraint_plus, constraint_minus;
+	WholeBodyState perturbed_state = state;
+	for (unsigned int i = 0; i < state_dimension_; i++) {
+		double value = decision_state(i);
+		double time_step = (system_variables_.time && i == 0) ? epsilon : 0.;
+
+		decision_state(i) = value + epsilon;
+		toWholeBodyState(perturbed_state, decision_state);
+		perturbed_state.time = state.time + time_step;
+		computeDynamicalConstraint(constraint_plus, perturbed_state);
+
+		decision_state(i) = value - epsilon;
+		toWholeBodyState(perturbed_state, decision_state);
+		perturbed_state.time = state.time - time_step;
+		computeDynamicalConstraint(constraint_minus, perturbed_state);
+
+		decision_state(i) = value;
+		jacobian.col(i) = (constraint_plus - constraint_minus) / (2 * epsilon);
+	}
+
+	// Perturbing the last decision state, which is used through the state buffer. The duration
+	// of the last knot shifts the time of both knots
+	WholeBodyState perturbed_last_state = last_state;
+	perturbed_state = state;
+	for (unsigned int i = 0; i < state_dimension_; i++) {
+		double value = last_decision_state(i);
+		double time_step = (system_variables_.time && i == 0) ? epsilon : 0.;
+
+		last_decision_state(i) = value + epsilon;
+		toWholeBodyState(perturbed_last_state, last_decision_state);
+		perturbed_last_state.time = last_state.time + time_step;
+		perturbed_state.time = state.time + time_step;
+		state_buffer_[0] = perturbed_last_state;
+		computeDynamicalConstraint(constraint_plus, perturbed_state);
+
+		last_decision_state(i) = value - epsilon;
+		toWholeBodyState(perturbed_last_state, last_decision_state);
+		perturbed_last_state.time = last_state.time - time_step;
+		perturbed_state.time = state.time - time_step;
+		state_buffer_[0] = perturbed_last_state;
+		computeDynamicalConstraint(constraint_minus, perturbed_state);
+
+		last_decision_state(i) = value;
+		last_jacobian.col(i) = (constraint_plus - constraint_minus) / (2 * epsilon);
+	}
+	state_buffer_[0] = last_state;
+}
+
+
 void DynamicalSystem::computeTerminalConstraint(Eigen::VectorXd& constraint,
 												const WholeBodyState& state)
 {
@@ -121,23 +295,30 @@ void DynamicalSystem::computeTerminalConstraint(Eigen::VectorXd& constraint,
 void DynamicalSystem::numericalIntegration(Eigen::VectorXd& constraint,
 										   const WholeBodyState& state)
 {
-	// Resizing the constraint vector
-	constraint.resize(system_.getSystemDoF());
-
-	// Transcription of the constrained inverse dynamic equation using Euler-backward integration.
-	// This integration method adds numerical stability
-	Eigen::VectorXd base_int = state_buffer_[0].base_pos - state.base_pos + state.duration * state.base_vel;
-	Eigen::VectorXd joint_int = state_buffer_[0].joint_pos - state.joint_pos + state.duration * state.joint_vel;
-
-	// Adding the time integration constraint
-	constraint = system_.toGeneralizedJointState(base_int, joint_int);
+	// Transcription of the constrained inverse dynamic equation given the transcription method.
+	// The Euler-backward integration adds numerical stability, and the higher-order methods
+	// reach the same accuracy with fewer knots
+	const WholeBodyState& last_state = state_buffer_[0];
+	Eigen::VectorXd last_position =
+			system_.toGeneralizedJointState(last_state.base_pos, last_state.joint_pos);
+	Eigen::VectorXd position = system_.toGeneralizedJointState(state.base_pos, state.joint_pos);
+	Eigen::VectorXd last_velocity =
+			system_.toGeneralizedJointState(last_state.base_vel, last_state.joint_vel);
+	Eigen::VectorXd velocity = system_.toGeneralizedJointState(state.base_vel, state.joint_vel);
+	Eigen::VectorXd last_acceleration =
+			system_.toGeneralizedJointState(last_state.base_acc, last_state.joint_acc);
+	Eigen::VectorXd acceleration =
+			system_.toGeneralizedJointState(state.base_acc, state.joint_acc);
+	computeIntegration(constraint, last_position, position, last_velocity, velocity,
+					   last_acceleration, acceleration, state.duration);
 }
 
 
 void DynamicalSystem::getBounds(Eigen::VectorXd& lower_bound,
 								Eigen::VectorXd& upper_bound)
 {
-	Eigen::VectorXd time_bound = Eigen::VectorXd::Zero(system_.getSystemDoF());
+	unsigned int integration_dim = getIntegrationDimension();
+	Eigen::VectorXd time_bound = Eigen::VectorXd::Zero(integration_dim);
 
 	// Getting the dynamical bounds
 	Eigen::VectorXd dynamical_lower_bound, dynamical_upper_bound;
@@ -145,12 +326,12 @@ void DynamicalSystem::getBounds(Eigen::VectorXd& lower_bound,
 
 	// Adding both bounds
 	unsigned int dynamical_dim = dynamical_lower_bound.size();
-	lower_bound.resize(system_.getSystemDoF() + dynamical_dim);
-	upper_bound.resize(system_.getSystemDoF() + dynamical_dim);
-	lower_bound.segment(0, system_.getSystemDoF()) = time_bound;
-	lower_bound.segment(system_.getSystemDoF(), dynamical_dim) = dynamical_lower_bound;
-	upper_bound.segment(0, system_.getSystemDoF()) = time_bound;
-	upper_bound.segment(system_.getSystemDoF(), dynamical_dim) = dynamical_upper_bound;
+	lower_bound.resize(integration_dim + dynamical_dim);
+	upper_bound.resize(integration_dim + dynamical_dim);
+	lower_bound.segment(0, integration_dim) = time_bound;
+	lower_bound.segment(integration_dim, dynamical_dim) = dynamical_lower_bound;
+	upper_bound.segment(0, integration_dim) = time_bound;
+	upper_bound.segment(integration_dim, dynamical_dim) = dynamical_upper_bound;
 }
 
 
@@ -189,6 +370,25 @@ void DynamicalSystem::setStepIntegrationTime(const double& step_time)
 }
 
 
+void DynamicalSystem::setTranscriptionMethod(TranscriptionMethod method)
+{
+	// Keeping the acceleration variables defined by the system
+	if (transcription_method_ == EulerBackward)
+		acceleration_variables_ = system_variables_.acceleration;
+	transcription_method_ = method;
+
+	// The higher-order methods integrate the velocities from the accelerations, so they are
+	// added as decision variables
+	if (transcription_method_ == EulerBackward)
+		system_variables_.acceleration = acceleration_variables_;
+	else
+		system_variables_.acceleration = true;
+
+	// Setting the state dimension
+	computeStateDimension();
+}
+
+
 model::WholeBodyKinematics& DynamicalSystem::getKinematics()
 {
 	return kinematics_;
@@ -253,6 +453,16 @@ unsigned int DynamicalSystem::getTerminalConstraintDimension()
 }
 
 
+unsigned int DynamicalSystem::getIntegrationDimension()
+{
+	// The higher-order methods integrate both positions and velocities
+	if (transcription_method_ == EulerBackward)
+		return system_.getSystemDoF();
+	else
+		return 2 * system_.getSystemDoF();
+}
+
+
 model::FloatingBaseSystem& DynamicalSystem::getFloatingBaseSystem()
 {
 	return system_;
@@ -418,6 +628,22 @@ bool DynamicalSystem::isFullTrajectoryOptimization()
 }
 
 
+void DynamicalSystem::computeAcceleration(rbd::Vector6d& base_acc,
+										  Eigen::VectorXd& joint_acc,
+										  const WholeBodyState& state)
+{
+	if (system_variables_.acceleration) {
+		base_acc = state.base_acc;
+		joint_acc = state.joint_acc;
+	} else {
+		// Computing the acceleration from velocities
+		double step_time = state.time - state_buffer_[0].time;
+		base_acc = (state.base_vel - state_buffer_[0].base_vel) / step_time;
+		joint_acc = (state.joint_vel - state_buffer_[0].joint_vel) / step_time;
+	}
+}
+
+
 void DynamicalSystem::computeStateDimension()
 {
 	// Computing the state dimension give the locomotion variables
@@ -485,5 +711,54 @@ void DynamicalSystem::initialConditions()
 	}
 }
 
+
+template<typename Scalar>
+void DynamicalSystem::computeIntegration(Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_position,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& position,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_velocity,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& velocity,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_acceleration,
+										 const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& acceleration,
+										 const Scalar& duration)
+{
+	typedef Eigen::Matrix<Scalar,Eigen::Dynamic,1> VectorS;
+	unsigned int dof = position.size();
+	Scalar half_step = duration / 2.;
+	Scalar sixth_step = duration / 6.;
+
+	switch (transcription_method_) {
+	case RungeKutta4: {
+		// Multiple shooting with a RK4 step of the second-order system (q, qd), where the
+		// acceleration is linearly interpolated inside the knot (first-order hold)
+		VectorS mid_acceleration = (last_acceleration + acceleration) / 2.;
+		VectorS k2_velocity = last_velocity + half_step * last_acceleration;
+		VectorS k3_velocity = last_velocity + half_step * mid_acceleration;
+		VectorS k4_velocity = last_velocity + duration * mid_acceleration;
+		constraint.resize(2 * dof);
+		constraint.head(dof) = last_position - position + sixth_step *
+				(last_velocity + 2. * k2_velocity + 2. * k3_velocity + k4_velocity);
+		constraint.tail(dof) = last_velocity - velocity + sixth_step *
+				(last_acceleration + 4. * mid_acceleration + acceleration);
+		break;
+	}
+	case HermiteSimpson: {
+		// Hermite-Simpson collocation in its compressed form, i.e. the midpoint velocity is
+		// interpolated with a cubic Hermite and the acceleration is piecewise linear
+		VectorS mid_velocity = (last_velocity + velocity) / 2. +
+				(duration / 8.) * (last_acceleration - acceleration);
+		constraint.resize(2 * dof);
+		constraint.head(dof) = last_position - position + sixth_step *
+				(last_velocity + 4. * mid_velocity + velocity);
+		constraint.tail(dof) = last_velocity - velocity + half_step *
+				(last_acceleration + acceleration);
+		break;
+	}
+	default:
+		constraint = last_position - position + duration * velocity;
+		break;
+	}
+}
+
 } //@namespace ocp
 } //@namespace dwl
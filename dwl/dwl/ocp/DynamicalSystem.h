@@ -31,6 +31,13 @@ struct WholeBodyVariables
 /** @brief Defines the different methods for step-time integration */
 enum StepIntegrationMethod {Fixed, Variable};
 
+/**
+ * @brief Defines the different transcription methods of the time integration, i.e. Euler-backward
+ * integration of the positions, RK4 multiple shooting and Hermite-Simpson collocation of the
+ * positions and velocities
+ */
+enum TranscriptionMethod {EulerBackward, RungeKutta4, HermiteSimpson};
+
 /**
  * @class DynamicalSystem
  * @brief This abstract class defines common methods for implementing dynamical system constraint.
@@ -47,6 +54,12 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 		/** @brief Destructor function */
 		virtual ~DynamicalSystem();
 
+		/**
+		 * @brief Clones the dynamical system. By default the dynamical system cannot be cloned
+		 * @return The cloned dynamical system, or NULL if cloning isn't supported
+		 */
+		virtual DynamicalSystem* clone() const;
+
 		/**
 		 * @brief Initializes the dynamical system constraint given an URDF model (xml)
 		 * @param Print model information
@@ -77,6 +90,33 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 		virtual void computeDynamicalConstraint(Eigen::VectorXd& constraint,
 				 	 	 	 	 	 	 	 	const WholeBodyState& state);
 
+		/**
+		 * @brief Computes the jacobian of the dynamical and time integration constraint given a
+		 * certain state. The time integration part is always obtained by automatic
+		 * differentiation. The dynamical part is analytic if the dynamical system implements
+		 * computeDynamicalJacobian(), otherwise it's approximated with central differences
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True, the jacobian is always available
+		 */
+		bool computeJacobian(Eigen::MatrixXd& jacobian,
+							 Eigen::MatrixXd& last_jacobian,
+							 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the analytic jacobian of the dynamical constraint given a certain state.
+		 * The jacobians are described with respect to the decision state of the current and last
+		 * knot (see fromWholeBodyState()). By default there isn't an analytic jacobian
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True if the analytic jacobian is implemented
+		 */
+		virtual bool computeDynamicalJacobian(Eigen::MatrixXd& jacobian,
+											  Eigen::MatrixXd& last_jacobian,
+											  const WholeBodyState& state);
+
 		/**
 		 * @brief Computes the terminal constraint vector given a certain state
 		 * @param Eigen::VectorXd& Evaluated the terminal constraint function
@@ -154,6 +194,16 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 		 */
 		void setStepIntegrationTime(const double& step_time);
 
+		/**
+		 * @brief Sets the transcription method of the time integration. The default value is
+		 * Euler-backward. The higher-order methods (RK4 and Hermite-Simpson) integrate the
+		 * positions and velocities of every knot, so the accelerations are added as decision
+		 * variables. Switching back to Euler-backward restores the acceleration variables of
+		 * the system. Note that the constraints still depend only on the current and last knots
+		 * @param TranscriptionMethod Transcription method
+		 */
+		void setTranscriptionMethod(TranscriptionMethod method);
+
 		/** @brief Gets the kinematics of the system */
 		model::WholeBodyKinematics& getKinematics();
 
@@ -180,6 +230,9 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 		/** @brief Gets the dimension of the terminal constraint */
 		unsigned int getTerminalConstraintDimension();
 
+		/** @brief Gets the dimension of the time integration constraint */
+		unsigned int getIntegrationDimension();
+
 		/** @brief Gets the floating-base system information */
 		model::FloatingBaseSystem& getFloatingBaseSystem();
 
@@ -214,6 +267,18 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 
 
 	protected:
+		/**
+		 * @brief Gets the accelerations of the current knot. They are decision variables in
+		 * the higher-order transcriptions, otherwise they are computed by differentiating the
+		 * velocities of the current and last knots
+		 * @param rbd::Vector6d& Base acceleration
+		 * @param Eigen::VectorXd& Joint acceleration
+		 * @param const WholeBodyState& Whole-body state
+		 */
+		void computeAcceleration(rbd::Vector6d& base_acc,
+								 Eigen::VectorXd& joint_acc,
+								 const WholeBodyState& state);
+
 		/** @brief Dimension of the dynamical state */
 		unsigned int state_dimension_;
 
@@ -238,17 +303,61 @@ class DynamicalSystem : public Constraint<WholeBodyState>
 		/** @brief Step integration method */
 		StepIntegrationMethod integration_method_;
 
+		/** @brief Transcription method of the time integration */
+		TranscriptionMethod transcription_method_;
+
+		/**
+		 * @brief Indicates if the accelerations are decision variables of the system, which is
+		 * restored when it's used the Euler-backward transcription
+		 */
+		bool acceleration_variables_;
+
 		/** @brief Fixed-step time value [in seconds] */
 		double step_time_;
 
 
 	private:
+		/**
+		 * @brief Approximates the jacobian of the dynamical constraint with central differences
+		 * over the decision states of the current and last knot
+		 * @param Eigen::MatrixXd& Jacobian with respect to the current decision state
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last decision state
+		 * @param const WholeBodyState& Whole-body state
+		 */
+		void computeNumericalDynamicalJacobian(Eigen::MatrixXd& jacobian,
+											   Eigen::MatrixXd& last_jacobian,
+											   const WholeBodyState& state);
+
 		/** @brief Computes the state dimension of the dynamical constraint */
 		void computeStateDimension();
 
 		/** @brief Initializes conditions of the dynamical constraint */
 		void initialConditions();
 
+		/**
+		 * @brief Computes the integration constraint in generalized coordinates given the
+		 * transcription method, e.g. q_{k-1} - q_k + dt_k * qd_k for Euler-backward. It's
+		 * templated on the scalar type, so the same routine gives the constraint value (double)
+		 * and its exact jacobian (math::ADScalar)
+		 * @param Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Integration constraint
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Last generalized position
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Current generalized position
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Last generalized velocity
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Current generalized velocity
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Last generalized acceleration
+		 * @param const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Current generalized acceleration
+		 * @param const Scalar& Duration of the knot
+		 */
+		template<typename Scalar>
+		void computeIntegration(Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_position,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& position,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_velocity,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& velocity,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& last_acceleration,
+								const Eigen::Matrix<Scalar,Eigen::Dynamic,1>& acceleration,
+								const Scalar& duration);
+
 		/** @brief Indicates if it's a full-trajectory optimization */
 		bool is_full_trajectory_optimization_;
 };
@@ -26,6 +26,12 @@ FullDynamicalSystem::~FullDynamicalSystem()
 }
 
 
+FullDynamicalSystem* FullDynamicalSystem::clone() const
+{
+	return new FullDynamicalSystem(*this);
+}
+
+
 void FullDynamicalSystem::initDynamicalSystem()
 {
 	// Getting the end-effector names
@@ -46,12 +52,10 @@ void FullDynamicalSystem::computeDynamicalConstraint(Eigen::VectorXd& constraint
 	// Resizing the constraint vector
 	constraint.resize(system_.getSystemDoF());
 
-	// Computing the step time
-	double step_time = state.time - state_buffer_[0].time;
-
-	// Computing the joint acceleration from velocities
-	Eigen::VectorXd base_acc = (state.base_vel - state_buffer_[0].base_vel) / step_time;
-	Eigen::VectorXd joint_acc = (state.joint_vel - state_buffer_[0].joint_vel) / step_time;
+	// Getting the accelerations given the transcription method
+	rbd::Vector6d base_acc;
+	Eigen::VectorXd joint_acc;
+	computeAcceleration(base_acc, joint_acc, state);
 
 	// Computing the full inverse dynamics. In real-cases, the floating-base effort (state.base_eff)
 	// is always equals to zero, which implicates that we are imposing that the base_wrench equals
@@ -25,6 +25,9 @@ class FullDynamicalSystem : public DynamicalSystem
 		/** @brief Destructor function */
 		~FullDynamicalSystem();
 
+		/** @brief Clones the dynamical system */
+		FullDynamicalSystem* clone() const;
+
 		/** @brief Initializes the full dynamical system constraint */
 		void initDynamicalSystem();
 
@@ -20,6 +20,12 @@ InelasticContactModelConstraint::~InelasticContactModelConstraint()
 }
 
 
+InelasticContactModelConstraint* InelasticContactModelConstraint::clone() const
+{
+	return new InelasticContactModelConstraint(*this);
+}
+
+
 void InelasticContactModelConstraint::init(bool info)
 {
 	// Getting the end-effector names
@@ -60,12 +66,6 @@ void InelasticContactModelConstraint::computeSecondComplement(Eigen::VectorXd& c
 	// Resizing the complementary constraint dimension
 	constraint.resize(system_.getNumberOfEndEffectors());
 
-	// Computing the contact position
-	rbd::BodyVectorXd contact_pos;
-	kinematics_.computeForwardKinematics(contact_pos,
-										 state.base_pos, state.joint_pos,
-										 end_effector_names_, rbd::Linear);
-
 	// Adding the contact distance per every end-effector as a the second complementary
 	// TODO there is missing the concept of surface
 	double surface1_height = -0.582715;
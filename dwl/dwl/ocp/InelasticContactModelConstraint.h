@@ -19,6 +19,9 @@ class InelasticContactModelConstraint : public ComplementaryConstraint
 		/** @brief Destructor function */
 		~InelasticContactModelConstraint();
 
+		/** @brief Clones the constraint */
+		InelasticContactModelConstraint* clone() const;
+
 		/**
 		 * @brief Initializes the inelastic contact model constraint given an URDF model (xml)
 		 * @param Print model information
@@ -20,6 +20,12 @@ InelasticContactVelocityConstraint::~InelasticContactVelocityConstraint()
 }
 
 
+InelasticContactVelocityConstraint* InelasticContactVelocityConstraint::clone() const
+{
+	return new InelasticContactVelocityConstraint(*this);
+}
+
+
 void InelasticContactVelocityConstraint::init(bool info)
 {
 	// Getting the end-effector names
@@ -60,15 +66,13 @@ void InelasticContactVelocityConstraint::computeSecondComplement(Eigen::VectorXd
 	// Resizing the complementary constraint dimension
 	constraint.resize(system_.getNumberOfEndEffectors());
 
-	// Computing the changes of the contact position
-	rbd::BodyVectorXd current_contact_pos;
-	kinematics_.computeForwardKinematics(current_contact_pos,
-										 state.base_pos, state.joint_pos,
-										 end_effector_names_, rbd::Linear);
-	rbd::BodyVectorXd last_contact_pos;
-	kinematics_.computeForwardKinematics(last_contact_pos,
-										 state_buffer_[0].base_pos, state_buffer_[0].joint_pos,
-										 end_effector_names_, rbd::Linear);
+	// Computing the changes of the contact position. Note that the last contact position is
+	// usually cached by the evaluation of the previous knot
+	const rbd::BodyVectorXd& last_contact_pos =
+			getKinematicCache().computePosition(kinematics_,
+												state_buffer_[0].base_pos,
+												state_buffer_[0].joint_pos,
+												end_effector_names_, rbd::Linear);
 
 	// Adding the contact distance per every end-effector as a the second complementary
 	// TODO there is missing the concept of surface
@@ -19,6 +19,12 @@ IntegralControlEnergyCost::~IntegralControlEnergyCost()
 }
 
 
+IntegralControlEnergyCost* IntegralControlEnergyCost::clone() const
+{
+	return new IntegralControlEnergyCost(*this);
+}
+
+
 void IntegralControlEnergyCost::compute(double& cost,
 										const WholeBodyState& state)
 {
@@ -34,5 +40,39 @@ void IntegralControlEnergyCost::compute(double& cost,
 	cost *= state.duration;
 }
 
+
+bool IntegralControlEnergyCost::computeGradient(WholeBodyState& gradient,
+												const WholeBodyState& state)
+{
+	// Checking sizes
+	if (state.joint_eff.size() != locomotion_weights_.joint_eff.size()) {
+		printf(RED_ "FATAL: the joint efforts dimensions are not consistent\n" COLOR_RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	// Computing the gradient of the control cost, which is linear with respect to the duration
+	Eigen::VectorXd weighted_eff = locomotion_weights_.joint_eff.cwiseProduct(state.joint_eff);
+	gradient.joint_eff = 2 * state.duration * weighted_eff;
+	gradient.duration = state.joint_eff.dot(weighted_eff);
+
+	return true;
+}
+
+
+bool IntegralControlEnergyCost::computeHessian(WholeBodyState& hessian,
+											   const WholeBodyState& state)
+{
+	// Checking sizes
+	if (state.joint_eff.size() != locomotion_weights_.joint_eff.size()) {
+		printf(RED_ "FATAL: the joint efforts dimensions are not consistent\n" COLOR_RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	// The Gauss-Newton approximation neglects the coupling with the duration
+	hessian.joint_eff = 2 * state.duration * locomotion_weights_.joint_eff;
+
+	return true;
+}
+
 } //@namespace ocp
 } //@namespace dwl
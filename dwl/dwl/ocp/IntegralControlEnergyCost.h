@@ -23,6 +23,9 @@ class IntegralControlEnergyCost : public Cost
 		/** @brief Destructor function */
 		~IntegralControlEnergyCost();
 
+		/** @brief Clones the cost */
+		IntegralControlEnergyCost* clone() const;
+
 		/**
 		 * @brief Computes the control energy cost, i.e. joint efforts energy, given a locomotion
 		 * state. The control energy is defined as quadratic cost function
@@ -31,6 +34,24 @@ class IntegralControlEnergyCost : public Cost
 		 */
 		void compute(double& cost,
 					 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the analytic gradient of the control energy cost
+		 * @param WholeBodyState& Cost gradient
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic gradient is implemented
+		 */
+		bool computeGradient(WholeBodyState& gradient,
+							 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the Gauss-Newton Hessian of the control energy cost
+		 * @param WholeBodyState& Diagonal of the cost Hessian
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic Hessian is implemented
+		 */
+		bool computeHessian(WholeBodyState& hessian,
+							const WholeBodyState& state);
 };
 
 } //@namespace ocp
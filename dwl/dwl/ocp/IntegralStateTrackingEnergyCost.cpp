@@ -19,6 +19,12 @@ IntegralStateTrackingEnergyCost::~IntegralStateTrackingEnergyCost()
 }
 
 
+IntegralStateTrackingEnergyCost* IntegralStateTrackingEnergyCost::clone() const
+{
+	return new IntegralStateTrackingEnergyCost(*this);
+}
+
+
 void IntegralStateTrackingEnergyCost::compute(double& cost,
 											  const WholeBodyState& state)
 {
@@ -134,5 +140,66 @@ void IntegralStateTrackingEnergyCost::compute(double& cost,
 	cost *= state.duration;
 }
 
+
+bool IntegralStateTrackingEnergyCost::computeGradient(WholeBodyState& gradient,
+													  const WholeBodyState& state)
+{
+	// Computing the cost value, which also updates the desired state
+	double cost;
+	compute(cost, state);
+
+	// Computing the gradient of the base and joint position-tracking error
+	if (cost_variables_.base_pos)
+		gradient.base_pos = -2 * state.duration * locomotion_weights_.base_pos.cwiseProduct(
+				desired_state_.base_pos - state.base_pos);
+	if (cost_variables_.joint_pos)
+		gradient.joint_pos = -2 * state.duration * locomotion_weights_.joint_pos.cwiseProduct(
+				desired_state_.joint_pos - state.joint_pos);
+
+	// Computing the gradient of the base and joint velocity-tracking error
+	if (cost_variables_.base_vel)
+		gradient.base_vel = -2 * state.duration * locomotion_weights_.base_vel.cwiseProduct(
+				desired_state_.base_vel - state.base_vel);
+	if (cost_variables_.joint_vel)
+		gradient.joint_vel = -2 * state.duration * locomotion_weights_.joint_vel.cwiseProduct(
+				desired_state_.joint_vel - state.joint_vel);
+
+	// Computing the gradient of the base and joint acceleration-tracking error
+	if (cost_variables_.base_acc)
+		gradient.base_acc = -2 * state.duration * locomotion_weights_.base_acc.cwiseProduct(
+				desired_state_.base_acc - state.base_acc);
+	if (cost_variables_.joint_acc)
+		gradient.joint_acc = -2 * state.duration * locomotion_weights_.joint_acc.cwiseProduct(
+				desired_state_.joint_acc - state.joint_acc);
+
+	// The integral cost is linear with respect to the duration
+	if (state.duration > 0.)
+		gradient.duration = cost / state.duration;
+
+	return true;
+}
+
+
+bool IntegralStateTrackingEnergyCost::computeHessian(WholeBodyState& hessian,
+													 const WholeBodyState& state)
+{
+	// The Gauss-Newton approximation neglects the coupling with the duration, so the Hessian is
+	// the diagonal of the weights scaled by the duration
+	if (cost_variables_.base_pos)
+		hessian.base_pos = 2 * state.duration * locomotion_weights_.base_pos;
+	if (cost_variables_.joint_pos)
+		hessian.joint_pos = 2 * state.duration * locomotion_weights_.joint_pos;
+	if (cost_variables_.base_vel)
+		hessian.base_vel = 2 * state.duration * locomotion_weights_.base_vel;
+	if (cost_variables_.joint_vel)
+		hessian.joint_vel = 2 * state.duration * locomotion_weights_.joint_vel;
+	if (cost_variables_.base_acc)
+		hessian.base_acc = 2 * state.duration * locomotion_weights_.base_acc;
+	if (cost_variables_.joint_acc)
+		hessian.joint_acc = 2 * state.duration * locomotion_weights_.joint_acc;
+
+	return true;
+}
+
 } //@namespace ocp
 } //@namespace dwl
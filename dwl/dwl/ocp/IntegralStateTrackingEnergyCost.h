@@ -23,6 +23,9 @@ class IntegralStateTrackingEnergyCost : public Cost
 		/** @brief Destructor function */
 		~IntegralStateTrackingEnergyCost();
 
+		/** @brief Clones the cost */
+		IntegralStateTrackingEnergyCost* clone() const;
+
 		/**
 		 * @brief Computes the state-tracking energy cost given a locomotion state. The
 		 * state-tracking energy is defined as quadratic cost function
@@ -31,6 +34,24 @@ class IntegralStateTrackingEnergyCost : public Cost
 		 */
 		void compute(double& cost,
 					 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the analytic gradient of the state-tracking energy cost
+		 * @param WholeBodyState& Cost gradient
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic gradient is implemented
+		 */
+		bool computeGradient(WholeBodyState& gradient,
+							 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the Gauss-Newton Hessian of the state-tracking energy cost
+		 * @param WholeBodyState& Diagonal of the cost Hessian
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic Hessian is implemented
+		 */
+		bool computeHessian(WholeBodyState& hessian,
+							const WholeBodyState& state);
 };
 
 } //@namespace ocp
@@ -1,4 +1,7 @@
 #include <dwl/ocp/OptimalControl.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 namespace dwl
@@ -9,7 +12,8 @@ namespace ocp
 
 OptimalControl::OptimalControl() : dynamical_system_(NULL),
 		is_added_dynamic_system_(false), is_added_constraint_(false), is_added_cost_(false),
-		terminal_constraint_dimension_(0), horizon_(1)
+		knot_constraint_dimension_(0), terminal_constraint_dimension_(0), horizon_(1),
+		num_threads_(1), is_initialized_(false)
 {
 
 }
@@ -17,6 +21,7 @@ OptimalControl::OptimalControl() : dynamical_system_(NULL),
 
 OptimalControl::~OptimalControl()
 {
+	deleteKnotModels();
 	delete dynamical_system_;
 
 	typedef std::vector<Constraint<WholeBodyState>*>::iterator ConstraintItr;
@@ -35,18 +40,19 @@ OptimalControl::~OptimalControl()
 
 void OptimalControl::init(bool only_soft_constraints)
 {
-	// Reading the state dimension
-	state_dimension_ = dynamical_system_->getDimensionOfState();
+	// Reading the state dimension of the whole horizon
+	state_dimension_ = horizon_ * dynamical_system_->getDimensionOfState();
 
-	// Initializing the constraint dimension
-	constraint_dimension_ = 0;
+	// Initializing the constraint dimension of a knot and the whole horizon
+	knot_constraint_dimension_ = 0;
+	terminal_constraint_dimension_ = 0;
 	if (!only_soft_constraints) {
 		if (!dynamical_system_->isSoftConstraint())
-			constraint_dimension_ += dynamical_system_->getConstraintDimension();
+			knot_constraint_dimension_ += dynamical_system_->getConstraintDimension();
 		if (is_added_constraint_) {
 			for (unsigned int i = 0; i < constraints_.size(); i++) {
 				if (!constraints_[i]->isSoftConstraint())
-					constraint_dimension_ += constraints_[i]->getConstraintDimension();
+					knot_constraint_dimension_ += constraints_[i]->getConstraintDimension();
 			}
 		}
 		// Initializing the terminal constraint dimension
@@ -60,6 +66,78 @@ void OptimalControl::init(bool only_soft_constraints)
 		for (unsigned int i = 0; i < constraints_.size(); i++)
 			constraints_[i]->defineAsSoftConstraint();
 	}
+	constraint_dimension_ = horizon_ * knot_constraint_dimension_ + terminal_constraint_dimension_;
+
+	// Initializing the sparsity pattern of the constraint jacobian and Lagrangian Hessian
+	initJacobianStructure();
+	initHessianStructure();
+
+	// Initializing the components used by every evaluation thread
+	initKnotModels();
+
+	is_initialized_ = true;
+}
+
+
+OptimalControl* OptimalControl::clone() const
+{
+	if (!is_added_dynamic_system_)
+		return NULL;
+
+	// Cloning the components of the problem. Note that the replica deletes its components, so
+	// it's deleted if some of them cannot be cloned
+	OptimalControl* replica = new OptimalControl();
+	replica->dynamical_system_ = dynamical_system_->clone();
+	replica->is_added_dynamic_system_ = true;
+	bool cloned = replica->dynamical_system_ != NULL;
+	if (cloned)
+		replica->dynamical_system_->setKinematicCache(NULL);
+	for (unsigned int i = 0; i < constraints_.size(); i++) {
+		Constraint<WholeBodyState>* constraint = constraints_[i]->clone();
+		if (constraint != NULL)
+			constraint->setKinematicCache(NULL);
+		else
+			cloned = false;
+		replica->constraints_.push_back(constraint);
+		replica->is_added_constraint_ = true;
+	}
+	for (unsigned int i = 0; i < costs_.size(); i++) {
+		replica->costs_.push_back(costs_[i]->clone());
+		replica->is_added_cost_ = true;
+		cloned &= replica->costs_.back() != NULL;
+	}
+
+	if (!cloned) {
+		delete replica;
+		return NULL;
+	}
+
+	replica->horizon_ = horizon_;
+	replica->starting_point_ = starting_point_;
+	copyProperties(replica);
+
+	return replica;
+}
+
+
+bool OptimalControl::requiresInitialization()
+{
+	return !is_initialized_;
+}
+
+
+bool OptimalControl::getStageStructure(unsigned int& num_stages,
+									   unsigned int& stage_dim,
+									   unsigned int& stage_constraint_dim)
+{
+	if (dynamical_system_ == NULL)
+		return false;
+
+	num_stages = horizon_;
+	stage_dim = dynamical_system_->getDimensionOfState();
+	stage_constraint_dim = knot_constraint_dimension_;
+
+	return true;
 }
 
 
@@ -67,15 +145,25 @@ void OptimalControl::setStartingTrajectory(WholeBodyTrajectory& initial_trajecto
 {
 	//TODO should convert to the defined horizon and time step integration
 	motion_solution_ = initial_trajectory;
+	starting_point_.resize(0);
 }
 
 
 void OptimalControl::getStartingPoint(double* decision, int decision_dim)
 {
+	// The solvers get the starting point before every solution, so the components of the
+	// evaluation threads are cloned again. Note that the initial and terminal states, desired
+	// states and weights could have changed since the last solution
+	if (knot_models_.size() > 1)
+		initKnotModels();
+
 	// Eigen interfacing to raw buffers
 	Eigen::Map<Eigen::VectorXd> full_initial_point(decision, decision_dim);
 
-	if (motion_solution_.size() == 0) {
+	if (starting_point_.size() == decision_dim) {
+		// Defining the shifted solution as starting point
+		full_initial_point = starting_point_;
+	} else if (motion_solution_.size() == 0) {
 		// Getting the initial and ending locomotion state
 		WholeBodyState starting_system_state = dynamical_system_->getInitialState();
 		WholeBodyState ending_system_state = dynamical_system_->getTerminalState();
@@ -126,7 +214,8 @@ void OptimalControl::getStartingPoint(double* decision, int decision_dim)
 			dynamical_system_->fromWholeBodyState(current_state, current_system_state);
 
 			// Adding the current state vector
-			full_initial_point.segment(k * state_dimension_, state_dimension_) = current_state;
+			unsigned int state_dimension = dynamical_system_->getDimensionOfState();
+			full_initial_point.segment(k * state_dimension, state_dimension) = current_state;
 		}
 	} else {
 		// Defining the current locomotion solution as starting point
@@ -141,6 +230,63 @@ void OptimalControl::getStartingPoint(double* decision, int decision_dim)
 }
 
 
+void OptimalControl::shiftStartingPoint(const Eigen::VectorXd& solution,
+										double shift_time)
+{
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	if (solution.size() != horizon_ * state_dim) {
+		printf(YELLOW_ "Warning: could not shift the solution because its dimension doesn't match "
+				"the horizon\n" COLOR_RESET);
+		starting_point_.resize(0);
+		return;
+	}
+
+	// Computing the ending time of every knot w.r.t. the initial state of the last solution
+	std::vector<double> knot_end(horizon_);
+	double time = 0.;
+	for (unsigned int k = 0; k < horizon_; k++) {
+		if (dynamical_system_->isFixedStepIntegration())
+			time += dynamical_system_->getFixedStepTime();
+		else
+			time += solution(k * state_dim);
+		knot_end[k] = time;
+	}
+
+	// Interpolating the decision states at the shifted time of every knot. Note that the
+	// shifted times are always after the ending time of the first knot
+	starting_point_.resize(horizon_ * state_dim);
+	unsigned int knot_shift = 0;
+	unsigned int j = 0;
+	for (unsigned int k = 0; k < horizon_; k++) {
+		double shifted_time = knot_end[k] + std::max(shift_time, 0.);
+		while (j + 1 < horizon_ && knot_end[j + 1] <= shifted_time)
+			j++;
+
+		if (j + 1 == horizon_) {
+			starting_point_.segment(k * state_dim, state_dim) =
+					solution.segment(j * state_dim, state_dim);
+			if (k == 0)
+				knot_shift = j;
+		} else {
+			double alpha = (shifted_time - knot_end[j]) / (knot_end[j + 1] - knot_end[j]);
+			starting_point_.segment(k * state_dim, state_dim) =
+					(1 - alpha) * solution.segment(j * state_dim, state_dim) +
+					alpha * solution.segment((j + 1) * state_dim, state_dim);
+			if (k == 0)
+				knot_shift = (alpha < 0.5) ? j : j + 1;
+		}
+	}
+
+	// Shifting the multipliers of the dual solution by the closest number of knots
+	if (knot_shift > 0 && bound_lmult_.size() == starting_point_.size() &&
+			constraint_mult_.size() == constraint_dimension_) {
+		shiftKnotBlocks(bound_lmult_, state_dim, knot_shift);
+		shiftKnotBlocks(bound_umult_, state_dim, knot_shift);
+		shiftKnotBlocks(constraint_mult_, knot_constraint_dimension_, knot_shift);
+	}
+}
+
+
 void OptimalControl::evaluateBounds(double* decision_lbound, int decision_dim1,
 									double* decision_ubound, int decision_dim2,
 									double* constraint_lbound, int constraint_dim1,
@@ -163,11 +309,11 @@ void OptimalControl::evaluateBounds(double* decision_lbound, int decision_dim1,
 	dynamical_system_->fromWholeBodyState(state_upper_bound, locomotion_upper_bound);
 
 	// Getting the lower and upper constraint bounds for a certain time
-	if (constraint_dimension_ != 0) {
+	if (knot_constraint_dimension_ != 0) {
 		unsigned int index = 0;
 		unsigned int num_constraints = constraints_.size();
-		Eigen::VectorXd constraint_lower_bound = Eigen::VectorXd::Zero(constraint_dimension_);
-		Eigen::VectorXd constraint_upper_bound = Eigen::VectorXd::Zero(constraint_dimension_);
+		Eigen::VectorXd constraint_lower_bound = Eigen::VectorXd::Zero(knot_constraint_dimension_);
+		Eigen::VectorXd constraint_upper_bound = Eigen::VectorXd::Zero(knot_constraint_dimension_);
 		for (unsigned int j = 0; j < num_constraints + 1; j++) {
 			Eigen::VectorXd lower_bound, upper_bound;
 			unsigned int current_bound_dim = 0;
@@ -207,18 +353,19 @@ void OptimalControl::evaluateBounds(double* decision_lbound, int decision_dim1,
 		// Setting the full-constraint lower and upper bounds for the predefined horizon
 		for (unsigned int k = 0; k < horizon_; k++) {
 			// Setting dynamic system bounds
-			full_constraint_lower_bound.segment(k * constraint_dimension_,
-												constraint_dimension_) = constraint_lower_bound;
-			full_constraint_upper_bound.segment(k * constraint_dimension_,
-												constraint_dimension_) = constraint_upper_bound;
+			full_constraint_lower_bound.segment(k * knot_constraint_dimension_,
+												knot_constraint_dimension_) = constraint_lower_bound;
+			full_constraint_upper_bound.segment(k * knot_constraint_dimension_,
+												knot_constraint_dimension_) = constraint_upper_bound;
 		}
 	}
 
 	// Setting the full-state lower and upper bounds for the predefined horizon
+	unsigned int state_dimension = dynamical_system_->getDimensionOfState();
 	for (unsigned int k = 0; k < horizon_; k++) {
 		// Setting state bounds
-		full_state_lower_bound.segment(k * state_dimension_, state_dimension_) = state_lower_bound;
-		full_state_upper_bound.segment(k * state_dimension_, state_dimension_) = state_upper_bound;
+		full_state_lower_bound.segment(k * state_dimension, state_dimension) = state_lower_bound;
+		full_state_upper_bound.segment(k * state_dimension, state_dimension) = state_upper_bound;
 	}
 
 	// Computing the terminal bounds in case of full trajectory optimization
@@ -234,9 +381,9 @@ void OptimalControl::evaluateBounds(double* decision_lbound, int decision_dim1,
 		}
 
 		// Setting the terminal bounds
-		full_constraint_lower_bound.segment(horizon_ * constraint_dimension_,
+		full_constraint_lower_bound.segment(horizon_ * knot_constraint_dimension_,
 											terminal_constraint_dimension_) = terminal_lower_bound;
-		full_constraint_upper_bound.segment(horizon_ * constraint_dimension_,
+		full_constraint_upper_bound.segment(horizon_ * knot_constraint_dimension_,
 											terminal_constraint_dimension_) = terminal_upper_bound;
 	}
 }
@@ -250,172 +397,324 @@ void OptimalControl::evaluateConstraints(double* constraint, int constraint_dim,
 	Eigen::Map<Eigen::VectorXd> full_constraint(constraint, constraint_dim);
 	full_constraint.setZero();
 
-	if (state_dimension_ != (decision_var.size() / horizon_)) {
+	if (state_dimension_ != (unsigned) decision_var.size()) {
 		printf(RED_ "FATAL: the state and decision dimensions are not consistent\n" COLOR_RESET);
 		exit(EXIT_FAILURE);
 	}
 
-	// Getting the initial conditions of the locomotion state
-	WholeBodyState locomotion_initial_cond = dynamical_system_->getInitialState();
+	// Converting the decision variables to the whole-body state of every knot
+	computeKnotStates(decision_var);
+
+	// Computing the active and inactive constraints for a predefined horizon. The knots are
+	// independent given their whole-body states, so they are evaluated concurrently, in which
+	// every thread uses its own components
+	if (knot_constraint_dimension_ != 0) {
+#pragma omp parallel for num_threads(knot_models_.size()) schedule(static)
+		for (int k = 0; k < (int) horizon_; k++) {
+			computeKnotConstraints(full_constraint.segment(k * knot_constraint_dimension_,
+														   knot_constraint_dimension_),
+								   knot_models_[getThreadIndex()], k);
+		}
+	}
 
-	// Setting the initial state
-	unsigned int num_constraints = constraints_.size();
-	for (unsigned int j = 0; j < num_constraints + 1; j++) {
-		if (j == 0) // dynamic system constraint
-			dynamical_system_->setLastState(locomotion_initial_cond);
-		else
-			constraints_[j-1]->setLastState(locomotion_initial_cond);
+	// Computing the terminal constraint in case of full trajectory optimization
+	if (dynamical_system_->isFullTrajectoryOptimization()) {
+		Eigen::VectorXd constraint;
+		dynamical_system_->computeTerminalConstraint(constraint, knot_states_[horizon_]);
+
+		// Setting in the full constraint vector
+		full_constraint.segment(horizon_ * knot_constraint_dimension_,
+								terminal_constraint_dimension_) = constraint;
 	}
 
-	// Computing the active and inactive constraints for a predefined horizon
-	WholeBodyState system_state(dynamical_system_->getFloatingBaseSystem().getJointDoF());
-	Eigen::VectorXd decision_state = Eigen::VectorXd::Zero(state_dimension_);
-	unsigned int index = 0;
-	for (unsigned int k = 0; k < horizon_; k++) {
-		// Converting the decision variable for a certain time to a robot state
-		decision_state = decision_var.segment(k * state_dimension_, state_dimension_);
-		dynamical_system_->toWholeBodyState(system_state, decision_state);
+	// Resetting the state buffer
+	resetStateBuffers();
+}
 
-		// Adding the time information in cases that time is not a decision variable
-		if (dynamical_system_->isFixedStepIntegration())
-			system_state.duration = dynamical_system_->getFixedStepTime();
-		system_state.time += system_state.duration;
 
-		// Computing the constraints for a certain time
-		if (constraint_dimension_ != 0) {
-			for (unsigned int j = 0; j < num_constraints + 1; j++) {
-				Eigen::VectorXd constraint;
-				unsigned int current_constraint_dim = 0;
-				if (j == 0) {// dynamic system constraint
-					// Evaluating the dynamical constraint
-					if (!dynamical_system_->isSoftConstraint()) {
-						dynamical_system_->compute(constraint, system_state);
-						dynamical_system_->setLastState(system_state);
-
-						// Checking the constraint dimension
-						current_constraint_dim = dynamical_system_->getConstraintDimension();
-						if (current_constraint_dim != (unsigned) constraint.size()) {
-							printf(RED_ "FATAL: the constraint dimension of %s constraint is not consistent\n"
-									COLOR_RESET, dynamical_system_->getName().c_str());
-							exit(EXIT_FAILURE);
-						}
-					}
-				} else {
-					// Evaluating the constraints
-					if (!constraints_[j-1]->isSoftConstraint()) {
-						constraints_[j-1]->compute(constraint, system_state);
-						constraints_[j-1]->setLastState(system_state);
-
-						// Checking the constraint dimension
-						current_constraint_dim = constraints_[j-1]->getConstraintDimension();
-						if (current_constraint_dim != (unsigned) constraint.size()) {
-							printf(RED_ "FATAL: the constraint dimension of %s constraint is not consistent\n"
-									COLOR_RESET, constraints_[j-1]->getName().c_str());
-							exit(EXIT_FAILURE);
-						}
-					}
-				}
+void OptimalControl::evaluateCosts(double& cost,
+								   const double* decision, int decision_dim)
+{
+	// Eigen interfacing to raw buffers
+	const Eigen::Map<const Eigen::VectorXd> decision_var(decision, decision_dim);
 
-				// Setting in the full constraint vector
-				full_constraint.segment(index, current_constraint_dim) = constraint;
+	if (state_dimension_ != (unsigned) decision_var.size()) {
+		printf(RED_ "FATAL: the state and decision dimensions are not consistent\n" COLOR_RESET);
+		exit(EXIT_FAILURE);
+	}
 
-				index += current_constraint_dim;
-			}
-		}
+	// Converting the decision variables to the whole-body state of every knot
+	computeKnotStates(decision_var);
 
-		// Computing the terminal constraint in case of full trajectory optimization
-		if (dynamical_system_->isFullTrajectoryOptimization()) {
-			if (k == horizon_ - 1) {
-				Eigen::VectorXd constraint;
-				dynamical_system_->computeTerminalConstraint(constraint, system_state);
+	// Computing the cost and soft-constraint values of every knot concurrently
+	unsigned int num_constraints = constraints_.size();
+	unsigned int num_cost_functions = costs_.size();
+	knot_costs_.setZero(num_cost_functions + num_constraints + 1, horizon_);
+#pragma omp parallel for num_threads(knot_models_.size()) schedule(static)
+	for (int k = 0; k < (int) horizon_; k++)
+		computeKnotCosts(knot_costs_.col(k), knot_models_[getThreadIndex()], k);
 
-				// Setting in the full constraint vector
-				full_constraint.segment(index, terminal_constraint_dimension_) = constraint;
+	// Adding up the values in the knot order, so the cost doesn't depend on the number of threads
+	cost = 0;
+	for (unsigned int k = 0; k < horizon_; k++) {
+		for (unsigned int j = 0; j < num_cost_functions; j++)
+			cost += knot_costs_(j,k);
 
-				index += terminal_constraint_dimension_;
-			}
+		for (unsigned int j = 0; j < num_constraints + 1; j++) {
+			Constraint<WholeBodyState>* constraint =
+					(j == 0) ? dynamical_system_ : constraints_[j-1];
+			if (constraint->isSoftConstraint())
+				cost += knot_costs_(num_cost_functions + j, k);
 		}
 	}
 
 	// Resetting the state buffer
-	for (unsigned int j = 0; j < num_constraints + 1; j++) {
-		if (j == 0) // dynamic system constraint
-			dynamical_system_->resetStateBuffer();
-		else
-			constraints_[j-1]->resetStateBuffer();
-	}
+	resetStateBuffers();
 }
 
 
-void OptimalControl::evaluateCosts(double& cost,
-								   const double* decision, int decision_dim)
+void OptimalControl::evaluateCostGradient(double* gradient, int grad_dim,
+										  const double* decision, int decision_dim)
 {
+	// There isn't a decision state when the solver checks the gradient implementation
+	if (decision == NULL)
+		return;
+
 	// Eigen interfacing to raw buffers
-	const Eigen::Map<const Eigen::VectorXd> decision_var(decision, decision_dim);
+	Eigen::Map<Eigen::VectorXd> full_gradient(gradient, grad_dim);
+	Eigen::VectorXd decision_var = Eigen::Map<const Eigen::VectorXd>(decision, decision_dim);
+	full_gradient.setZero();
 
-	if (state_dimension_ != (decision_var.size() / horizon_)) {
+	if (state_dimension_ != (unsigned) decision_var.size()) {
 		printf(RED_ "FATAL: the state and decision dimensions are not consistent\n" COLOR_RESET);
 		exit(EXIT_FAILURE);
 	}
 
-	// Initializing the cost value
-	cost = 0;
-
-	// Getting the initial conditions of the locomotion state
-	WholeBodyState locomotion_initial_cond = dynamical_system_->getInitialState();
+	// Computing the starting time of every knot
+	computeKnotTimes(decision_var);
 
-	// Setting the initial state
+	// Computing the gradient of the costs and soft-constraints per knot
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
 	unsigned int num_constraints = constraints_.size();
-	for (unsigned int j = 0; j < num_constraints + 1; j++) {
-		if (j == 0) // dynamic system constraint
-			dynamical_system_->setLastState(locomotion_initial_cond);
-		else
-			constraints_[j-1]->setLastState(locomotion_initial_cond);
+	unsigned int num_cost_functions = costs_.size();
+	Eigen::VectorXd knot_gradient, fd_gradient(2 * state_dim);
+	Eigen::VectorXd zero_state = Eigen::VectorXd::Zero(state_dim);
+	for (unsigned int k = 0; k < horizon_; k++) {
+		for (unsigned int j = 0; j < num_cost_functions; j++) {
+			// Evaluating the analytic gradient, which is described as whole-body state. The
+			// gradient state is zero-initialized in the decision variables
+			toKnotState(knot_state_, decision_var.segment(k * state_dim, state_dim), knot_time_[k]);
+			dynamical_system_->toWholeBodyState(gradient_state_, zero_state);
+			if (costs_[j]->computeGradient(gradient_state_, knot_state_)) {
+				dynamical_system_->fromWholeBodyState(knot_gradient, gradient_state_);
+				full_gradient.segment(k * state_dim, state_dim) += knot_gradient;
+			} else {
+				computeKnotCostGradient(fd_gradient, costs_[j], NULL, k, decision_var);
+				full_gradient.segment(k * state_dim, state_dim) += fd_gradient.tail(state_dim);
+			}
+		}
+
+		// The soft-constraints depend on the current and last decision states
+		for (unsigned int j = 0; j < num_constraints + 1; j++) {
+			Constraint<WholeBodyState>* constraint =
+					(j == 0) ? dynamical_system_ : constraints_[j-1];
+			if (!constraint->isSoftConstraint())
+				continue;
+
+			computeKnotCostGradient(fd_gradient, NULL, constraint, k, decision_var);
+			if (k > 0)
+				full_gradient.segment((k - 1) * state_dim, state_dim) += fd_gradient.head(state_dim);
+			full_gradient.segment(k * state_dim, state_dim) += fd_gradient.tail(state_dim);
+		}
 	}
 
-	// Computing the cost for predefined horizon
-	WholeBodyState system_state(dynamical_system_->getFloatingBaseSystem().getJointDoF());
-	for (unsigned int k = 0; k < horizon_; k++) {
-		// Converting the decision variable for a certain time to a robot state
-		Eigen::VectorXd decision_state = decision_var.segment(k * state_dimension_, state_dimension_);
-		dynamical_system_->toWholeBodyState(system_state, decision_state);
+	// Resetting the state buffer
+	resetStateBuffers();
+}
 
-		// Adding the time information in cases that time is not a decision variable
-		if (dynamical_system_->isFixedStepIntegration())
-			system_state.duration = dynamical_system_->getFixedStepTime();
-		system_state.time += system_state.duration;
 
-		// Computing the cost function for a certain time
-		double simple_cost;
-		unsigned int num_cost_functions = costs_.size();
-		for (unsigned int j = 0; j < num_cost_functions; j++) {
-			costs_[j]->compute(simple_cost, system_state);
-			cost += simple_cost;
+void OptimalControl::evaluateConstraintJacobian(double* jacobian_values, int nonzero_dim1,
+												int* row_entries, int nonzero_dim2,
+												int* col_entries, int nonzero_dim3,
+												const double* decision, int decision_dim,
+												bool flag)
+{
+	// Returning the precomputed sparsity pattern
+	if (flag) {
+		for (int i = 0; i < nonzero_dim2; i++) {
+			row_entries[i] = jacobian_rows_[i];
+			col_entries[i] = jacobian_cols_[i];
 		}
+		return;
+	}
 
-		// Computing the soft-constraints for a certain time
-		for (unsigned int j = 0; j < num_constraints + 1; j++) {
-			if (j == 0) {// dynamic system constraint
-				if (dynamical_system_->isSoftConstraint()) {
-					dynamical_system_->computeSoft(simple_cost, system_state);
-					dynamical_system_->setLastState(system_state);
-					cost += simple_cost;
-				}
-			} else if (constraints_[j-1]->isSoftConstraint()) {
-				constraints_[j-1]->computeSoft(simple_cost, system_state);
-				constraints_[j-1]->setLastState(system_state);
-				cost += simple_cost;
+	// There isn't a decision state when the solver checks the jacobian implementation
+	if (decision == NULL)
+		return;
+
+	// Eigen interfacing to raw buffers
+	Eigen::Map<Eigen::VectorXd> full_jacobian(jacobian_values, nonzero_dim1);
+	Eigen::VectorXd decision_var = Eigen::Map<const Eigen::VectorXd>(decision, decision_dim);
+
+	if (state_dimension_ != (unsigned) decision_var.size() ||
+			jacobian_rows_.size() != (unsigned) nonzero_dim1) {
+		printf(RED_ "FATAL: the jacobian and decision dimensions are not consistent\n" COLOR_RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	// Computing the starting time of every knot
+	computeKnotTimes(decision_var);
+
+	// Computing the jacobian blocks of the constraints per knot. Each block is described with
+	// respect to the last and current decision states, and it's copied in the same order of the
+	// sparsity pattern, i.e. row-wise
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int num_constraints = constraints_.size();
+	unsigned int index = 0;
+	if (knot_constraint_dimension_ != 0) {
+		Eigen::MatrixXd knot_jacobian(knot_constraint_dimension_, 2 * state_dim);
+		for (unsigned int k = 0; k < horizon_; k++) {
+			unsigned int row = 0;
+			for (unsigned int j = 0; j < num_constraints + 1; j++) {
+				Constraint<WholeBodyState>* constraint =
+						(j == 0) ? dynamical_system_ : constraints_[j-1];
+				if (constraint->isSoftConstraint())
+					continue;
+
+				unsigned int constraint_dim = constraint->getConstraintDimension();
+				computeKnotJacobian(knot_jacobian.middleRows(row, constraint_dim),
+									constraint, k, decision_var);
+				row += constraint_dim;
+			}
+
+			// The first knot only depends on the current decision state
+			unsigned int first_col = (k == 0) ? state_dim : 0;
+			unsigned int num_cols = 2 * state_dim - first_col;
+			for (unsigned int r = 0; r < knot_constraint_dimension_; r++) {
+				full_jacobian.segment(index, num_cols) =
+						knot_jacobian.row(r).segment(first_col, num_cols).transpose();
+				index += num_cols;
 			}
 		}
 	}
 
+	// Computing the jacobian of the terminal constraint in case of full trajectory optimization.
+	// It only depends on the last decision state, and it's approximated with finite differences
+	if (terminal_constraint_dimension_ != 0) {
+		unsigned int last_idx = (horizon_ - 1) * state_dim;
+		Eigen::MatrixXd terminal_jacobian(terminal_constraint_dimension_, state_dim);
+		Eigen::VectorXd terminal_plus, terminal_minus;
+		for (unsigned int i = 0; i < state_dim; i++) {
+			double value = decision_var(last_idx + i);
+
+			decision_var(last_idx + i) = value + epsilon_;
+			toKnotState(knot_state_, decision_var.segment(last_idx, state_dim), knot_time_[horizon_ - 1]);
+			dynamical_system_->computeTerminalConstraint(terminal_plus, knot_state_);
+
+			decision_var(last_idx + i) = value - epsilon_;
+			toKnotState(knot_state_, decision_var.segment(last_idx, state_dim), knot_time_[horizon_ - 1]);
+			dynamical_system_->computeTerminalConstraint(terminal_minus, knot_state_);
+
+			decision_var(last_idx + i) = value;
+			terminal_jacobian.col(i) = (terminal_plus - terminal_minus) / (2 * epsilon_);
+		}
+
+		for (unsigned int r = 0; r < terminal_constraint_dimension_; r++) {
+			full_jacobian.segment(index, state_dim) = terminal_jacobian.row(r).transpose();
+			index += state_dim;
+		}
+	}
+
 	// Resetting the state buffer
-	for (unsigned int j = 0; j < num_constraints + 1; j++) {
-		if (j == 0) // dynamic system constraint
-			dynamical_system_->resetStateBuffer();
-		else
-			constraints_[j-1]->resetStateBuffer();
+	resetStateBuffers();
+}
+
+
+void OptimalControl::evaluateLagrangianHessian(double* hessian_values, int nonzero_dim1,
+											   int* row_entries, int nonzero_dim2,
+											   int* col_entries, int nonzero_dim3,
+											   double obj_factor,
+											   const double* lagrange, int constraint_dim,
+											   const double* decision, int decision_dim,
+											   bool flag)
+{
+	// Returning the precomputed sparsity pattern
+	if (flag) {
+		for (int i = 0; i < nonzero_dim2; i++) {
+			row_entries[i] = hessian_rows_[i];
+			col_entries[i] = hessian_cols_[i];
+		}
+		return;
 	}
+
+	// There isn't a decision state when the solver checks the Hessian implementation
+	if (decision == NULL)
+		return;
+
+	// Eigen interfacing to raw buffers
+	Eigen::Map<Eigen::VectorXd> full_hessian(hessian_values, nonzero_dim1);
+	Eigen::VectorXd decision_var = Eigen::Map<const Eigen::VectorXd>(decision, decision_dim);
+	full_hessian.setZero();
+
+	if (state_dimension_ != (unsigned) decision_var.size() ||
+			hessian_rows_.size() != (unsigned) nonzero_dim1) {
+		printf(RED_ "FATAL: the Hessian and decision dimensions are not consistent\n" COLOR_RESET);
+		exit(EXIT_FAILURE);
+	}
+
+	// Computing the starting time of every knot
+	computeKnotTimes(decision_var);
+
+	// Computing the Hessian blocks per knot. Each block is described with respect to the last
+	// and current decision states
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int num_constraints = constraints_.size();
+	unsigned int num_cost_functions = costs_.size();
+	Eigen::MatrixXd knot_hessian(2 * state_dim, 2 * state_dim);
+	Eigen::VectorXd knot_diagonal;
+	Eigen::VectorXd zero_state = Eigen::VectorXd::Zero(state_dim);
+	for (unsigned int k = 0; k < horizon_; k++) {
+		knot_hessian.setZero();
+
+		// The costs only depend on the current decision state. The analytic Hessian is
+		// described as the diagonal of a whole-body state
+		if (obj_factor != 0.) {
+			for (unsigned int j = 0; j < num_cost_functions; j++) {
+				toKnotState(knot_state_, decision_var.segment(k * state_dim, state_dim),
+							knot_time_[k]);
+				dynamical_system_->toWholeBodyState(gradient_state_, zero_state);
+				if (costs_[j]->computeHessian(gradient_state_, knot_state_)) {
+					dynamical_system_->fromWholeBodyState(knot_diagonal, gradient_state_);
+					knot_hessian.bottomRightCorner(state_dim, state_dim).diagonal() +=
+							obj_factor * knot_diagonal;
+				} else
+					computeKnotCostHessian(knot_hessian.bottomRightCorner(state_dim, state_dim),
+										   obj_factor, costs_[j], k, decision_var);
+			}
+		}
+
+		// Adding the curvature of the constraints weighted by their multipliers
+		if (knot_constraint_dimension_ != 0 && lagrange != NULL) {
+			unsigned int row = k * knot_constraint_dimension_;
+			for (unsigned int j = 0; j < num_constraints + 1; j++) {
+				Constraint<WholeBodyState>* constraint =
+						(j == 0) ? dynamical_system_ : constraints_[j-1];
+				if (constraint->isSoftConstraint())
+					continue;
+
+				unsigned int dim = constraint->getConstraintDimension();
+				Eigen::Map<const Eigen::VectorXd> multipliers(lagrange + row, dim);
+				computeKnotConstraintHessian(knot_hessian, constraint, multipliers,
+											 k, decision_var);
+				row += dim;
+			}
+		}
+
+		addKnotHessian(full_hessian, knot_hessian, k);
+	}
+
+	// Resetting the state buffer
+	resetStateBuffers();
 }
 
 
@@ -541,6 +840,503 @@ WholeBodyTrajectory& OptimalControl::evaluateSolution(const Eigen::Ref<const Eig
 }
 
 
+void OptimalControl::initKnotModels()
+{
+	deleteKnotModels();
+
+	// The first thread uses the components of the optimal control problem
+	KnotModel model;
+	model.dynamical_system = dynamical_system_;
+	model.constraints = constraints_;
+	model.costs = costs_;
+	addKnotModel(model);
+
+	// Cloning the components for the rest of threads
+	for (unsigned int t = 1; t < num_threads_; t++) {
+		KnotModel replica;
+		replica.dynamical_system = dynamical_system_->clone();
+		bool cloned = replica.dynamical_system != NULL;
+		for (unsigned int i = 0; i < constraints_.size(); i++) {
+			replica.constraints.push_back(constraints_[i]->clone());
+			cloned &= replica.constraints.back() != NULL;
+		}
+		for (unsigned int i = 0; i < costs_.size(); i++) {
+			replica.costs.push_back(costs_[i]->clone());
+			cloned &= replica.costs.back() != NULL;
+		}
+		addKnotModel(replica);
+
+		if (!cloned) {
+			printf(YELLOW_ "Warning: the components of the optimal control problem could not be "
+					"cloned, so they are evaluated serially\n" COLOR_RESET);
+			deleteKnotModels();
+			addKnotModel(model);
+			return;
+		}
+	}
+}
+
+
+void OptimalControl::deleteKnotModels()
+{
+	// Deleting the cloned components, i.e. all except the ones of the first thread
+	for (unsigned int t = 1; t < knot_models_.size(); t++) {
+		delete knot_models_[t].dynamical_system;
+		for (unsigned int i = 0; i < knot_models_[t].constraints.size(); i++)
+			delete knot_models_[t].constraints[i];
+		for (unsigned int i = 0; i < knot_models_[t].costs.size(); i++)
+			delete knot_models_[t].costs[i];
+	}
+
+	// Deleting the kinematic caches, where the components of the first thread go back to
+	// their own caches
+	if (!knot_models_.empty()) {
+		KnotModel& knot_model = knot_models_[0];
+		if (knot_model.dynamical_system != NULL)
+			knot_model.dynamical_system->setKinematicCache(NULL);
+		for (unsigned int i = 0; i < knot_model.constraints.size(); i++)
+			knot_model.constraints[i]->setKinematicCache(NULL);
+	}
+	for (unsigned int t = 0; t < knot_models_.size(); t++)
+		delete knot_models_[t].kinematic_cache;
+	knot_models_.clear();
+}
+
+
+void OptimalControl::addKnotModel(KnotModel& knot_model)
+{
+	knot_model.kinematic_cache = new model::KinematicCache();
+	if (knot_model.dynamical_system != NULL)
+		knot_model.dynamical_system->setKinematicCache(knot_model.kinematic_cache);
+	for (unsigned int i = 0; i < knot_model.constraints.size(); i++) {
+		if (knot_model.constraints[i] != NULL)
+			knot_model.constraints[i]->setKinematicCache(knot_model.kinematic_cache);
+	}
+	knot_models_.push_back(knot_model);
+}
+
+
+unsigned int OptimalControl::getThreadIndex()
+{
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+
+void OptimalControl::computeKnotStates(const Eigen::Ref<const Eigen::VectorXd>& decision)
+{
+	// The first state is the initial state of the problem, and it's followed by the state of
+	// every knot. Note that the time accumulates from zero
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int num_joints = dynamical_system_->getFloatingBaseSystem().getJointDoF();
+	knot_states_.resize(horizon_ + 1);
+	knot_states_[0] = dynamical_system_->getInitialState();
+	double time = 0.;
+	for (unsigned int k = 0; k < horizon_; k++) {
+		WholeBodyState& system_state = knot_states_[k + 1];
+		system_state = WholeBodyState(num_joints);
+		toKnotState(system_state, decision.segment(k * state_dim, state_dim), time);
+		time = system_state.time;
+	}
+}
+
+
+void OptimalControl::computeKnotConstraints(Eigen::Ref<Eigen::VectorXd> constraint,
+											KnotModel& model,
+											unsigned int knot)
+{
+	// Computing the active and inactive constraints of the knot given the last state
+	unsigned int num_constraints = model.constraints.size();
+	unsigned int index = 0;
+	Eigen::VectorXd simple_constraint;
+	for (unsigned int j = 0; j < num_constraints + 1; j++) {
+		Constraint<WholeBodyState>* current_constraint =
+				(j == 0) ? model.dynamical_system : model.constraints[j-1];
+		if (current_constraint->isSoftConstraint())
+			continue;
+
+		current_constraint->setLastState(knot_states_[knot]);
+		current_constraint->compute(simple_constraint, knot_states_[knot + 1]);
+
+		// Checking the constraint dimension
+		unsigned int current_constraint_dim = current_constraint->getConstraintDimension();
+		if (current_constraint_dim != (unsigned) simple_constraint.size()) {
+			printf(RED_ "FATAL: the constraint dimension of %s constraint is not consistent\n"
+					COLOR_RESET, current_constraint->getName().c_str());
+			exit(EXIT_FAILURE);
+		}
+
+		// Setting in the knot constraint vector
+		constraint.segment(index, current_constraint_dim) = simple_constraint;
+		index += current_constraint_dim;
+	}
+}
+
+
+void OptimalControl::computeKnotCosts(Eigen::Ref<Eigen::VectorXd> cost,
+									  KnotModel& model,
+									  unsigned int knot)
+{
+	// Computing the cost functions of the knot
+	unsigned int num_cost_functions = model.costs.size();
+	for (unsigned int j = 0; j < num_cost_functions; j++)
+		model.costs[j]->compute(cost(j), knot_states_[knot + 1]);
+
+	// Computing the soft-constraints of the knot given the last state
+	unsigned int num_constraints = model.constraints.size();
+	for (unsigned int j = 0; j < num_constraints + 1; j++) {
+		Constraint<WholeBodyState>* constraint =
+				(j == 0) ? model.dynamical_system : model.constraints[j-1];
+		if (constraint->isSoftConstraint()) {
+			constraint->setLastState(knot_states_[knot]);
+			constraint->computeSoft(cost(num_cost_functions + j), knot_states_[knot + 1]);
+		}
+	}
+}
+
+
+void OptimalControl::shiftKnotBlocks(Eigen::VectorXd& vector,
+									 unsigned int block_dim,
+									 unsigned int num_knots)
+{
+	if (block_dim == 0)
+		return;
+
+	for (unsigned int k = 0; k < horizon_; k++) {
+		unsigned int knot = std::min(k + num_knots, horizon_ - 1);
+		vector.segment(k * block_dim, block_dim) = vector.segment(knot * block_dim, block_dim);
+	}
+}
+
+
+void OptimalControl::resetStateBuffers()
+{
+	for (unsigned int t = 0; t < knot_models_.size(); t++) {
+		knot_models_[t].dynamical_system->resetStateBuffer();
+		for (unsigned int j = 0; j < knot_models_[t].constraints.size(); j++)
+			knot_models_[t].constraints[j]->resetStateBuffer();
+	}
+}
+
+
+void OptimalControl::initJacobianStructure()
+{
+	// The constraints of a knot depend on its decision state and the last one (the first knot
+	// depends on the initial state instead), and the terminal constraint only depends on the
+	// decision state of the last knot. So, every row of a knot block is dense in both states
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	jacobian_rows_.clear();
+	jacobian_cols_.clear();
+	for (unsigned int k = 0; k < horizon_; k++) {
+		unsigned int first_col = (k == 0) ? k * state_dim : (k - 1) * state_dim;
+		unsigned int last_col = (k + 1) * state_dim;
+		for (unsigned int r = 0; r < knot_constraint_dimension_; r++) {
+			for (unsigned int c = first_col; c < last_col; c++) {
+				jacobian_rows_.push_back(k * knot_constraint_dimension_ + r);
+				jacobian_cols_.push_back(c);
+			}
+		}
+	}
+	for (unsigned int r = 0; r < terminal_constraint_dimension_; r++) {
+		for (unsigned int c = (horizon_ - 1) * state_dim; c < horizon_ * state_dim; c++) {
+			jacobian_rows_.push_back(horizon_ * knot_constraint_dimension_ + r);
+			jacobian_cols_.push_back(c);
+		}
+	}
+
+	// Setting the number of nonzero values of the jacobian
+	setNumberOfNonzeroJacobian(jacobian_rows_.size());
+}
+
+
+void OptimalControl::initHessianStructure()
+{
+	// The costs of a knot depend on its decision state, and the constraints also on the last
+	// one. So, every row of a knot is dense from the first variable of the last knot up to the
+	// diagonal, i.e. lower triangle of a block-tridiagonal matrix
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	hessian_rows_.clear();
+	hessian_cols_.clear();
+	hessian_offsets_.resize(horizon_ * state_dim);
+	for (unsigned int k = 0; k < horizon_; k++) {
+		unsigned int first_col = (k == 0) ? 0 : (k - 1) * state_dim;
+		for (unsigned int r = k * state_dim; r < (k + 1) * state_dim; r++) {
+			hessian_offsets_[r] = hessian_rows_.size();
+			for (unsigned int c = first_col; c <= r; c++) {
+				hessian_rows_.push_back(r);
+				hessian_cols_.push_back(c);
+			}
+		}
+	}
+
+	// Setting the number of nonzero values of the Hessian
+	setNumberOfNonzeroHessian(hessian_rows_.size());
+}
+
+
+void OptimalControl::computeKnotTimes(const Eigen::VectorXd& decision)
+{
+	// Note that the time accumulates from zero as in the evaluation of the constraints and costs
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	knot_time_.resize(horizon_);
+	double time = 0.;
+	for (unsigned int k = 0; k < horizon_; k++) {
+		knot_time_[k] = time;
+		if (dynamical_system_->isFixedStepIntegration())
+			time += dynamical_system_->getFixedStepTime();
+		else
+			time += decision(k * state_dim);
+	}
+}
+
+
+void OptimalControl::toKnotState(WholeBodyState& state,
+								 const Eigen::VectorXd& decision_state,
+								 double starting_time)
+{
+	dynamical_system_->toWholeBodyState(state, decision_state);
+
+	// Adding the time information in cases that time is not a decision variable
+	if (dynamical_system_->isFixedStepIntegration())
+		state.duration = dynamical_system_->getFixedStepTime();
+	state.time = starting_time + state.duration;
+}
+
+
+void OptimalControl::toKnotStates(unsigned int knot,
+								  const Eigen::VectorXd& decision)
+{
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	if (knot == 0) {
+		last_knot_state_ = dynamical_system_->getInitialState();
+		toKnotState(knot_state_, decision.segment(0, state_dim), 0.);
+	} else {
+		// The starting time of the knot depends on the duration of the last one
+		toKnotState(last_knot_state_, decision.segment((knot - 1) * state_dim, state_dim),
+					knot_time_[knot - 1]);
+		toKnotState(knot_state_, decision.segment(knot * state_dim, state_dim),
+					last_knot_state_.time);
+	}
+}
+
+
+void OptimalControl::computeKnotJacobian(Eigen::Ref<Eigen::MatrixXd> jacobian,
+										 Constraint<WholeBodyState>* constraint,
+										 unsigned int knot,
+										 Eigen::VectorXd& decision)
+{
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int constraint_dim = jacobian.rows();
+
+	// Evaluating the analytic jacobian if the constraint implements it
+	Eigen::MatrixXd current_jac, last_jac;
+	toKnotStates(knot, decision);
+	constraint->setLastState(last_knot_state_);
+	if (constraint->computeJacobian(current_jac, last_jac, knot_state_)) {
+		// Checking the jacobian dimension
+		if ((unsigned) current_jac.rows() != constraint_dim ||
+				(unsigned) current_jac.cols() != state_dim ||
+				(unsigned) last_jac.rows() != constraint_dim ||
+				(unsigned) last_jac.cols() != state_dim) {
+			printf(RED_ "FATAL: the jacobian dimension of %s constraint is not consistent\n"
+					COLOR_RESET, constraint->getName().c_str());
+			exit(EXIT_FAILURE);
+		}
+
+		jacobian.leftCols(state_dim) = last_jac;
+		jacobian.rightCols(state_dim) = current_jac;
+		return;
+	}
+
+	// Otherwise, approximating the jacobian with central differences over the last and current
+	// decision states. The first knot doesn't depend on decision variables of the last one
+	jacobian.setZero();
+	Eigen::VectorXd constraint_plus, constraint_minus;
+	unsigned int first_col = (knot == 0) ? state_dim : 0;
+	for (unsigned int c = first_col; c < 2 * state_dim; c++) {
+		unsigned int idx = knot * state_dim + c - state_dim;
+		double value = decision(idx);
+
+		decision(idx) = value + epsilon_;
+		toKnotStates(knot, decision);
+		constraint->setLastState(last_knot_state_);
+		constraint->compute(constraint_plus, knot_state_);
+
+		decision(idx) = value - epsilon_;
+		toKnotStates(knot, decision);
+		constraint->setLastState(last_knot_state_);
+		constraint->compute(constraint_minus, knot_state_);
+
+		decision(idx) = value;
+		jacobian.col(c) = (constraint_plus - constraint_minus) / (2 * epsilon_);
+	}
+}
+
+
+void OptimalControl::computeKnotCostGradient(Eigen::Ref<Eigen::VectorXd> gradient,
+											 Cost* cost,
+											 Constraint<WholeBodyState>* constraint,
+											 unsigned int knot,
+											 Eigen::VectorXd& decision)
+{
+	// Approximating the gradient with central differences. The costs only depend on the
+	// current decision state, and the soft-constraints also on the last one
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	gradient.setZero();
+	unsigned int first_col = (knot == 0 || cost != NULL) ? state_dim : 0;
+	for (unsigned int c = first_col; c < 2 * state_dim; c++) {
+		unsigned int idx = knot * state_dim + c - state_dim;
+		double value = decision(idx);
+
+		decision(idx) = value + epsilon_;
+		double cost_plus = evaluateKnotCost(cost, constraint, knot, decision);
+
+		decision(idx) = value - epsilon_;
+		double cost_minus = evaluateKnotCost(cost, constraint, knot, decision);
+
+		decision(idx) = value;
+		gradient(c) = (cost_plus - cost_minus) / (2 * epsilon_);
+	}
+}
+
+
+void OptimalControl::computeKnotCostHessian(Eigen::Ref<Eigen::MatrixXd> hessian,
+											double factor,
+											Cost* cost,
+											unsigned int knot,
+											Eigen::VectorXd& decision)
+{
+	// Approximating the Hessian with central differences of the gradient. If the cost doesn't
+	// implement the analytic gradient, it's also approximated with central differences, and
+	// the Hessian uses a larger step for bounding the round-off error
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int first_idx = knot * state_dim;
+	Eigen::MatrixXd cost_hessian(state_dim, state_dim);
+	Eigen::VectorXd zero_state = Eigen::VectorXd::Zero(state_dim);
+	Eigen::VectorXd gradient_plus, gradient_minus;
+	Eigen::VectorXd knot_gradient(2 * state_dim);
+	toKnotState(knot_state_, decision.segment(first_idx, state_dim), knot_time_[knot]);
+	dynamical_system_->toWholeBodyState(gradient_state_, zero_state);
+	bool analytic_gradient = cost->computeGradient(gradient_state_, knot_state_);
+	double step = analytic_gradient ? epsilon_ : sqrt(epsilon_);
+	for (unsigned int c = 0; c < state_dim; c++) {
+		double value = decision(first_idx + c);
+
+		decision(first_idx + c) = value + step;
+		if (analytic_gradient) {
+			toKnotState(knot_state_, decision.segment(first_idx, state_dim), knot_time_[knot]);
+			dynamical_system_->toWholeBodyState(gradient_state_, zero_state);
+			cost->computeGradient(gradient_state_, knot_state_);
+			dynamical_system_->fromWholeBodyState(gradient_plus, gradient_state_);
+		} else {
+			computeKnotCostGradient(knot_gradient, cost, NULL, knot, decision);
+			gradient_plus = knot_gradient.tail(state_dim);
+		}
+
+		decision(first_idx + c) = value - step;
+		if (analytic_gradient) {
+			toKnotState(knot_state_, decision.segment(first_idx, state_dim), knot_time_[knot]);
+			dynamical_system_->toWholeBodyState(gradient_state_, zero_state);
+			cost->computeGradient(gradient_state_, knot_state_);
+			dynamical_system_->fromWholeBodyState(gradient_minus, gradient_state_);
+		} else {
+			computeKnotCostGradient(knot_gradient, cost, NULL, knot, decision);
+			gradient_minus = knot_gradient.tail(state_dim);
+		}
+
+		decision(first_idx + c) = value;
+		cost_hessian.col(c) = (gradient_plus - gradient_minus) / (2 * step);
+	}
+
+	hessian += 0.5 * factor * (cost_hessian + cost_hessian.transpose());
+}
+
+
+void OptimalControl::computeKnotConstraintHessian(
+		Eigen::Ref<Eigen::MatrixXd> hessian,
+		Constraint<WholeBodyState>* constraint,
+		const Eigen::Ref<const Eigen::VectorXd>& multipliers,
+		unsigned int knot,
+		Eigen::VectorXd& decision)
+{
+	// Approximating the Hessian with central differences of the multiplier-weighted jacobian
+	// over the last and current decision states. If the constraint doesn't implement the
+	// analytic jacobian, it's also approximated with central differences (see
+	// computeKnotJacobian), and the Hessian uses a larger step for bounding the round-off
+	// error. The first knot doesn't depend on decision variables of the last one
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	Eigen::MatrixXd constraint_hessian = Eigen::MatrixXd::Zero(2 * state_dim, 2 * state_dim);
+	Eigen::MatrixXd current_jac, last_jac;
+	Eigen::MatrixXd knot_jac(multipliers.size(), 2 * state_dim);
+	Eigen::VectorXd gradient_plus(2 * state_dim), gradient_minus(2 * state_dim);
+	toKnotStates(knot, decision);
+	constraint->setLastState(last_knot_state_);
+	bool analytic_jacobian = constraint->computeJacobian(current_jac, last_jac, knot_state_);
+	double step = analytic_jacobian ? epsilon_ : sqrt(epsilon_);
+	unsigned int first_col = (knot == 0) ? state_dim : 0;
+	for (unsigned int c = first_col; c < 2 * state_dim; c++) {
+		unsigned int idx = knot * state_dim + c - state_dim;
+		double value = decision(idx);
+
+		decision(idx) = value + step;
+		computeKnotJacobian(knot_jac, constraint, knot, decision);
+		gradient_plus = knot_jac.transpose() * multipliers;
+
+		decision(idx) = value - step;
+		computeKnotJacobian(knot_jac, constraint, knot, decision);
+		gradient_minus = knot_jac.transpose() * multipliers;
+
+		decision(idx) = value;
+		constraint_hessian.col(c) = (gradient_plus - gradient_minus) / (2 * step);
+	}
+
+	hessian += 0.5 * (constraint_hessian + constraint_hessian.transpose());
+}
+
+
+void OptimalControl::addKnotHessian(Eigen::Ref<Eigen::VectorXd> hessian_values,
+									const Eigen::MatrixXd& knot_hessian,
+									unsigned int knot)
+{
+	// The block contributes to the diagonal blocks of the last and current knots, and to the
+	// block between them. The first knot only depends on the current decision state
+	unsigned int state_dim = dynamical_system_->getDimensionOfState();
+	unsigned int first_row = (knot == 0) ? state_dim : 0;
+	for (unsigned int r = first_row; r < 2 * state_dim; r++) {
+		unsigned int row = knot * state_dim + r - state_dim;
+		unsigned int offset = hessian_offsets_[row];
+		unsigned int first_col = hessian_cols_[offset];
+		for (unsigned int c = first_row; c <= r; c++) {
+			unsigned int col = knot * state_dim + c - state_dim;
+			hessian_values(offset + col - first_col) += knot_hessian(r, c);
+		}
+	}
+}
+
+
+double OptimalControl::evaluateKnotCost(Cost* cost,
+										Constraint<WholeBodyState>* constraint,
+										unsigned int knot,
+										const Eigen::VectorXd& decision)
+{
+	double value;
+	if (cost != NULL) {
+		unsigned int state_dim = dynamical_system_->getDimensionOfState();
+		toKnotState(knot_state_, decision.segment(knot * state_dim, state_dim), knot_time_[knot]);
+		cost->compute(value, knot_state_);
+	} else {
+		toKnotStates(knot, decision);
+		constraint->setLastState(last_knot_state_);
+		constraint->computeSoft(value, knot_state_);
+	}
+
+	return value;
+}
+
+
 void OptimalControl::addDynamicalSystem(DynamicalSystem* dynamical_system)
 {
 	if (is_added_dynamic_system_) {
@@ -551,14 +1347,16 @@ void OptimalControl::addDynamicalSystem(DynamicalSystem* dynamical_system)
 	printf(GREEN_ "Adding the %s dynamical system\n" COLOR_RESET, dynamical_system->getName().c_str());
 	dynamical_system_ = dynamical_system;
 	is_added_dynamic_system_ = true;
+	is_initialized_ = false;
 }
 
 
 void OptimalControl::removeDynamicalSystem()
 {
-	if (is_added_dynamic_system_)
+	if (is_added_dynamic_system_) {
 		is_added_dynamic_system_ = false;
-	else
+		is_initialized_ = false;
+	} else
 		printf(YELLOW_ "There was not added a dynamical system\n" COLOR_RESET);
 }
 
@@ -567,6 +1365,7 @@ void OptimalControl::addConstraint(Constraint<WholeBodyState>* constraint)
 {
 	printf(GREEN_ "Adding the %s constraint\n" COLOR_RESET, constraint->getName().c_str());
 	constraints_.push_back(constraint);
+	is_initialized_ = false;
 
 	if (!is_added_constraint_)
 		is_added_constraint_ = true;
@@ -584,6 +1383,7 @@ void OptimalControl::removeConstraint(std::string constraint_name)
 				// Deleting the constraint
 				delete constraints_.at(i);
 				constraints_.erase(constraints_.begin() + i);
+				is_initialized_ = false;
 
 				return;
 			}
@@ -602,6 +1402,7 @@ void OptimalControl::addCost(Cost* cost)
 
 	costs_.push_back(cost);
 	is_added_cost_ = true;
+	is_initialized_ = false;
 }
 
 
@@ -620,6 +1421,7 @@ void OptimalControl::removeCost(std::string cost_name)
 					// Deleting the cost
 					delete costs_.at(i);
 					costs_.erase(costs_.begin() + i);
+					is_initialized_ = false;
 
 					return;
 				}
@@ -635,12 +1437,25 @@ void OptimalControl::removeCost(std::string cost_name)
 }
 
 
+void OptimalControl::setNumberOfThreads(unsigned int num_threads)
+{
+	if (num_threads == 0)
+		num_threads_ = 1;
+	else
+		num_threads_ = num_threads;
+
+	is_initialized_ = false;
+}
+
+
 void OptimalControl::setHorizon(unsigned int horizon)
 {
 	if (horizon == 0)
 		horizon_ = 1;
 	else
 		horizon_ = horizon;
+
+	is_initialized_ = false;
 }
 
 
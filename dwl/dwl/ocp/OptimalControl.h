@@ -34,6 +34,33 @@ class OptimalControl : public model::OptimizationModel
 		 * vectors */
 		void init(bool only_soft_constraints);
 
+		/**
+		 * @brief Clones the optimal control problem, i.e. its dynamical system, constraints,
+		 * costs, horizon and starting point. The clone evaluates its knots serially, since it's
+		 * used for evaluating decision vectors concurrently
+		 * @return The cloned problem, or NULL if some component cannot be cloned
+		 */
+		OptimalControl* clone() const;
+
+		/**
+		 * @brief Indicates if the problem has to be initialized, i.e. if its components, horizon
+		 * or number of threads changed since the last initialization. Changes of the initial
+		 * and terminal states don't require it
+		 */
+		bool requiresInitialization();
+
+		/**
+		 * @brief Gets the stage-wise structure of the problem, where every knot is a stage, i.e.
+		 * the knot constraints depend on the current and previous knots
+		 * @param unsigned int& Number of stages (horizon)
+		 * @param unsigned int& Number of decision variables of every stage
+		 * @param unsigned int& Number of constraints of every stage
+		 * @return True if the problem has a stage-wise structure
+		 */
+		bool getStageStructure(unsigned int& num_stages,
+							   unsigned int& stage_dim,
+							   unsigned int& stage_constraint_dim);
+
 		/**
 		 * @brief Sets the initial trajectory
 		 * @param WholeBodyTrajectory& Initial whole-body trajectory
@@ -41,12 +68,25 @@ class OptimalControl : public model::OptimizationModel
 		void setStartingTrajectory(WholeBodyTrajectory& initial_trajectory);
 
 		/**
-		 * @brief Gets the starting point of the problem
+		 * @brief Gets the starting point of the problem. The solvers call it before every
+		 * solution, so it also updates the clones of the evaluation threads
 		 * @param double* Initial values for the decision variables, $x$
 		 * @param int Number of the decision variables
 		 */
 		void getStartingPoint(double* decision, int decision_dim);
 
+		/**
+		 * @brief Shifts the last solution in time for warm-starting the next computation (i.e.
+		 * receding horizon). The decision state of every knot is interpolated from the last
+		 * solution at its shifted time, where the ones beyond the horizon take the last knot.
+		 * The bound and constraint multipliers of the dual solution are shifted by the closest
+		 * number of knots. The starting point is used until a new starting trajectory is set
+		 * @param const Eigen::VectorXd& Last solution vector
+		 * @param double Shifting time, i.e. the elapsed time since the last initial state
+		 */
+		void shiftStartingPoint(const Eigen::VectorXd& solution,
+								double shift_time);
+
 		/**
 		 * @brief Evaluates the bounds of the optimal control problem
 		 * @param double* Lower bounds $x^L$ for $x$
@@ -84,6 +124,76 @@ class OptimalControl : public model::OptimizationModel
 		void evaluateConstraints(double* constraint, int constraint_dim,
 								 const double* decision, int decision_dim);
 
+		/**
+		 * @brief Evaluates the gradient of the cost function of the optimal control problem. The
+		 * cost of each knot depends only on its decision state, so the gradient is assembled per
+		 * knot from the analytic gradient of each cost (see Cost::computeGradient), and every
+		 * cost without one is approximated with finite differences over its knot
+		 * @param double* Array of the gradient of the cost function, $nabla_x f(x)$
+		 * @param int Number of the gradient variables
+		 * @param const double* Array of the decision variables, $x$, at which the gradient of the
+		 * cost function, $nabla_x f(x)$, is evaluated
+		 * @param int Number of decision variables (dimension of $x$)
+		 */
+		void evaluateCostGradient(double* gradient, int grad_dim,
+								  const double* decision, int decision_dim);
+
+		/**
+		 * @brief Evaluates the jacobian of the constraint function of the optimal control problem.
+		 * The constraints of each knot depend only on the current and last decision states, so
+		 * the jacobian is block-banded and its sparsity pattern is computed once in init(). The
+		 * blocks are filled per knot with the analytic jacobian of each constraint (see
+		 * Constraint::computeJacobian), and every constraint without one is approximated with
+		 * finite differences over its two knots
+		 * @param double* Array of the values of the jacobian
+		 * @param int Number of nonzero values of the jacobian
+		 * @param int* Row indices of the nonzero values of the jacobian
+		 * @param int Number of nonzero values of the jacobian
+		 * @param int* Column indices of the nonzero values of the jacobian
+		 * @param int Number of nonzero values of the jacobian
+		 * @param const double* Array of the decision variables, $x$, at which the jacobian is
+		 * evaluated
+		 * @param int Number of decision variables (dimension of $x$)
+		 * @param bool True for returning the sparsity pattern instead of the values
+		 */
+		void evaluateConstraintJacobian(double* jacobian_values, int nonzero_dim1,
+										int* row_entries, int nonzero_dim2,
+										int* col_entries, int nonzero_dim3,
+										const double* decision, int decision_dim,
+										bool flag);
+
+		/**
+		 * @brief Evaluates the Hessian of the Lagrangian of the optimal control problem. The
+		 * costs of each knot depend only on its decision state, and the constraints also on the
+		 * last one, so the Hessian is block-tridiagonal and its sparsity pattern (lower
+		 * triangle) is computed once in init(). The cost blocks are filled with the analytic
+		 * (or Gauss-Newton) Hessian of each cost (see Cost::computeHessian), and every cost
+		 * without one is approximated with finite differences of its gradient. The constraint
+		 * curvature is approximated with finite differences of the jacobians. The gradients and
+		 * jacobians that aren't analytic are also approximated with finite differences, so the
+		 * Hessian is complete
+		 * @param double* Array of the values of the Hessian
+		 * @param int Number of nonzero values of the Hessian
+		 * @param int* Row indices of the nonzero values of the Hessian
+		 * @param int Number of nonzero values of the Hessian
+		 * @param int* Column indices of the nonzero values of the Hessian
+		 * @param int Number of nonzero values of the Hessian
+		 * @param double Factor in front of the objective term in the Hessian
+		 * @param const double* Constraint multipliers at which the Hessian is evaluated
+		 * @param int Number of constraints (dimension of $g(x)$)
+		 * @param const double* Array of the decision variables, $x$, at which the Hessian is
+		 * evaluated
+		 * @param int Number of decision variables (dimension of $x$)
+		 * @param bool True for returning the sparsity pattern instead of the values
+		 */
+		void evaluateLagrangianHessian(double* hessian_values, int nonzero_dim1,
+									   int* row_entries, int nonzero_dim2,
+									   int* col_entries, int nonzero_dim3,
+									   double obj_factor,
+									   const double* lagrange, int constraint_dim,
+									   const double* decision, int decision_dim,
+									   bool flag);
+
 		/**
 		 * @brief Evaluates the solution from an optimizer
 		 * @param const Eigen::Ref<const Eigen::VectorXd>& Solution vector
@@ -124,6 +234,19 @@ class OptimalControl : public model::OptimizationModel
 		 */
 		void removeCost(std::string cost_name);
 
+		/**
+		 * @brief Sets the number of threads used for evaluating the costs and constraints of
+		 * the knots concurrently. Every thread evaluates its knots with its own clones of the
+		 * dynamical system, constraints and costs (see Constraint::clone()), so the evaluation
+		 * is identical to the serial one as long as they only depend on the state of the knot
+		 * and the last one. The clones are updated before every solution (see
+		 * getStartingPoint()), so they take the actual desired states and weights. If some
+		 * component cannot be cloned, the evaluation is serial. It takes effect in the next
+		 * initialization of the problem. The default value is 1
+		 * @param unsigned int Number of threads
+		 */
+		void setNumberOfThreads(unsigned int num_threads);
+
 		/**
 		 * @brief Sets the horizon steps
 		 * @param unsigned int Horizon
@@ -162,6 +285,9 @@ class OptimalControl : public model::OptimizationModel
 		/** @brief Indicates if it was added a cost in the solver */
 		bool is_added_cost_;
 
+		/** @brief Dimension of the constraint vector of a knot */
+		unsigned int knot_constraint_dimension_;
+
 		/** @brief Dimension of the terminal constraint vector */
 		unsigned int terminal_constraint_dimension_;
 
@@ -170,6 +296,237 @@ class OptimalControl : public model::OptimizationModel
 
 		/** @brief Whole-body solution */
 		WholeBodyTrajectory motion_solution_;
+
+
+	private:
+		/** @brief Defines the components of the problem used by an evaluation thread, and
+		 * the kinematic cache shared by them */
+		struct KnotModel
+		{
+			DynamicalSystem* dynamical_system;
+			std::vector<Constraint<WholeBodyState>*> constraints;
+			std::vector<Cost*> costs;
+			model::KinematicCache* kinematic_cache;
+		};
+
+		/** @brief Initializes the components of every evaluation thread, which are clones of
+		 * the problem components except for the first thread */
+		void initKnotModels();
+
+		/** @brief Deletes the cloned components and the kinematic caches of the evaluation
+		 * threads */
+		void deleteKnotModels();
+
+		/**
+		 * @brief Adds the components of an evaluation thread, which share a new kinematic
+		 * cache. So the kinematic quantities of a knot are computed once per thread
+		 * @param KnotModel& Components of the evaluation thread
+		 */
+		void addKnotModel(KnotModel& knot_model);
+
+		/** @brief Gets the index of the current evaluation thread */
+		unsigned int getThreadIndex();
+
+		/**
+		 * @brief Converts the decision vector to the whole-body states of every knot
+		 * (knot_states_), in which the first one is the initial state of the problem
+		 * @param const Eigen::Ref<const Eigen::VectorXd>& Decision vector
+		 */
+		void computeKnotStates(const Eigen::Ref<const Eigen::VectorXd>& decision);
+
+		/**
+		 * @brief Computes the active and inactive constraints of a certain knot
+		 * @param Eigen::Ref<Eigen::VectorXd> Constraint vector of the knot
+		 * @param KnotModel& Components used for the evaluation
+		 * @param unsigned int Knot index
+		 */
+		void computeKnotConstraints(Eigen::Ref<Eigen::VectorXd> constraint,
+									KnotModel& model,
+									unsigned int knot);
+
+		/**
+		 * @brief Computes the cost and soft-constraint values of a certain knot
+		 * @param Eigen::Ref<Eigen::VectorXd> Cost values of the knot, i.e. the costs followed
+		 * by the soft-constraints
+		 * @param KnotModel& Components used for the evaluation
+		 * @param unsigned int Knot index
+		 */
+		void computeKnotCosts(Eigen::Ref<Eigen::VectorXd> cost,
+							  KnotModel& model,
+							  unsigned int knot);
+
+		/**
+		 * @brief Shifts the knot blocks of a vector by a number of knots, where the blocks
+		 * beyond the horizon take the last one. The values after the knot blocks (e.g. the
+		 * terminal constraints) are kept
+		 * @param Eigen::VectorXd& Vector to shift
+		 * @param unsigned int Dimension of the block of a knot
+		 * @param unsigned int Number of knots to shift
+		 */
+		void shiftKnotBlocks(Eigen::VectorXd& vector,
+							 unsigned int block_dim,
+							 unsigned int num_knots);
+
+		/** @brief Resets the state buffer of the constraints of every evaluation thread */
+		void resetStateBuffers();
+
+		/** @brief Computes the block-banded sparsity pattern of the constraint jacobian */
+		void initJacobianStructure();
+
+		/** @brief Computes the block-tridiagonal sparsity pattern of the Lagrangian Hessian */
+		void initHessianStructure();
+
+		/**
+		 * @brief Computes the finite-difference Hessian of a cost in a certain knot from its
+		 * gradient. If the cost doesn't implement the analytic gradient, the gradient is also
+		 * approximated with finite differences
+		 * @param Eigen::Ref<Eigen::MatrixXd> Hessian of the knot, where the cost Hessian is added
+		 * @param double Factor of the cost Hessian
+		 * @param Cost* Cost
+		 * @param unsigned int Knot index
+		 * @param Eigen::VectorXd& Decision vector (restored after the finite differences)
+		 */
+		void computeKnotCostHessian(Eigen::Ref<Eigen::MatrixXd> hessian,
+									double factor,
+									Cost* cost,
+									unsigned int knot,
+									Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Computes the finite-difference Hessian of the multiplier-weighted constraint
+		 * in a certain knot from its jacobian. The Hessian is described with respect to the last
+		 * and current decision states, i.e. [last | current]. If the constraint doesn't
+		 * implement the analytic jacobian, the jacobian is also approximated with finite
+		 * differences
+		 * @param Eigen::Ref<Eigen::MatrixXd> Hessian of the knot, where the constraint Hessian
+		 * is added
+		 * @param Constraint<WholeBodyState>* Constraint
+		 * @param const Eigen::Ref<const Eigen::VectorXd>& Multipliers of the constraint
+		 * @param unsigned int Knot index
+		 * @param Eigen::VectorXd& Decision vector (restored after the finite differences)
+		 */
+		void computeKnotConstraintHessian(Eigen::Ref<Eigen::MatrixXd> hessian,
+										  Constraint<WholeBodyState>* constraint,
+										  const Eigen::Ref<const Eigen::VectorXd>& multipliers,
+										  unsigned int knot,
+										  Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Adds the lower triangle of the Hessian of a knot to the nonzero values of the
+		 * Lagrangian Hessian
+		 * @param Eigen::Ref<Eigen::VectorXd> Nonzero values of the Lagrangian Hessian
+		 * @param const Eigen::MatrixXd& Hessian of the knot, i.e. [last | current]
+		 * @param unsigned int Knot index
+		 */
+		void addKnotHessian(Eigen::Ref<Eigen::VectorXd> hessian_values,
+							const Eigen::MatrixXd& knot_hessian,
+							unsigned int knot);
+
+		/**
+		 * @brief Computes the starting time of every knot given a decision vector
+		 * @param const Eigen::VectorXd& Decision vector
+		 */
+		void computeKnotTimes(const Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Converts the decision state of a knot to a whole-body state
+		 * @param WholeBodyState& Whole-body state
+		 * @param const Eigen::VectorXd& Decision state of the knot
+		 * @param double Starting time of the knot
+		 */
+		void toKnotState(WholeBodyState& state,
+						 const Eigen::VectorXd& decision_state,
+						 double starting_time);
+
+		/**
+		 * @brief Converts the decision states of a knot and its last one to whole-body states
+		 * (knot_state_ and last_knot_state_). The last state of the first knot is the initial
+		 * state of the problem
+		 * @param unsigned int Knot index
+		 * @param const Eigen::VectorXd& Decision vector
+		 */
+		void toKnotStates(unsigned int knot,
+						  const Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Computes the jacobian of a constraint in a certain knot. The jacobian is
+		 * described with respect to the last and current decision states, i.e. [last | current]
+		 * @param Eigen::Ref<Eigen::MatrixXd> Jacobian of the constraint
+		 * @param Constraint<WholeBodyState>* Constraint
+		 * @param unsigned int Knot index
+		 * @param Eigen::VectorXd& Decision vector (restored after the finite differences)
+		 */
+		void computeKnotJacobian(Eigen::Ref<Eigen::MatrixXd> jacobian,
+								 Constraint<WholeBodyState>* constraint,
+								 unsigned int knot,
+								 Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Computes the finite-difference gradient of a cost or soft constraint in a
+		 * certain knot. The gradient is described with respect to the last and current decision
+		 * states, i.e. [last | current]. Only the current state is perturbed for costs
+		 * @param Eigen::Ref<Eigen::VectorXd> Gradient of the cost
+		 * @param Cost* Cost, or NULL for evaluating the soft constraint
+		 * @param Constraint<WholeBodyState>* Soft constraint
+		 * @param unsigned int Knot index
+		 * @param Eigen::VectorXd& Decision vector (restored after the finite differences)
+		 */
+		void computeKnotCostGradient(Eigen::Ref<Eigen::VectorXd> gradient,
+									 Cost* cost,
+									 Constraint<WholeBodyState>* constraint,
+									 unsigned int knot,
+									 Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Evaluates a cost or soft constraint in a certain knot
+		 * @param Cost* Cost, or NULL for evaluating the soft constraint
+		 * @param Constraint<WholeBodyState>* Soft constraint
+		 * @param unsigned int Knot index
+		 * @param const Eigen::VectorXd& Decision vector
+		 * @return The cost value
+		 */
+		double evaluateKnotCost(Cost* cost,
+								Constraint<WholeBodyState>* constraint,
+								unsigned int knot,
+								const Eigen::VectorXd& decision);
+
+		/** @brief Components of every evaluation thread */
+		std::vector<KnotModel> knot_models_;
+
+		/** @brief Number of evaluation threads */
+		unsigned int num_threads_;
+
+		/** @brief Whole-body states of the initial state and every knot */
+		std::vector<WholeBodyState> knot_states_;
+
+		/** @brief Cost and soft-constraint values of every knot (column-wise) */
+		Eigen::MatrixXd knot_costs_;
+
+		/** @brief Row and column indices of the nonzero values of the constraint jacobian */
+		std::vector<int> jacobian_rows_;
+		std::vector<int> jacobian_cols_;
+
+		/** @brief Row and column indices of the nonzero values of the Lagrangian Hessian, and
+		 * the index of the first nonzero value of every row */
+		std::vector<int> hessian_rows_;
+		std::vector<int> hessian_cols_;
+		std::vector<unsigned int> hessian_offsets_;
+
+		/** @brief Starting time of every knot */
+		std::vector<double> knot_time_;
+
+		/** @brief Whole-body states of the current and last knot */
+		WholeBodyState knot_state_;
+		WholeBodyState last_knot_state_;
+
+		/** @brief Whole-body state used for describing the analytic cost gradients */
+		WholeBodyState gradient_state_;
+
+		/** @brief Shifted starting point of the decision variables */
+		Eigen::VectorXd starting_point_;
+
+		/** @brief Indicates if the problem was initialized after its last structural change */
+		bool is_initialized_;
 };
 
 } //@namespace ocp
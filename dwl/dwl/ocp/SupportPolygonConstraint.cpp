@@ -1,4 +1,5 @@
 #include <dwl/ocp/SupportPolygonConstraint.h>
+#include <dwl/utils/AutoDiff.h>
 
 
 namespace dwl
@@ -21,6 +22,36 @@ SupportPolygonConstraint::~SupportPolygonConstraint()
 
 void SupportPolygonConstraint::compute(Eigen::VectorXd& constraint,
 									   const PolygonState& state)
+{
+	Eigen::MatrixXd lines;
+	computeLines(lines, state);
+	computeLineConstraint(constraint, lines, state.point(rbd::X), state.point(rbd::Y));
+}
+
+
+bool SupportPolygonConstraint::computeJacobian(Eigen::MatrixXd& jacobian,
+											   Eigen::MatrixXd& last_jacobian,
+											   const PolygonState& state)
+{
+	Eigen::MatrixXd lines;
+	computeLines(lines, state);
+
+	// Evaluating the constraint with the point coordinates as seeds
+	math::ADScalar x(state.point(rbd::X), 3, rbd::X);
+	math::ADScalar y(state.point(rbd::Y), 3, rbd::Y);
+	math::ADVector constraint;
+	computeLineConstraint(constraint, lines, x, y);
+
+	Eigen::VectorXd constraint_value;
+	math::getJacobian(constraint_value, jacobian, constraint, 3);
+	last_jacobian.setZero(jacobian.rows(), 3);
+
+	return true;
+}
+
+
+void SupportPolygonConstraint::computeLines(Eigen::MatrixXd& lines,
+											const PolygonState& state)
 {
 	// Ordering the polygon vertexes in order to implement the constraints
 	std::vector<Eigen::Vector3d> polygon = state.vertexes;
@@ -35,50 +66,56 @@ void SupportPolygonConstraint::compute(Eigen::VectorXd& constraint,
 	else
 		num_lines_ = num_vertex;
 
-
-	Eigen::Vector3d extended_point(state.point(rbd::X), state.point(rbd::Y), 1.);
 	if (num_lines_ > 2) { // this is a polygon, so it's imposed an inequality
-		// Computing the inequality constraints, i.e. imposing the point
-		// position inside the support polygon. This constraints can be
-		// expressed as P * [x; y; 1]^T >= 0. where the
+		// The inequality constraints impose the point position inside the support polygon.
+		// This constraints can be expressed as P * [x; y; 1]^T >= 0. where the
 		// P = [line1; line_2; ... line_n] is polygon matrix. The line is
 		// defined by its coefficient and a polygon margin
-		Eigen::MatrixXd polygon_mat = Eigen::MatrixXd::Zero(num_lines_, 3);
+		lines = Eigen::MatrixXd::Zero(num_lines_, 3);
 		math::LineCoeff2d line_coeff;
 		for (unsigned int j = 0; j < num_lines_; j++) {
 			// Computing the coefficients of the line between two points
 			line_coeff = math::lineCoeff(polygon[j], polygon[(j + 1) % num_lines_]); // normalized to use margin
 
 			// Filling the line in the polygon matrix
-			polygon_mat(j,0) = line_coeff.p;
-			polygon_mat(j,1) = line_coeff.q;
-			polygon_mat(j,2) = line_coeff.r - state.margin;
+			lines(j,0) = line_coeff.p;
+			lines(j,1) = line_coeff.q;
+			lines(j,2) = line_coeff.r - state.margin;
 		}
-		// Computing as inequality constraint (polygon support)
-		constraint = polygon_mat * extended_point;
 	} else if (num_lines_ == 1) { // this is a line, so it's imposed an equality
-		// Computing the equality constraints, i.e. imposing the point
-		// position inside the support line. This constraint can be
-		// expressed as p*x + q*y + r = 0. Note that here, we cannot impose
+		// The equality constraint imposes the point position inside the support line. This
+		// constraint can be expressed as p*x + q*y + r = 0. Note that here, we cannot impose
 		// a margin.
-		// Computing the coefficients of the line between two points
-		math::LineCoeff2d line_coeff;
-		line_coeff = math::lineCoeff(polygon[0], polygon[1]);
-
-		// Computing as equality constraint (support line)
-		double const_value = line_coeff.p * extended_point(rbd::X) +
-				line_coeff.q * extended_point(rbd::Y) + line_coeff.r;
-		constraint = Eigen::Vector2d(const_value, 0.);
+		math::LineCoeff2d line_coeff = math::lineCoeff(polygon[0], polygon[1]);
+		lines.resize(1, 3);
+		lines << line_coeff.p, line_coeff.q, line_coeff.r;
 	} else { // this is a point, so it's imposed an equality
-		// Computing the equality constraints, i.e. imposing the point
-		// position inside the support point. This constraint can be
-		double const_value = (extended_point(rbd::X) - polygon[0](rbd::X)) -
-				(extended_point(rbd::Y) - polygon[0](rbd::Y));
-		constraint = Eigen::Vector2d(const_value, 0.);
+		// The equality constraint imposes the point position inside the support point, i.e.
+		// (x - x_0) - (y - y_0) = 0
+		lines.resize(1, 3);
+		lines << 1., -1., polygon[0](rbd::Y) - polygon[0](rbd::X);
 	}
 }
 
 
+template<typename Scalar>
+void SupportPolygonConstraint::computeLineConstraint(
+		Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+		const Eigen::MatrixXd& lines,
+		const Scalar& x,
+		const Scalar& y)
+{
+	// The polygon is imposed as inequality, and the line or point as equality. Note that the
+	// equality constraints have two dimensions, where the second one is zero
+	unsigned int num_lines = lines.rows();
+	constraint.resize((num_lines_ > 2) ? num_lines_ : 2);
+	for (unsigned int j = 0; j < num_lines; j++)
+		constraint(j) = lines(j,0) * x + lines(j,1) * y + lines(j,2);
+	for (unsigned int j = num_lines; j < (unsigned) constraint.size(); j++)
+		constraint(j) = Scalar(0.);
+}
+
+
 void SupportPolygonConstraint::getBounds(Eigen::VectorXd& lower_bound,
 		   	   	   	   	   	   	   	     Eigen::VectorXd& upper_bound)
 {
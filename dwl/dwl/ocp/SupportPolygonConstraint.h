@@ -47,6 +47,18 @@ class SupportPolygonConstraint : public Constraint<PolygonState>
 		void compute(Eigen::VectorXd& constraint,
 					 const PolygonState& state);
 
+		/**
+		 * @brief Computes the exact jacobian of the constraint with respect to the point, which
+		 * is obtained by automatic differentiation. The vertexes of the polygon are constants
+		 * @param Eigen::MatrixXd& Jacobian with respect to the point
+		 * @param Eigen::MatrixXd& Jacobian with respect to the last state (zero)
+		 * @param const PolygonState& Polygon state
+		 * @return True since the jacobian is implemented
+		 */
+		bool computeJacobian(Eigen::MatrixXd& jacobian,
+							 Eigen::MatrixXd& last_jacobian,
+							 const PolygonState& state);
+
 		/**
 		 * @brief Gets the lower and upper bounds of the constraint
 		 * @param Eigen::VectorXd& Lower constraint bound
@@ -57,6 +69,30 @@ class SupportPolygonConstraint : public Constraint<PolygonState>
 
 
 	private:
+		/**
+		 * @brief Computes the coefficients of the polygon lines, i.e. a row [p q r] per line,
+		 * where the polygon could be a line or a point
+		 * @param Eigen::MatrixXd& Coefficients of the lines
+		 * @param const PolygonState& Polygon state
+		 */
+		void computeLines(Eigen::MatrixXd& lines,
+						  const PolygonState& state);
+
+		/**
+		 * @brief Computes the constraint of a point given the polygon lines, i.e.
+		 * p * x + q * y + r per line. It's templated on the scalar type for computing the
+		 * constraint value (double) and its jacobian (math::ADScalar)
+		 * @param Eigen::Matrix<Scalar,Eigen::Dynamic,1>& Evaluated constraint function
+		 * @param const Eigen::MatrixXd& Coefficients of the lines
+		 * @param const Scalar& Point position along the x-axis
+		 * @param const Scalar& Point position along the y-axis
+		 */
+		template<typename Scalar>
+		void computeLineConstraint(Eigen::Matrix<Scalar,Eigen::Dynamic,1>& constraint,
+								   const Eigen::MatrixXd& lines,
+								   const Scalar& x,
+								   const Scalar& y);
+
 		/** @brief Number of polygon lines */
 		unsigned int num_lines_;
 };
@@ -19,6 +19,12 @@ TerminalStateTrackingEnergyCost::~TerminalStateTrackingEnergyCost()
 }
 
 
+TerminalStateTrackingEnergyCost* TerminalStateTrackingEnergyCost::clone() const
+{
+	return new TerminalStateTrackingEnergyCost(*this);
+}
+
+
 void TerminalStateTrackingEnergyCost::compute(double& cost,
 											  const WholeBodyState& state)
 {
@@ -74,5 +80,56 @@ void TerminalStateTrackingEnergyCost::compute(double& cost,
 	}
 }
 
+
+bool TerminalStateTrackingEnergyCost::computeGradient(WholeBodyState& gradient,
+													  const WholeBodyState& state)
+{
+	// Computing the gradient of the base and joint position-tracking error
+	if (cost_variables_.base_pos)
+		gradient.base_pos = -2 * locomotion_weights_.base_pos.cwiseProduct(
+				desired_state_.base_pos - state.base_pos);
+	if (cost_variables_.joint_pos)
+		gradient.joint_pos = -2 * locomotion_weights_.joint_pos.cwiseProduct(
+				desired_state_.joint_pos - state.joint_pos);
+
+	// Computing the gradient of the base and joint velocity-tracking error
+	if (cost_variables_.base_vel)
+		gradient.base_vel = -2 * locomotion_weights_.base_vel.cwiseProduct(
+				desired_state_.base_vel - state.base_vel);
+	if (cost_variables_.joint_vel)
+		gradient.joint_vel = -2 * locomotion_weights_.joint_vel.cwiseProduct(
+				desired_state_.joint_vel - state.joint_vel);
+
+	// Computing the gradient of the base and joint acceleration-tracking error
+	if (cost_variables_.base_acc)
+		gradient.base_acc = -2 * locomotion_weights_.base_acc.cwiseProduct(
+				desired_state_.base_acc - state.base_acc);
+	if (cost_variables_.joint_acc)
+		gradient.joint_acc = -2 * locomotion_weights_.joint_acc.cwiseProduct(
+				desired_state_.joint_acc - state.joint_acc);
+
+	return true;
+}
+
+
+bool TerminalStateTrackingEnergyCost::computeHessian(WholeBodyState& hessian,
+													 const WholeBodyState& state)
+{
+	if (cost_variables_.base_pos)
+		hessian.base_pos = 2 * locomotion_weights_.base_pos;
+	if (cost_variables_.joint_pos)
+		hessian.joint_pos = 2 * locomotion_weights_.joint_pos;
+	if (cost_variables_.base_vel)
+		hessian.base_vel = 2 * locomotion_weights_.base_vel;
+	if (cost_variables_.joint_vel)
+		hessian.joint_vel = 2 * locomotion_weights_.joint_vel;
+	if (cost_variables_.base_acc)
+		hessian.base_acc = 2 * locomotion_weights_.base_acc;
+	if (cost_variables_.joint_acc)
+		hessian.joint_acc = 2 * locomotion_weights_.joint_acc;
+
+	return true;
+}
+
 } //@namespace ocp
 } //@namespace dwl
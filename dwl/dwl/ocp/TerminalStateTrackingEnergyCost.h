@@ -23,6 +23,9 @@ class TerminalStateTrackingEnergyCost : public Cost
 		/** @brief Destructor function */
 		~TerminalStateTrackingEnergyCost();
 
+		/** @brief Clones the cost */
+		TerminalStateTrackingEnergyCost* clone() const;
+
 		/**
 		 * @brief Computes the state-tracking energy cost given a locomotion state. The
 		 * state-tracking energy is defined as quadratic cost function
@@ -31,6 +34,24 @@ class TerminalStateTrackingEnergyCost : public Cost
 		 */
 		void compute(double& cost,
 					 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the analytic gradient of the state-tracking energy cost
+		 * @param WholeBodyState& Cost gradient
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic gradient is implemented
+		 */
+		bool computeGradient(WholeBodyState& gradient,
+							 const WholeBodyState& state);
+
+		/**
+		 * @brief Computes the Hessian of the state-tracking energy cost, which is constant
+		 * @param WholeBodyState& Diagonal of the cost Hessian
+		 * @param const WholeBodyState& Whole-body state
+		 * @return True since the analytic Hessian is implemented
+		 */
+		bool computeHessian(WholeBodyState& hessian,
+							const WholeBodyState& state);
 };
 
 } //@namespace ocp
@@ -10,7 +10,7 @@ namespace ocp
 
 template <typename TState>
 Constraint<TState>::Constraint() : constraint_dimension_(0), is_soft_(false),
-	soft_properties_(SoftConstraintProperties(10000., 0., 0.))
+	soft_properties_(SoftConstraintProperties(10000., 0., 0.)), kinematic_cache_(NULL)
 {
 	state_buffer_.set_capacity(4);
 }
@@ -23,6 +23,13 @@ Constraint<TState>::~Constraint()
 }
 
 
+template <typename TState>
+Constraint<TState>* Constraint<TState>::clone() const
+{
+	return NULL;
+}
+
+
 template <typename TState>
 void Constraint<TState>::modelFromURDFFile(std::string urdf_file,
 										   std::string system_file,
@@ -128,6 +135,15 @@ void Constraint<TState>::computeSoft(double& constraint_cost,
 }
 
 
+template <typename TState>
+bool Constraint<TState>::computeJacobian(Eigen::MatrixXd& jacobian,
+										 Eigen::MatrixXd& last_jacobian,
+										 const TState& state)
+{
+	return false;
+}
+
+
 template <typename TState>
 bool Constraint<TState>::isSoftConstraint()
 {
@@ -152,13 +168,33 @@ void Constraint<TState>::setLastState(TState& last_state)
 template <typename TState>
 void Constraint<TState>::resetStateBuffer()
 {
+	// Note that the components that weren't evaluated don't have states
+	if (state_buffer_.empty())
+		return;
+
 	unsigned int buffer_size = state_buffer_.size();
-	WholeBodyState empty_state(state_buffer_[0].joint_pos.size());
 	for (unsigned int i = 0; i < buffer_size; i++)
 		state_buffer_.push_back();
 }
 
 
+template <typename TState>
+void Constraint<TState>::setKinematicCache(model::KinematicCache* cache)
+{
+	kinematic_cache_ = cache;
+}
+
+
+template <typename TState>
+model::KinematicCache& Constraint<TState>::getKinematicCache()
+{
+	if (kinematic_cache_ != NULL)
+		return *kinematic_cache_;
+	else
+		return own_kinematic_cache_;
+}
+
+
 template <typename TState>
 unsigned int Constraint<TState>::getConstraintDimension()
 {
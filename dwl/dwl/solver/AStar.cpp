@@ -45,51 +45,41 @@ bool AStar::compute(Vertex source,
 void AStar::findShortestPath(Vertex source,
 							 Vertex target)
 {
-	// Defining the f_cost and g_cost
-	CostMap f_cost;
-	CostMap g_cost;
-
 	// Setting the initial time
 	time_started_ = clock();
 
 	// Number of expansions
 	expansions_ = 0;
 
-	// Defining the set of nodes already evaluated (openset), the set of
-	// tentative nodes to be evaluated (openset), and ordered openset queue
-	std::set< std::pair<Weight, Vertex>, pair_first_less<Weight, Vertex> > openset_queue;
-	std::map<Vertex, bool> openset;
-	std::map<Vertex, bool> closedset;
-
-	// Cost from start along best known path.
-	g_cost[source] = 0;
+	// Clearing the search data of the visited vertices, i.e. the g-cost, parent and closed
+	// flag of each vertex are stored in dense arrays indexed by the search table
+	resetSearch();
+	total_cost_ = std::numeric_limits<double>::max();
 
-	// Estimated total cost from start to goal
-	f_cost[source] = g_cost[source] + adjacency_->heuristicCost(source, target);
+	// Adding the start vertex to the open queue
+	unsigned int source_idx = getSearchIndex(source);
+	g_cost_[source_idx] = 0;
+	open_queue_.push(source_idx, QueueKey(adjacency_->heuristicCost(source, target), 0));
 
-	// Adding the start vertex to the openset
-	openset_queue.insert(std::pair<Weight, Vertex>(f_cost[source], source));
-	openset[source] = true;
-	double min_f_cost = std::numeric_limits<double>::max();
-	while ((!openset.empty()) && (g_cost[target] < min_f_cost)) {
-		Vertex current = openset_queue.begin()->second;
+	std::list<Edge> successors;
+	while (!open_queue_.empty()) {
+		unsigned int current_idx = open_queue_.pop();
+		Vertex current = search_table_.getVertex(current_idx);
 
 		// Checking if it is getted the target
 		if (adjacency_->isReachedGoal(target, current)) {
-			policy_[target] = current;
-			g_cost[target] = g_cost[current];
+			recordPolicy(current_idx);
+			if (current != target)
+				policy_[target] = current;
+			total_cost_ = g_cost_[current_idx];
 			break;
 		}
 
-		// Deleting the current vertex to the openset list
-		openset_queue.erase(openset_queue.begin());
-		openset.erase(current);
-
-		// Adding the current vertex to the closedset
-		closedset[current] = true;
+		// Adding the current vertex to the closed set
+		closed_[current_idx] = true;
 
 		// Visit each edge exiting in the current vertex
-		std::list<Edge> successors;
+		successors.clear();
 		adjacency_->getSuccessors(successors, current);
 		for (std::list<Edge>::iterator edge_iter = successors.begin();
 						edge_iter != successors.end();
@@ -98,32 +88,22 @@ void AStar::findShortestPath(Vertex source,
 			Vertex neighbor = edge_iter->target;
 			Weight weight = edge_iter->weight;
 
-			if (closedset.count(neighbor) > 0)
+			unsigned int neighbor_idx = getSearchIndex(neighbor);
+			if (closed_[neighbor_idx])
 				continue;
 
-			Weight tentative_g_cost = g_cost[current] + weight;
-			if ((openset.count(neighbor) == 0) || (tentative_g_cost < g_cost[neighbor])) {
-				policy_[neighbor] = current;
-				g_cost[neighbor] = tentative_g_cost;
-				f_cost[neighbor] = g_cost[neighbor] + adjacency_->heuristicCost(neighbor, target);
-
-				if (openset.count(neighbor) == 0) {
-					openset[neighbor] = true;
-					openset_queue.insert(std::pair<Weight, Vertex>(f_cost[neighbor], neighbor));
-				}
+			// Inserting the neighbor, or decreasing its key if it's already in the open queue
+			Weight tentative_g_cost = g_cost_[current_idx] + weight;
+			if (tentative_g_cost < g_cost_[neighbor_idx]) {
+				parent_[neighbor_idx] = current_idx;
+				g_cost_[neighbor_idx] = tentative_g_cost;
+				Weight f_cost = tentative_g_cost + adjacency_->heuristicCost(neighbor, target);
+				open_queue_.push(neighbor_idx, QueueKey(f_cost, tentative_g_cost));
 			}
 		}
 		expansions_++;
-
-		// Computing the minimum f cost
-		Vertex current_vertex = openset_queue.begin()->second;
-		double current_f_cost = openset_queue.begin()->first;
-		min_f_cost = current_f_cost + adjacency_->heuristicCost(current_vertex, target);
 	}
-
-	total_cost_ = g_cost[target];
 }
 
 } //@namespace solver
 } //@namespace dwl
-
@@ -10,7 +10,8 @@ namespace solver
 
 AnytimeRepairingAStar::AnytimeRepairingAStar(double initial_inflation) :
 		initial_inflation_(initial_inflation), satisfied_inflation_(1.0),
-		min_f_cost_(std::numeric_limits<double>::max()), expansions_(0)
+		inflation_decrement_(0.5), source_(0), target_(0), is_search_tree_(false),
+		is_repaired_(false), terrain_revision_(0), stamp_(0), computation_time_(0.), expansions_(0)
 {
 	name_ = "Anytime Repairing A*";
 }
@@ -19,7 +20,6 @@ AnytimeRepairingAStar::AnytimeRepairingAStar(double initial_inflation) :
 AnytimeRepairingAStar::~AnytimeRepairingAStar()
 {
 	policy_.clear();
-	g_cost_.clear();
 }
 
 
@@ -39,130 +39,430 @@ bool AnytimeRepairingAStar::compute(Vertex source,
 		return false;
 	}
 
-	// Defining the set of nodes already evaluated (openset), the set of tentative nodes
-	// to be evaluated (openset), and ordered openset queue
-	SetQueue openset_queue;
-	Set openset, visitedset;
-
-	// Setting the initial time
+	// Setting the initial wall-clock time and the allowed time of the computation
 	time_started_ = clock();
-
-	satisfied_inflation_ = initial_inflation_;
-	double current_inflation = initial_inflation_;
+	started_time_ = std::chrono::steady_clock::now();
+	computation_time_ = computation_time;
 
 	// Number of expansions
 	expansions_ = 0;
 
-	// Getting the allocated time for computing a solution
-	double allocated_time_secs = computation_time * (double) CLOCKS_PER_SEC;
-
-	// Setting the g cost of the start and goal state
-	g_cost_[source] = 0;
-	g_cost_[target] = std::numeric_limits<double>::max();
-
-	// Estimated total cost from start to goal
-	double f_cost = g_cost_[source] +
-			satisfied_inflation_ * adjacency_->heuristicCost(source, target);
-
-	// Adding the start vertex to the openset
-	openset_queue.insert(std::pair<Weight, Vertex>(f_cost, source));
-	openset[source] = true;
+	// The search tree is discarded if the terrain changed and it wasn't repaired, since its
+	// edge costs are stale
+	environment::TerrainMap* terrain = adjacency_->getTerrainMap();
+	unsigned int terrain_revision = (terrain != NULL) ? terrain->getRevision() : 0;
+	if (terrain_revision != terrain_revision_) {
+		is_search_tree_ = false;
+		terrain_revision_ = terrain_revision;
+	}
 
-	// Computing the minimum f cost
-	Vertex current_vertex = openset_queue.begin()->second;
-	double current_f_cost = openset_queue.begin()->first;
-	min_f_cost_ = current_f_cost +
-			satisfied_inflation_ * adjacency_->heuristicCost(current_vertex, target);
+	if (!is_search_tree_ || source != source_ || target != target_) {
+		// Clearing the search data of the visited vertices
+		resetSearch();
+		h_cost_.clear();
+		v_cost_.clear();
+		inconsistent_.clear();
+		predecessors_.clear();
+		inconsistent_list_.clear();
+		total_cost_ = std::numeric_limits<double>::max();
+		solution_ = SearchSolution();
+		source_ = source;
+		target_ = target;
+		is_search_tree_ = true;
+		is_repaired_ = false;
+
+		satisfied_inflation_ = initial_inflation_;
+		if (satisfied_inflation_ < 1)
+			satisfied_inflation_ = 1;
+
+		// Setting the g cost of the start state, and adding it to the open queue
+		getVertexIndex(target);
+		unsigned int source_idx = getVertexIndex(source);
+		g_cost_[source_idx] = 0;
+		open_queue_.push(source_idx, computeKey(source_idx));
+	} else if (is_repaired_) {
+		// Repairing the solution from the initial inflation, the search tree is reused
+		satisfied_inflation_ = initial_inflation_;
+		if (satisfied_inflation_ < 1)
+			satisfied_inflation_ = 1;
+
+		updateOpenQueue();
+		is_repaired_ = false;
+	}
 
-	while ((satisfied_inflation_ > 1) && ((clock() - time_started_) < allocated_time_secs)) {
+	// Note that the search continues from the last inflation when the search tree is reused
+	unsigned int target_idx = getVertexIndex(target);
+	while (getElapsedTime() < computation_time_) {
 		// Computing a path with reuse of states values
-		if (improvePath(openset_queue, visitedset, target, computation_time)) {
-			// Decreasing the current inflation gain
-			double next_inflation = min_f_cost_ / g_cost_[target];
-			if (current_inflation > next_inflation)
-				current_inflation = next_inflation;
-
-			if (current_inflation < 1)
-				current_inflation = 1;
-			satisfied_inflation_ = current_inflation;
-
-			total_cost_ = g_cost_[target];
-		}
+		if (!improvePath(target_idx))
+			break;
+
+		// Publishing the solution of this inflation. The sub-optimality bound of the current
+		// solution allows us to skip the inflations that cannot improve it
+		double next_inflation = g_cost_[target_idx] / computeMinimumCost();
+		if (next_inflation > satisfied_inflation_)
+			next_inflation = satisfied_inflation_;
+		if (next_inflation < 1)
+			next_inflation = 1;
+		publishSolution(target_idx, next_inflation);
+		if (satisfied_inflation_ <= 1)
+			break;
+
+		// Decreasing the inflation gain
+		if (next_inflation > satisfied_inflation_ - inflation_decrement_)
+			next_inflation = satisfied_inflation_ - inflation_decrement_;
+		if (next_inflation < 1)
+			next_inflation = 1;
+		satisfied_inflation_ = next_inflation;
+
+		// Reusing the search data of the previous iteration
+		updateOpenQueue();
 	}
 
-	return true;
+	return total_cost_ < std::numeric_limits<double>::max();
 }
 
 
-bool AnytimeRepairingAStar::improvePath(SetQueue& openset_queue,
-										Set& visitedset,
-										Vertex target,
-										double computation_time)
+void AnytimeRepairingAStar::setSolutionCallback(SolutionCallback callback)
 {
-	// Setting an empty closed set and inconsistent set
-	Set closedset;
-	SetQueue inconsistentset_queue;
+	solution_callback_ = callback;
+}
 
-	double allocated_time_secs = computation_time * (double) CLOCKS_PER_SEC;
-	while ((!openset_queue.empty()) && ((clock() - time_started_) < allocated_time_secs)
-			&& (g_cost_[target] > min_f_cost_)) {
-		Vertex current = openset_queue.begin()->second;
 
-		// Deleting the current vertex to the openset list
-		openset_queue.erase(openset_queue.begin());
+void AnytimeRepairingAStar::updateVertices(const std::vector<Vertex>& vertices)
+{
+	if (!is_search_tree_)
+		return;
+
+	// The search tree is repaired up to the actual terrain revision
+	environment::TerrainMap* terrain = adjacency_->getTerrainMap();
+	if (terrain != NULL)
+		terrain_revision_ = terrain->getRevision();
+
+	// Getting the visited vertices and their predecessors
+	std::vector<unsigned int> changed_vertices, pred_vertices;
+	std::vector<bool> is_pred(search_table_.size(), false);
+	for (unsigned int i = 0; i < vertices.size(); i++) {
+		unsigned int index;
+		if (!search_table_.find(index, vertices[i]))
+			continue;
+
+		changed_vertices.push_back(index);
+		for (unsigned int p = 0; p < predecessors_[index].size(); p++) {
+			unsigned int pred_index = predecessors_[index][p].index;
+			if (!is_pred[pred_index]) {
+				is_pred[pred_index] = true;
+				pred_vertices.push_back(pred_index);
+			}
+		}
+	}
 
-		// Adding the current vertex to the closedset
-		closedset[current] = true;
+	// Updating the outgoing edges of the predecessors
+	stamp_++;
+	std::vector<unsigned int> updated_vertices;
+	std::vector<bool> is_updated(search_table_.size(), false);
+	std::list<Edge> successors;
+	for (unsigned int i = 0; i < pred_vertices.size(); i++) {
+		unsigned int pred_index = pred_vertices[i];
 
-		// Visit each edge exiting in the current vertex
-		std::list<Edge> successors;
-		adjacency_->getSuccessors(successors, current);
+		successors.clear();
+		adjacency_->getSuccessors(successors, search_table_.getVertex(pred_index));
 		for (std::list<Edge>::iterator edge_iter = successors.begin();
 				edge_iter != successors.end();
 				edge_iter++)
 		{
-			Vertex neighbor = edge_iter->target;
-			Weight weight = edge_iter->weight;
-
-			if (visitedset.count(neighbor) == 0) {
-				g_cost_[neighbor] = std::numeric_limits<double>::max();
-				visitedset[neighbor] = true;
+			unsigned int neighbor_idx = getVertexIndex(edge_iter->target);
+			if (neighbor_idx >= is_updated.size())
+				is_updated.resize(neighbor_idx + 1, false);
+
+			if (setPredecessor(neighbor_idx, pred_index, edge_iter->weight) &&
+					!is_updated[neighbor_idx]) {
+				is_updated[neighbor_idx] = true;
+				updated_vertices.push_back(neighbor_idx);
 			}
+		}
+	}
 
-			Weight tentative_g_cost = g_cost_[current] + weight;
-			if (tentative_g_cost < g_cost_[neighbor]) {
-				policy_[neighbor] = current;
-				g_cost_[neighbor] = tentative_g_cost;
-				double f_cost = g_cost_[neighbor] +
-						satisfied_inflation_ * adjacency_->heuristicCost(neighbor, target);
-				if (closedset.count(neighbor) == 0) {
-					openset_queue.insert(std::pair<Weight, Vertex>(f_cost, neighbor));
-				} else {
-					inconsistentset_queue.insert(std::pair<Weight, Vertex>(f_cost, neighbor));
+	// Removing the incoming edges that don't exist anymore (e.g. due to obstacles)
+	for (unsigned int i = 0; i < changed_vertices.size(); i++) {
+		unsigned int index = changed_vertices[i];
+		for (unsigned int p = 0; p < predecessors_[index].size(); p++) {
+			Predecessor& pred = predecessors_[index][p];
+			if (pred.stamp != stamp_ && pred.weight != std::numeric_limits<double>::max()) {
+				pred.weight = std::numeric_limits<double>::max();
+				if (!is_updated[index]) {
+					is_updated[index] = true;
+					updated_vertices.push_back(index);
 				}
 			}
 		}
+	}
+
+	// Updating the g-cost of the vertices whose incoming edges changed. Note that the
+	// inconsistent vertices are repaired in the next computation
+	for (unsigned int i = 0; i < updated_vertices.size(); i++) {
+		updateParent(updated_vertices[i]);
+		updateMembership(updated_vertices[i]);
+	}
+
+	// The repaired solution is published even if its cost increased
+	if (!updated_vertices.empty()) {
+		is_repaired_ = true;
+		solution_.cost = std::numeric_limits<double>::max();
+		solution_.inflation = std::numeric_limits<double>::max();
+	}
+}
+
+
+void AnytimeRepairingAStar::resetSearchTree()
+{
+	is_search_tree_ = false;
+}
+
+
+const SearchSolution& AnytimeRepairingAStar::getBestSolution() const
+{
+	return solution_;
+}
+
+
+bool AnytimeRepairingAStar::improvePath(unsigned int target_idx)
+{
+	while (!open_queue_.empty()) {
+		// Stopping when the target can't be improved with this inflation. Note that the
+		// underconsistent vertices with the same f-cost are processed, since the path of the
+		// target could go through them (e.g. a removed vertex of the last path)
+		unsigned int top_idx = open_queue_.top();
+		double top_f_cost = open_queue_.topKey().f_cost;
+		double target_f_cost = computeKey(target_idx).f_cost;
+		bool underconsistent = v_cost_[top_idx] < g_cost_[top_idx];
+		if ((top_f_cost > target_f_cost ||
+				(top_f_cost == target_f_cost && !underconsistent)) &&
+				v_cost_[target_idx] >= g_cost_[target_idx])
+			break;
+
+		// Stopping when the deadline is reached
+		if (getElapsedTime() >= computation_time_)
+			return false;
+
+		unsigned int current_idx = open_queue_.pop();
+		if (v_cost_[current_idx] > g_cost_[current_idx]) {
+			// Adding the overconsistent vertex to the closed set
+			v_cost_[current_idx] = g_cost_[current_idx];
+			closed_[current_idx] = true;
+			expandVertex(current_idx, true);
+		} else {
+			// Invalidating the underconsistent vertex, it goes back to the open queue as
+			// overconsistent
+			v_cost_[current_idx] = std::numeric_limits<double>::max();
+			updateMembership(current_idx);
+			expandVertex(current_idx, false);
+		}
 
 		expansions_++;
 	}
 
-	// Setting open set with all over consistent states
-	for (SetQueue::iterator incons_iter = inconsistentset_queue.begin();
-			incons_iter != inconsistentset_queue.end(); incons_iter++)
+	return g_cost_[target_idx] < std::numeric_limits<double>::max();
+}
+
+
+void AnytimeRepairingAStar::expandVertex(unsigned int index,
+										 bool overconsistent)
+{
+	// Visit each edge exiting in the current vertex
+	stamp_++;
+	std::list<Edge> successors;
+	adjacency_->getSuccessors(successors, search_table_.getVertex(index));
+	for (std::list<Edge>::iterator edge_iter = successors.begin();
+			edge_iter != successors.end();
+			edge_iter++)
 	{
-		double f_cost = incons_iter->first;
-		Vertex vertex = incons_iter->second;
-		openset_queue.insert(std::pair<Weight, Vertex>(f_cost, vertex));
+		if (edge_iter->target == source_)
+			continue;
+
+		unsigned int neighbor_idx = getVertexIndex(edge_iter->target);
+		setPredecessor(neighbor_idx, index, edge_iter->weight);
+
+		if (overconsistent) {
+			Weight tentative_g_cost = v_cost_[index] + edge_iter->weight;
+			if (tentative_g_cost < g_cost_[neighbor_idx]) {
+				parent_[neighbor_idx] = index;
+				g_cost_[neighbor_idx] = tentative_g_cost;
+				updateMembership(neighbor_idx);
+			}
+		} else if (parent_[neighbor_idx] == index) {
+			updateParent(neighbor_idx);
+			updateMembership(neighbor_idx);
+		}
+	}
+}
+
+
+unsigned int AnytimeRepairingAStar::getVertexIndex(Vertex vertex)
+{
+	unsigned int index = getSearchIndex(vertex);
+	if (index == h_cost_.size()) {
+		h_cost_.push_back(adjacency_->heuristicCost(vertex, target_));
+		v_cost_.push_back(std::numeric_limits<double>::max());
+		inconsistent_.push_back(false);
+		predecessors_.push_back(std::vector<Predecessor>());
 	}
 
-	// Computing the minimum f cost
-	Vertex current_vertex = openset_queue.begin()->second;
-	double current_f_cost = openset_queue.begin()->first;
-	min_f_cost_ = current_f_cost +
-			satisfied_inflation_ * adjacency_->heuristicCost(current_vertex, target);
+	return index;
+}
 
+
+bool AnytimeRepairingAStar::setPredecessor(unsigned int index,
+										   unsigned int pred_index,
+										   Weight weight)
+{
+	std::vector<Predecessor>& preds = predecessors_[index];
+	for (unsigned int p = 0; p < preds.size(); p++) {
+		if (preds[p].index == pred_index) {
+			if (preds[p].stamp == stamp_ && preds[p].weight <= weight)
+				return false;
+
+			bool changed = (preds[p].weight != weight);
+			preds[p].weight = weight;
+			preds[p].stamp = stamp_;
+			return changed;
+		}
+	}
+
+	preds.push_back(Predecessor(pred_index, weight, stamp_));
 	return true;
 }
 
+
+void AnytimeRepairingAStar::updateParent(unsigned int index)
+{
+	// The g-cost of the source is always zero
+	if (search_table_.getVertex(index) == source_)
+		return;
+
+	// Note that a vertex without a valid predecessor is its own parent
+	Weight min_g_cost = std::numeric_limits<double>::max();
+	unsigned int parent = index;
+	const std::vector<Predecessor>& preds = predecessors_[index];
+	for (unsigned int p = 0; p < preds.size(); p++) {
+		if (v_cost_[preds[p].index] == std::numeric_limits<double>::max() ||
+				preds[p].weight == std::numeric_limits<double>::max())
+			continue;
+
+		Weight g_cost = v_cost_[preds[p].index] + preds[p].weight;
+		if (g_cost < min_g_cost) {
+			min_g_cost = g_cost;
+			parent = preds[p].index;
+		}
+	}
+
+	g_cost_[index] = min_g_cost;
+	parent_[index] = parent;
+}
+
+
+void AnytimeRepairingAStar::updateMembership(unsigned int index)
+{
+	if (v_cost_[index] != g_cost_[index]) {
+		if (!closed_[index])
+			open_queue_.push(index, computeKey(index));
+		else if (!inconsistent_[index]) {
+			inconsistent_[index] = true;
+			inconsistent_list_.push_back(index);
+		}
+	} else {
+		// Note that the inconsistent list is filtered by the inconsistent flags
+		open_queue_.remove(index);
+		inconsistent_[index] = false;
+	}
+}
+
+
+QueueKey AnytimeRepairingAStar::computeKey(unsigned int index)
+{
+	// The underconsistent vertices are prioritized with their non-inflated cost, and they go
+	// first among the vertices with the same f-cost
+	if (v_cost_[index] >= g_cost_[index])
+		return QueueKey(g_cost_[index] + satisfied_inflation_ * h_cost_[index], g_cost_[index]);
+	else
+		return QueueKey(v_cost_[index] + h_cost_[index], std::numeric_limits<double>::max());
+}
+
+
+void AnytimeRepairingAStar::updateOpenQueue()
+{
+	// Moving the inconsistent vertices to the open queue
+	for (unsigned int i = 0; i < inconsistent_list_.size(); i++) {
+		unsigned int index = inconsistent_list_[i];
+		if (inconsistent_[index]) {
+			inconsistent_[index] = false;
+			open_queue_.push(index, computeKey(index));
+		}
+	}
+	inconsistent_list_.clear();
+
+	// Updating the keys with the new inflation. Note that the heap elements are copied
+	// because their order changes while the keys are updated
+	std::vector<unsigned int> open_vertices = open_queue_.getElements();
+	for (unsigned int i = 0; i < open_vertices.size(); i++) {
+		unsigned int index = open_vertices[i];
+		open_queue_.push(index, computeKey(index));
+	}
+
+	// Setting an empty closed set
+	closed_.assign(closed_.size(), false);
+}
+
+
+double AnytimeRepairingAStar::computeMinimumCost()
+{
+	double min_f_cost = std::numeric_limits<double>::max();
+
+	const std::vector<unsigned int>& open_vertices = open_queue_.getElements();
+	for (unsigned int i = 0; i < open_vertices.size(); i++) {
+		unsigned int index = open_vertices[i];
+		double g_cost = std::min(g_cost_[index], v_cost_[index]);
+		min_f_cost = std::min(min_f_cost, g_cost + h_cost_[index]);
+	}
+
+	for (unsigned int i = 0; i < inconsistent_list_.size(); i++) {
+		unsigned int index = inconsistent_list_[i];
+		if (inconsistent_[index]) {
+			double g_cost = std::min(g_cost_[index], v_cost_[index]);
+			min_f_cost = std::min(min_f_cost, g_cost + h_cost_[index]);
+		}
+	}
+
+	return min_f_cost;
+}
+
+
+void AnytimeRepairingAStar::publishSolution(unsigned int target_idx,
+											double inflation)
+{
+	double cost = g_cost_[target_idx];
+	if (cost >= solution_.cost && inflation >= solution_.inflation)
+		return;
+
+	// Recording the solution
+	recordPolicy(target_idx);
+	total_cost_ = cost;
+
+	solution_.path = getShortestPath(source_, target_);
+	solution_.cost = cost;
+	solution_.inflation = inflation;
+	solution_.expansions = expansions_;
+	solution_.time = getElapsedTime();
+
+	if (solution_callback_)
+		solution_callback_(solution_);
+}
+
+
+double AnytimeRepairingAStar::getElapsedTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - started_time_).count();
+}
+
 } //@namespace solver
 } //@namespace dwl
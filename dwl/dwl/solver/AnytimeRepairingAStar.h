@@ -2,6 +2,8 @@
 #define DWL__SOLVER__ANYTIME_REPAIRING_ASTAR__H
 
 #include <dwl/solver/SearchTreeSolver.h>
+#include <functional>
+#include <chrono>
 
 
 namespace dwl
@@ -10,10 +12,41 @@ namespace dwl
 namespace solver
 {
 
+/**
+ * @struct SearchSolution
+ * @brief Solution of an anytime search, which is published after each improvement
+ */
+struct SearchSolution
+{
+	SearchSolution() : cost(std::numeric_limits<double>::max()),
+			inflation(std::numeric_limits<double>::max()), expansions(0), time(0.) {}
+
+	/** @brief Path from the source to the target vertex */
+	std::list<Vertex> path;
+
+	/** @brief Cost of the path */
+	double cost;
+
+	/** @brief Sub-optimality bound of the path */
+	double inflation;
+
+	/** @brief Number of expansions and elapsed wall-clock time (in seconds) of the search */
+	unsigned int expansions;
+	double time;
+};
+
+/** @brief Defines the callback that receives the improved solutions */
+typedef std::function<void (const SearchSolution&)> SolutionCallback;
+
+
 /**
  * @class AnytimeRepairingAStar
  * @brief Class for solving a shortest-search problem using the ARA* algorithm. This class derives
- * from the SearchTreeSolver class
+ * from the SearchTreeSolver class. The search is bounded by a wall-clock deadline and publishes
+ * every improved solution. It keeps the search tree between computations, so the changes of
+ * the edge costs (e.g. terrain updates) are repaired incrementally as in Anytime D*, i.e. every
+ * vertex keeps its g-cost (one-step lookahead) and the g-cost of its last expansion, and the
+ * underconsistent vertices are re-expanded
  */
 class AnytimeRepairingAStar : public SearchTreeSolver
 {
@@ -31,35 +64,135 @@ class AnytimeRepairingAStar : public SearchTreeSolver
 		bool init();
 
 		/**
-		 * @brief Computes a shortest-path using ARA* algorithm
+		 * @brief Computes a shortest-path using ARA* algorithm. The search tree of the last
+		 * computation is reused if the source and target vertices didn't change, i.e. it
+		 * continues improving the last solution, or repairs it after an update of vertices.
+		 * The search tree is discarded if the terrain changed (see TerrainMap::getRevision())
+		 * and its changes weren't repaired with updateVertices()
 		 * @param Vertex Source vertex
 		 * @param Vertex Target vertex
-		 * @param double Allowed time for computing a solution (in seconds)
+		 * @param double Allowed wall-clock time for computing a solution (in seconds)
 		 * @return True if it was computed a solution
 		 */
 		bool compute(Vertex source,
 					 Vertex target,
 					 double computation_time);
 
-		/** @brief Defines a ordered queue according to the less weight */
-		typedef std::set< std::pair<Weight, Vertex>, pair_first_less<Weight, Vertex> > SetQueue;
+		/**
+		 * @brief Sets the callback that receives every improved solution during the computation
+		 * @param SolutionCallback Solution callback
+		 */
+		void setSolutionCallback(SolutionCallback callback);
 
-		/** @brief Defines a set of known vertex */
-		typedef std::map<Vertex, bool> Set;
+		/**
+		 * @brief Updates the costs of the incoming edges of a set of vertices (e.g. the vertices
+		 * of the changed terrain cells) in the search tree. The next computation repairs the
+		 * solution starting from the initial inflation. It has to be called after the terrain
+		 * update, so the search tree is consistent with the actual terrain revision
+		 * @param const std::vector<Vertex>& Vertices whose incoming edges changed
+		 */
+		void updateVertices(const std::vector<Vertex>& vertices);
+
+		/** @brief Discards the search tree, i.e. the next computation starts from scratch */
+		void resetSearchTree();
+
+		/** @brief Gets the best solution of the last computation */
+		const SearchSolution& getBestSolution() const;
 
 
 	private:
+		/** @brief Predecessor of a vertex, i.e. an incoming edge */
+		struct Predecessor
+		{
+			Predecessor(unsigned int _index,
+						Weight _weight,
+						unsigned int _stamp) : index(_index), weight(_weight), stamp(_stamp) {}
+
+			unsigned int index;
+			Weight weight;
+			unsigned int stamp;
+		};
+
+		/**
+		 * @brief Improves the path according to the current inflation gain, i.e. it expands the
+		 * vertices of the open queue until the target can't be improved with this inflation
+		 * @param unsigned int Dense index of the target vertex
+		 * @return True if it was found a path to the target before the deadline
+		 */
+		bool improvePath(unsigned int target_idx);
+
+		/**
+		 * @brief Expands a vertex, i.e. it records the incoming edges of its successors. The
+		 * g-costs of the successors are relaxed for overconsistent vertices, and recomputed
+		 * from their predecessors for underconsistent ones
+		 * @param unsigned int Dense index of the vertex
+		 * @param bool True for an overconsistent vertex
+		 */
+		void expandVertex(unsigned int index,
+						  bool overconsistent);
+
+		/**
+		 * @brief Gets the dense index of a vertex, and caches its heuristic cost if it wasn't
+		 * visited
+		 * @param Vertex Vertex
+		 * @return The dense index of the vertex
+		 */
+		unsigned int getVertexIndex(Vertex vertex);
+
 		/**
-		 * @brief Improves the path according to inflation gain
-		 * @param SetQueue& openset_queue Openset queue
-		 * @param Set& visitedset Visited set
-		 * @param Vertex target Target vertex
-		 * @return True if the path was improved
+		 * @brief Sets the weight of an incoming edge of a vertex. The edges of the same stamp
+		 * (e.g. expansion) keep the minimum weight
+		 * @param unsigned int Dense index of the vertex
+		 * @param unsigned int Dense index of the predecessor
+		 * @param Weight Weight of the edge
+		 * @return True if the weight of the edge changed
 		 */
-		bool improvePath(SetQueue& openset_queue,
-						 Set& visitedset,
-						 Vertex target,
-						 double computation_time);
+		bool setPredecessor(unsigned int index,
+							unsigned int pred_index,
+							Weight weight);
+
+		/**
+		 * @brief Recomputes the g-cost and parent of a vertex from its predecessors
+		 * @param unsigned int Dense index of the vertex
+		 */
+		void updateParent(unsigned int index);
+
+		/**
+		 * @brief Updates the membership of a vertex to the open queue and inconsistent list
+		 * according to its consistency
+		 * @param unsigned int Dense index of the vertex
+		 */
+		void updateMembership(unsigned int index);
+
+		/**
+		 * @brief Computes the key of a vertex in the open queue
+		 * @param unsigned int Dense index of the vertex
+		 * @return The key of the vertex
+		 */
+		QueueKey computeKey(unsigned int index);
+
+		/**
+		 * @brief Moves the inconsistent vertices to the open queue, and updates the keys of the
+		 * open queue with the satisfied inflation
+		 */
+		void updateOpenQueue();
+
+		/**
+		 * @brief Computes the minimum non-inflated f-cost of the open and inconsistent vertices
+		 * @return The minimum f-cost
+		 */
+		double computeMinimumCost();
+
+		/**
+		 * @brief Publishes the solution of the current inflation if it improves the last one
+		 * @param unsigned int Dense index of the target vertex
+		 * @param double Sub-optimality bound of the solution
+		 */
+		void publishSolution(unsigned int target_idx,
+							 double inflation);
+
+		/** @brief Gets the elapsed wall-clock time of the computation (in seconds) */
+		double getElapsedTime();
 
 		/** @brief Initial inflation */
 		double initial_inflation_;
@@ -67,11 +200,42 @@ class AnytimeRepairingAStar : public SearchTreeSolver
 		/** @brief Satisfied inflation */
 		double satisfied_inflation_;
 
-		/** @brief G cost */
-		CostMap g_cost_;
+		/** @brief Heuristic cost, g-cost of the last expansion and inconsistent flag of the
+		 * visited vertices */
+		std::vector<Weight> h_cost_;
+		std::vector<Weight> v_cost_;
+		std::vector<bool> inconsistent_;
+
+		/** @brief Incoming edges of the visited vertices */
+		std::vector<std::vector<Predecessor> > predecessors_;
+
+		/** @brief Inconsistent vertices, i.e. closed vertices whose g-cost was changed */
+		std::vector<unsigned int> inconsistent_list_;
+
+		/** @brief Inflation decrement between consecutive searches */
+		double inflation_decrement_;
+
+		/** @brief Source and target vertices of the search tree */
+		Vertex source_;
+		Vertex target_;
+
+		/** @brief Indicates if there is a search tree, and if it was repaired */
+		bool is_search_tree_;
+		bool is_repaired_;
+
+		/** @brief Terrain revision of the search tree */
+		unsigned int terrain_revision_;
+
+		/** @brief Stamp of the current expansion or update of edges */
+		unsigned int stamp_;
+
+		/** @brief Best solution and its callback */
+		SearchSolution solution_;
+		SolutionCallback solution_callback_;
 
-		/** @brief Minimum f cost */
-		double min_f_cost_;
+		/** @brief Starting wall-clock time and allowed time of the computation */
+		std::chrono::steady_clock::time_point started_time_;
+		double computation_time_;
 
 		/** @brief number of expansions */
 		int expansions_;
@@ -52,56 +52,58 @@ bool Dijkstrap::compute(Vertex source,
 
 void Dijkstrap::findShortestPath(Vertex source,
 								 Vertex target,
-								 AdjacencyMap adjacency_map)
+								 const AdjacencyMap& adjacency_map)
 {
-	// Defining the minimum cost
-	CostMap min_cost;
-
-	for (AdjacencyMap::iterator vertex_iter = adjacency_map.begin();
-		vertex_iter != adjacency_map.end();
-		vertex_iter++)
-	{
-		Vertex v = vertex_iter->first;
-		min_cost[v] = std::numeric_limits<double>::infinity();
-	}
+	// Number of expansions
+	expansions_ = 0;
 
-	min_cost[source] = 0;
-	std::set< std::pair<Weight, Vertex>, pair_first_less<Weight, Vertex> > vertex_queue;
-	for (AdjacencyMap::iterator vertex_iter = adjacency_map.begin();
-		vertex_iter != adjacency_map.end();
-		vertex_iter++)
-	{
-		Vertex v = vertex_iter->first;
-		vertex_queue.insert(std::pair<Weight, Vertex>(min_cost[v], v));
-	}
+	// Clearing the search data of the visited vertices. The vertices are inserted in the
+	// queue when they are discovered, instead of queuing the whole adjacency map
+	resetSearch();
+	total_cost_ = std::numeric_limits<double>::max();
+
+	unsigned int source_idx = getSearchIndex(source);
+	g_cost_[source_idx] = 0;
+	open_queue_.push(source_idx, QueueKey(0, 0));
 
-	while (!vertex_queue.empty()) {
-		Vertex current = vertex_queue.begin()->second;
-		vertex_queue.erase(vertex_queue.begin());
+	while (!open_queue_.empty()) {
+		unsigned int current_idx = open_queue_.pop();
+		Vertex current = search_table_.getVertex(current_idx);
 
 		// Checking if it is get the target
 		if (adjacency_->isReachedGoal(target, current)) {
-			policy_[target] = current;
-			min_cost[target] = min_cost[current];
+			recordPolicy(current_idx);
+			if (current != target)
+				policy_[target] = current;
+			total_cost_ = g_cost_[current_idx];
 			break;
 		}
 
+		// The minimum cost of the current vertex is final
+		closed_[current_idx] = true;
+
+		AdjacencyMap::const_iterator adjacency_iter = adjacency_map.find(current);
+		if (adjacency_iter == adjacency_map.end())
+			continue;
+
 		// Visit each edge exiting u
-		for (std::list<Edge>::iterator edge_iter = adjacency_map[current].begin();
-			edge_iter != adjacency_map[current].end();
+		for (std::list<Edge>::const_iterator edge_iter = adjacency_iter->second.begin();
+			edge_iter != adjacency_iter->second.end();
 			edge_iter++)
 		{
-			Vertex neighbor = edge_iter->target;
-			Weight weight = edge_iter->weight;
-			Weight distance_through_current = min_cost[current] + weight;
-			if (distance_through_current < min_cost[neighbor]) {
-				vertex_queue.erase(std::pair<Weight, Vertex>(min_cost[neighbor], neighbor));
-
-				min_cost[neighbor] = distance_through_current;
-				policy_[neighbor] = current;
-				vertex_queue.insert(std::pair<Weight, Vertex>(min_cost[neighbor], neighbor));
+			unsigned int neighbor_idx = getSearchIndex(edge_iter->target);
+			if (closed_[neighbor_idx])
+				continue;
+
+			Weight distance_through_current = g_cost_[current_idx] + edge_iter->weight;
+			if (distance_through_current < g_cost_[neighbor_idx]) {
+				g_cost_[neighbor_idx] = distance_through_current;
+				parent_[neighbor_idx] = current_idx;
+				open_queue_.push(neighbor_idx,
+								 QueueKey(distance_through_current, distance_through_current));
 			}
 		}
+		expansions_++;
 	}
 }
 
@@ -46,11 +46,12 @@ class Dijkstrap : public SearchTreeSolver
 		 * @brief Computes the minimum cost and previous vertex according to the shortest
 		 * Dijkstrap path
 		 * @param Vertex Source vertex
-		 * @param AdjacencyMap Adjacency map
+		 * @param Vertex Target vertex
+		 * @param const AdjacencyMap& Adjacency map
 		 */
 		void findShortestPath(Vertex source,
 							  Vertex target,
-							  AdjacencyMap adjacency_map);
+							  const AdjacencyMap& adjacency_map);
 
 		/** @brief number of expansions */
 		int expansions_;
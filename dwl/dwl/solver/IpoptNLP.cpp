@@ -7,7 +7,7 @@ namespace dwl
 namespace solver
 {
 
-IpoptNLP::IpoptNLP() : initialized_(false), print_level_(5),
+IpoptNLP::IpoptNLP() : initialized_(false), optimized_(false), print_level_(5),
 		print_freq_iter_(1), outfile_(false), filename_("ipopt.opt"),
 		file_print_level_(5), convergence_tol_(1e-7), max_iter_(-1),
 		dual_inf_tol_(1.), constr_viol_tol_(0.0001), compl_viol_tol_(0.0001),
@@ -251,6 +251,25 @@ void IpoptNLP::setHessianApproximation(bool enable)
 }
 
 
+void IpoptNLP::setWarmStart(bool warm_start)
+{
+	warm_start_ = warm_start;
+
+	if (initialized_) {
+		if (warm_start_) {
+			// Keeping the starting point close to the last solution
+			app_->Options()->SetStringValue("warm_start_init_point", "yes");
+			app_->Options()->SetNumericValue("warm_start_bound_push", 1e-6);
+			app_->Options()->SetNumericValue("warm_start_mult_bound_push", 1e-6);
+			app_->Options()->SetNumericValue("mu_init", 1e-6);
+		} else {
+			app_->Options()->SetStringValue("warm_start_init_point", "no");
+			app_->Options()->SetNumericValue("mu_init", 0.1);
+		}
+	}
+}
+
+
 bool IpoptNLP::init()
 {
 	// Setting the optimization model to Ipopt wrapper
@@ -280,6 +299,8 @@ bool IpoptNLP::init()
 	setAcceptableConvergenceTolerance(acceptable_tol_);
 	setAcceptableIterations(acceptable_iter_);
 	setMuStrategy(mu_strategy_);
+	setWarmStart(warm_start_);
+	optimized_ = false;
 
 	if (!model_->isCostGradientImplemented())
 		printf(BLUE_ "Info: Computing the Gradient using numerical differentiation.\n" COLOR_RESET);
@@ -298,8 +319,6 @@ bool IpoptNLP::init()
 		app_->Options()->SetStringValue("hessian_approximation", "limited-memory");
 	}
 
-	app_->Options()->SetStringValue("warm_start_init_point", "yes");
-
 //	app_->Options()->SetNumericValue("dual_inf_tol", 1000);
 //	app_->Options()->SetNumericValue("constr_viol_tol", 0.1);
 //	app_->Options()->SetNumericValue("compl_inf_tol", 0.1);
@@ -331,7 +350,14 @@ bool IpoptNLP::compute(double allocated_time_secs)
 		// Setting the allowed time for this optimization loop
 		double new_allocated_time_secs = allocated_time_secs - current_duration_secs;
 		app_->Options()->SetNumericValue("max_cpu_time", new_allocated_time_secs);
-		status = app_->OptimizeTNLP(nlp_ptr_);
+		// Re-optimizing the NLP when its structure didn't change
+		if (warm_start_ && optimized_ && !model_->requiresInitialization())
+			status = app_->ReOptimizeTNLP(nlp_ptr_);
+		else
+			status = app_->OptimizeTNLP(nlp_ptr_);
+
+		// Note that the errors of the problem definition don't set up the NLP
+		optimized_ = (status > Ipopt::Not_Enough_Degrees_Of_Freedom);
 
 		if (status == Ipopt::Solve_Succeeded || status == Ipopt::Solved_To_Acceptable_Level)
 			solved = true;
@@ -113,6 +113,14 @@ class IpoptNLP : public OptimizationSolver
 		 */
 		void setHessianApproximation(bool enable);
 
+		/**
+		 * @brief Enables/disables the warm start of the primal and dual variables. The problem
+		 * is re-optimized (i.e. without rebuilding the NLP structure) when the model doesn't
+		 * require a new initialization
+		 * @param bool True for enabling the warm start
+		 */
+		void setWarmStart(bool warm_start);
+
 		/**
 		 * @brief Initialization of the NLP solver using Ipopt
 		 * @return True if was initialized
@@ -140,6 +148,9 @@ class IpoptNLP : public OptimizationSolver
 		/** @brief Label that indicates if it's initialized the solver */
 		bool initialized_;
 
+		/** @brief Indicates if the application solved the NLP, i.e. it could be re-optimized */
+		bool optimized_;
+
 		/** @brief Printing level uses during the Ipopt computation */
 		int print_level_;
 
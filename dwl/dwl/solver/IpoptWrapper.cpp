@@ -28,8 +28,10 @@ void IpoptWrapper::setOptimizationModel(model::OptimizationModel* model)
 bool IpoptWrapper::get_nlp_info(Index& n, Index& m, Index& nnz_jac_g,
 								Index& nnz_h_lag, IndexStyleEnum& index_style)
 {
-	// Initializing the optimization model
-	opt_model_->init();
+	// Initializing the optimization model, it's skipped when its structure didn't change
+	// (e.g. receding horizon computations)
+	if (opt_model_->requiresInitialization())
+		opt_model_->init();
 
 	// Getting the dimension of decision variables for every knots
 	n = opt_model_->getDimensionOfState();
@@ -75,9 +77,22 @@ bool IpoptWrapper::get_starting_point(Index n, bool init_x, Number* x,
 									  bool init_z, Number* z_L, Number* z_U,
 									  Index m, bool init_lambda, Number* lambda)
 {
-	// Here, we assume we only have starting values for x, if you code your own NLP, you can
-	// provide starting values for the dual variables if you wish to use a warmstart option
-	opt_model_->getStartingPoint(x, n);
+	// Getting the starting point of the primal variables
+	if (init_x)
+		opt_model_->getStartingPoint(x, n);
+
+	// Getting the starting point of the dual variables, which are requested in warm starts.
+	// Without a dual solution, we use the default initialization of Ipopt
+	if (init_z || init_lambda) {
+		if (!opt_model_->getStartingDualPoint(z_L, z_U, n, lambda, m)) {
+			for (Index i = 0; i < n; i++) {
+				z_L[i] = 1.;
+				z_U[i] = 1.;
+			}
+			for (Index i = 0; i < m; i++)
+				lambda[i] = 0.;
+		}
+	}
 
 	return true;
 }
@@ -213,6 +228,9 @@ void IpoptWrapper::finalize_solution(Ipopt::SolverReturn status,
 
 	// Evaluating the solution
 	solution_ = solution;
+
+	// Recording the dual solution for warm-starting the next computation
+	opt_model_->setDualSolution(z_L, z_U, n, lambda, m);
 }
 
 
@@ -7,7 +7,7 @@ namespace dwl
 namespace solver
 {
 
-OptimizationSolver::OptimizationSolver() : model_(NULL)
+OptimizationSolver::OptimizationSolver() : model_(NULL), warm_start_(false)
 {
 
 }
@@ -65,6 +65,12 @@ bool OptimizationSolver::compute(double computation_time)
 }
 
 
+void OptimizationSolver::setWarmStart(bool warm_start)
+{
+	warm_start_ = warm_start;
+}
+
+
 model::OptimizationModel* OptimizationSolver::getOptimizationModel()
 {
 	return model_;
@@ -51,6 +51,14 @@ class OptimizationSolver
 		 */
 		virtual bool compute(double computation_time = 2e19);
 
+		/**
+		 * @brief Enables/disables the warm start of the next computations, in which the primal
+		 * and dual variables start from the starting point of the model (e.g. a shifted
+		 * solution). Solvers without dual variables only use the primal ones
+		 * @param bool True for enabling the warm start
+		 */
+		virtual void setWarmStart(bool warm_start);
+
 		/**
 		 * @brief Gets the optimization model
 		 * @return the object pointer of the optimization model
@@ -79,6 +87,9 @@ class OptimizationSolver
 
 		/** @brief The solution vector */
 		Eigen::VectorXd solution_;
+
+		/** @brief Indicates if the computation is warm-started */
+		bool warm_start_;
 };
 
 } //@namespace solver
@@ -0,0 +1,641 @@
+#include <dwl/solver/RiccatiSolver.h>
+
+
+namespace dwl
+{
+
+namespace solver
+{
+
+RiccatiSolver::RiccatiSolver() : num_stages_(0), stage_dim_(0), stage_constraint_dim_(0),
+		decision_dim_(0), constraint_dim_(0), penalty_(10.), jacobian_(false), hessian_(false),
+		initialized_(false), print_(false), max_iter_(100), convergence_tol_(1e-6),
+		constr_viol_tol_(1e-4), initial_penalty_(10.), max_penalty_(1e8), regularization_(1e-8)
+{
+	name_ = "Riccati";
+}
+
+
+RiccatiSolver::~RiccatiSolver()
+{
+
+}
+
+
+void RiccatiSolver::setFromConfigFile(std::string filename)
+{
+	// Yaml reader
+	YamlWrapper yaml_reader(filename);
+
+	// Parsing the configuration file
+	std::string riccati_ns = "riccati";
+	printf(BLUE_ "Reading the configuration parameters from the %s namespace.\n" COLOR_RESET,
+			riccati_ns.c_str());
+
+	// Getting the different nodes
+	YamlNamespace output_ns = {riccati_ns, "output"};
+	YamlNamespace termination_ns = {riccati_ns, "termination"};
+	YamlNamespace penalty_ns = {riccati_ns, "penalty"};
+
+	// Reading and setting up the print option
+	bool print;
+	if (yaml_reader.read(print, "print", output_ns))
+		setPrintOption(print);
+
+	// Reading and setting up the termination parameters
+	double tol;
+	if (yaml_reader.read(tol, "tol", termination_ns))
+		setConvergenceTolerance(tol);
+
+	int max_iter;
+	if (yaml_reader.read(max_iter, "max_iter", termination_ns))
+		setMaxIteration(max_iter);
+
+	double constr_viol_tol;
+	if (yaml_reader.read(constr_viol_tol, "constr_viol_tol", termination_ns))
+		setConstraintViolationTolerance(constr_viol_tol);
+
+	// Reading and setting up the initial penalty
+	double initial_penalty;
+	if (yaml_reader.read(initial_penalty, "initial_penalty", penalty_ns))
+		setInitialPenalty(initial_penalty);
+}
+
+
+void RiccatiSolver::setMaxIteration(int max_iter)
+{
+	max_iter_ = max_iter;
+}
+
+
+void RiccatiSolver::setConvergenceTolerance(double tolerance)
+{
+	convergence_tol_ = tolerance;
+}
+
+
+void RiccatiSolver::setConstraintViolationTolerance(double tolerance)
+{
+	constr_viol_tol_ = tolerance;
+}
+
+
+void RiccatiSolver::setInitialPenalty(double penalty)
+{
+	initial_penalty_ = penalty;
+}
+
+
+void RiccatiSolver::setPrintOption(bool print)
+{
+	print_ = print;
+}
+
+
+bool RiccatiSolver::init()
+{
+	if (model_ == NULL) {
+		printf(RED_ "Error: the optimization model was not defined\n" COLOR_RESET);
+		return false;
+	}
+
+	// Initializing the optimization model
+	if (model_->requiresInitialization())
+		model_->init();
+
+	decision_dim_ = model_->getDimensionOfState();
+	constraint_dim_ = model_->getDimensionOfConstraints();
+
+	// Getting the bounds of the problem
+	decision_lbound_.resize(decision_dim_);
+	decision_ubound_.resize(decision_dim_);
+	constraint_lbound_.resize(constraint_dim_);
+	constraint_ubound_.resize(constraint_dim_);
+	model_->evaluateBounds(decision_lbound_.data(), decision_dim_,
+						   decision_ubound_.data(), decision_dim_,
+						   constraint_lbound_.data(), constraint_dim_,
+						   constraint_ubound_.data(), constraint_dim_);
+
+	// Getting the stage-wise structure of the problem. A problem without it is solved as a
+	// single stage, i.e. with a dense Newton system
+	bool stage_wise = model_->getStageStructure(num_stages_, stage_dim_, stage_constraint_dim_);
+	if (!stage_wise || num_stages_ == 0 || num_stages_ * stage_dim_ != decision_dim_ ||
+			num_stages_ * stage_constraint_dim_ > constraint_dim_) {
+		stage_wise = false;
+		num_stages_ = 1;
+		stage_dim_ = decision_dim_;
+		stage_constraint_dim_ = constraint_dim_;
+	}
+
+	// Getting the sparsity pattern of the jacobian. Without the jacobian, it's computed by
+	// finite differences of the entries allowed by the stage-wise structure
+	unsigned int nnz_jac = model_->getNumberOfNonzeroJacobian();
+	jacobian_ = model_->isConstraintJacobianImplemented() && nnz_jac != 0;
+	if (jacobian_) {
+		jacobian_rows_.resize(nnz_jac);
+		jacobian_cols_.resize(nnz_jac);
+		model_->evaluateConstraintJacobian(NULL, nnz_jac,
+										   jacobian_rows_.data(), nnz_jac,
+										   jacobian_cols_.data(), nnz_jac,
+										   NULL, decision_dim_, true);
+	} else {
+		printf(BLUE_ "Info: Computing the Jacobian using finite-difference.\n" COLOR_RESET);
+		jacobian_rows_.clear();
+		jacobian_cols_.clear();
+		unsigned int stage_rows = num_stages_ * stage_constraint_dim_;
+		for (unsigned int i = 0; i < constraint_dim_; i++) {
+			unsigned int stage = (i < stage_rows) ? i / stage_constraint_dim_ : num_stages_ - 1;
+			unsigned int first_col = (stage > 0) ? (stage - 1) * stage_dim_ : 0;
+			for (unsigned int j = first_col; j < (stage + 1) * stage_dim_; j++) {
+				jacobian_rows_.push_back(i);
+				jacobian_cols_.push_back(j);
+			}
+		}
+	}
+	jacobian_values_.resize(jacobian_rows_.size());
+
+	// Getting the sparsity pattern of the Hessian. Without the Hessian, the cost Hessian is
+	// computed by finite differences, and the constraints only have the Gauss-Newton
+	// approximation of their penalty
+	unsigned int nnz_hess = model_->getNumberOfNonzeroHessian();
+	hessian_ = model_->isLagrangianHessianImplemented() && nnz_hess != 0;
+	hessian_rows_.clear();
+	hessian_cols_.clear();
+	if (hessian_) {
+		hessian_rows_.resize(nnz_hess);
+		hessian_cols_.resize(nnz_hess);
+		model_->evaluateLagrangianHessian(NULL, nnz_hess,
+										  hessian_rows_.data(), nnz_hess,
+										  hessian_cols_.data(), nnz_hess,
+										  1., NULL, constraint_dim_,
+										  NULL, decision_dim_, true);
+	} else
+		printf(BLUE_ "Info: Approximating the Lagrangian Hessian using finite-difference.\n" COLOR_RESET);
+	hessian_values_.resize(hessian_rows_.size());
+
+	// Checking that the sparsity patterns agree with the stage-wise structure
+	if (stage_wise && !checkStageStructure()) {
+		stage_wise = false;
+		num_stages_ = 1;
+		stage_dim_ = decision_dim_;
+		stage_constraint_dim_ = constraint_dim_;
+	}
+	if (!stage_wise)
+		printf(YELLOW_ "Warning: the problem doesn't have a stage-wise structure, so it's solved"
+				" as a single stage\n" COLOR_RESET);
+
+	// Allocating the blocks of the jacobian and Newton matrix
+	unsigned int terminal_dim = constraint_dim_ - num_stages_ * stage_constraint_dim_;
+	stage_jacobians_.assign(num_stages_, Eigen::MatrixXd::Zero(stage_constraint_dim_,
+															   2 * stage_dim_));
+	stage_jacobians_.push_back(Eigen::MatrixXd::Zero(terminal_dim, 2 * stage_dim_));
+	diagonal_blocks_.assign(num_stages_, Eigen::MatrixXd::Zero(stage_dim_, stage_dim_));
+	lower_blocks_.assign(num_stages_, Eigen::MatrixXd::Zero(stage_dim_, stage_dim_));
+	schur_factors_.resize(num_stages_);
+
+	if ((unsigned) multipliers_.size() != constraint_dim_)
+		multipliers_ = Eigen::VectorXd::Zero(constraint_dim_);
+
+	initialized_ = true;
+	return true;
+}
+
+
+bool RiccatiSolver::compute(double allocated_time_secs)
+{
+	// Setting the initial time
+	clock_t started_time = clock();
+
+	if (!initialized_ || model_->requiresInitialization()) {
+		if (!init())
+			return false;
+	}
+
+	// Getting the starting point of the primal and dual variables
+	Eigen::VectorXd decision(decision_dim_);
+	model_->getStartingPoint(decision.data(), decision_dim_);
+	project(decision);
+	Eigen::VectorXd bound_lmult(decision_dim_), bound_umult(decision_dim_);
+	Eigen::VectorXd constraint_mult(constraint_dim_);
+	if (warm_start_ &&
+			model_->getStartingDualPoint(bound_lmult.data(), bound_umult.data(), decision_dim_,
+										 constraint_mult.data(), constraint_dim_))
+		multipliers_ = constraint_mult;
+	else
+		multipliers_ = Eigen::VectorXd::Zero(constraint_dim_);
+	penalty_ = initial_penalty_;
+
+	// Evaluating the augmented Lagrangian of the starting point
+	Eigen::VectorXd multipliers, constraint;
+	double merit = evaluateMerit(multipliers, constraint, decision);
+
+	Eigen::VectorXd cost_gradient(decision_dim_), gradient(decision_dim_), step(decision_dim_);
+	std::vector<bool> active(decision_dim_);
+	double last_violation = std::numeric_limits<double>::max();
+	bool solved = false;
+	double current_duration_secs = 0.;
+	for (int iter = 0; (max_iter_ < 0 || iter < max_iter_) &&
+			current_duration_secs < allocated_time_secs; iter++) {
+		// Computing the gradient of the augmented Lagrangian, i.e. the gradient of the Lagrangian
+		// with the effective multipliers
+		evaluateJacobian(decision, constraint);
+		model_->evaluateCostGradient(cost_gradient.data(), decision_dim_,
+									 decision.data(), decision_dim_);
+		gradient = cost_gradient;
+		for (unsigned int i = 0; i < jacobian_rows_.size(); i++)
+			gradient(jacobian_cols_[i]) += jacobian_values_(i) * multipliers(jacobian_rows_[i]);
+
+		// Getting the active bounds, i.e. the bounds that block the steepest descent
+		double pgrad_norm = 0.;
+		for (unsigned int i = 0; i < decision_dim_; i++) {
+			double x = decision(i);
+			double projected = std::max(decision_lbound_(i),
+										std::min(decision_ubound_(i), x - gradient(i)));
+			pgrad_norm = std::max(pgrad_norm, fabs(x - projected));
+			active[i] = (x <= decision_lbound_(i) && gradient(i) > 0.) ||
+					(x >= decision_ubound_(i) && gradient(i) < 0.);
+		}
+
+		// Computing the constraint violation
+		double violation = 0.;
+		for (unsigned int i = 0; i < constraint_dim_; i++) {
+			double value = constraint(i);
+			violation = std::max(violation, constraint_lbound_(i) - value);
+			violation = std::max(violation, value - constraint_ubound_(i));
+		}
+
+		if (print_)
+			printf("iter %4i  merit %e  constr_viol %e  proj_grad %e  penalty %.1e  reg %.1e\n",
+					iter, merit, violation, pgrad_norm, penalty_, regularization_);
+
+		// Updating the multipliers and penalty once the subproblem is solved. The subproblems
+		// are solved with a tolerance of the order of the constraint violation
+		if (pgrad_norm < std::max(convergence_tol_, std::min(1., violation))) {
+			if (violation < constr_viol_tol_ && pgrad_norm < convergence_tol_) {
+				solved = true;
+				break;
+			}
+
+			multipliers_ = multipliers;
+			if (violation > 0.25 * last_violation)
+				penalty_ = std::min(10. * penalty_, max_penalty_);
+			last_violation = violation;
+			merit = evaluateMerit(multipliers, constraint, decision);
+			continue;
+		}
+
+		// Computing the Newton step with the Riccati recursion. The regularization is increased
+		// until the Newton matrix is positive definite
+		buildNewtonMatrix(decision, multipliers, constraint, cost_gradient);
+		bool factorized = false;
+		while (!factorized && regularization_ < 1e10) {
+			factorized = solveNewtonSystem(step, gradient, active, regularization_);
+			if (!factorized)
+				regularization_ = std::max(1e-4, 10. * regularization_);
+		}
+		if (!factorized) {
+			printf(YELLOW_ "Warning: the Newton matrix couldn't be factorized\n" COLOR_RESET);
+			break;
+		}
+
+		// Projected backtracking line-search with the Armijo condition
+		Eigen::VectorXd new_decision, new_multipliers, new_constraint;
+		double new_merit = merit;
+		bool accepted = false;
+		double alpha = 1.;
+		for (unsigned int ls = 0; ls < 30; ls++) {
+			new_decision = decision + alpha * step;
+			project(new_decision);
+			new_merit = evaluateMerit(new_multipliers, new_constraint, new_decision);
+			if (new_merit <= merit + 1e-4 * gradient.dot(new_decision - decision)) {
+				accepted = true;
+				break;
+			}
+			alpha *= 0.5;
+		}
+
+		if (accepted) {
+			decision = new_decision;
+			multipliers = new_multipliers;
+			constraint = new_constraint;
+			merit = new_merit;
+			regularization_ = std::max(1e-8, 0.1 * regularization_);
+		} else // A poor Newton step, so the next one is closer to the steepest descent
+			regularization_ = std::max(1e-4, 100. * regularization_);
+
+		// Computing the current time
+		clock_t current_time = clock() - started_time;
+		current_duration_secs = ((double) current_time) / CLOCKS_PER_SEC;
+	}
+
+	// Setting the solution, and the dual solution for warm-starting the next computation. Note
+	// that the bound multipliers are the components of the gradient blocked by the bounds
+	solution_ = decision;
+	for (unsigned int i = 0; i < decision_dim_; i++) {
+		bound_lmult(i) = (decision(i) <= decision_lbound_(i)) ? std::max(0., gradient(i)) : 0.;
+		bound_umult(i) = (decision(i) >= decision_ubound_(i)) ? std::max(0., -gradient(i)) : 0.;
+	}
+	model_->setDualSolution(bound_lmult.data(), bound_umult.data(), decision_dim_,
+							multipliers.data(), constraint_dim_);
+
+	if (!solved)
+		printf("\n\n*** The problem FAILED!\n");
+
+	return solved;
+}
+
+
+double RiccatiSolver::evaluateMerit(Eigen::VectorXd& multipliers,
+									Eigen::VectorXd& constraint,
+									const Eigen::VectorXd& decision)
+{
+	double cost;
+	model_->evaluateCosts(cost, decision.data(), decision_dim_);
+	constraint.resize(constraint_dim_);
+	model_->evaluateConstraints(constraint.data(), constraint_dim_,
+								decision.data(), decision_dim_);
+
+	// Computing the shifted penalty of the constraints, i.e. the distance of the shifted
+	// constraint c + lambda / rho to its bounds
+	double merit = cost;
+	multipliers.resize(constraint_dim_);
+	for (unsigned int i = 0; i < constraint_dim_; i++) {
+		double shifted = constraint(i) + multipliers_(i) / penalty_;
+		double projected = std::max(constraint_lbound_(i),
+									std::min(constraint_ubound_(i), shifted));
+		multipliers(i) = penalty_ * (shifted - projected);
+		merit += 0.5 * penalty_ * (shifted - projected) * (shifted - projected);
+	}
+
+	return merit;
+}
+
+
+void RiccatiSolver::evaluateJacobian(const Eigen::VectorXd& decision,
+									 const Eigen::VectorXd& constraint)
+{
+	if (jacobian_) {
+		model_->evaluateConstraintJacobian(jacobian_values_.data(), jacobian_values_.size(),
+										   NULL, jacobian_values_.size(),
+										   NULL, jacobian_values_.size(),
+										   decision.data(), decision_dim_, false);
+	} else {
+		// Computing the jacobian with forward differences. The constraints of a stage only
+		// depend on the previous and current stages, so every second stage is perturbed together
+		Eigen::VectorXd perturbed_decision = decision;
+		Eigen::VectorXd perturbed_constraint(constraint_dim_);
+		for (unsigned int color = 0; color < std::min(2u, num_stages_); color++) {
+			for (unsigned int i = 0; i < stage_dim_; i++) {
+				for (unsigned int k = color; k < num_stages_; k += 2) {
+					unsigned int index = k * stage_dim_ + i;
+					perturbed_decision(index) += 1e-7 * std::max(1., fabs(decision(index)));
+				}
+				model_->evaluateConstraints(perturbed_constraint.data(), constraint_dim_,
+											perturbed_decision.data(), decision_dim_);
+
+				for (unsigned int j = 0; j < jacobian_rows_.size(); j++) {
+					unsigned int col = jacobian_cols_[j];
+					if (col % stage_dim_ != i || getStage(col) % 2 != color)
+						continue;
+
+					unsigned int row = jacobian_rows_[j];
+					jacobian_values_(j) = (perturbed_constraint(row) - constraint(row)) /
+							(perturbed_decision(col) - decision(col));
+				}
+
+				for (unsigned int k = color; k < num_stages_; k += 2) {
+					unsigned int index = k * stage_dim_ + i;
+					perturbed_decision(index) = decision(index);
+				}
+			}
+		}
+	}
+}
+
+
+void RiccatiSolver::buildNewtonMatrix(const Eigen::VectorXd& decision,
+									  const Eigen::VectorXd& multipliers,
+									  const Eigen::VectorXd& constraint,
+									  const Eigen::VectorXd& cost_gradient)
+{
+	for (unsigned int k = 0; k < num_stages_; k++) {
+		diagonal_blocks_[k].setZero();
+		lower_blocks_[k].setZero();
+	}
+
+	// Adding the Lagrangian Hessian, which is described by its lower triangle
+	if (hessian_) {
+		model_->evaluateLagrangianHessian(hessian_values_.data(), hessian_values_.size(),
+										  NULL, hessian_values_.size(),
+										  NULL, hessian_values_.size(),
+										  1., multipliers.data(), constraint_dim_,
+										  decision.data(), decision_dim_, false);
+		for (unsigned int i = 0; i < hessian_rows_.size(); i++) {
+			unsigned int row = hessian_rows_[i];
+			unsigned int col = hessian_cols_[i];
+			unsigned int row_stage = getStage(row);
+			unsigned int col_stage = getStage(col);
+			unsigned int r = row - row_stage * stage_dim_;
+			unsigned int c = col - col_stage * stage_dim_;
+			double value = hessian_values_(i);
+			if (row_stage == col_stage) {
+				diagonal_blocks_[row_stage](r,c) += value;
+				if (r != c)
+					diagonal_blocks_[row_stage](c,r) += value;
+			} else if (row_stage == col_stage + 1)
+				lower_blocks_[row_stage](r,c) += value;
+			else if (col_stage == row_stage + 1)
+				lower_blocks_[col_stage](c,r) += value;
+		}
+	} else
+		approximateCostHessian(decision, cost_gradient);
+
+	// Getting the jacobian blocks of every stage
+	for (unsigned int b = 0; b < stage_jacobians_.size(); b++)
+		stage_jacobians_[b].setZero();
+	unsigned int block, row, col;
+	for (unsigned int i = 0; i < jacobian_rows_.size(); i++) {
+		if (getJacobianEntry(block, row, col, i))
+			stage_jacobians_[block](row,col) += jacobian_values_(i);
+	}
+
+	// Adding the Gauss-Newton approximation of the penalty of the active constraints, i.e.
+	// rho * J_a^T * J_a, which couples the current and previous stages
+	for (unsigned int b = 0; b < stage_jacobians_.size(); b++) {
+		const Eigen::MatrixXd& jacobian = stage_jacobians_[b];
+		if (jacobian.rows() == 0)
+			continue;
+
+		unsigned int stage = std::min(b, num_stages_ - 1);
+		unsigned int first_row = b * stage_constraint_dim_;
+		Eigen::VectorXd weights(jacobian.rows());
+		for (unsigned int r = 0; r < jacobian.rows(); r++)
+			weights(r) = isActiveConstraint(first_row + r, constraint(first_row + r)) ?
+					penalty_ : 0.;
+
+		Eigen::MatrixXd penalty_hessian = jacobian.transpose() * weights.asDiagonal() * jacobian;
+		diagonal_blocks_[stage] += penalty_hessian.bottomRightCorner(stage_dim_, stage_dim_);
+		if (stage > 0) {
+			diagonal_blocks_[stage - 1] += penalty_hessian.topLeftCorner(stage_dim_, stage_dim_);
+			lower_blocks_[stage] += penalty_hessian.bottomLeftCorner(stage_dim_, stage_dim_);
+		}
+	}
+}
+
+
+void RiccatiSolver::approximateCostHessian(const Eigen::VectorXd& decision,
+										   const Eigen::VectorXd& cost_gradient)
+{
+	Eigen::VectorXd perturbed_decision = decision;
+	Eigen::VectorXd perturbed_gradient(decision_dim_);
+	for (unsigned int color = 0; color < std::min(3u, num_stages_); color++) {
+		for (unsigned int i = 0; i < stage_dim_; i++) {
+			for (unsigned int k = color; k < num_stages_; k += 3) {
+				unsigned int index = k * stage_dim_ + i;
+				perturbed_decision(index) += 1e-5 * std::max(1., fabs(decision(index)));
+			}
+			model_->evaluateCostGradient(perturbed_gradient.data(), decision_dim_,
+										 perturbed_decision.data(), decision_dim_);
+
+			// Getting the columns of the diagonal and lower blocks of every perturbed stage
+			for (unsigned int k = color; k < num_stages_; k += 3) {
+				unsigned int index = k * stage_dim_ + i;
+				double step = perturbed_decision(index) - decision(index);
+				diagonal_blocks_[k].col(i) +=
+						(perturbed_gradient - cost_gradient).segment(k * stage_dim_, stage_dim_) /
+						step;
+				if (k + 1 < num_stages_)
+					lower_blocks_[k + 1].col(i) +=
+							(perturbed_gradient - cost_gradient).segment((k + 1) * stage_dim_,
+																		 stage_dim_) / step;
+				perturbed_decision(index) = decision(index);
+			}
+		}
+	}
+
+	// Symmetrizing the diagonal blocks
+	for (unsigned int k = 0; k < num_stages_; k++)
+		diagonal_blocks_[k] = 0.5 * (diagonal_blocks_[k] + diagonal_blocks_[k].transpose()).eval();
+}
+
+
+bool RiccatiSolver::solveNewtonSystem(Eigen::VectorXd& step,
+									  const Eigen::VectorXd& gradient,
+									  const std::vector<bool>& active,
+									  double regularization)
+{
+	// Forward recursion, i.e. the Schur complements S_k = H_kk - H_k,k-1 S_k-1^-1 H_k-1,k.
+	// The variables of the active bounds are decoupled from the rest and fixed
+	std::vector<Eigen::VectorXd> reduced_rhs(num_stages_);
+	for (unsigned int k = 0; k < num_stages_; k++) {
+		unsigned int offset = k * stage_dim_;
+		Eigen::MatrixXd schur = diagonal_blocks_[k];
+		Eigen::MatrixXd& lower = lower_blocks_[k];
+		Eigen::VectorXd rhs = -gradient.segment(offset, stage_dim_);
+		for (unsigned int i = 0; i < stage_dim_; i++) {
+			if (active[offset + i]) {
+				schur.row(i).setZero();
+				schur.col(i).setZero();
+				schur(i,i) = 1.;
+				lower.row(i).setZero();
+				rhs(i) = 0.;
+			}
+			if (k > 0 && active[offset - stage_dim_ + i])
+				lower.col(i).setZero();
+		}
+		schur.diagonal().array() += regularization;
+
+		if (k > 0) {
+			Eigen::MatrixXd gain = schur_factors_[k - 1].solve(lower.transpose());
+			schur -= lower * gain;
+			rhs -= gain.transpose() * reduced_rhs[k - 1];
+		}
+
+		schur_factors_[k].compute(schur);
+		if (schur_factors_[k].info() != Eigen::Success)
+			return false;
+		reduced_rhs[k] = rhs;
+	}
+
+	// Backward recursion
+	step.resize(decision_dim_);
+	for (int k = num_stages_ - 1; k >= 0; k--) {
+		Eigen::VectorXd rhs = reduced_rhs[k];
+		if (k < (int) num_stages_ - 1)
+			rhs -= lower_blocks_[k + 1].transpose() * step.segment((k + 1) * stage_dim_, stage_dim_);
+		step.segment(k * stage_dim_, stage_dim_) = schur_factors_[k].solve(rhs);
+	}
+
+	return true;
+}
+
+
+bool RiccatiSolver::checkStageStructure()
+{
+	unsigned int block, row, col;
+	for (unsigned int i = 0; i < jacobian_rows_.size(); i++) {
+		if (!getJacobianEntry(block, row, col, i))
+			return false;
+	}
+
+	for (unsigned int i = 0; i < hessian_rows_.size(); i++) {
+		int row_stage = getStage(hessian_rows_[i]);
+		int col_stage = getStage(hessian_cols_[i]);
+		if (abs(row_stage - col_stage) > 1)
+			return false;
+	}
+
+	return true;
+}
+
+
+bool RiccatiSolver::getJacobianEntry(unsigned int& block,
+									 unsigned int& row,
+									 unsigned int& col,
+									 unsigned int index)
+{
+	unsigned int jacobian_row = jacobian_rows_[index];
+	unsigned int jacobian_col = jacobian_cols_[index];
+	if (stage_constraint_dim_ != 0 && jacobian_row < num_stages_ * stage_constraint_dim_) {
+		block = jacobian_row / stage_constraint_dim_;
+		row = jacobian_row - block * stage_constraint_dim_;
+	} else {
+		block = num_stages_;
+		row = jacobian_row - num_stages_ * stage_constraint_dim_;
+	}
+
+	// The columns of the block are the previous and current stages
+	unsigned int stage = std::min(block, num_stages_ - 1);
+	unsigned int col_stage = getStage(jacobian_col);
+	if (col_stage == stage)
+		col = stage_dim_ + jacobian_col - col_stage * stage_dim_;
+	else if (col_stage + 1 == stage)
+		col = jacobian_col - col_stage * stage_dim_;
+	else
+		return false;
+
+	return true;
+}
+
+
+void RiccatiSolver::project(Eigen::VectorXd& decision)
+{
+	decision = decision.cwiseMax(decision_lbound_).cwiseMin(decision_ubound_);
+}
+
+
+bool RiccatiSolver::isActiveConstraint(unsigned int index,
+									   double constraint)
+{
+	double shifted = constraint + multipliers_(index) / penalty_;
+	return shifted <= constraint_lbound_(index) || shifted >= constraint_ubound_(index);
+}
+
+
+unsigned int RiccatiSolver::getStage(unsigned int decision_index)
+{
+	return std::min(decision_index / stage_dim_, num_stages_ - 1);
+}
+
+} //@namespace solver
+} //@namespace dwl
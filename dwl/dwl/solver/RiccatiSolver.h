@@ -0,0 +1,244 @@
+#ifndef DWL__SOLVER__RICCATI_SOLVER__H
+#define DWL__SOLVER__RICCATI_SOLVER__H
+
+#include <dwl/solver/OptimizationSolver.h>
+#include <time.h>
+
+
+namespace dwl
+{
+
+namespace solver
+{
+
+/**
+ * @class RiccatiSolver
+ * @brief Structure-exploiting solver of stage-wise optimization problems (e.g. optimal control
+ * problems), in which the constraints of every stage only depend on its decision variables and
+ * the ones of the previous stage (see model::OptimizationModel::getStageStructure). The
+ * constraints are handled with an augmented Lagrangian, and every subproblem is solved with a
+ * projected Newton method that keeps the decision bounds (box constraints). The Newton system
+ * is block-tridiagonal, so it's factorized with a Riccati-like recursion over the stages, i.e.
+ * the complexity is linear in the number of stages
+ */
+class RiccatiSolver : public OptimizationSolver
+{
+	public:
+		/** @brief Constructor function */
+		RiccatiSolver();
+
+		/** @brief Destructor function */
+		~RiccatiSolver();
+
+		/**
+		 * @brief Sets the configuration parameters from a yaml file
+		 * @param std::string Filename
+		 */
+		void setFromConfigFile(std::string filename);
+
+		/**
+		 * @brief Sets the maximum allowed number of Newton iterations
+		 * @param int Maximum number of iterations
+		 */
+		void setMaxIteration(int max_iter);
+
+		/**
+		 * @brief Sets the convergence tolerance of the projected gradient of the Lagrangian
+		 * @param double Convergence tolerance
+		 */
+		void setConvergenceTolerance(double tolerance);
+
+		/**
+		 * @brief Sets the constraint violation tolerance
+		 * @param double Tolerance value
+		 */
+		void setConstraintViolationTolerance(double tolerance);
+
+		/**
+		 * @brief Sets the initial penalty of the augmented Lagrangian
+		 * @param double Initial penalty
+		 */
+		void setInitialPenalty(double penalty);
+
+		/** @brief Sets if we desired to print the iterations in the terminal */
+		void setPrintOption(bool print);
+
+		/**
+		 * @brief Initializes the solver, i.e. the stage-wise structure of the problem
+		 * @return True if was initialized
+		 */
+		bool init();
+
+		/**
+		 * @brief Computes a solution of the optimization problem given a computation time
+		 * @param double Allocated computation time in seconds
+		 * @return True if it was computed a solution
+		 */
+		bool compute(double allocated_time_secs = 2e19);
+
+
+	private:
+		/**
+		 * @brief Evaluates the augmented Lagrangian of the current multipliers and penalty, and
+		 * the effective multipliers, i.e. the ones of the first-order expansion
+		 * @param Eigen::VectorXd& Effective constraint multipliers
+		 * @param Eigen::VectorXd& Constraint values
+		 * @param const Eigen::VectorXd& Decision variables
+		 * @return The augmented Lagrangian value
+		 */
+		double evaluateMerit(Eigen::VectorXd& multipliers,
+							 Eigen::VectorXd& constraint,
+							 const Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Evaluates the constraint jacobian, which is computed by finite differences if
+		 * the model doesn't implement it
+		 * @param const Eigen::VectorXd& Decision variables
+		 * @param const Eigen::VectorXd& Constraint values at the decision variables
+		 */
+		void evaluateJacobian(const Eigen::VectorXd& decision,
+							  const Eigen::VectorXd& constraint);
+
+		/**
+		 * @brief Builds the block-tridiagonal Newton matrix, i.e. the Lagrangian Hessian (or an
+		 * approximation of the cost Hessian) and the Gauss-Newton approximation of the penalty
+		 * @param const Eigen::VectorXd& Decision variables
+		 * @param const Eigen::VectorXd& Effective constraint multipliers
+		 * @param const Eigen::VectorXd& Constraint values
+		 * @param const Eigen::VectorXd& Cost gradient
+		 */
+		void buildNewtonMatrix(const Eigen::VectorXd& decision,
+							   const Eigen::VectorXd& multipliers,
+							   const Eigen::VectorXd& constraint,
+							   const Eigen::VectorXd& cost_gradient);
+
+		/**
+		 * @brief Approximates the cost Hessian by finite differences of the cost gradient. The
+		 * stages that are three stages apart don't share Hessian blocks, so they are perturbed
+		 * together, i.e. it needs 3 x (stage dimension) gradient evaluations
+		 * @param const Eigen::VectorXd& Decision variables
+		 * @param const Eigen::VectorXd& Cost gradient
+		 */
+		void approximateCostHessian(const Eigen::VectorXd& decision,
+									const Eigen::VectorXd& cost_gradient);
+
+		/**
+		 * @brief Solves the regularized Newton system with the Riccati recursion, where the
+		 * variables of the active bounds are fixed
+		 * @param Eigen::VectorXd& Newton step
+		 * @param const Eigen::VectorXd& Gradient of the augmented Lagrangian
+		 * @param const std::vector<bool>& Active bounds
+		 * @param double Regularization of the diagonal
+		 * @return False if the regularized matrix isn't positive definite
+		 */
+		bool solveNewtonSystem(Eigen::VectorXd& step,
+							   const Eigen::VectorXd& gradient,
+							   const std::vector<bool>& active,
+							   double regularization);
+
+		/**
+		 * @brief Checks that the sparsity patterns of the jacobian and Hessian agree with the
+		 * stage-wise structure, i.e. they only couple consecutive stages
+		 * @return True if the patterns are consistent
+		 */
+		bool checkStageStructure();
+
+		/**
+		 * @brief Gets the stage block of an entry of the constraint jacobian. The block of a
+		 * stage is described with respect to the decision variables of the previous and current
+		 * stages, and the terminal constraints are the last block
+		 * @param unsigned int& Block index
+		 * @param unsigned int& Row inside the block
+		 * @param unsigned int& Column inside the block
+		 * @param unsigned int Index of the jacobian entry
+		 * @return False if the entry doesn't agree with the stage-wise structure
+		 */
+		bool getJacobianEntry(unsigned int& block,
+							  unsigned int& row,
+							  unsigned int& col,
+							  unsigned int index);
+
+		/** @brief Projects the decision variables onto their bounds */
+		void project(Eigen::VectorXd& decision);
+
+		/**
+		 * @brief Indicates if a constraint is active in the current augmented Lagrangian, i.e.
+		 * if its shifted value leaves its bounds
+		 * @param unsigned int Index of the constraint
+		 * @param double Constraint value
+		 */
+		bool isActiveConstraint(unsigned int index,
+								double constraint);
+
+		/** @brief Gets the stage of a decision variable */
+		unsigned int getStage(unsigned int decision_index);
+
+		/** @brief Stage-wise structure, i.e. number of stages, and decision and constraint
+		 * dimensions of every stage */
+		unsigned int num_stages_;
+		unsigned int stage_dim_;
+		unsigned int stage_constraint_dim_;
+
+		/** @brief Decision and constraint dimensions */
+		unsigned int decision_dim_;
+		unsigned int constraint_dim_;
+
+		/** @brief Decision and constraint bounds */
+		Eigen::VectorXd decision_lbound_;
+		Eigen::VectorXd decision_ubound_;
+		Eigen::VectorXd constraint_lbound_;
+		Eigen::VectorXd constraint_ubound_;
+
+		/** @brief Constraint multipliers and penalty of the augmented Lagrangian */
+		Eigen::VectorXd multipliers_;
+		double penalty_;
+
+		/** @brief Sparsity pattern and values of the constraint jacobian */
+		std::vector<int> jacobian_rows_;
+		std::vector<int> jacobian_cols_;
+		Eigen::VectorXd jacobian_values_;
+
+		/** @brief Sparsity pattern and values of the Lagrangian Hessian (lower triangle) */
+		std::vector<int> hessian_rows_;
+		std::vector<int> hessian_cols_;
+		Eigen::VectorXd hessian_values_;
+
+		/** @brief Jacobian blocks of every stage (and the terminal constraints) */
+		std::vector<Eigen::MatrixXd> stage_jacobians_;
+
+		/** @brief Diagonal and lower blocks of the Newton matrix, i.e. H(k,k) and H(k,k-1) */
+		std::vector<Eigen::MatrixXd> diagonal_blocks_;
+		std::vector<Eigen::MatrixXd> lower_blocks_;
+
+		/** @brief Factorizations of the Schur complements of the Riccati recursion */
+		std::vector<Eigen::LLT<Eigen::MatrixXd> > schur_factors_;
+
+		/** @brief Indicates if the jacobian and Hessian are implemented by the model */
+		bool jacobian_;
+		bool hessian_;
+
+		/** @brief Label that indicates if it's initialized the solver */
+		bool initialized_;
+
+		/** @brief Prints the iterations */
+		bool print_;
+
+		/** @brief Maximum number of Newton iterations */
+		int max_iter_;
+
+		/** @brief Convergence and constraint violation tolerances */
+		double convergence_tol_;
+		double constr_viol_tol_;
+
+		/** @brief Initial and maximum penalties */
+		double initial_penalty_;
+		double max_penalty_;
+
+		/** @brief Regularization of the Newton matrix, which is adapted between iterations */
+		double regularization_;
+};
+
+} //@namespace solver
+} //@namespace dwl
+
+#endif
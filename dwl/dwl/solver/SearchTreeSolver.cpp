@@ -46,6 +46,18 @@ void SearchTreeSolver::setAdjacencyModel(model::AdjacencyModel* adjacency_model)
 }
 
 
+void SearchTreeSolver::setNumberOfThreads(unsigned int num_threads)
+{
+	if (!is_set_adjacency_model_) {
+		printf(YELLOW_ "WARNING: Could not be set the number of threads because it is required "
+				"to defined an adjacency model\n" COLOR_RESET);
+		return;
+	}
+
+	adjacency_->setNumberOfThreads(num_threads);
+}
+
+
 std::list<Vertex> SearchTreeSolver::getShortestPath(Vertex source,
 													Vertex target)
 {
@@ -64,6 +76,41 @@ std::list<Vertex> SearchTreeSolver::getShortestPath(Vertex source,
 }
 
 
+void SearchTreeSolver::resetSearch()
+{
+	policy_.clear();
+	search_table_.clear();
+	open_queue_.clear();
+	g_cost_.clear();
+	parent_.clear();
+	closed_.clear();
+}
+
+
+unsigned int SearchTreeSolver::getSearchIndex(Vertex vertex)
+{
+	unsigned int index;
+	if (search_table_.insert(index, vertex)) {
+		g_cost_.push_back(std::numeric_limits<double>::max());
+		parent_.push_back(index);
+		closed_.push_back(false);
+	}
+
+	return index;
+}
+
+
+void SearchTreeSolver::recordPolicy(unsigned int index)
+{
+	// Only the vertices of the path are recorded, the parent of the source is itself
+	policy_.clear();
+	while (parent_[index] != index) {
+		policy_[search_table_.getVertex(index)] = search_table_.getVertex(parent_[index]);
+		index = parent_[index];
+	}
+}
+
+
 double SearchTreeSolver::getMinimumCost()
 {
 	return total_cost_;
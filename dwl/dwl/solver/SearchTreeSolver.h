@@ -46,6 +46,14 @@ class SearchTreeSolver
 		 */
 		void setAdjacencyModel(model::AdjacencyModel* adjacency_model);
 
+		/**
+		 * @brief Sets the number of threads used by the adjacency model for evaluating the
+		 * successors of every expanded vertex. The successors keep their order, so the solution
+		 * doesn't depend on the number of threads
+		 * @param unsigned int Number of threads
+		 */
+		void setNumberOfThreads(unsigned int num_threads);
+
 		/**
 		 * @brief Abstract method for computing a shortest-path using graph search algorithms
 		 * such as A*
@@ -78,6 +86,24 @@ class SearchTreeSolver
 
 
 	protected:
+		/** @brief Clears the search data of the visited vertices, keeping its memory */
+		void resetSearch();
+
+		/**
+		 * @brief Gets the dense index of a vertex, and initializes its search data (infinite
+		 * g-cost and without parent) if it wasn't visited
+		 * @param Vertex Vertex
+		 * @return The dense index of the vertex
+		 */
+		unsigned int getSearchIndex(Vertex vertex);
+
+		/**
+		 * @brief Records the policy of the path that ends in a certain vertex by backtracking
+		 * its parents
+		 * @param unsigned int Dense index of the last vertex
+		 */
+		void recordPolicy(unsigned int index);
+
 		/** @brief Name of the solver */
 		std::string name_;
 
@@ -87,6 +113,17 @@ class SearchTreeSolver
 		/** @brief Shortest previous vertex */
 		PreviousVertex policy_;
 
+		/** @brief Dense indexes of the visited vertices */
+		VertexTable search_table_;
+
+		/** @brief Open queue of the search */
+		IndexedHeap open_queue_;
+
+		/** @brief G-cost, parent index and closed flag of the visited vertices */
+		std::vector<Weight> g_cost_;
+		std::vector<unsigned int> parent_;
+		std::vector<bool> closed_;
+
 		/** @brief Total cost of the path */
 		double total_cost_;
 
@@ -66,7 +66,10 @@ class cmaesSOFamily : public OptimizationSolver
 		void setNumberOfRestarts(int max_restarts);
 
 		/**
-		 * @brief Sets the multi-threading option
+		 * @brief Sets the multi-threading option. The population is evaluated concurrently
+		 * where every thread uses its own clone of the optimization model (see
+		 * model::OptimizationModel::clone()), which is cloned again before every solution.
+		 * If the model cannot be cloned, the evaluations are serialized
 		 * @param bool True for enabling the multi-threading optimization
 		 */
 		void setMultithreading(bool multithreading);
@@ -95,6 +98,13 @@ class cmaesSOFamily : public OptimizationSolver
 
 
 	private:
+		/** @brief Initializes the clones of the optimization model used by every evaluation
+		 * thread, where the first thread uses the optimization model */
+		void initFitnessModels();
+
+		/** @brief Deletes the clones of the optimization model */
+		void deleteFitnessModels();
+
 		/**
 		 * @brief Wraps the fitness (objective) function
 		 * @param const double* State array
@@ -111,6 +121,9 @@ class cmaesSOFamily : public OptimizationSolver
 		dVec gradientFitnessFunction(const double *x,
 									 const int& n);
 
+		/** @brief Optimization models used by every evaluation thread */
+		std::vector<model::OptimizationModel*> fitness_models_;
+
 		/** @brief Fitness function wrapper */
 		libcmaes::FitFunc fitness_;
 
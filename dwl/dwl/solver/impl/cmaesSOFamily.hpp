@@ -2,6 +2,9 @@
 #define DWL__SOLVER__CMAESSOFAMILY__IMPL_H
 
 #include <mutex>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 std::mutex fmtx;  // protects fitness function
 
 
@@ -25,7 +28,7 @@ cmaesSOFamily<TScaling>::cmaesSOFamily() : cmaes_params_(NULL),
 template<typename TScaling>
 cmaesSOFamily<TScaling>::~cmaesSOFamily()
 {
-
+	deleteFitnessModels();
 }
 
 
@@ -221,8 +224,10 @@ void cmaesSOFamily<TScaling>::setMultithreading(bool multithreading)
 
 	// Setting up if the parameters pointer was initialized.
 	// Otherwise it will be initialized when init() is called
-	if (initialized_)
+	if (initialized_) {
 		cmaes_params_->set_mt_feval(multithreading_);
+		initFitnessModels();
+	}
 }
 
 
@@ -334,6 +339,11 @@ bool cmaesSOFamily<TScaling>::compute(double allocated_time_secs)
 	model_->getStartingPoint(warm_point_.data(), warm_point_.size());
 	cmaes_params_->set_x0(warm_point_);
 
+	// Cloning again the optimization model of every evaluation thread, since its initial
+	// state, desired states and weights could have changed since the last solution
+	if (fitness_models_.size() > 1)
+		initFitnessModels();
+
 	// Computing the solution
 	libcmaes::CMASolutions cmasols;
 	if (with_gradient_)
@@ -362,19 +372,68 @@ bool cmaesSOFamily<TScaling>::compute(double allocated_time_secs)
 }
 
 
+template<typename TScaling>
+void cmaesSOFamily<TScaling>::initFitnessModels()
+{
+	deleteFitnessModels();
+	if (!multithreading_)
+		return;
+
+	// Cloning the optimization model for the rest of threads
+	fitness_models_.push_back(model_);
+	unsigned int num_threads = 1;
+#ifdef _OPENMP
+	num_threads = omp_get_max_threads();
+#endif
+	for (unsigned int t = 1; t < num_threads; t++) {
+		model::OptimizationModel* replica = model_->clone();
+		if (replica == NULL) {
+			printf(YELLOW_ "Warning: the optimization model could not be cloned, so the "
+					"population is evaluated serially\n" COLOR_RESET);
+			deleteFitnessModels();
+			return;
+		}
+
+		replica->init(true);
+		fitness_models_.push_back(replica);
+	}
+}
+
+
+template<typename TScaling>
+void cmaesSOFamily<TScaling>::deleteFitnessModels()
+{
+	// Deleting the clones, i.e. all except the model of the first thread
+	for (unsigned int t = 1; t < fitness_models_.size(); t++)
+		delete fitness_models_[t];
+	fitness_models_.clear();
+}
+
+
 template<typename TScaling>
 double cmaesSOFamily<TScaling>::fitnessFunction(const double* x,
 												const int& n)
 {
-	// Locking the thread for multi-threading cases
-	std::lock_guard<std::mutex> lck(fmtx);
+	// Getting the optimization model of the evaluation thread. The evaluations with the
+	// original model are serialized, since it's shared by the first thread and the threads
+	// that don't have their own clone
+	unsigned int thread = 0;
+#ifdef _OPENMP
+	thread = omp_get_thread_num();
+#endif
+	std::unique_lock<std::mutex> lck(fmtx, std::defer_lock);
+	model::OptimizationModel* model = model_;
+	if (thread < fitness_models_.size())
+		model = fitness_models_[thread];
+	if (model == model_)
+		lck.lock();
 
 	// Numerical evaluation of the cost function
 	double obj_value = 0;
-	model_->evaluateCosts(obj_value, x, n);
+	model->evaluateCosts(obj_value, x, n);
 
 	if (constraint_dim_ > 0) {
-		obj_value += model_->evaluateAsSoftConstraints(x, n);
+		obj_value += model->evaluateAsSoftConstraints(x, n);
 	}
 
 	return obj_value;
@@ -0,0 +1,60 @@
+#include <dwl/utils/AutoDiff.h>
+
+
+namespace dwl
+{
+
+namespace math
+{
+
+void seedVariables(ADVector& variables,
+				   const Eigen::VectorXd& values,
+				   unsigned int first_seed,
+				   unsigned int num_seeds)
+{
+	unsigned int num_variables = values.size();
+	variables.resize(num_variables);
+	for (unsigned int i = 0; i < num_variables; i++)
+		variables(i) = ADScalar(values(i), num_seeds, first_seed + i);
+}
+
+
+void setVariables(ADVector& variables,
+				  const Eigen::VectorXd& values,
+				  const Eigen::MatrixXd& jacobian)
+{
+	unsigned int num_variables = values.size();
+	variables.resize(num_variables);
+	for (unsigned int i = 0; i < num_variables; i++)
+		variables(i) = ADScalar(values(i), jacobian.row(i).transpose());
+}
+
+
+void setConstants(ADVector& variables,
+				  const Eigen::VectorXd& values,
+				  unsigned int num_seeds)
+{
+	unsigned int num_variables = values.size();
+	variables.resize(num_variables);
+	for (unsigned int i = 0; i < num_variables; i++)
+		variables(i) = ADScalar(values(i), Eigen::VectorXd::Zero(num_seeds));
+}
+
+
+void getJacobian(Eigen::VectorXd& values,
+				 Eigen::MatrixXd& jacobian,
+				 const ADVector& function,
+				 unsigned int num_seeds)
+{
+	unsigned int num_values = function.size();
+	values.resize(num_values);
+	jacobian.setZero(num_values, num_seeds);
+	for (unsigned int i = 0; i < num_values; i++) {
+		values(i) = function(i).value();
+		if ((unsigned) function(i).derivatives().size() == num_seeds)
+			jacobian.row(i) = function(i).derivatives().transpose();
+	}
+}
+
+} //@namespace math
+} //@namespace dwl
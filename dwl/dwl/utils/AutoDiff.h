@@ -0,0 +1,72 @@
+#ifndef DWL__MATH__AUTO_DIFF__H
+#define DWL__MATH__AUTO_DIFF__H
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/AutoDiff>
+
+
+namespace dwl
+{
+
+namespace math
+{
+
+/**
+ * @brief Forward-mode automatic differentiation scalar, where the derivatives are described
+ * with respect to all the seeded variables. So, a single evaluation of a templated function
+ * gives its values and its exact jacobian
+ */
+typedef Eigen::AutoDiffScalar<Eigen::VectorXd> ADScalar;
+typedef Eigen::Matrix<ADScalar, Eigen::Dynamic, 1> ADVector;
+
+/**
+ * @brief Seeds a set of independent variables, i.e. the derivative of every variable is a
+ * unit vector
+ * @param ADVector& Seeded variables
+ * @param const Eigen::VectorXd& Values of the variables
+ * @param unsigned int Index of the seed of the first variable
+ * @param unsigned int Number of seeds, i.e. the dimension of the derivatives
+ */
+void seedVariables(ADVector& variables,
+				   const Eigen::VectorXd& values,
+				   unsigned int first_seed,
+				   unsigned int num_seeds);
+
+/**
+ * @brief Sets a set of dependent variables from their values and jacobian with respect to the
+ * seeds, which applies the chain rule in the next evaluations
+ * @param ADVector& Dependent variables
+ * @param const Eigen::VectorXd& Values of the variables
+ * @param const Eigen::MatrixXd& Jacobian of the variables (one column per seed)
+ */
+void setVariables(ADVector& variables,
+				  const Eigen::VectorXd& values,
+				  const Eigen::MatrixXd& jacobian);
+
+/**
+ * @brief Sets a set of constants, i.e. the derivatives are zero
+ * @param ADVector& Constant variables
+ * @param const Eigen::VectorXd& Values of the constants
+ * @param unsigned int Number of seeds, i.e. the dimension of the derivatives
+ */
+void setConstants(ADVector& variables,
+				  const Eigen::VectorXd& values,
+				  unsigned int num_seeds);
+
+/**
+ * @brief Gets the values and jacobian of an evaluated function. The values without
+ * derivatives (i.e. constants) get zero rows
+ * @param Eigen::VectorXd& Values of the function
+ * @param Eigen::MatrixXd& Jacobian of the function (one column per seed)
+ * @param const ADVector& Evaluated function
+ * @param unsigned int Number of seeds, i.e. the dimension of the derivatives
+ */
+void getJacobian(Eigen::VectorXd& values,
+				 Eigen::MatrixXd& jacobian,
+				 const ADVector& function,
+				 unsigned int num_seeds);
+
+} //@namespace math
+} //@namespace dwl
+
+#endif
@@ -113,11 +113,13 @@ struct ContactSearchRegion
  */
 struct RobotAndTerrain
 {
+	RobotAndTerrain() : height_map(NULL), resolution(0.) {}
+
 	Eigen::Vector3d body_action;
 	Pose3d pose;
 	Contact potential_contact;
 	std::vector<Contact> current_contacts;
-	std::map<Vertex, double> height_map;
+	const std::map<Vertex, double>* height_map;
 	double resolution;
 };
 
@@ -0,0 +1,282 @@
+#include <dwl/utils/GraphSearching.h>
+#include <algorithm>
+
+
+namespace dwl
+{
+
+VertexTable::VertexTable() : mask_(0)
+{
+	rehash(64);
+}
+
+
+VertexTable::~VertexTable()
+{
+
+}
+
+
+void VertexTable::clear()
+{
+	std::fill(slots_.begin(), slots_.end(), 0);
+	vertices_.clear();
+}
+
+
+void VertexTable::reserve(unsigned int num_vertices)
+{
+	// The load factor is kept under 0.5
+	std::size_t capacity = slots_.size();
+	while (capacity < 2 * (std::size_t) num_vertices)
+		capacity *= 2;
+
+	if (capacity > slots_.size())
+		rehash(capacity);
+	vertices_.reserve(num_vertices);
+}
+
+
+bool VertexTable::insert(unsigned int& index,
+						 Vertex vertex)
+{
+	if (2 * (vertices_.size() + 1) > slots_.size())
+		rehash(2 * slots_.size());
+
+	std::size_t slot = hash(vertex);
+	while (slots_[slot] != 0) {
+		if (vertices_[slots_[slot] - 1] == vertex) {
+			index = slots_[slot] - 1;
+			return false;
+		}
+		slot = (slot + 1) & mask_;
+	}
+
+	index = vertices_.size();
+	vertices_.push_back(vertex);
+	slots_[slot] = index + 1;
+
+	return true;
+}
+
+
+bool VertexTable::find(unsigned int& index,
+					   Vertex vertex) const
+{
+	std::size_t slot = hash(vertex);
+	while (slots_[slot] != 0) {
+		if (vertices_[slots_[slot] - 1] == vertex) {
+			index = slots_[slot] - 1;
+			return true;
+		}
+		slot = (slot + 1) & mask_;
+	}
+
+	return false;
+}
+
+
+Vertex VertexTable::getVertex(unsigned int index) const
+{
+	return vertices_[index];
+}
+
+
+unsigned int VertexTable::size() const
+{
+	return vertices_.size();
+}
+
+
+void VertexTable::rehash(std::size_t capacity)
+{
+	slots_.assign(capacity, 0);
+	mask_ = capacity - 1;
+
+	for (unsigned int i = 0; i < vertices_.size(); i++) {
+		std::size_t slot = hash(vertices_[i]);
+		while (slots_[slot] != 0)
+			slot = (slot + 1) & mask_;
+		slots_[slot] = i + 1;
+	}
+}
+
+
+std::size_t VertexTable::hash(Vertex vertex) const
+{
+	// Fibonacci hashing, the high bits are folded since the vertex keys of the space
+	// discretization are concatenated coordinates
+	unsigned long long key = (unsigned long long) vertex * 0x9E3779B97F4A7C15ULL;
+	return (std::size_t) (key ^ (key >> 32)) & mask_;
+}
+
+
+
+IndexedHeap::IndexedHeap()
+{
+
+}
+
+
+IndexedHeap::~IndexedHeap()
+{
+
+}
+
+
+void IndexedHeap::clear()
+{
+	for (unsigned int pos = 0; pos < heap_.size(); pos++)
+		position_[heap_[pos]] = -1;
+
+	heap_.clear();
+	keys_.clear();
+}
+
+
+bool IndexedHeap::empty() const
+{
+	return heap_.empty();
+}
+
+
+unsigned int IndexedHeap::size() const
+{
+	return heap_.size();
+}
+
+
+bool IndexedHeap::contains(unsigned int index) const
+{
+	return index < position_.size() && position_[index] >= 0;
+}
+
+
+void IndexedHeap::push(unsigned int index,
+					   const QueueKey& key)
+{
+	if (index >= position_.size())
+		position_.resize(index + 1, -1);
+
+	int pos = position_[index];
+	if (pos < 0) {
+		// Inserting the index at the end of the heap
+		heap_.push_back(index);
+		keys_.push_back(key);
+		position_[index] = heap_.size() - 1;
+		siftUp(heap_.size() - 1);
+	} else {
+		// Updating the key, it could move in both directions
+		keys_[pos] = key;
+		siftUp(pos);
+		siftDown(position_[index]);
+	}
+}
+
+
+void IndexedHeap::remove(unsigned int index)
+{
+	if (!contains(index))
+		return;
+
+	unsigned int pos = position_[index];
+	unsigned int last = heap_.size() - 1;
+	if (pos != last) {
+		swap(pos, last);
+		heap_.pop_back();
+		keys_.pop_back();
+		siftUp(pos);
+		siftDown(position_[heap_[pos]]);
+	} else {
+		heap_.pop_back();
+		keys_.pop_back();
+	}
+	position_[index] = -1;
+}
+
+
+unsigned int IndexedHeap::top() const
+{
+	return heap_.front();
+}
+
+
+const QueueKey& IndexedHeap::topKey() const
+{
+	return keys_.front();
+}
+
+
+unsigned int IndexedHeap::pop()
+{
+	unsigned int index = heap_.front();
+	remove(index);
+
+	return index;
+}
+
+
+const std::vector<unsigned int>& IndexedHeap::getElements() const
+{
+	return heap_;
+}
+
+
+bool IndexedHeap::isHigherPriority(unsigned int pos_a,
+								   unsigned int pos_b) const
+{
+	const QueueKey& key_a = keys_[pos_a];
+	const QueueKey& key_b = keys_[pos_b];
+	if (key_a.f_cost != key_b.f_cost)
+		return key_a.f_cost < key_b.f_cost;
+	else if (key_a.g_cost != key_b.g_cost)
+		return key_a.g_cost > key_b.g_cost;
+	else
+		return heap_[pos_a] < heap_[pos_b];
+}
+
+
+void IndexedHeap::siftUp(unsigned int pos)
+{
+	while (pos > 0) {
+		unsigned int parent = (pos - 1) / 2;
+		if (!isHigherPriority(pos, parent))
+			break;
+
+		swap(pos, parent);
+		pos = parent;
+	}
+}
+
+
+void IndexedHeap::siftDown(unsigned int pos)
+{
+	unsigned int num_elements = heap_.size();
+	while (true) {
+		unsigned int left = 2 * pos + 1;
+		unsigned int right = left + 1;
+		unsigned int best = pos;
+		if (left < num_elements && isHigherPriority(left, best))
+			best = left;
+		if (right < num_elements && isHigherPriority(right, best))
+			best = right;
+
+		if (best == pos)
+			break;
+
+		swap(pos, best);
+		pos = best;
+	}
+}
+
+
+void IndexedHeap::swap(unsigned int pos_a,
+					   unsigned int pos_b)
+{
+	std::swap(heap_[pos_a], heap_[pos_b]);
+	std::swap(keys_[pos_a], keys_[pos_b]);
+	position_[heap_[pos_a]] = pos_a;
+	position_[heap_[pos_b]] = pos_b;
+}
+
+} //@namespace dwl
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 
 namespace dwl
@@ -47,6 +48,183 @@ struct Edge
 /** Defines an adjacency map for graph-searching algorithms */
 typedef std::map<Vertex, std::list<Edge> > AdjacencyMap;
 
+/**
+ * @brief Defines the priority of a vertex in the open queue of graph-searching algorithms.
+ * The vertices are ordered by their f-cost. The ties are broken in favor of the vertex with
+ * the higher g-cost (i.e. the one closer to the goal), and then in favor of the vertex that
+ * was discovered first, so vertices with equal f-cost are never lost
+ */
+struct QueueKey
+{
+	QueueKey() : f_cost(0.), g_cost(0.) {}
+	QueueKey(Weight f_cost, Weight g_cost) : f_cost(f_cost), g_cost(g_cost) {}
+
+	Weight f_cost;
+	Weight g_cost;
+};
+
+
+/**
+ * @class VertexTable
+ * @brief Open-addressing hash table that maps the vertices to dense indexes. The indexes are
+ * assigned in the insertion order, so the search data (costs, parents, etc.) of the visited
+ * vertices can be stored in contiguous arrays. Note that the vertex keys of the space
+ * discretization span a range that is too large for allocating these arrays directly
+ */
+class VertexTable
+{
+	public:
+		/** @brief Constructor function */
+		VertexTable();
+
+		/** @brief Destructor function */
+		~VertexTable();
+
+		/**
+		 * @brief Removes all the vertices. The allocated memory is kept for the next search
+		 */
+		void clear();
+
+		/**
+		 * @brief Reserves memory for a certain number of vertices
+		 * @param unsigned int Number of vertices
+		 */
+		void reserve(unsigned int num_vertices);
+
+		/**
+		 * @brief Inserts a vertex if it isn't in the table
+		 * @param unsigned int& Dense index of the vertex
+		 * @param Vertex Vertex
+		 * @return True if the vertex was inserted, and false if it was already in the table
+		 */
+		bool insert(unsigned int& index,
+					Vertex vertex);
+
+		/**
+		 * @brief Finds the dense index of a vertex
+		 * @param unsigned int& Dense index of the vertex
+		 * @param Vertex Vertex
+		 * @return True if the vertex is in the table
+		 */
+		bool find(unsigned int& index,
+				  Vertex vertex) const;
+
+		/**
+		 * @brief Gets the vertex of a certain dense index
+		 * @param unsigned int Dense index
+		 * @return The vertex
+		 */
+		Vertex getVertex(unsigned int index) const;
+
+		/** @brief Gets the number of vertices in the table */
+		unsigned int size() const;
+
+
+	private:
+		/**
+		 * @brief Rebuilds the slots with a new capacity (power of two)
+		 * @param std::size_t Number of slots
+		 */
+		void rehash(std::size_t capacity);
+
+		/** @brief Computes the slot of a vertex */
+		std::size_t hash(Vertex vertex) const;
+
+		/** @brief Slots of the table, i.e. dense index + 1 of the vertex, or 0 if it's empty */
+		std::vector<unsigned int> slots_;
+
+		/** @brief Vertices ordered by their dense index */
+		std::vector<Vertex> vertices_;
+
+		/** @brief Mask of the slots (capacity - 1) */
+		std::size_t mask_;
+};
+
+
+/**
+ * @class IndexedHeap
+ * @brief Binary min-heap of dense vertex indexes ordered by their QueueKey. It keeps the position
+ * of each index in the heap, so the key of a queued vertex can be decreased (or increased) in
+ * logarithmic time without duplicating it
+ */
+class IndexedHeap
+{
+	public:
+		/** @brief Constructor function */
+		IndexedHeap();
+
+		/** @brief Destructor function */
+		~IndexedHeap();
+
+		/** @brief Removes all the elements. The allocated memory is kept for the next search */
+		void clear();
+
+		/** @brief Returns true if the heap doesn't have elements */
+		bool empty() const;
+
+		/** @brief Gets the number of elements of the heap */
+		unsigned int size() const;
+
+		/**
+		 * @brief Returns true if a certain index is in the heap
+		 * @param unsigned int Dense index
+		 */
+		bool contains(unsigned int index) const;
+
+		/**
+		 * @brief Inserts an index, or updates its key if it's already in the heap
+		 * @param unsigned int Dense index
+		 * @param const QueueKey& Key of the index
+		 */
+		void push(unsigned int index,
+				  const QueueKey& key);
+
+		/**
+		 * @brief Removes a certain index if it's in the heap
+		 * @param unsigned int Dense index
+		 */
+		void remove(unsigned int index);
+
+		/** @brief Gets the index with the highest priority */
+		unsigned int top() const;
+
+		/** @brief Gets the key of the index with the highest priority */
+		const QueueKey& topKey() const;
+
+		/**
+		 * @brief Removes the index with the highest priority
+		 * @return The removed index
+		 */
+		unsigned int pop();
+
+		/** @brief Gets the indexes of the heap (in heap order) */
+		const std::vector<unsigned int>& getElements() const;
+
+
+	private:
+		/** @brief Returns true if the element in position a has higher priority than b's one */
+		bool isHigherPriority(unsigned int pos_a,
+							  unsigned int pos_b) const;
+
+		/** @brief Moves up the element of a certain position until the heap is ordered */
+		void siftUp(unsigned int pos);
+
+		/** @brief Moves down the element of a certain position until the heap is ordered */
+		void siftDown(unsigned int pos);
+
+		/** @brief Swaps the elements of two positions */
+		void swap(unsigned int pos_a,
+				  unsigned int pos_b);
+
+		/** @brief Indexes and keys in heap order */
+		std::vector<unsigned int> heap_;
+		std::vector<QueueKey> keys_;
+
+		/** @brief Heap position of each index (-1 if it isn't in the heap) */
+		std::vector<int> position_;
+};
+
+
 
 } //@namespace dwl
 
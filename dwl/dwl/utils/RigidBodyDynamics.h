@@ -22,6 +22,27 @@ typedef std::map<std::string,Eigen::Vector3d> BodyVector3d;
 typedef std::map<std::string,Eigen::VectorXd> BodyVectorXd;
 typedef std::map<std::string,Vector6d> BodyVector6d;
 
+/**
+ * @brief Defines a set of bodies resolved to their RBDL ids.
+ * A body set is compiled once from the body names (see
+ * WholeBodyKinematics::compileBodySet), so the routines that use it don't
+ * need to look up the bodies by name. Their outputs are stacked in the order
+ * of the set, i.e. the k-th body is the k-th column of an operational matrix
+ * or the k-th block of rows of a whole-body jacobian
+ */
+struct BodySet {
+	/** @brief Gets the number of bodies of the set */
+	unsigned int size() const { return ids.size(); }
+
+	/** @brief Body names and RBDL ids */
+	BodySelector names;
+	std::vector<unsigned int> ids;
+
+	/** @brief Joint index and DoF of the branch of each body */
+	std::vector<unsigned int> branch_idx;
+	std::vector<unsigned int> branch_dof;
+};
+
 /**
  * @brief Vector coordinates
  * Constants to index either 6d or 3d coordinate vectors.
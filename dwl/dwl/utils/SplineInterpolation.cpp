@@ -8,9 +8,83 @@ namespace dwl
 namespace math
 {
 
-Spline::Spline() : initial_time_(0.), duration_(0.)
+/**
+ * @brief Computes the coefficients of a linear polynomial, where the type is a scalar or an
+ * array of channels
+ */
+template<typename Type>
+void computeLinearCoefficients(Type* coeff,
+							   double duration,
+							   const Type& start_pos,
+							   const Type& end_pos)
 {
+	coeff[0] = start_pos;
+	coeff[1] = (end_pos - start_pos) / duration;
+}
+
+
+/**
+ * @brief Computes the coefficients of a cubic polynomial, where the type is a scalar or an
+ * array of channels
+ */
+template<typename Type>
+void computeCubicCoefficients(Type* coeff,
+							  double duration,
+							  const Type& start_pos,
+							  const Type& start_vel,
+							  const Type& end_pos,
+							  const Type& end_vel)
+{
+	// powers of the duration
+	double T1 = duration;
+	double T2 = duration * T1;
+	double T3 = duration * T2;
+
+	coeff[0] = start_pos;
+	coeff[1] = start_vel;
+	coeff[2] = -((3 * start_pos) - (3 * end_pos) + (2 * T1 * start_vel) + (T1 * end_vel)) / T2;
+	coeff[3] = ((2 * start_pos) - (2 * end_pos) + T1 * (start_vel + end_vel)) / T3;
+}
+
 
+/**
+ * @brief Computes the coefficients of a fifth-order polynomial, where the type is a scalar or
+ * an array of channels
+ */
+template<typename Type>
+void computeFifthOrderCoefficients(Type* coeff,
+								   double duration,
+								   const Type& start_pos,
+								   const Type& start_vel,
+								   const Type& start_acc,
+								   const Type& end_pos,
+								   const Type& end_vel,
+								   const Type& end_acc)
+{
+	// powers of the duration
+	double T1 = duration;
+	double T2 = duration * T1;
+	double T3 = duration * T2;
+	double T4 = duration * T3;
+	double T5 = duration * T4;
+
+	coeff[0] = start_pos;
+	coeff[1] = start_vel;
+	coeff[2] = start_acc / 2;
+	coeff[3] = (-20 * start_pos + 20 * end_pos +
+			T1 * (-3 * start_acc * T1 + end_acc * T1 - 12 * start_vel - 8 * end_vel)) / (2 * T3);
+	coeff[4] = (30 * start_pos - 30 * end_pos +
+			T1 * (3 * start_acc * T1 - 2 * end_acc * T1 + 16 * start_vel + 14 * end_vel)) /
+			(2 * T4);
+	coeff[5] = -(12 * start_pos - 12 * end_pos +
+			T1 * (start_acc * T1 - end_acc * T1 + 6 * (start_vel + end_vel))) / (2 * T5);
+}
+
+
+Spline::Spline() : initial_time_(0.), duration_(0.)
+{
+	for (unsigned int i = 0; i < 6; i++)
+		coeff_[i] = 0.;
 }
 
 
@@ -22,6 +96,9 @@ Spline::Spline(const double& initial_time,
 {
 	if (duration <= 0)
 		throw std::invalid_argument("Cannot create a Spliner with zero or negative duration");
+
+	for (unsigned int i = 0; i < 6; i++)
+		coeff_[i] = 0.;
 }
 
 
@@ -40,6 +117,8 @@ void Spline::setBoundary(const double& initial_time,
 	duration_ = duration;
 	start_ = start_p;
 	end_ = end_p;
+
+	computeCoefficients();
 }
 
 
@@ -58,6 +137,14 @@ void Spline::setBoundary(const double& initial_time,
 	end_.x = end_p;
 	end_.xd = 0.0;
 	end_.xdd = 0.0;
+
+	computeCoefficients();
+}
+
+
+void Spline::computeCoefficients()
+{
+
 }
 
 
@@ -67,7 +154,7 @@ CubicSpline::CubicSpline(const double& initial_time,
 						 const Point& end) :
 	Spline(initial_time, duration, start, end)
 {
-
+	computeCoefficients();
 }
 
 
@@ -100,29 +187,14 @@ bool CubicSpline::getPoint(const double& current_time,
     if (dt < 0)
         return false;
 
-    double a0, a1, a2, a3;
-    double T1, T2, T3;
-    double dt2, dt3;
-
-    // powers of the duration
-    T1 = duration_;
-    T2 = duration_ * T1;
-    T3 = duration_ * T2;
-
     // powers of dt
-    dt2 = dt * dt;
-    dt3 = dt * dt2;
-
-    // spline coefficients
-    a0 = start_.x;
-    a1 = start_.xd;
-    a2 = -((3 * a0) - (3 * end_.x) + (2 * T1 * a1) + (T1 * end_.xd)) / T2;
-    a3 = ((2 * a0) - (2 * end_.x) + T1 * (a1 + end_.xd)) / T3;
+    double dt2 = dt * dt;
+    double dt3 = dt * dt2;
 
     // interpolated point
-    out.x = a0 + a1 * dt + a2 * dt2 + a3 * dt3;
-    out.xd = a1 + 2 * a2 * dt + 3 * a3 * dt2;
-    out.xdd = 2 * a2 + 6 * a3 * dt;
+    out.x = coeff_[0] + coeff_[1] * dt + coeff_[2] * dt2 + coeff_[3] * dt3;
+    out.xd = coeff_[1] + 2 * coeff_[2] * dt + 3 * coeff_[3] * dt2;
+    out.xdd = 2 * coeff_[2] + 6 * coeff_[3] * dt;
 
     return true;
 }
@@ -139,6 +211,15 @@ bool CubicSpline::getPoint(const double& current_time,
 }
 
 
+void CubicSpline::computeCoefficients()
+{
+	if (duration_ == 0.)
+		return;
+
+	computeCubicCoefficients(coeff_, duration_, start_.x, start_.xd, end_.x, end_.xd);
+}
+
+
 FifthOrderPolySpline::FifthOrderPolySpline()
 {
 
@@ -151,7 +232,7 @@ FifthOrderPolySpline::FifthOrderPolySpline(const double& initial_time,
 										   const Point& end) :
 	Spline(initial_time, duration, start, end)
 {
-
+	computeCoefficients();
 }
 
 FifthOrderPolySpline::~FifthOrderPolySpline()
@@ -177,36 +258,17 @@ bool FifthOrderPolySpline::getPoint(const double& current_time,
     if (dt < 0)
         return false;
 
-    double a0, a1, a2, a3, a4, a5;
-    double T1, T2, T3, T4, T5;
-    double dt2, dt3, dt4, dt5;
-
-    // powers of duration
-    T1 = duration_;
-    T2 = duration_ * duration_;
-    T3 = duration_ * T2;
-    T4 = duration_ * T3;
-    T5 = duration_ * T4;
-
-    dt2 = dt * dt;
-    dt3 = dt * dt2;
-    dt4 = dt * dt3;
-    dt5 = dt * dt4;
-
-    // spline coefficients
-    a0 = start_.x;
-    a1 = start_.xd;
-    a2 = start_.xdd / 2;
-    a3 = (-20 * a0 + 20 * end_.x +
-    		T1 * (-3 * a2 / 2 * T1 + end_.xdd * T1 - 12 * a1 - 8 * end_.xd)) / (2 * T3);
-    a4 = (30 * a0 - 30 * end_.x +
-    		T1 * (3 * start_.xdd * T1 - 2 * end_.xdd * T1 + 16 * start_.xd + 14 * end_.xd)) / (2 * T4);
-    a5 = -(12 * start_.x - 12 * end_.x +
-    		T1 * (start_.xdd * T1 - end_.xdd * T1 + 6 * (start_.xd + end_.xd))) / (2 * T5);
-
-    out.x = a0 + a1 * dt + a2 * dt2 + a3 * dt3 + a4 * dt4 + a5 * dt5;
-    out.xd = a1 + 2 * a2 * dt + 3 * a3 * dt2 + 4 * a4 * dt3 + 5 * a5 * dt4;
-    out.xdd = a2 + 6 * a3 * dt + 12 * a4 * dt2 + 20 * a5 * dt3;
+    // powers of dt
+    double dt2 = dt * dt;
+    double dt3 = dt * dt2;
+    double dt4 = dt * dt3;
+    double dt5 = dt * dt4;
+
+    out.x = coeff_[0] + coeff_[1] * dt + coeff_[2] * dt2 + coeff_[3] * dt3 +
+    		coeff_[4] * dt4 + coeff_[5] * dt5;
+    out.xd = coeff_[1] + 2 * coeff_[2] * dt + 3 * coeff_[3] * dt2 + 4 * coeff_[4] * dt3 +
+    		5 * coeff_[5] * dt4;
+    out.xdd = 2 * coeff_[2] + 6 * coeff_[3] * dt + 12 * coeff_[4] * dt2 + 20 * coeff_[5] * dt3;
 
     return true;
 }
@@ -223,6 +285,17 @@ bool FifthOrderPolySpline::getPoint(const double& current_time,
 }
 
 
+void FifthOrderPolySpline::computeCoefficients()
+{
+	if (duration_ == 0.)
+		return;
+
+	computeFifthOrderCoefficients(coeff_, duration_,
+								  start_.x, start_.xd, start_.xdd,
+								  end_.x, end_.xd, end_.xdd);
+}
+
+
 LinearSpline::LinearSpline()
 {
 
@@ -235,7 +308,7 @@ LinearSpline::LinearSpline(const double& initial_time,
 						   const Point& end) :
 	Spline(initial_time, duration, start, end)
 {
-
+	computeCoefficients();
 }
 
 
@@ -263,8 +336,8 @@ bool LinearSpline::getPoint(const double& current_time,
 		return false;
 
 
-	out.xd = (end_.x - start_.x) / duration_;
-	out.x = start_.x + dt * out.xd;
+	out.xd = coeff_[1];
+	out.x = coeff_[0] + dt * out.xd;
 	out.xdd = 0;
 
 	return true;
@@ -281,5 +354,173 @@ bool LinearSpline::getPoint(const double& current_time,
 	return true;
 }
 
+
+void LinearSpline::computeCoefficients()
+{
+	if (duration_ == 0.)
+		return;
+
+	computeLinearCoefficients(coeff_, duration_, start_.x, end_.x);
+}
+
+
+MultiDimensionalSpline::MultiDimensionalSpline(enum PolynomialOrder order) : order_(order),
+		initial_time_(0.), duration_(0.)
+{
+
+}
+
+
+MultiDimensionalSpline::~MultiDimensionalSpline()
+{
+
+}
+
+
+void MultiDimensionalSpline::setBoundary(const double& initial_time,
+										 const double& duration,
+										 const Eigen::VectorXd& start_pos,
+										 const Eigen::VectorXd& start_vel,
+										 const Eigen::VectorXd& start_acc,
+										 const Eigen::VectorXd& end_pos,
+										 const Eigen::VectorXd& end_vel,
+										 const Eigen::VectorXd& end_acc)
+{
+	initial_time_ = initial_time;
+	duration_ = duration;
+
+	// Computing the coefficients of every channel at once. No interpolation is required if
+	// the duration is zero, i.e. the spline is the start point
+	unsigned int num_coeff = order_ + 1;
+	Eigen::ArrayXd coeff[6];
+	if (duration_ == 0.) {
+		num_coeff = 3;
+		coeff[0] = start_pos;
+		coeff[1] = start_vel;
+		coeff[2] = start_acc / 2;
+	} else {
+		switch (order_) {
+		case FirstOrder:
+			computeLinearCoefficients<Eigen::ArrayXd>(coeff, duration_,
+													  start_pos.array(), end_pos.array());
+			break;
+		case ThirdOrder:
+			computeCubicCoefficients<Eigen::ArrayXd>(coeff, duration_,
+													 start_pos.array(), start_vel.array(),
+													 end_pos.array(), end_vel.array());
+			break;
+		case FifthOrder:
+			computeFifthOrderCoefficients<Eigen::ArrayXd>(coeff, duration_,
+														  start_pos.array(), start_vel.array(),
+														  start_acc.array(), end_pos.array(),
+														  end_vel.array(), end_acc.array());
+			break;
+		}
+	}
+
+	// Storing the coefficients of the position, velocity and acceleration per power
+	unsigned int dim = start_pos.size();
+	pos_coeff_.resize(dim, num_coeff);
+	vel_coeff_.resize(dim, num_coeff - 1);
+	acc_coeff_.resize(dim, std::max(0, (int) num_coeff - 2));
+	for (unsigned int i = 0; i < num_coeff; i++)
+		pos_coeff_.col(i) = coeff[i].matrix();
+	for (unsigned int i = 0; i < num_coeff - 1; i++)
+		vel_coeff_.col(i) = (i + 1) * pos_coeff_.col(i + 1);
+	for (unsigned int i = 0; i + 2 < num_coeff; i++)
+		acc_coeff_.col(i) = (i + 1) * (i + 2) * pos_coeff_.col(i + 2);
+}
+
+
+void MultiDimensionalSpline::setBoundary(const double& initial_time,
+										 const double& duration,
+										 const Eigen::VectorXd& start_pos,
+										 const Eigen::VectorXd& end_pos)
+{
+	Eigen::VectorXd zero = Eigen::VectorXd::Zero(start_pos.size());
+	setBoundary(initial_time, duration,
+				start_pos, zero, zero,
+				end_pos, zero, zero);
+}
+
+
+bool MultiDimensionalSpline::getPoint(const double& current_time,
+									  Eigen::VectorXd& pos,
+									  Eigen::VectorXd& vel,
+									  Eigen::VectorXd& acc)
+{
+	double dt = current_time - initial_time_;
+	if (dt > duration_)
+		dt = duration_;
+
+	// sanity checks
+	if (dt < 0)
+		return false;
+
+	unsigned int dim = getDimension();
+	pos.resize(dim);
+	vel.resize(dim);
+	acc.resize(dim);
+	evaluate(pos, vel, acc, dt);
+
+	return true;
+}
+
+
+bool MultiDimensionalSpline::sample(const std::vector<double>& times,
+									Eigen::MatrixXd& pos,
+									Eigen::MatrixXd& vel,
+									Eigen::MatrixXd& acc)
+{
+	unsigned int dim = getDimension();
+	unsigned int num_samples = times.size();
+	if (pos.rows() != dim || pos.cols() != num_samples)
+		pos.resize(dim, num_samples);
+	if (vel.rows() != dim || vel.cols() != num_samples)
+		vel.resize(dim, num_samples);
+	if (acc.rows() != dim || acc.cols() != num_samples)
+		acc.resize(dim, num_samples);
+
+	for (unsigned int j = 0; j < num_samples; j++) {
+		double dt = times[j] - initial_time_;
+		if (dt > duration_)
+			dt = duration_;
+
+		// sanity checks
+		if (dt < 0)
+			return false;
+
+		evaluate(pos.col(j), vel.col(j), acc.col(j), dt);
+	}
+
+	return true;
+}
+
+
+unsigned int MultiDimensionalSpline::getDimension() const
+{
+	return pos_coeff_.rows();
+}
+
+
+void MultiDimensionalSpline::evaluate(Eigen::Ref<Eigen::VectorXd> pos,
+									  Eigen::Ref<Eigen::VectorXd> vel,
+									  Eigen::Ref<Eigen::VectorXd> acc,
+									  double dt) const
+{
+	// Evaluating the polynomials with the Horner's method, i.e. a vector operation per power
+	pos.setZero();
+	for (int i = pos_coeff_.cols() - 1; i >= 0; i--)
+		pos = pos_coeff_.col(i) + dt * pos;
+
+	vel.setZero();
+	for (int i = vel_coeff_.cols() - 1; i >= 0; i--)
+		vel = vel_coeff_.col(i) + dt * vel;
+
+	acc.setZero();
+	for (int i = acc_coeff_.cols() - 1; i >= 0; i--)
+		acc = acc_coeff_.col(i) + dt * acc;
+}
+
 } //@namespace utils
 } //@namespace dwl
@@ -2,6 +2,8 @@
 #define DWL__MATH__SPLINE_INTERPOLATION__H
 
 #include <stdexcept>
+#include <vector>
+#include <Eigen/Dense>
 
 
 namespace dwl
@@ -98,6 +100,13 @@ class Spline
 
 
 	protected:
+		/** @brief Computes the polynomial coefficients from the boundary of the spline, so they
+		 * aren't computed in every sample */
+		virtual void computeCoefficients();
+
+		/** @brief Polynomial coefficients of the spline, i.e. the coefficient of dt^i */
+		double coeff_[6];
+
 		/** @brief Initial time of the spline */
 		double initial_time_;
 
@@ -160,6 +169,11 @@ class CubicSpline : public Spline
 		 */
 		bool getPoint(const double& current_time,
 					  double& p);
+
+
+	protected:
+		/** @brief Computes the polynomial coefficients from the boundary of the spline */
+		void computeCoefficients();
 };
 
 
@@ -202,6 +216,11 @@ class FifthOrderPolySpline : public Spline
 		 */
 		bool getPoint(const double& current_time,
 					  double& p);
+
+
+	protected:
+		/** @brief Computes the polynomial coefficients from the boundary of the spline */
+		void computeCoefficients();
 };
 
 
@@ -244,6 +263,127 @@ class LinearSpline : public Spline
 		 */
 		bool getPoint(const double& current_time,
 					  double& p);
+
+
+	protected:
+		/** @brief Computes the polynomial coefficients from the boundary of the spline */
+		void computeCoefficients();
+};
+
+
+/** @brief Defines the order of the polynomial of a multi-dimensional spline */
+enum PolynomialOrder {FirstOrder = 1, ThirdOrder = 3, FifthOrder = 5};
+
+/**
+ * @brief MultiDimensionalSpline class defines a spline interpolation of several channels (e.g.
+ * the joints of a robot) with the same timing. The polynomial coefficients are computed when the
+ * boundary is set, and they are stored per power (i.e. a column per power), so every sample
+ * evaluates all the channels with vector operations. The polynomials are the same as the
+ * LinearSpline, CubicSpline and FifthOrderPolySpline ones
+ */
+class MultiDimensionalSpline
+{
+	public:
+		/**
+		 * @brief Constructor function
+		 * @param enum PolynomialOrder Order of the polynomial
+		 */
+		MultiDimensionalSpline(enum PolynomialOrder order = ThirdOrder);
+
+		/** @ Destructor function */
+		~MultiDimensionalSpline();
+
+		/**
+		 * @brief Sets the boundary of the spline
+		 * @param const double& Initial time
+		 * @param const double& Duration of the spline
+		 * @param const Eigen::VectorXd& Start position
+		 * @param const Eigen::VectorXd& Start velocity
+		 * @param const Eigen::VectorXd& Start acceleration
+		 * @param const Eigen::VectorXd& End position
+		 * @param const Eigen::VectorXd& End velocity
+		 * @param const Eigen::VectorXd& End acceleration
+		 */
+		void setBoundary(const double& initial_time,
+						 const double& duration,
+						 const Eigen::VectorXd& start_pos,
+						 const Eigen::VectorXd& start_vel,
+						 const Eigen::VectorXd& start_acc,
+						 const Eigen::VectorXd& end_pos,
+						 const Eigen::VectorXd& end_vel,
+						 const Eigen::VectorXd& end_acc);
+
+		/**
+		 * @brief Sets the boundary of the spline with zero velocities and accelerations
+		 * @param const double& Initial time
+		 * @param const double& Duration of the spline
+		 * @param const Eigen::VectorXd& Start position
+		 * @param const Eigen::VectorXd& End position
+		 */
+		void setBoundary(const double& initial_time,
+						 const double& duration,
+						 const Eigen::VectorXd& start_pos,
+						 const Eigen::VectorXd& end_pos);
+
+		/**
+		 * @brief Gets the value of every channel according to the spline interpolation
+		 * @param const double& Current time
+		 * @param Eigen::VectorXd& Position of every channel
+		 * @param Eigen::VectorXd& Velocity of every channel
+		 * @param Eigen::VectorXd& Acceleration of every channel
+		 * @return False if the time is before the initial time
+		 */
+		bool getPoint(const double& current_time,
+					  Eigen::VectorXd& pos,
+					  Eigen::VectorXd& vel,
+					  Eigen::VectorXd& acc);
+
+		/**
+		 * @brief Samples the spline at a set of times, where every column of the buffers is a
+		 * sample. The buffers are only resized if their dimensions are different, so
+		 * preallocated buffers are reused
+		 * @param const std::vector<double>& Sample times
+		 * @param Eigen::MatrixXd& Position of every channel (channels x samples)
+		 * @param Eigen::MatrixXd& Velocity of every channel (channels x samples)
+		 * @param Eigen::MatrixXd& Acceleration of every channel (channels x samples)
+		 * @return False if some time is before the initial time
+		 */
+		bool sample(const std::vector<double>& times,
+					Eigen::MatrixXd& pos,
+					Eigen::MatrixXd& vel,
+					Eigen::MatrixXd& acc);
+
+		/** @brief Gets the number of channels of the spline */
+		unsigned int getDimension() const;
+
+
+	private:
+		/**
+		 * @brief Evaluates the polynomials of every channel
+		 * @param Eigen::Ref<Eigen::VectorXd> Position of every channel
+		 * @param Eigen::Ref<Eigen::VectorXd> Velocity of every channel
+		 * @param Eigen::Ref<Eigen::VectorXd> Acceleration of every channel
+		 * @param double Elapsed time since the initial time
+		 */
+		void evaluate(Eigen::Ref<Eigen::VectorXd> pos,
+					  Eigen::Ref<Eigen::VectorXd> vel,
+					  Eigen::Ref<Eigen::VectorXd> acc,
+					  double dt) const;
+
+		/** @brief Order of the polynomial */
+		enum PolynomialOrder order_;
+
+		/** @brief Initial time of the spline */
+		double initial_time_;
+
+		/** @brief Duration of the spline */
+		double duration_;
+
+		/** @brief Polynomial coefficients of the position, velocity and acceleration, where the
+		 * column i has the coefficients of dt^i of every channel */
+		Eigen::MatrixXd pos_coeff_;
+		Eigen::MatrixXd vel_coeff_;
+		Eigen::MatrixXd acc_coeff_;
 };
 
 } //@namespace utils
@@ -121,6 +121,13 @@
 %ignore computeInverseKinematics(rbd::Vector6d&,
 								 Eigen::VectorXd&,
 								 const rbd::BodyVector3d&);
+%rename(computeForwardKinematics_buffer)
+		computeForwardKinematics(Eigen::MatrixXd&,
+								 const rbd::Vector6d&,
+								 const Eigen::VectorXd&,
+								 const rbd::BodySelector&,
+								 enum rbd::Component,
+								 enum TypeOfOrientation);
 
 
 // Renaming some functions that generate ambiguity in the WholeBodyDynamic class
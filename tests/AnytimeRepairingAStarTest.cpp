@@ -0,0 +1,134 @@
+#include <dwl/solver/AnytimeRepairingAStar.h>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+/**
+ * @brief 4-connected grid of the terrain cells, where the weight of an edge is
+ * one plus the cost of the target cell. The vertex of a cell is y * width + x
+ */
+class GridAdjacency : public dwl::model::AdjacencyModel
+{
+	public:
+		GridAdjacency(unsigned int width) : width_(width)
+		{
+			name_ = "Grid";
+		}
+
+		void getSuccessors(std::list<dwl::Edge>& successors,
+						   dwl::Vertex state_vertex)
+		{
+			const dwl::TerrainDataMap& terrain_map = terrain_->getTerrainDataMap();
+			long x = state_vertex % width_, y = state_vertex / width_;
+			long dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+			for (unsigned int i = 0; i < 4; i++) {
+				if (x + dx[i] < 0 || x + dx[i] >= (long) width_ || y + dy[i] < 0)
+					continue;
+
+				dwl::Vertex vertex = (y + dy[i]) * width_ + x + dx[i];
+				dwl::TerrainDataMap::const_iterator cell_it = terrain_map.find(vertex);
+				if (cell_it != terrain_map.end())
+					successors.push_back(dwl::Edge(vertex, 1. + cell_it->second.cost));
+			}
+		}
+
+		double heuristicCost(dwl::Vertex source,
+							 dwl::Vertex target)
+		{
+			long dx = (long) (source % width_) - (long) (target % width_);
+			long dy = (long) (source / width_) - (long) (target / width_);
+			return labs(dx) + labs(dy);
+		}
+
+	private:
+		unsigned int width_;
+};
+
+
+struct GridTerrain
+{
+	GridTerrain() : width(10), source(0), target(99)
+	{
+		for (dwl::Vertex v = 0; v < width * width; v++)
+			cells[v] = dwl::TerrainCell();
+		terrain.setTerrainMap(cells);
+	}
+
+	/** @brief Computes the optimal path of the actual terrain from scratch */
+	double computeOptimalCost()
+	{
+		dwl::solver::AnytimeRepairingAStar solver(1.);
+		solver.setAdjacencyModel(new GridAdjacency(width));
+		solver.reset(NULL, &terrain);
+		BOOST_REQUIRE(solver.compute(source, target, 10.));
+		return solver.getBestSolution().cost;
+	}
+
+	/** @brief Blocks the cells of a column, except the one of the last row */
+	void addWall(std::vector<dwl::Vertex>& changed_vertices,
+				 unsigned int column)
+	{
+		for (unsigned int y = 0; y < width - 1; y++) {
+			dwl::Vertex vertex = y * width + column;
+			cells.erase(vertex);
+			changed_vertices.push_back(vertex);
+		}
+		terrain.setTerrainMap(cells);
+	}
+
+	/** @brief Checks that the path is connected and avoids the missing cells */
+	void checkPath(const std::list<dwl::Vertex>& path)
+	{
+		BOOST_REQUIRE(!path.empty());
+		BOOST_CHECK_EQUAL(path.front(), source);
+		BOOST_CHECK_EQUAL(path.back(), target);
+		for (std::list<dwl::Vertex>::const_iterator it = path.begin(); it != path.end(); ++it)
+			BOOST_CHECK(cells.find(*it) != cells.end());
+	}
+
+	unsigned int width;
+	dwl::Vertex source;
+	dwl::Vertex target;
+	dwl::TerrainDataMap cells;
+	dwl::environment::TerrainMap terrain;
+};
+
+
+BOOST_FIXTURE_TEST_CASE(terrain_change_without_repair, GridTerrain)
+{
+	dwl::solver::AnytimeRepairingAStar solver(3.);
+	solver.setAdjacencyModel(new GridAdjacency(width));
+	solver.reset(NULL, &terrain);
+	BOOST_REQUIRE(solver.compute(source, target, 10.));
+	BOOST_CHECK_CLOSE(solver.getBestSolution().cost, 18., 1e-9);
+
+	// Changing the terrain without repairing the search tree, so it has to be discarded
+	std::vector<dwl::Vertex> changed_vertices;
+	addWall(changed_vertices, 5);
+	BOOST_REQUIRE(solver.compute(source, target, 10.));
+	BOOST_CHECK_CLOSE(solver.getBestSolution().cost, computeOptimalCost(), 1e-9);
+	checkPath(solver.getBestSolution().path);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(terrain_change_with_repair, GridTerrain)
+{
+	dwl::solver::AnytimeRepairingAStar solver(3.);
+	solver.setAdjacencyModel(new GridAdjacency(width));
+	solver.reset(NULL, &terrain);
+	BOOST_REQUIRE(solver.compute(source, target, 10.));
+
+	// Changing the terrain several times, where the search tree is repaired after every
+	// change
+	for (unsigned int column = 3; column < 8; column += 2) {
+		std::vector<dwl::Vertex> changed_vertices;
+		addWall(changed_vertices, column);
+		solver.updateVertices(changed_vertices);
+		BOOST_REQUIRE(solver.compute(source, target, 10.));
+		BOOST_CHECK_EQUAL(solver.getBestSolution().inflation, 1.);
+		BOOST_CHECK_CLOSE(solver.getBestSolution().cost, computeOptimalCost(), 1e-9);
+		checkPath(solver.getBestSolution().path);
+	}
+}
@@ -0,0 +1,85 @@
+#include <model/HyQModel.h>
+#include <cstdlib>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+// Tolerance
+double epsilon = 1e-6;
+
+/**
+ * @brief Round-trips random postures around the default one, i.e. the feet positions of the
+ * forward kinematics are solved by the inverse kinematics, whose solution has to reach the
+ * same positions
+ * @param dwl::model::WholeBodyKinematics& Kinematics of the robot
+ * @param const Eigen::VectorXd& Default posture, which is also the initial one of the solver
+ * @param bool Indicates if the solution has to be the sampled posture
+ */
+void checkRoundTrip(dwl::model::WholeBodyKinematics& wkin,
+					const Eigen::VectorXd& joint_pos_init,
+					bool same_posture)
+{
+	srand(0);
+	const dwl::rbd::BodySelector& feet =
+			wkin.getFloatingBaseSystem().getEndEffectorNames(dwl::model::FOOT);
+	dwl::rbd::Vector6d base_pos = dwl::rbd::Vector6d::Zero();
+	unsigned int num_joints = joint_pos_init.size();
+	Eigen::MatrixXd feet_pos, solution_feet_pos;
+	for (unsigned int sample = 0; sample < 50; sample++) {
+		// Sampling a posture close to the default one
+		Eigen::VectorXd joint_pos = joint_pos_init;
+		for (unsigned int i = 0; i < num_joints; i++)
+			joint_pos(i) += 0.2 * (2. * rand() / RAND_MAX - 1.);
+
+		wkin.computeForwardKinematics(feet_pos, base_pos, joint_pos,
+									  feet, dwl::rbd::Linear);
+		dwl::rbd::BodyVector3d op_pos;
+		for (unsigned int k = 0; k < feet.size(); k++)
+			op_pos[feet[k]] = feet_pos.col(k);
+
+		Eigen::VectorXd solution = joint_pos_init;
+		BOOST_REQUIRE(wkin.computeJointPosition(solution, op_pos, joint_pos_init));
+
+		wkin.computeForwardKinematics(solution_feet_pos, base_pos, solution,
+									  feet, dwl::rbd::Linear);
+		BOOST_CHECK_SMALL((solution_feet_pos - feet_pos).norm(), epsilon);
+		if (same_posture)
+			BOOST_CHECK_SMALL((solution - joint_pos).norm(), epsilon);
+	}
+}
+
+
+BOOST_FIXTURE_TEST_CASE(analytic_round_trip, HyQModel)
+{
+	dwl::model::WholeBodyKinematics wkin = wdyn.getWholeBodyKinematics();
+	wkin.setIKSolver(1.0e-12, 0.01, 50);
+
+	// The HAA-HFE-KFE legs are solved in closed form, where the knee
+	// configuration closest to the initial posture is chosen
+	const dwl::rbd::BodySelector& feet =
+			wdyn.getFloatingBaseSystem().getEndEffectorNames(dwl::model::FOOT);
+	for (unsigned int k = 0; k < feet.size(); k++)
+		BOOST_REQUIRE_EQUAL(wkin.getTypeOfBranchSolver(feet[k]),
+							dwl::model::AnalyticBranchSolver);
+
+	checkRoundTrip(wkin, joint_pos, true);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(newton_round_trip, HyQModel)
+{
+	dwl::model::WholeBodyKinematics wkin = wdyn.getWholeBodyKinematics();
+	wkin.setIKSolver(1.0e-12, 0.01, 50);
+
+	const dwl::rbd::BodySelector& feet =
+			wdyn.getFloatingBaseSystem().getEndEffectorNames(dwl::model::FOOT);
+	for (unsigned int k = 0; k < feet.size(); k++) {
+		BOOST_REQUIRE(wkin.setTypeOfBranchSolver(feet[k], dwl::model::NewtonBranchSolver));
+		BOOST_REQUIRE_EQUAL(wkin.getTypeOfBranchSolver(feet[k]),
+							dwl::model::NewtonBranchSolver);
+	}
+
+	checkRoundTrip(wkin, joint_pos, false);
+}
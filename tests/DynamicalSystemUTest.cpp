@@ -0,0 +1,127 @@
+#include <dwl/ocp/FullDynamicalSystem.h>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+
+// Tolerance
+double epsilon = 1E-04;
+
+/**
+ * @brief Computes the constraint of the current knot given the decision states of the last
+ * and current knots
+ */
+void computeConstraint(Eigen::VectorXd& constraint,
+					   dwl::ocp::DynamicalSystem& system,
+					   const Eigen::VectorXd& last_decision_state,
+					   const Eigen::VectorXd& decision_state)
+{
+	dwl::WholeBodyState last_state, state;
+	system.toWholeBodyState(last_state, last_decision_state);
+	system.toWholeBodyState(state, decision_state);
+	system.resetStateBuffer();
+	system.setLastState(last_state);
+	system.compute(constraint, state);
+}
+
+
+/**
+ * @brief Compares the jacobian of the HyQ dynamical system, where the integration rows are
+ * computed with automatic differentiation and the dynamical rows with central differences,
+ * against central differences of the whole constraint
+ */
+void checkIntegrationJacobian(dwl::ocp::TranscriptionMethod method)
+{
+	dwl::ocp::FullDynamicalSystem system;
+	std::string urdf_file = DWL_SOURCE_DIR"/sample/hyq.urdf";
+	std::string yarf_file = DWL_SOURCE_DIR"/config/hyq.yarf";
+	system.modelFromURDFFile(urdf_file, yarf_file);
+	system.setStepIntegrationMethod(dwl::ocp::Variable);
+	system.setTranscriptionMethod(method);
+	system.init(false);
+
+	// Defining the decision states of the last and current knots
+	unsigned int dim = system.getDimensionOfState();
+	Eigen::VectorXd last_decision = Eigen::VectorXd::Zero(dim);
+	Eigen::VectorXd decision = Eigen::VectorXd::Zero(dim);
+	for (unsigned int i = 0; i < dim; i++) {
+		last_decision(i) = 0.1 * sin(i + 1.);
+		decision(i) = 0.1 * cos(i + 1.);
+	}
+	last_decision(0) = 0.1;
+	decision(0) = 0.1;
+
+	// Computing the jacobian
+	dwl::WholeBodyState last_state, state;
+	system.toWholeBodyState(last_state, last_decision);
+	system.toWholeBodyState(state, decision);
+	system.resetStateBuffer();
+	system.setLastState(last_state);
+	Eigen::MatrixXd jacobian, last_jacobian;
+	BOOST_CHECK(system.computeJacobian(jacobian, last_jacobian, state));
+
+	// Comparing against central differences of the whole constraint
+	BOOST_REQUIRE_EQUAL(jacobian.cols(), dim);
+	BOOST_REQUIRE_EQUAL(last_jacobian.cols(), dim);
+	double step = 1E-06;
+	Eigen::VectorXd plus, minus;
+	for (unsigned int i = 0; i < dim; i++) {
+		Eigen::VectorXd perturbed = decision;
+		perturbed(i) += step;
+		computeConstraint(plus, system, last_decision, perturbed);
+		perturbed(i) -= 2 * step;
+		computeConstraint(minus, system, last_decision, perturbed);
+		BOOST_REQUIRE_EQUAL(plus.size(), jacobian.rows());
+		Eigen::VectorXd column = (plus - minus) / (2 * step);
+		BOOST_CHECK_SMALL((jacobian.col(i) - column).lpNorm<Eigen::Infinity>(), epsilon);
+
+		perturbed = last_decision;
+		perturbed(i) += step;
+		computeConstraint(plus, system, perturbed, decision);
+		perturbed(i) -= 2 * step;
+		computeConstraint(minus, system, perturbed, decision);
+		column = (plus - minus) / (2 * step);
+		BOOST_CHECK_SMALL((last_jacobian.col(i) - column).lpNorm<Eigen::Infinity>(), epsilon);
+	}
+
+	// The integration rows don't depend on the last knot duration
+	unsigned int integration_dim = system.getIntegrationDimension();
+	BOOST_CHECK_SMALL(last_jacobian.block(0, 0, integration_dim, 1).norm(), 1E-12);
+}
+
+
+BOOST_AUTO_TEST_CASE(euler_backward_jacobian) // specify a test case for Euler-backward
+{
+	checkIntegrationJacobian(dwl::ocp::EulerBackward);
+}
+
+
+BOOST_AUTO_TEST_CASE(runge_kutta4_jacobian) // specify a test case for RK4
+{
+	checkIntegrationJacobian(dwl::ocp::RungeKutta4);
+}
+
+
+BOOST_AUTO_TEST_CASE(hermite_simpson_jacobian) // specify a test case for Hermite-Simpson
+{
+	checkIntegrationJacobian(dwl::ocp::HermiteSimpson);
+}
+
+
+BOOST_AUTO_TEST_CASE(transcription_variables) // specify a test case for switching methods
+{
+	// The accelerations are only decision variables of the higher-order methods
+	dwl::ocp::FullDynamicalSystem system;
+	std::string urdf_file = DWL_SOURCE_DIR"/sample/hyq.urdf";
+	std::string yarf_file = DWL_SOURCE_DIR"/config/hyq.yarf";
+	system.modelFromURDFFile(urdf_file, yarf_file);
+	unsigned int dim = system.getDimensionOfState();
+	unsigned int sys_dof = system.getFloatingBaseSystem().getSystemDoF();
+
+	system.setTranscriptionMethod(dwl::ocp::HermiteSimpson);
+	BOOST_CHECK_EQUAL(system.getDimensionOfState(), dim + sys_dof);
+	system.setTranscriptionMethod(dwl::ocp::EulerBackward);
+	BOOST_CHECK_EQUAL(system.getDimensionOfState(), dim);
+}
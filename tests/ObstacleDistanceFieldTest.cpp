@@ -0,0 +1,82 @@
+#include <dwl/environment/ObstacleDistanceField.h>
+#include <cstdlib>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+/**
+ * @brief Computes the distance from a position to the closest obstacle cell
+ * center by brute force
+ */
+double computeBruteForceDistance(const Eigen::Vector2d& position,
+								 const dwl::ObstacleMap& obstacle_map,
+								 const dwl::environment::SpaceDiscretization& space_discretization,
+								 double max_distance)
+{
+	double distance = max_distance;
+	for (dwl::ObstacleMap::const_iterator obstacle_it = obstacle_map.begin();
+			obstacle_it != obstacle_map.end(); obstacle_it++) {
+		Eigen::Vector2d obstacle_position;
+		space_discretization.vertexToCoord(obstacle_position, obstacle_it->first);
+		distance = std::min(distance, (position - obstacle_position).norm());
+	}
+
+	return distance;
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_updates) // specify a test case for incremental updates
+{
+	// Defining the field, where the area of the obstacles is smaller than the grid, so the
+	// updates are incremental
+	double resolution = 0.1, max_distance = 0.5;
+	unsigned int num_cells = 30;
+	dwl::environment::SpaceDiscretization space_discretization(resolution);
+	dwl::environment::ObstacleDistanceField field(max_distance);
+
+	// Updating the field with random obstacles that are added and removed
+	srand(0);
+	dwl::ObstacleMap obstacle_map;
+	std::vector<dwl::Vertex> cells;
+	for (unsigned int update = 0; update < 40; update++) {
+		// Adding new obstacles
+		unsigned int num_added = 1 + rand() % 10;
+		for (unsigned int i = 0; i < num_added; i++) {
+			Eigen::Vector2d position((rand() % num_cells) * resolution,
+									 (rand() % num_cells) * resolution);
+			dwl::Vertex vertex;
+			space_discretization.coordToVertex(vertex, position);
+			if (obstacle_map.find(vertex) == obstacle_map.end()) {
+				obstacle_map[vertex] = true;
+				cells.push_back(vertex);
+			}
+		}
+
+		// Removing some obstacles
+		unsigned int num_removed = (update % 3 == 0) ? 0 : rand() % 6;
+		for (unsigned int i = 0; i < num_removed && !cells.empty(); i++) {
+			unsigned int idx = rand() % cells.size();
+			obstacle_map.erase(cells[idx]);
+			cells.erase(cells.begin() + idx);
+		}
+
+		field.update(obstacle_map, space_discretization);
+
+		// Checking the distances of the cell centers of the area and its margin
+		for (int x = -5; x < (int) num_cells + 5; x++) {
+			for (int y = -5; y < (int) num_cells + 5; y++) {
+				dwl::Vertex vertex;
+				Eigen::Vector2d position;
+				space_discretization.coordToVertex(vertex,
+												   Eigen::Vector2d(x * resolution, y * resolution));
+				space_discretization.vertexToCoord(position, vertex);
+				double distance =
+						computeBruteForceDistance(position, obstacle_map,
+												  space_discretization, max_distance);
+				BOOST_CHECK_SMALL(field.getDistance(position) - distance, 1e-9);
+			}
+		}
+	}
+}
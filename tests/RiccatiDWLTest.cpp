@@ -0,0 +1,55 @@
+#include <dwl/ocp/OptimalControl.h>
+#include <dwl/solver/OptimizationSolver.h>
+#include <dwl/solver/RiccatiSolver.h>
+#include <model/HS071DynamicalSystem.cpp>
+#include <model/HS071Cost.cpp>
+#include <model/LinearQuadraticChain.cpp>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+
+// Tolerance
+double epsilon = 1E-03;
+
+BOOST_AUTO_TEST_CASE(hs071_single_stage) // specify a test case for a single-stage problem
+{
+	dwl::solver::RiccatiSolver solver;
+	dwl::ocp::OptimalControl optimal_control;
+	solver.setOptimizationModel(&optimal_control);
+
+	optimal_control.addDynamicalSystem(new dwl::model::HS071DynamicalSystem());
+	optimal_control.addCost(new dwl::model::HS071Cost());
+
+	solver.setFromConfigFile(DWL_SOURCE_DIR"/config/riccati_config.yaml");
+	BOOST_REQUIRE(solver.init());
+	BOOST_REQUIRE(solver.compute());
+
+	// Known optimum of the HS071 problem
+	Eigen::VectorXd optimum(4);
+	optimum << 1., 4.74299964, 3.82114998, 1.37940829;
+	Eigen::VectorXd solution = solver.getSolution();
+	BOOST_REQUIRE_EQUAL(solution.size(), optimum.size());
+	BOOST_CHECK_SMALL((solution - optimum).lpNorm<Eigen::Infinity>(), epsilon);
+}
+
+
+BOOST_AUTO_TEST_CASE(multiple_stages) // specify a test case for a stage-wise problem
+{
+	// The constraints couple consecutive stages, so the Newton system is block-tridiagonal
+	dwl::model::LinearQuadraticChain problem(20);
+	dwl::solver::RiccatiSolver solver;
+	solver.setOptimizationModel(&problem);
+	solver.setFromConfigFile(DWL_SOURCE_DIR"/config/riccati_config.yaml");
+	BOOST_REQUIRE(solver.init());
+	BOOST_REQUIRE(solver.compute());
+
+	// Comparing against the solution of the KKT system
+	Eigen::VectorXd optimum;
+	problem.computeOptimalSolution(optimum);
+	Eigen::VectorXd solution = solver.getSolution();
+	BOOST_REQUIRE_EQUAL(solution.size(), optimum.size());
+	BOOST_CHECK_SMALL((solution - optimum).lpNorm<Eigen::Infinity>(), epsilon);
+}
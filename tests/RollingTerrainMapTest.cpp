@@ -0,0 +1,143 @@
+#include <dwl/environment/RollingTerrainMap.h>
+#include <cstdlib>
+#include <map>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+typedef std::map<std::pair<int,int>, dwl::TerrainCell> CellMap;
+
+/**
+ * @brief Removes the cells outside the window by brute force, where the window is defined by
+ * the minimum (x,y) key and the number of cells per side
+ */
+void removeOutsideCells(CellMap& cells,
+						int origin_x,
+						int origin_y,
+						int size)
+{
+	for (CellMap::iterator cell_it = cells.begin(); cell_it != cells.end(); ) {
+		int x = cell_it->first.first;
+		int y = cell_it->first.second;
+		if (x < origin_x || x >= origin_x + size || y < origin_y || y >= origin_y + size)
+			cells.erase(cell_it++);
+		else
+			cell_it++;
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(rolling_window) // specify a test case for moving the window
+{
+	// Defining a small window of 16x16 cells, so its circular buffer wraps around often
+	double resolution = 0.04, window_size = 0.64;
+	int size = 16;
+	dwl::environment::RollingTerrainMap map(resolution, window_size);
+	const dwl::environment::SpaceDiscretization& space_discretization =
+			map.getTerrainSpaceModel();
+
+	unsigned short int ground_key;
+	space_discretization.coordToKey(ground_key, 0., false);
+
+	srand(0);
+	CellMap cells;
+	Eigen::Vector2d center = Eigen::Vector2d::Zero();
+	for (unsigned int update = 0; update < 100; update++) {
+		// Moving the window a few cells in both directions, and sometimes further than its
+		// size (i.e. without overlapping)
+		int max_shift = (update % 25 == 24) ? 40 : 6;
+		center(0) += (rand() % (2 * max_shift + 1) - max_shift) * resolution;
+		center(1) += (rand() % (2 * max_shift + 1) - max_shift) * resolution;
+		map.moveWindow(center);
+
+		unsigned short int center_x, center_y;
+		space_discretization.coordToKey(center_x, (double) center(0), true);
+		space_discretization.coordToKey(center_y, (double) center(1), true);
+		int origin_x = (int) center_x - size / 2;
+		int origin_y = (int) center_y - size / 2;
+		removeOutsideCells(cells, origin_x, origin_y, size);
+
+		// Updating random cells around the window, where the outside ones are ignored
+		for (unsigned int i = 0; i < 30; i++) {
+			dwl::TerrainCell cell;
+			int x = origin_x - 2 + rand() % (size + 4);
+			int y = origin_y - 2 + rand() % (size + 4);
+			cell.key.x = x;
+			cell.key.y = y;
+			cell.key.z = ground_key + rand() % 20 - 10;
+			cell.cost = (rand() % 100) / 10.;
+			cell.normal = Eigen::Vector3d((rand() % 21 - 10) / 10.,
+										  (rand() % 21 - 10) / 10., 1.).normalized();
+			space_discretization.keyToCoord(cell.height, cell.key.z, false);
+
+			bool inside = x >= origin_x && x < origin_x + size &&
+					y >= origin_y && y < origin_y + size;
+			BOOST_CHECK_EQUAL(map.updateCell(cell), inside);
+			if (inside)
+				cells[std::make_pair(x, y)] = cell;
+		}
+
+		// Removing some cells
+		for (unsigned int i = 0; i < 5 && !cells.empty(); i++) {
+			CellMap::iterator cell_it = cells.begin();
+			std::advance(cell_it, rand() % cells.size());
+			map.removeCell(cell_it->second.key);
+			cells.erase(cell_it);
+		}
+
+		// Checking the cells of the window and its margin
+		for (int x = origin_x - 4; x < origin_x + size + 4; x++) {
+			for (int y = origin_y - 4; y < origin_y + size + 4; y++) {
+				dwl::Key key(x, y, 0);
+				dwl::Vertex vertex;
+				space_discretization.keyToVertex(vertex, key, true);
+
+				dwl::TerrainCell cell;
+				CellMap::iterator cell_it = cells.find(std::make_pair(x, y));
+				bool known = cell_it != cells.end();
+				BOOST_REQUIRE_EQUAL(map.getTerrainData(cell, vertex), known);
+				if (!known)
+					continue;
+
+				const dwl::TerrainCell& expected = cell_it->second;
+				BOOST_CHECK_EQUAL(cell.key.z, expected.key.z);
+				BOOST_CHECK_EQUAL(cell.cost, expected.cost);
+				BOOST_CHECK_EQUAL(cell.height, expected.height);
+				BOOST_CHECK_SMALL((cell.normal - expected.normal).norm(), 1e-12);
+
+				// Checking the position queries
+				Eigen::Vector2d position;
+				double height;
+				space_discretization.vertexToCoord(position, vertex);
+				BOOST_CHECK(map.getTerrainHeight(height, position));
+				BOOST_CHECK_EQUAL(height, expected.height);
+			}
+		}
+
+		// Checking the aggregates against their recomputation
+		BOOST_REQUIRE_EQUAL(map.getNumberOfCells(), cells.size());
+		if (cells.empty())
+			continue;
+
+		double cost_sum = 0., height_sum = 0.;
+		double max_cost = cells.begin()->second.cost;
+		double min_height = cells.begin()->second.height;
+		Eigen::Vector3d normal_sum = Eigen::Vector3d::Zero();
+		for (CellMap::iterator cell_it = cells.begin(); cell_it != cells.end(); cell_it++) {
+			const dwl::TerrainCell& cell = cell_it->second;
+			cost_sum += cell.cost;
+			height_sum += cell.height;
+			normal_sum += cell.normal;
+			max_cost = std::max(max_cost, cell.cost);
+			min_height = std::min(min_height, cell.height);
+		}
+		BOOST_CHECK_SMALL(map.getAverageCostOfTerrain() - cost_sum / cells.size(), 1e-9);
+		BOOST_CHECK_SMALL(map.getAverageHeightOfTerrain() - height_sum / cells.size(), 1e-9);
+		BOOST_CHECK_EQUAL(map.getMaxCostOfTerrain(), max_cost);
+		BOOST_CHECK_EQUAL(map.getMinHeightOfTerrain(), min_height);
+		BOOST_CHECK_SMALL((map.getAverageNormalOfTerrain() - normal_sum.normalized()).norm(),
+						  1e-9);
+	}
+}
@@ -0,0 +1,117 @@
+#include <dwl/utils/SplineInterpolation.h>
+#include <cstdlib>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+// Tolerance
+double epsilon = 1E-09;
+
+/** @brief Gets a random number between -1 and 1 */
+double getRandom()
+{
+	return 2. * rand() / RAND_MAX - 1.;
+}
+
+
+/**
+ * @brief Compares every channel of a multi-dimensional spline against a single-dimensional
+ * one with the same boundary
+ * @param enum dwl::math::PolynomialOrder Order of the multi-dimensional spline
+ * @param dwl::math::Spline& Single-dimensional spline of the same order
+ */
+void checkChannels(enum dwl::math::PolynomialOrder order,
+				   dwl::math::Spline& spline)
+{
+	srand(0);
+	unsigned int dim = 7;
+	double initial_time = 0.3, duration = 0.8;
+	Eigen::VectorXd start_pos(dim), start_vel(dim), start_acc(dim);
+	Eigen::VectorXd end_pos(dim), end_vel(dim), end_acc(dim);
+	for (unsigned int i = 0; i < dim; i++) {
+		start_pos(i) = getRandom();
+		start_vel(i) = getRandom();
+		start_acc(i) = getRandom();
+		end_pos(i) = getRandom();
+		end_vel(i) = getRandom();
+		end_acc(i) = getRandom();
+	}
+
+	dwl::math::MultiDimensionalSpline multi_spline(order);
+	multi_spline.setBoundary(initial_time, duration,
+							 start_pos, start_vel, start_acc,
+							 end_pos, end_vel, end_acc);
+	BOOST_REQUIRE_EQUAL(multi_spline.getDimension(), dim);
+
+	// Sampling inside and after the spline, where the last samples are clamped to its end
+	std::vector<double> times;
+	for (unsigned int j = 0; j <= 24; j++)
+		times.push_back(initial_time + j * duration / 20);
+	Eigen::MatrixXd pos, vel, acc;
+	BOOST_REQUIRE(multi_spline.sample(times, pos, vel, acc));
+	BOOST_REQUIRE_EQUAL(pos.cols(), times.size());
+
+	for (unsigned int i = 0; i < dim; i++) {
+		dwl::math::Spline::Point start(start_pos(i), start_vel(i), start_acc(i));
+		dwl::math::Spline::Point end(end_pos(i), end_vel(i), end_acc(i));
+		spline.setBoundary(initial_time, duration, start, end);
+		for (unsigned int j = 0; j < times.size(); j++) {
+			dwl::math::Spline::Point point;
+			BOOST_REQUIRE(spline.getPoint(times[j], point));
+			BOOST_CHECK_SMALL(pos(i,j) - point.x, epsilon);
+			BOOST_CHECK_SMALL(vel(i,j) - point.xd, epsilon);
+			BOOST_CHECK_SMALL(acc(i,j) - point.xdd, epsilon);
+		}
+	}
+
+	// Checking the single samples, and the times before the spline
+	Eigen::VectorXd point_pos, point_vel, point_acc;
+	BOOST_REQUIRE(multi_spline.getPoint(times[7], point_pos, point_vel, point_acc));
+	BOOST_CHECK_SMALL((point_pos - pos.col(7)).norm(), epsilon);
+	BOOST_CHECK_SMALL((point_vel - vel.col(7)).norm(), epsilon);
+	BOOST_CHECK_SMALL((point_acc - acc.col(7)).norm(), epsilon);
+	BOOST_CHECK(!multi_spline.getPoint(0., point_pos, point_vel, point_acc));
+	times[3] = 0.;
+	BOOST_CHECK(!multi_spline.sample(times, pos, vel, acc));
+}
+
+
+BOOST_AUTO_TEST_CASE(fifth_order_boundary) // specify a test case for the fifth-order boundary
+{
+	// The fifth-order polynomial has to reach the position, velocity and acceleration of
+	// both boundaries
+	srand(0);
+	double initial_time = 1.2;
+	for (unsigned int k = 0; k < 20; k++) {
+		double duration = 0.1 + (k % 5) * 0.4;
+		dwl::math::Spline::Point start(getRandom(), getRandom(), getRandom());
+		dwl::math::Spline::Point end(getRandom(), getRandom(), getRandom());
+		dwl::math::FifthOrderPolySpline spline(initial_time, duration, start, end);
+
+		dwl::math::Spline::Point point;
+		BOOST_REQUIRE(spline.getPoint(initial_time, point));
+		BOOST_CHECK_SMALL(point.x - start.x, epsilon);
+		BOOST_CHECK_SMALL(point.xd - start.xd, epsilon);
+		BOOST_CHECK_SMALL(point.xdd - start.xdd, epsilon);
+
+		BOOST_REQUIRE(spline.getPoint(initial_time + duration, point));
+		BOOST_CHECK_SMALL(point.x - end.x, epsilon);
+		BOOST_CHECK_SMALL(point.xd - end.xd, epsilon);
+		BOOST_CHECK_SMALL(point.xdd - end.xdd, epsilon);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(multi_dimensional_sample) // specify a test case for the channels
+{
+	dwl::math::LinearSpline linear_spline;
+	checkChannels(dwl::math::FirstOrder, linear_spline);
+
+	dwl::math::CubicSpline cubic_spline;
+	checkChannels(dwl::math::ThirdOrder, cubic_spline);
+
+	dwl::math::FifthOrderPolySpline fifth_order_spline;
+	checkChannels(dwl::math::FifthOrder, fifth_order_spline);
+}
@@ -0,0 +1,116 @@
+#include <model/HyQModel.h>
+
+#define BOOST_TEST_MODULE DWL_TESTS
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+
+// Allocation counter. The glibc allocator is interposed by this executable, so
+// every heap allocation (i.e. Eigen, STL containers and operator new) made
+// while the counter is enabled is recorded
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static bool count_allocations = false;
+static unsigned int num_allocations = 0;
+
+extern "C" void* malloc(size_t size)
+{
+	if (count_allocations)
+		++num_allocations;
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t num, size_t size)
+{
+	if (count_allocations)
+		++num_allocations;
+	return __libc_calloc(num, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size)
+{
+	if (count_allocations)
+		++num_allocations;
+	return __libc_realloc(ptr, size);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(inverse_dynamics_allocations, HyQModel)
+{
+	// The first call sizes the output vectors
+	wdyn.computeInverseDynamics(base_wrench, joint_forces,
+								base_pos, joint_pos,
+								base_vel, joint_vel,
+								base_acc, joint_acc, grf);
+
+	num_allocations = 0;
+	count_allocations = true;
+	for (unsigned int i = 0; i < 1000; i++) {
+		wdyn.computeInverseDynamics(base_wrench, joint_forces,
+									base_pos, joint_pos,
+									base_vel, joint_vel,
+									base_acc, joint_acc, grf);
+		wdyn.computeInverseDynamics(base_wrench, joint_forces,
+									base_pos, joint_pos,
+									base_vel, joint_vel,
+									base_acc, joint_acc);
+	}
+	count_allocations = false;
+
+	BOOST_CHECK_EQUAL(num_allocations, 0);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(floating_base_inverse_dynamics_allocations, HyQModel)
+{
+	// The first call sizes the output vectors
+	dwl::rbd::Vector6d base_feas_acc;
+	wdyn.computeFloatingBaseInverseDynamics(base_feas_acc, joint_forces,
+											base_pos, joint_pos,
+											base_vel, joint_vel,
+											joint_acc, grf);
+
+	num_allocations = 0;
+	count_allocations = true;
+	for (unsigned int i = 0; i < 1000; i++)
+		wdyn.computeFloatingBaseInverseDynamics(base_feas_acc, joint_forces,
+												base_pos, joint_pos,
+												base_vel, joint_vel,
+												joint_acc, grf);
+	count_allocations = false;
+
+	BOOST_CHECK_EQUAL(num_allocations, 0);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(contact_forces_allocations, HyQModel)
+{
+	// Compiling the contact set, and the first call sizes the workspaces
+	dwl::rbd::BodySet contacts;
+	wdyn.getWholeBodyKinematics().compileBodySet(contacts,
+			wdyn.getFloatingBaseSystem().getEndEffectorNames(dwl::model::FOOT));
+
+	Eigen::MatrixXd contact_forces;
+	dwl::rbd::Vector6d des_base_acc = base_acc;
+	Eigen::VectorXd des_joint_acc = joint_acc;
+	wdyn.computeContactForces(contact_forces, joint_forces,
+							  base_pos, joint_pos,
+							  base_vel, joint_vel,
+							  des_base_acc, des_joint_acc, contacts);
+
+	num_allocations = 0;
+	count_allocations = true;
+	for (unsigned int i = 0; i < 1000; i++) {
+		des_base_acc = base_acc;
+		des_joint_acc = joint_acc;
+		wdyn.computeContactForces(contact_forces, joint_forces,
+								  base_pos, joint_pos,
+								  base_vel, joint_vel,
+								  des_base_acc, des_joint_acc, contacts);
+	}
+	count_allocations = false;
+
+	BOOST_CHECK_EQUAL(num_allocations, 0);
+}
@@ -23,6 +23,18 @@ class HS071Cost : public ocp::Cost
 			cost = state.joint_pos(0) * state.joint_pos(3) * (state.joint_pos(0) +
 					state.joint_pos(1) + state.joint_pos(2)) + state.joint_pos(2);
 		}
+
+		bool computeGradient(WholeBodyState& gradient,
+							 const WholeBodyState& state)
+		{
+			const Eigen::VectorXd& x = state.joint_pos;
+			gradient.joint_pos(0) = x(0) * x(3) + x(3) * (x(0) + x(1) + x(2));
+			gradient.joint_pos(1) = x(0) * x(3);
+			gradient.joint_pos(2) = x(0) * x(3) + 1;
+			gradient.joint_pos(3) = x(0) * (x(0) + x(1) + x(2));
+
+			return true;
+		}
 };
 
 } //@namespace model
@@ -57,6 +57,24 @@ class HS071DynamicalSystem : public ocp::DynamicalSystem
 					state.joint_pos(3) * state.joint_pos(3);
 		}
 
+		bool computeJacobian(Eigen::MatrixXd& jacobian,
+							 Eigen::MatrixXd& last_jacobian,
+							 const WholeBodyState& state)
+		{
+			const Eigen::VectorXd& x = state.joint_pos;
+			jacobian = Eigen::MatrixXd::Zero(constraint_dimension_, state_dimension_);
+			jacobian(0,0) = x(1) * x(2) * x(3);
+			jacobian(0,1) = x(0) * x(2) * x(3);
+			jacobian(0,2) = x(0) * x(1) * x(3);
+			jacobian(0,3) = x(0) * x(1) * x(2);
+			jacobian.row(1) = 2 * x.transpose();
+
+			// The constraints don't depend on the last state
+			last_jacobian = Eigen::MatrixXd::Zero(constraint_dimension_, state_dimension_);
+
+			return true;
+		}
+
 		void getBounds(Eigen::VectorXd& lower_bound,
 					   Eigen::VectorXd& upper_bound)
 		{
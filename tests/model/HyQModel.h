@@ -0,0 +1,40 @@
+#ifndef DWL__MODEL__HYQ_MODEL__H
+#define DWL__MODEL__HYQ_MODEL__H
+
+
+#include <dwl/model/WholeBodyDynamics.h>
+
+
+/**
+ * @brief Test fixture of the HyQ model in its default posture, with a constant joint
+ * velocity and acceleration, and the contact forces of the four feet
+ */
+struct HyQModel
+{
+	HyQModel()
+	{
+		std::string urdf_file = DWL_SOURCE_DIR"/sample/hyq.urdf";
+		std::string yarf_file = DWL_SOURCE_DIR"/config/hyq.yarf";
+		wdyn.modelFromURDFFile(urdf_file, yarf_file);
+
+		unsigned int num_joints = wdyn.getFloatingBaseSystem().getJointDoF();
+		base_pos.setZero();
+		base_vel.setZero();
+		base_acc.setZero();
+		joint_pos = wdyn.getFloatingBaseSystem().getDefaultPosture();
+		joint_vel = Eigen::VectorXd::Constant(num_joints, 0.1);
+		joint_acc = Eigen::VectorXd::Constant(num_joints, 0.2);
+
+		grf["lf_foot"] << 0, 0, 0, 0, 0, 190.778;
+		grf["rf_foot"] << 0, 0, 0, 0, 0, 190.778;
+		grf["lh_foot"] << 0, 0, 0, 0, 0, 190.778;
+		grf["rh_foot"] << 0, 0, 0, 0, 0, 190.778;
+	}
+
+	dwl::model::WholeBodyDynamics wdyn;
+	dwl::rbd::Vector6d base_pos, base_vel, base_acc, base_wrench;
+	Eigen::VectorXd joint_pos, joint_vel, joint_acc, joint_forces;
+	dwl::rbd::BodyVector6d grf;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef DWL__MODEL__LINEAR_QUADRATIC_CHAIN__H
+#define DWL__MODEL__LINEAR_QUADRATIC_CHAIN__H
+
+
+#include <dwl/model/OptimizationModel.h>
+
+
+namespace dwl
+{
+
+namespace model
+{
+
+/**
+ * @brief Stage-wise quadratic program of a single integrator, where every stage has the state
+ * and control (x_k, u_k). The dynamics are x_k = x_{k-1} + dt * u_k, where x_{-1} is the
+ * initial state, and the last state has to reach the origin. The cost tracks a sinusoidal
+ * reference, i.e. sum (x_k - r_k)^2 + w * u_k^2
+ */
+class LinearQuadraticChain : public OptimizationModel
+{
+	public:
+		LinearQuadraticChain(unsigned int num_stages) : num_stages_(num_stages),
+				initial_state_(1.), time_step_(0.1), control_weight_(0.1)
+		{
+			state_dimension_ = 2 * num_stages_;
+			constraint_dimension_ = num_stages_ + 1;
+		}
+
+		~LinearQuadraticChain() {}
+
+		void init(bool only_soft_constraints = false) {}
+
+		bool requiresInitialization()
+		{
+			return false;
+		}
+
+		bool getStageStructure(unsigned int& num_stages,
+							   unsigned int& stage_dim,
+							   unsigned int& stage_constraint_dim)
+		{
+			num_stages = num_stages_;
+			stage_dim = 2;
+			stage_constraint_dim = 1;
+			return true;
+		}
+
+		void getStartingPoint(double* decision, int decision_dim)
+		{
+			Eigen::Map<Eigen::VectorXd>(decision, decision_dim).setZero();
+		}
+
+		void evaluateBounds(double* decision_lbound, int decision_dim1,
+							double* decision_ubound, int decision_dim2,
+							double* constraint_lbound, int constraint_dim1,
+							double* constraint_ubound, int constraint_dim2)
+		{
+			Eigen::Map<Eigen::VectorXd>(decision_lbound, decision_dim1).setConstant(-NO_BOUND);
+			Eigen::Map<Eigen::VectorXd>(decision_ubound, decision_dim2).setConstant(NO_BOUND);
+			Eigen::Map<Eigen::VectorXd>(constraint_lbound, constraint_dim1).setZero();
+			Eigen::Map<Eigen::VectorXd>(constraint_ubound, constraint_dim2).setZero();
+		}
+
+		void evaluateCosts(double& cost,
+						   const double* decision, int decision_dim)
+		{
+			cost = 0.;
+			for (unsigned int k = 0; k < num_stages_; k++) {
+				double state_error = decision[2 * k] - getReference(k);
+				double control = decision[2 * k + 1];
+				cost += state_error * state_error + control_weight_ * control * control;
+			}
+		}
+
+		void evaluateCostGradient(double* gradient, int grad_dim,
+								  const double* decision, int decision_dim)
+		{
+			if (decision == NULL)
+				return;
+
+			for (unsigned int k = 0; k < num_stages_; k++) {
+				gradient[2 * k] = 2. * (decision[2 * k] - getReference(k));
+				gradient[2 * k + 1] = 2. * control_weight_ * decision[2 * k + 1];
+			}
+		}
+
+		void evaluateConstraints(double* constraint, int constraint_dim,
+								 const double* decision, int decision_dim)
+		{
+			for (unsigned int k = 0; k < num_stages_; k++) {
+				double last_state = (k == 0) ? initial_state_ : decision[2 * (k - 1)];
+				constraint[k] = decision[2 * k] - last_state - time_step_ * decision[2 * k + 1];
+			}
+			constraint[num_stages_] = decision[2 * (num_stages_ - 1)];
+		}
+
+		/**
+		 * @brief Computes the optimal solution from the KKT system of the quadratic program
+		 * @param Eigen::VectorXd& Optimal decision variables
+		 */
+		void computeOptimalSolution(Eigen::VectorXd& solution)
+		{
+			unsigned int decision_dim = state_dimension_;
+			unsigned int constraint_dim = constraint_dimension_;
+			Eigen::MatrixXd kkt = Eigen::MatrixXd::Zero(decision_dim + constraint_dim,
+														 decision_dim + constraint_dim);
+			Eigen::VectorXd rhs = Eigen::VectorXd::Zero(decision_dim + constraint_dim);
+			for (unsigned int k = 0; k < num_stages_; k++) {
+				// Cost Hessian and gradient
+				kkt(2 * k, 2 * k) = 2.;
+				kkt(2 * k + 1, 2 * k + 1) = 2. * control_weight_;
+				rhs(2 * k) = 2. * getReference(k);
+
+				// Dynamical constraints
+				unsigned int row = decision_dim + k;
+				kkt(row, 2 * k) = 1.;
+				kkt(row, 2 * k + 1) = -time_step_;
+				if (k == 0)
+					rhs(row) = initial_state_;
+				else
+					kkt(row, 2 * (k - 1)) = -1.;
+			}
+			kkt(decision_dim + num_stages_, 2 * (num_stages_ - 1)) = 1.;
+			kkt.topRightCorner(decision_dim, constraint_dim) =
+					kkt.bottomLeftCorner(constraint_dim, decision_dim).transpose();
+
+			solution = kkt.fullPivLu().solve(rhs).head(decision_dim);
+		}
+
+
+	private:
+		/** @brief Gets the state reference of a stage */
+		double getReference(unsigned int stage)
+		{
+			return sin(0.5 * stage);
+		}
+
+		unsigned int num_stages_;
+		double initial_state_;
+		double time_step_;
+		double control_weight_;
+};
+
+} //@namespace model
+} //@namespace dwl
+
+#endif